@@ -1,50 +1,69 @@
 #version 330 core
 
+// The effects are compiled into the variants of the shader(see ::SpriteRenderer), so there
+// are no branches on them:
+//   SPRITE_EFFECT_SHADOW       - the translucent black silhouette
+//   SPRITE_EFFECT_GLOW         - the pulsing glow, the sprite tint is the intensity mask
+//   SPRITE_EFFECT_TRAIL        - the faded copy of the motion blur trail
+//   SPRITE_EFFECT_SMOOTH_EDGES - the rounded corners and the anti-aliased edges of the card
+//   SPRITE_DEBUG_OVERDRAW      - the overdraw heatmap(the blending is additive, see ::SpriteRenderer::setOverdrawView)
+
 in  vec2 textureCoordinates;
+in  vec2 quadCoordinates;
+in  vec3 spriteTint;
 out vec4 color;
 
-uniform vec2 textureResolution;
-uniform vec2 screenResolution;
-
 uniform sampler2D image;
-uniform vec3 spriteColor;
 
-// Effects accessors
-uniform int applyGlowingEffect = 0;
-uniform int applyMotionEffect  = 0;
-uniform int applyShadowEffect  = 0;
+uniform float elapsedTime  = 0.0;
+uniform float cornerRadius = 0.06; // relative to the shorter side of the sprite
+
+#if defined(SPRITE_EFFECT_SMOOTH_EDGES)
+// The part of the pixel that is covered by the rounded rectangle of the sprite. The sprite
+// transform is affine, so the derivatives of the quad coordinates give the size of the sprite
+// in the pixels, and the distance to the edge is measured in the pixels as well. The edge is
+// moved inside by the half of the pixel, because the pixels outside the quad are not drawn.
+float getEdgeCoverage()
+{
+    vec2 spriteSize = vec2(1.0 / length(vec2(dFdx(quadCoordinates.x), dFdy(quadCoordinates.x))),
+                           1.0 / length(vec2(dFdx(quadCoordinates.y), dFdy(quadCoordinates.y))));
+
+    vec2  position = (quadCoordinates - 0.5) * spriteSize;
+    float radius   = cornerRadius * min(spriteSize.x, spriteSize.y);
 
-uniform float elapsedTime        = 0.0;
-uniform vec3  intencityMask      = vec3(0.6, 0.8, 0.8);
+    // The signed distance to the rounded rectangle(negative inside).
+    vec2  corner   = abs(position) - 0.5 * spriteSize + radius;
+    float distance = length(max(corner, 0.0)) + min(max(corner.x, corner.y), 0.0) - radius;
+
+    return clamp(-distance, 0.0, 1.0);
+}
+#endif
 
 void main() 
 {
-    vec4  _spriteColor   = vec4(spriteColor, 1.0); 
-    float intencity      = sin(elapsedTime);
-    
-    color = _spriteColor * texture(image, textureCoordinates);
-
-    if(applyGlowingEffect == 1)
-    {
-      // Glowing effect whenever user hovers the card on the sprite
-      if(applyGlowingEffect == 1) 
-      {
-        for(int i = 0; i < 3; ++i) 
-        {
-          _spriteColor[i] = (intencityMask[i]) + (intencity*(1-intencityMask[i])); 
-        }
-      } 
-
-      color = _spriteColor * texture(image, textureCoordinates);
-    }
-
-    if(applyShadowEffect == 1)
-    {
-      color = vec4(0.0, 0.0, 0.0, 0.2);
-    }
-
-    if(applyMotionEffect == 1)
-    {
-      color.w = 0.1;
-    }
-}
\ No newline at end of file
+#if defined(SPRITE_EFFECT_SHADOW)
+    color = vec4(0.0, 0.0, 0.0, 0.2);
+#elif defined(SPRITE_EFFECT_GLOW)
+    // Glowing effect whenever user hovers the card on the sprite
+    float intencity = sin(elapsedTime);
+
+    color = vec4(spriteTint + intencity * (1.0 - spriteTint), 1.0) * texture(image, textureCoordinates);
+#else
+    color = vec4(spriteTint, 1.0) * texture(image, textureCoordinates);
+#endif
+
+#if defined(SPRITE_EFFECT_TRAIL)
+    color.w = 0.1;
+#endif
+
+#if defined(SPRITE_EFFECT_SMOOTH_EDGES)
+    color.w *= getEdgeCoverage();
+#endif
+
+#if defined(SPRITE_DEBUG_OVERDRAW)
+    // Every rasterized pixel adds the same heat, even the transparent one(it costs the same fill
+    // rate). The pixels that are drawn once are dark red, four times red, eight times orange and
+    // sixteen times yellow.
+    color = vec4(0.25, 0.06, 0.015, 1.0);
+#endif
+}
@@ -1,13 +1,70 @@
 #version 330 core
+
+// The way the sprite is transformed is compiled into the variants of the shader(see ::SpriteRenderer):
+//   SPRITE_PATH_BATCH  - the batched sprites(the instance data is generated on the CPU)
+//   SPRITE_PATH_MOTION - the motion instances(interpolated by the shader)
+//   otherwise          - the single sprite with the model matrix
+
 layout (location = 0) in vec4 vertexIn;
 
+// Per-instance attributes of the GPU-driven sprite motion.
+layout (location = 1) in vec4 motionPositions;       // start.xy, end.xy
+layout (location = 2) in vec4 motionSizeAndRotation; // size.xy, start rotation, end rotation
+layout (location = 3) in vec4 motionColor;           // rgb, unused
+layout (location = 4) in vec4 motionTiming;          // start time, duration
+
+// Per-instance attributes of the batched sprites(generated on the CPU worker threads).
+layout (location = 5) in vec4 instanceAffine;        // the columns of the 2x2 transform
+layout (location = 6) in vec4 instanceOffset;        // translation.xy, flags
+layout (location = 7) in vec4 instanceTextureRect;   // u0, v0, u1, v1
+layout (location = 8) in vec4 instanceColor;         // rgb
+
 out vec2 textureCoordinates;
+out vec2 quadCoordinates; // the position inside the sprite quad, [0, 1]
+out vec3 spriteTint;
 
 uniform mat4 modelMatrix;
 uniform mat4 projectionMatrix;
+uniform vec3 spriteColor;
+
+uniform float globalTime = 0.0;
 
 void main()
 {
     textureCoordinates = vertexIn.zw;
-    gl_Position = projectionMatrix* modelMatrix * vec4(vertexIn.zy, 0.0, 1.0);
-}
\ No newline at end of file
+    quadCoordinates    = vertexIn.zw;
+
+#if defined(SPRITE_PATH_BATCH)
+    {
+      vec2 transformed = mat2(instanceAffine.xy, instanceAffine.zw) * vertexIn.zy + instanceOffset.xy;
+
+      textureCoordinates = mix(instanceTextureRect.xy, instanceTextureRect.zw, vertexIn.zw);
+      spriteTint         = instanceColor.rgb;
+      gl_Position        = projectionMatrix * vec4(transformed, 1.0, 1.0);
+    }
+#elif defined(SPRITE_PATH_MOTION)
+    {
+      // Eased(cubic out) progress of the motion.
+      float progress = clamp((globalTime - motionTiming.x) / max(motionTiming.y, 0.0001), 0.0, 1.0);
+      float inverse  = progress - 1.0;
+      float eased    = inverse * inverse * inverse + 1.0;
+
+      vec2  size     = motionSizeAndRotation.xy;
+      vec2  position = mix(motionPositions.xy, motionPositions.zw, eased);
+      float rotation = radians(mix(motionSizeAndRotation.z, motionSizeAndRotation.w, eased));
+
+      // The same transform as the sprite model matrix: scale, rotate around the center, translate.
+      vec2 local   = vertexIn.zy * size - 0.5 * size;
+      vec2 rotated = vec2(cos(rotation) * local.x - sin(rotation) * local.y,
+                          sin(rotation) * local.x + cos(rotation) * local.y);
+
+      spriteTint  = motionColor.rgb;
+      gl_Position = projectionMatrix * vec4(rotated + 0.5 * size + position, 1.0, 1.0);
+    }
+#else
+    {
+      spriteTint  = spriteColor;
+      gl_Position = projectionMatrix * modelMatrix * vec4(vertexIn.zy, 0.0, 1.0);
+    }
+#endif
+}
@@ -0,0 +1,38 @@
+#version 330 core
+
+// Upscales the scene that was rendered with the lower resolution into the corner of the scene
+// texture(see ::DynamicResolution). The bilinear sample is sharpened by the difference from its
+// neighbour texels, and the result is limited by them, so the edges of the cards do not ring.
+
+in  vec2 screenCoordinates;
+out vec4 color;
+
+uniform sampler2D scene;
+uniform vec2      sceneScale; // the part of the scene texture the scene was rendered into
+uniform float     sharpness;  // zero is the plain bilinear upscale
+
+vec3 sampleScene(vec2 coordinates, vec2 texelSize)
+{
+    // The texels outside of the rendered part are left from the larger scales.
+    return texture(scene, clamp(coordinates, 0.5 * texelSize, sceneScale - 0.5 * texelSize)).rgb;
+}
+
+void main()
+{
+    vec2 texelSize   = 1.0 / vec2(textureSize(scene, 0));
+    vec2 coordinates = screenCoordinates * sceneScale;
+
+    vec3 center = sampleScene(coordinates, texelSize);
+    vec3 left   = sampleScene(coordinates - vec2(texelSize.x, 0.0), texelSize);
+    vec3 right  = sampleScene(coordinates + vec2(texelSize.x, 0.0), texelSize);
+    vec3 bottom = sampleScene(coordinates - vec2(0.0, texelSize.y), texelSize);
+    vec3 top    = sampleScene(coordinates + vec2(0.0, texelSize.y), texelSize);
+
+    vec3 minimum = min(center, min(min(left, right), min(bottom, top)));
+    vec3 maximum = max(center, max(max(left, right), max(bottom, top)));
+
+    // The unsharp mask: the center is moved away from the average of the neighbours.
+    vec3 sharpened = center + sharpness * (center - 0.25 * (left + right + bottom + top));
+
+    color = vec4(clamp(sharpened, minimum, maximum), 1.0);
+}
@@ -0,0 +1,14 @@
+#version 330 core
+
+// The triangle that covers the whole screen, the vertices are generated from their index(there
+// are no vertex attributes, see ::DynamicResolution).
+
+out vec2 screenCoordinates; // [0, 1] on the screen
+
+void main()
+{
+    vec2 position = vec2((gl_VertexID << 1) & 2, gl_VertexID & 2);
+
+    screenCoordinates = position;
+    gl_Position       = vec4(position * 2.0 - 1.0, 0.0, 1.0);
+}
@@ -1,15 +1,20 @@
 #include "engine/Application.hpp"
+#include "engine/HeadlessRunner.hpp"
 #include "engine/Logger.hpp"
 
 #include "game/Program.hpp"
 
-int main(int argc, char** argv[])
+int main(int argc, char* argv[])
 {
-	UnreferencedParameter(argc);
-	UnreferencedParameter(argv);
+	// The arguments select the headless mode(see ::HeadlessRunner::parseArguments).
+	if (!FunctionSuccessA(Engine::HeadlessRunner::instance().parseArguments(argc, argv)))
+		return(1);
 
 	Game::GameProgram gameProgram;
-	gameProgram.execute();
+
+	// The build server tells the failed run by the exit code.
+	if (!FunctionSuccessA(gameProgram.execute()))
+		return(1);
 
 	return(0);
-}
\ No newline at end of file
+}
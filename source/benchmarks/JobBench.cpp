@@ -0,0 +1,158 @@
+// This file implements the `job-bench` stress benchmark of the `JobSystem` class.
+//
+// The benchmark runs the same workloads with the growing amount of the worker threads,
+// so the scaling of the job system(and the cost of the stealing) can be measured. The
+// main thread helps the workers while it waits for the results, like the game does:
+//
+//   job-bench [jobs per run] [work per job] [runs]
+#include "../engine/JobSystem.hpp"
+#include "../engine/Logger.hpp"
+
+#include "chrono"
+#include "cstdio"
+#include "cstdlib"
+
+using namespace std;
+
+// The CPU-bound work that can not be optimized away.
+static uint64_t spin(uint64_t seed, uint32_t iterations) noexcept
+{
+	uint64_t state = seed | 1u;
+
+	for (uint32_t iteration = 0; iteration < iterations; ++iteration)
+	{
+		state ^= state << 13;
+		state ^= state >> 7;
+		state ^= state << 17;
+	}
+
+	return(state);
+}
+
+// The independent jobs scheduled from the main thread.
+static double runFlatWorkload(size_t jobsTotal, uint32_t workPerJob, vector<uint64_t>& results)
+{
+	auto& jobSystem = Engine::JobSystem::instance();
+
+	const auto timeBegin = chrono::steady_clock::now();
+
+	Engine::JobCounter jobCounter;
+	jobSystem.parallelFor(jobsTotal, 1, [&results, workPerJob](size_t batchBegin, size_t batchEnd)
+	{
+		for (size_t jobIndex = batchBegin; jobIndex < batchEnd; ++jobIndex)
+			results[jobIndex] = spin(jobIndex, workPerJob);
+	}, &jobCounter);
+	jobSystem.wait(jobCounter);
+
+	return(chrono::duration<double, milli>(chrono::steady_clock::now() - timeBegin).count());
+}
+
+// The jobs are spawned by the jobs(so the work starts on the single worker and has to be
+// stolen), and the second stage depends on the first one through the counter.
+static double runNestedWorkload(size_t jobsTotal, uint32_t workPerJob, vector<uint64_t>& results)
+{
+	auto& jobSystem = Engine::JobSystem::instance();
+
+	const auto timeBegin = chrono::steady_clock::now();
+
+	Engine::JobCounter firstStage;
+	Engine::JobCounter secondStage;
+
+	jobSystem.schedule([&]()
+	{
+		for (size_t jobIndex = 0; jobIndex < jobsTotal; ++jobIndex)
+			jobSystem.schedule([&results, jobIndex, workPerJob]() { results[jobIndex] = spin(jobIndex, workPerJob); }, &firstStage);
+	}, &firstStage);
+
+	jobSystem.schedule([&]()
+	{
+		uint64_t checksum = 0;
+
+		for (const auto result : results)
+			checksum ^= result;
+
+		results[0] = checksum;
+	}, &secondStage, &firstStage);
+
+	jobSystem.wait(secondStage);
+
+	return(chrono::duration<double, milli>(chrono::steady_clock::now() - timeBegin).count());
+}
+
+// Get the amount of the jobs that were stolen by all the workers.
+static uint64_t getStolenTotal() noexcept
+{
+	auto& jobSystem = Engine::JobSystem::instance();
+
+	uint64_t stolenTotal = 0;
+
+	for (uint32_t workerIndex = 0; workerIndex < jobSystem.getWorkerCount(); ++workerIndex)
+		stolenTotal += jobSystem.getWorkerStats(workerIndex).jobsStolen;
+
+	return(stolenTotal);
+}
+
+int main(int argc, char* argv[])
+{
+	const size_t   jobsTotal  = argc > 1 ? strtoull(argv[1], nullptr, 10) : 20000;
+	const uint32_t workPerJob = argc > 2 ? static_cast<uint32_t>(strtoul(argv[2], nullptr, 10)) : 20000;
+	const uint32_t runsTotal  = argc > 3 ? static_cast<uint32_t>(strtoul(argv[3], nullptr, 10)) : 5;
+
+	Engine::Logger::initialize();
+
+	const uint32_t maxWorkers = std::max(thread::hardware_concurrency(), 1u);
+
+	printf("jobs: %zu, work per job: %u, runs: %u, cores: %u\n\n", jobsTotal, workPerJob, runsTotal, maxWorkers);
+	printf("%-8s %-10s %12s %9s %14s %9s\n", "workers", "workload", "best ms", "speedup", "jobs/s", "stolen");
+
+	// The powers of two, and all the cores at last.
+	vector<uint32_t> workerCounts;
+	for (uint32_t workersTotal = 1; workersTotal < maxWorkers; workersTotal *= 2)
+		workerCounts.push_back(workersTotal);
+	workerCounts.push_back(maxWorkers);
+
+	vector<uint64_t> results(std::max<size_t>(jobsTotal, 1));
+	double           baselineTime[2] = { 0.0, 0.0 };
+
+	for (const uint32_t workersTotal : workerCounts)
+	{
+		auto& jobSystem = Engine::JobSystem::instance();
+
+		if (jobSystem.initialize(workersTotal) != Engine::Error::Ok)
+			return(1);
+
+		for (int workloadIndex = 0; workloadIndex < 2; ++workloadIndex)
+		{
+			const uint64_t stolenBefore = getStolenTotal();
+
+			double bestTime = 1e300;
+
+			for (uint32_t runIndex = 0; runIndex < runsTotal; ++runIndex)
+			{
+				const double runTime = workloadIndex == 0
+					? runFlatWorkload  (jobsTotal, workPerJob, results)
+					: runNestedWorkload(jobsTotal, workPerJob, results);
+
+				bestTime = std::min(bestTime, runTime);
+			}
+
+			const uint64_t stolenAfter = getStolenTotal();
+
+			if (workersTotal == 1)
+				baselineTime[workloadIndex] = bestTime;
+
+			printf("%-8u %-10s %12.2f %8.2fx %14.0f %9llu\n",
+				workersTotal,
+				workloadIndex == 0 ? "flat" : "nested",
+				bestTime,
+				baselineTime[workloadIndex] / bestTime,
+				static_cast<double>(jobsTotal) / (bestTime / 1000.0),
+				static_cast<unsigned long long>((stolenAfter - stolenBefore) / std::max(runsTotal, 1u)));
+		}
+
+		jobSystem.release();
+	}
+
+	// Keep the results alive, so the work is not optimized out.
+	return(results[0] == 0x5EEDu ? 2 : 0);
+}
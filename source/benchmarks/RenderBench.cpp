@@ -0,0 +1,468 @@
+// This file implements the `render-bench` sprite stress benchmark of the renderer.
+//
+// The benchmark draws the configurable scene through the same `Application`/`SpriteRenderer`
+// stack as the game(including the shadow, glowing and motion blur paths of the card
+// rendering), runs for the fixed amount of frames and reports the CPU submit time, the GPU
+// time, the draw calls and the sprites per second. It runs headless by default:
+//
+//   render-bench [--sprites=N] [--textures=K] [--rotation] [--effects] [--motion-blur]
+//                [--batched] [--sorted] [--smooth-edges] [--stack=N] [--no-culling] [--overdraw]
+//                [--warmup=N] [--csv=PATH] [--windowed] [headless options, see ::HeadlessRunner]
+//
+// The `--batched` option queues the sprites and flushes them once per frame(the instance
+// data is generated on the job system workers), instead of drawing them one by one. The
+// `--sorted` option sorts the queued sprites by the shader variant and the texture. The
+// `--smooth-edges` option anti-aliases the card edges in the shader, compare it with the
+// multisampled target of the runner(`--rotation --msaa=4`).
+//
+// The `--stack=N` option piles every N sprites at the same position(like the deck of the game),
+// the batched sprites that are covered by the ones on top are culled unless `--no-culling` is
+// given. The `--overdraw` option draws the overdraw heatmap instead of the sprites(see the
+// `--capture` option of the runner).
+#include "../engine/Application.hpp"
+#include "../engine/HeadlessRunner.hpp"
+#include "../engine/GpuProfiler.hpp"
+#include "../engine/Logger.hpp"
+#include "../engine/Sprite.hpp"
+
+#include "algorithm"
+#include "filesystem"
+#include "cstring"
+#include "cstdio"
+#include "vector"
+
+using namespace std;
+using Engine::operator""_sid;
+
+// The directory the card textures are taken from.
+static constexpr const char* _RENDER_BENCH_ASSETS_RELPATH = "data/assets";
+
+// The size of the benchmark sprite(the size of the card on the board).
+static constexpr const glm::vec2 _RENDER_BENCH_SPRITE_SIZE = { 150.0f, 225.0f };
+
+// The intensity masks of the glowing effect(the same as the game is using).
+static constexpr const glm::vec3 _RENDER_BENCH_MASK_BAD  = { 0.9f, 0.8f, 0.8f };
+static constexpr const glm::vec3 _RENDER_BENCH_MASK_GOOD = { 0.8f, 0.9f, 0.8f };
+
+// The scene that is drawn every frame.
+struct BenchScene
+{
+	size_t      spritesTotal   = 1000;
+	size_t      texturesTotal  = 8;
+	bool        isRotating     = false;
+	bool        hasEffects     = false;
+	bool        hasMotionBlur  = false;
+	bool        isBatched      = false;
+	bool        isSorted       = false;
+	bool        hasSmoothEdges = false;
+	size_t      stackSize      = 1;
+	bool        isCulling      = true;
+	bool        isOverdrawView = false;
+	uint64_t    warmupFrames   = 10;
+	std::string csvPath;
+};
+
+// The scene and the measurements of the run.
+class RenderBench : public One::Application
+{
+public:
+	explicit RenderBench(const BenchScene& benchScene) : m_Scene(benchScene)
+	{
+		// The windowed run measures the native resolution as well.
+		m_IsDynamicResolutionAllowed = false;
+	}
+
+public:
+	virtual Engine::Error onUserInitialize() override;
+
+	virtual Engine::Error onUserRelease() override;
+
+	virtual Engine::Error onUserUpdate(GLfloat elapsedTime) override;
+
+private:
+	// Render the sprite the way the game renders the card(the shadow first, then the
+	// sprite itself with the glowing or the motion blur effect).
+	void renderBenchSprite(Engine::GFX::Sprite& sprite, size_t spriteIndex);
+
+	// Queue the same sprites as the ::renderBenchSprite, the effects are the instance flags.
+	void queueBenchSprite(const Engine::GFX::Sprite& sprite, size_t spriteIndex);
+
+private:
+	BenchScene m_Scene;
+
+	std::vector<Engine::StringID>    m_Textures;
+	std::vector<Engine::GFX::Sprite> m_Sprites;
+
+	uint64_t m_FrameIndex      = 0;
+	uint64_t m_MeasureBegin    = 0;
+	uint64_t m_SubmitTime      = 0; // nanoseconds
+	uint64_t m_DrawCalls       = 0;
+	uint64_t m_StateChanges    = 0;
+	uint64_t m_CountedFrames   = 0; // the frames the draw calls were counted for
+	uint64_t m_MeasuredFrames  = 0;
+	double   m_GpuTimeBegin    = 0.0;
+	uint64_t m_GpuFramesBegin  = 0;
+};
+
+Engine::Error RenderBench::onUserInitialize()
+{
+	// The textures are the card images in the stable order, so the runs are comparable.
+	vector<string> texturePaths;
+
+	for (const auto& directoryEntry : filesystem::recursive_directory_iterator(_RENDER_BENCH_ASSETS_RELPATH))
+		if (directoryEntry.is_regular_file() && directoryEntry.path().extension() == ".png")
+			texturePaths.push_back(directoryEntry.path().generic_string());
+
+	sort(texturePaths.begin(), texturePaths.end());
+
+	if (texturePaths.empty())
+	{
+		Engine::Logger::m_ApplicationLogger->error("No textures found in {}", _RENDER_BENCH_ASSETS_RELPATH);
+
+		return(Engine::Error::InitializationError);
+	}
+
+	if (m_Scene.texturesTotal > texturePaths.size())
+	{
+		Engine::Logger::m_ApplicationLogger->warn("Only {} textures are available", texturePaths.size());
+
+		m_Scene.texturesTotal = texturePaths.size();
+	}
+
+	for (size_t textureIndex = 0; textureIndex < m_Scene.texturesTotal; ++textureIndex)
+	{
+		const string textureName = fmt::format("bench-texture-{}", textureIndex);
+
+		// The same filtering as the cards of the game.
+		Engine::ResourceManager::loadTexture(texturePaths[textureIndex].c_str(), true, textureName, { .filtering = Engine::GFX::Core::TextureFiltering::Anisotropic });
+		m_Textures.push_back(Engine::StringID(textureName));
+	}
+
+	// Scatter the sprites over the window with the fixed seed.
+	const auto windowDimensions = getWindowDimensions();
+	uint32_t   randomState      = 0x101u;
+
+	auto nextRandom = [&randomState]() -> float
+	{
+		randomState ^= randomState << 13;
+		randomState ^= randomState >> 17;
+		randomState ^= randomState << 5;
+
+		return(static_cast<float>(randomState & 0xFFFFFF) / static_cast<float>(0x1000000));
+	};
+
+	m_Sprites.resize(m_Scene.spritesTotal);
+
+	glm::vec2 stackPosition = { 0.0f, 0.0f };
+
+	for (size_t spriteIndex = 0; spriteIndex < m_Sprites.size(); ++spriteIndex)
+	{
+		auto& sprite = m_Sprites[spriteIndex];
+
+		if (spriteIndex % m_Scene.stackSize == 0)
+		{
+			stackPosition = {
+				nextRandom() * (windowDimensions.x - _RENDER_BENCH_SPRITE_SIZE.x),
+				nextRandom() * (windowDimensions.y - _RENDER_BENCH_SPRITE_SIZE.y) };
+		}
+
+		sprite.setSpriteSize    (_RENDER_BENCH_SPRITE_SIZE);
+		sprite.bindTexture      (m_Textures[spriteIndex % m_Textures.size()]);
+		sprite.setSpritePosition(stackPosition);
+	}
+
+	m_SpriteRenderer->setOcclusionCulling(m_Scene.isCulling);
+	m_SpriteRenderer->setOverdrawView    (m_Scene.isOverdrawView);
+
+	// The GPU time is measured for the whole run.
+	Engine::GpuProfiler::instance().setEnabled(true);
+
+	return(Engine::Error::Ok);
+}
+
+Engine::Error RenderBench::onUserUpdate(GLfloat elapsedTime)
+{
+	UnreferencedParameter(elapsedTime);
+
+	auto& gpuProfiler = Engine::GpuProfiler::instance();
+
+	// The counters of the previous frame are ready now.
+	if (m_FrameIndex > m_Scene.warmupFrames)
+	{
+		m_DrawCalls    += gpuProfiler.getRenderStats().drawCalls;
+		m_StateChanges += gpuProfiler.getRenderStats().stateChanges;
+		m_CountedFrames++;
+	}
+
+	if (m_FrameIndex == m_Scene.warmupFrames)
+	{
+		m_MeasureBegin   = Engine::InputQueue::timestamp();
+		m_GpuTimeBegin   = gpuProfiler.getMeasuredGpuTime();
+		m_GpuFramesBegin = gpuProfiler.getMeasuredFrames();
+	}
+
+	const uint64_t submitBegin = Engine::InputQueue::timestamp();
+
+	m_SpriteRenderer->setElapsedTime(static_cast<GLfloat>(glfwGetTime() * 6));
+
+	const GLfloat rotationOffset = static_cast<GLfloat>(m_FrameIndex);
+
+	for (size_t spriteIndex = 0; spriteIndex < m_Sprites.size(); ++spriteIndex)
+	{
+		auto& sprite = m_Sprites[spriteIndex];
+
+		if (m_Scene.isRotating)
+			sprite.setSpriteRotation(static_cast<GLfloat>(spriteIndex * 7) + rotationOffset);
+
+		renderBenchSprite(sprite, spriteIndex);
+	}
+
+	if (m_Scene.isBatched)
+	{
+		gpuProfiler.beginPass(Engine::GpuPass::Cards);
+
+		m_SpriteRenderer->flushSprites(m_Scene.isSorted ? Engine::GFX::SpriteBatchOrder::Variant : Engine::GFX::SpriteBatchOrder::Queue);
+	}
+
+	gpuProfiler.endPass();
+
+	if (m_FrameIndex >= m_Scene.warmupFrames)
+	{
+		m_SubmitTime += Engine::InputQueue::timestamp() - submitBegin;
+		m_MeasuredFrames++;
+	}
+
+	// The UI is not drawn, but the engine renders the ImGui draw data every frame.
+	ImguiCreateNewFrameKHR();
+	ImGui::NewFrame();
+	ImGui::Render();
+
+	m_FrameIndex++;
+
+	// The windowed run is not stopped by the ::HeadlessRunner(zero frames run until the window is closed).
+	const uint64_t framesTotal = Engine::HeadlessRunner::instance().getSettings().framesTotal;
+
+	if (framesTotal != 0 && m_FrameIndex >= framesTotal)
+		glfwSetWindowShouldClose(getWindowPointer(), true);
+
+	return(Engine::Error::Ok);
+}
+
+void RenderBench::renderBenchSprite(Engine::GFX::Sprite& sprite, size_t spriteIndex)
+{
+	auto& gpuProfiler = Engine::GpuProfiler::instance();
+
+	if (m_Scene.isBatched)
+	{
+		queueBenchSprite(sprite, spriteIndex);
+
+		return;
+	}
+
+	const uint32_t edgeFlags = m_Scene.hasSmoothEdges ? Engine::GFX::SpriteInstanceSmoothEdges : Engine::GFX::SpriteInstanceNone;
+
+	if (!m_Scene.hasEffects && !m_Scene.hasMotionBlur)
+	{
+		gpuProfiler.beginPass(Engine::GpuPass::Cards);
+
+		sprite.render(m_SpriteRenderer, edgeFlags);
+
+		return;
+	}
+
+	const auto size     = sprite.getSpriteSize();
+	const auto position = sprite.getSpritePosition();
+
+	// The shadow is the same sprite, moved a bit and darkened by the shader.
+	Engine::GFX::Sprite shadowSprite = sprite;
+	shadowSprite.setSpritePosition({ position.x + size.x / 14, position.y + size.y / 14 });
+
+	gpuProfiler.beginPass(Engine::GpuPass::Effects);
+
+	shadowSprite.render(m_SpriteRenderer, Engine::GFX::SpriteInstanceShadow | edgeFlags);
+
+	if (m_Scene.hasMotionBlur)
+	{
+		// The sprite itself and the 18 shifted copies of it.
+		constexpr float blurOffset = 2.6f;
+
+		sprite.render(m_SpriteRenderer, edgeFlags);
+
+		Engine::GFX::Sprite spriteCopy = sprite;
+
+		for (int offsetX = 0; offsetX < 3; ++offsetX)
+		{
+			for (int offsetY = 0; offsetY < 3; ++offsetY)
+			{
+				spriteCopy.setSpritePosition({ position.x + blurOffset * offsetX, position.y + blurOffset * offsetY });
+				spriteCopy.render(m_SpriteRenderer, Engine::GFX::SpriteInstanceTrail | edgeFlags);
+				spriteCopy.setSpritePosition({ position.x - blurOffset * offsetX, position.y - blurOffset * offsetY });
+				spriteCopy.render(m_SpriteRenderer, Engine::GFX::SpriteInstanceTrail | edgeFlags);
+			}
+		}
+	}
+	else
+	{
+		// Every other sprite glows red, the rest glow green(the sprite color is the intensity mask).
+		Engine::GFX::Sprite glowingSprite = sprite;
+		glowingSprite.setSpriteColor((spriteIndex & 1) ? _RENDER_BENCH_MASK_BAD : _RENDER_BENCH_MASK_GOOD);
+		glowingSprite.render(m_SpriteRenderer, Engine::GFX::SpriteInstanceGlow | edgeFlags);
+	}
+}
+
+void RenderBench::queueBenchSprite(const Engine::GFX::Sprite& sprite, size_t spriteIndex)
+{
+	const uint32_t edgeFlags = m_Scene.hasSmoothEdges ? Engine::GFX::SpriteInstanceSmoothEdges : Engine::GFX::SpriteInstanceNone;
+
+	if (!m_Scene.hasEffects && !m_Scene.hasMotionBlur)
+	{
+		sprite.queue(m_SpriteRenderer, edgeFlags);
+
+		return;
+	}
+
+	const auto size     = sprite.getSpriteSize();
+	const auto position = sprite.getSpritePosition();
+
+	Engine::GFX::Sprite shadowSprite = sprite;
+	shadowSprite.setSpritePosition({ position.x + size.x / 14, position.y + size.y / 14 });
+	shadowSprite.queue(m_SpriteRenderer, Engine::GFX::SpriteInstanceShadow | edgeFlags);
+
+	if (m_Scene.hasMotionBlur)
+	{
+		constexpr float blurOffset = 2.6f;
+
+		sprite.queue(m_SpriteRenderer, edgeFlags);
+
+		Engine::GFX::Sprite spriteCopy = sprite;
+
+		for (int offsetX = 0; offsetX < 3; ++offsetX)
+		{
+			for (int offsetY = 0; offsetY < 3; ++offsetY)
+			{
+				spriteCopy.setSpritePosition({ position.x + blurOffset * offsetX, position.y + blurOffset * offsetY });
+				spriteCopy.queue(m_SpriteRenderer, Engine::GFX::SpriteInstanceTrail | edgeFlags);
+				spriteCopy.setSpritePosition({ position.x - blurOffset * offsetX, position.y - blurOffset * offsetY });
+				spriteCopy.queue(m_SpriteRenderer, Engine::GFX::SpriteInstanceTrail | edgeFlags);
+			}
+		}
+	}
+	else
+	{
+		Engine::GFX::Sprite glowingSprite = sprite;
+		glowingSprite.setSpriteColor((spriteIndex & 1) ? _RENDER_BENCH_MASK_BAD : _RENDER_BENCH_MASK_GOOD);
+		glowingSprite.queue(m_SpriteRenderer, Engine::GFX::SpriteInstanceGlow | edgeFlags);
+	}
+}
+
+Engine::Error RenderBench::onUserRelease()
+{
+	if (m_MeasuredFrames == 0)
+	{
+		printf("No frames were measured(the run is shorter than %llu warmup frames)\n", static_cast<unsigned long long>(m_Scene.warmupFrames));
+
+		return(Engine::Error::ValidationError);
+	}
+
+	const double measuredSeconds = static_cast<double>(Engine::InputQueue::timestamp() - m_MeasureBegin) * 1e-9;
+	const double measuredFrames  = static_cast<double>(m_MeasuredFrames);
+	const double countedFrames   = static_cast<double>(std::max<uint64_t>(m_CountedFrames,  1));
+
+	auto& gpuProfiler = Engine::GpuProfiler::instance();
+
+	// The GPU results are read back a few frames later, so they are averaged over the frames
+	// that were actually measured.
+	const uint64_t gpuFrames = gpuProfiler.getMeasuredFrames() - m_GpuFramesBegin;
+	const double   gpuTime   = gpuFrames > 0 ? (gpuProfiler.getMeasuredGpuTime() - m_GpuTimeBegin) / static_cast<double>(gpuFrames) : 0.0;
+
+	const double submitTime   = static_cast<double>(m_SubmitTime) * 1e-6 / measuredFrames;
+	const double frameTime    = measuredSeconds * 1e3 / measuredFrames;
+	const double drawCalls    = static_cast<double>(m_DrawCalls)    / countedFrames;
+	const double stateChanges = static_cast<double>(m_StateChanges) / countedFrames;
+	const double spritesRate  = static_cast<double>(m_Sprites.size()) * measuredFrames / measuredSeconds;
+
+	const int multisampleCount = Engine::HeadlessRunner::instance().getSettings().samples;
+
+	printf("sprites: %zu, textures: %zu, rotation: %s, effects: %s, motion blur: %s, batched: %s, sorted: %s, smooth edges: %s, msaa: %d, stack: %zu, culling: %s, frames: %llu\n\n",
+		m_Sprites.size(), m_Textures.size(),
+		m_Scene.isRotating    ? "on" : "off",
+		m_Scene.hasEffects    ? "on" : "off",
+		m_Scene.hasMotionBlur ? "on" : "off",
+		m_Scene.isBatched     ? "on" : "off",
+		m_Scene.isSorted      ? "on" : "off",
+		m_Scene.hasSmoothEdges ? "on" : "off",
+		multisampleCount,
+		m_Scene.stackSize,
+		m_Scene.isCulling      ? "on" : "off",
+		static_cast<unsigned long long>(m_MeasuredFrames));
+
+	printf("%12s %12s %12s %12s %14s %14s\n", "submit ms", "gpu ms", "frame ms", "draw calls", "state changes", "sprites/s");
+	printf("%12.3f %12.3f %12.3f %12.0f %14.0f %14.0f\n", submitTime, gpuTime, frameTime, drawCalls, stateChanges, spritesRate);
+
+	// Append the row, so the history of the runs can be plotted.
+	if (!m_Scene.csvPath.empty())
+	{
+		const bool isNewFile = !filesystem::exists(m_Scene.csvPath);
+
+		if (FILE* csvFile = fopen(m_Scene.csvPath.c_str(), "a"); csvFile != nullptr)
+		{
+			if (isNewFile)
+				fputs("sprites,textures,rotation,effects,motion_blur,frames,submit_ms,gpu_ms,frame_ms,draw_calls,state_changes,sprites_per_s,batched,sorted,smooth_edges,msaa,stack,culling\n", csvFile);
+
+			fprintf(csvFile, "%zu,%zu,%d,%d,%d,%llu,%.4f,%.4f,%.4f,%.0f,%.0f,%.0f,%d,%d,%d,%d,%zu,%d\n",
+				m_Sprites.size(), m_Textures.size(), m_Scene.isRotating, m_Scene.hasEffects, m_Scene.hasMotionBlur,
+				static_cast<unsigned long long>(m_MeasuredFrames), submitTime, gpuTime, frameTime, drawCalls, stateChanges, spritesRate, m_Scene.isBatched, m_Scene.isSorted,
+				m_Scene.hasSmoothEdges, multisampleCount, m_Scene.stackSize, m_Scene.isCulling);
+
+			fclose(csvFile);
+		}
+	}
+
+	return(Engine::Error::Ok);
+}
+
+int main(int argc, char* argv[])
+{
+	BenchScene benchScene;
+	bool       isWindowed = false;
+
+	// The benchmark options are taken out, the rest goes to the ::HeadlessRunner.
+	vector<char*> runnerArguments = { argv[0] };
+
+	for (int argumentIndex = 1; argumentIndex < argc; ++argumentIndex)
+	{
+		char* argument = argv[argumentIndex];
+
+		if      (strncmp(argument, "--sprites=",  10) == 0) benchScene.spritesTotal  = strtoull(argument + 10, nullptr, 10);
+		else if (strncmp(argument, "--textures=", 11) == 0) benchScene.texturesTotal = std::max<size_t>(strtoull(argument + 11, nullptr, 10), 1);
+		else if (strncmp(argument, "--stack=",     8) == 0) benchScene.stackSize     = std::max<size_t>(strtoull(argument + 8, nullptr, 10), 1);
+		else if (strncmp(argument, "--warmup=",    9) == 0) benchScene.warmupFrames  = strtoull(argument + 9, nullptr, 10);
+		else if (strncmp(argument, "--csv=",       6) == 0) benchScene.csvPath       = argument + 6;
+		else if (strcmp (argument, "--rotation")     == 0) benchScene.isRotating    = true;
+		else if (strcmp (argument, "--effects")      == 0) benchScene.hasEffects    = true;
+		else if (strcmp (argument, "--motion-blur")  == 0) benchScene.hasMotionBlur = true;
+		else if (strcmp (argument, "--batched")      == 0) benchScene.isBatched     = true;
+		else if (strcmp (argument, "--sorted")       == 0) benchScene.isSorted      = true;
+		else if (strcmp (argument, "--smooth-edges") == 0) benchScene.hasSmoothEdges = true;
+		else if (strcmp (argument, "--no-culling")   == 0) benchScene.isCulling      = false;
+		else if (strcmp (argument, "--overdraw")     == 0) benchScene.isOverdrawView = true;
+		else if (strcmp (argument, "--windowed")     == 0) isWindowed               = true;
+		else
+			runnerArguments.push_back(argument);
+	}
+
+	static char headlessArgument[] = "--headless";
+
+	if (!isWindowed)
+		runnerArguments.push_back(headlessArgument);
+
+	if (!FunctionSuccessA(Engine::HeadlessRunner::instance().parseArguments(static_cast<int>(runnerArguments.size()), runnerArguments.data())))
+		return(1);
+
+	RenderBench renderBench(benchScene);
+
+	if (!FunctionSuccessA(renderBench.execute()))
+		return(1);
+
+	return(0);
+}
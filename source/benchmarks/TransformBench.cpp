@@ -0,0 +1,156 @@
+// This file implements the `transform-bench` microbenchmark of the sprite affine kernel.
+//
+// The benchmark transforms the same random sprites with the five glm operations the sprite
+// renderer used to build the model matrix with, with the scalar kernel and with the vector
+// kernel the engine is compiled with, and reports the time per sprite and the largest
+// difference from the glm matrices:
+//
+//   transform-bench [sprites] [runs]
+#include "../engine/rendering/AffineKernel.hpp"
+
+#include "glm/glm.hpp"
+#include "glm/gtc/matrix_transform.hpp"
+
+#include "algorithm"
+#include "chrono"
+#include "cmath"
+#include "cstdio"
+#include "cstdlib"
+#include "random"
+#include "vector"
+
+using namespace std;
+
+// The sprites in both layouts.
+struct BenchSprites
+{
+	vector<float> positionX, positionY, sizeX, sizeY, rotation;
+	vector<float> m00, m01, m02, m10, m11, m12;
+
+	vector<glm::mat4> modelMatrices;
+
+	explicit BenchSprites(size_t spritesTotal)
+		: positionX(spritesTotal), positionY(spritesTotal), sizeX(spritesTotal), sizeY(spritesTotal), rotation(spritesTotal),
+		  m00(spritesTotal), m01(spritesTotal), m02(spritesTotal), m10(spritesTotal), m11(spritesTotal), m12(spritesTotal),
+		  modelMatrices(spritesTotal)
+	{
+		mt19937 randomEngine(101);
+
+		uniform_real_distribution<float> positionDistribution(-2000.0f, 2000.0f);
+		uniform_real_distribution<float> sizeDistribution    (  10.0f,  300.0f);
+		uniform_real_distribution<float> rotationDistribution(-720.0f, 720.0f);
+
+		for (size_t spriteIndex = 0; spriteIndex < spritesTotal; ++spriteIndex)
+		{
+			positionX[spriteIndex] = positionDistribution(randomEngine);
+			positionY[spriteIndex] = positionDistribution(randomEngine);
+			sizeX    [spriteIndex] = sizeDistribution    (randomEngine);
+			sizeY    [spriteIndex] = sizeDistribution    (randomEngine);
+			rotation [spriteIndex] = rotationDistribution(randomEngine);
+		}
+	}
+
+	Engine::GFX::SpriteTransformsSoA transforms() const noexcept
+	{
+		return(Engine::GFX::SpriteTransformsSoA{ positionX.data(), positionY.data(), sizeX.data(), sizeY.data(), rotation.data() });
+	}
+
+	Engine::GFX::SpriteAffinesSoA affines() noexcept
+	{
+		return(Engine::GFX::SpriteAffinesSoA{ m00.data(), m01.data(), m02.data(), m10.data(), m11.data(), m12.data() });
+	}
+};
+
+// The model matrices the way the sprite renderer used to build them.
+static void buildModelMatrices(BenchSprites& benchSprites) noexcept
+{
+	const size_t spritesTotal = benchSprites.modelMatrices.size();
+
+	for (size_t spriteIndex = 0; spriteIndex < spritesTotal; ++spriteIndex)
+	{
+		const glm::vec2 spritePosition = { benchSprites.positionX[spriteIndex], benchSprites.positionY[spriteIndex] };
+		const glm::vec2 spriteSize     = { benchSprites.sizeX[spriteIndex],     benchSprites.sizeY[spriteIndex]     };
+
+		glm::mat4 modelMatrix = glm::mat4(1.0f);
+		modelMatrix = glm::translate(modelMatrix, glm::vec3(spritePosition, 1.0f));
+		modelMatrix = glm::translate(modelMatrix, glm::vec3(0.5f * spriteSize.x, 0.5f * spriteSize.y, 0.0f));
+		modelMatrix = glm::rotate   (modelMatrix, glm::radians(benchSprites.rotation[spriteIndex]), glm::vec3(0.0f, 0.0f, 1.0f));
+		modelMatrix = glm::translate(modelMatrix, glm::vec3(-0.5f * spriteSize.x, -0.5f * spriteSize.y, 0.0f));
+		modelMatrix = glm::scale    (modelMatrix, glm::vec3(spriteSize, 1.0f));
+
+		benchSprites.modelMatrices[spriteIndex] = modelMatrix;
+	}
+}
+
+// The best time of the runs in the nanoseconds per sprite.
+template<typename BenchFunction>
+static double measure(size_t spritesTotal, uint32_t runsTotal, BenchFunction benchFunction)
+{
+	double bestTime = 1e300;
+
+	for (uint32_t runIndex = 0; runIndex < runsTotal; ++runIndex)
+	{
+		const auto timeBegin = chrono::steady_clock::now();
+
+		benchFunction();
+
+		bestTime = std::min(bestTime, chrono::duration<double, nano>(chrono::steady_clock::now() - timeBegin).count());
+	}
+
+	return(bestTime / static_cast<double>(std::max<size_t>(spritesTotal, 1)));
+}
+
+// The largest difference of the affine rows from the glm matrices.
+static float getLargestError(const BenchSprites& benchSprites) noexcept
+{
+	float largestError = 0.0f;
+
+	for (size_t spriteIndex = 0; spriteIndex < benchSprites.modelMatrices.size(); ++spriteIndex)
+	{
+		const glm::mat4& modelMatrix = benchSprites.modelMatrices[spriteIndex];
+
+		const float affineRows[6] = {
+			benchSprites.m00[spriteIndex], benchSprites.m01[spriteIndex], benchSprites.m02[spriteIndex],
+			benchSprites.m10[spriteIndex], benchSprites.m11[spriteIndex], benchSprites.m12[spriteIndex] };
+
+		const float matrixRows[6] = {
+			modelMatrix[0][0], modelMatrix[1][0], modelMatrix[3][0],
+			modelMatrix[0][1], modelMatrix[1][1], modelMatrix[3][1] };
+
+		for (int elementIndex = 0; elementIndex < 6; ++elementIndex)
+			largestError = std::max(largestError, std::abs(affineRows[elementIndex] - matrixRows[elementIndex]));
+	}
+
+	return(largestError);
+}
+
+int main(int argc, char* argv[])
+{
+	const size_t   spritesTotal = argc > 1 ? strtoull(argv[1], nullptr, 10) : 100000;
+	const uint32_t runsTotal    = argc > 2 ? static_cast<uint32_t>(strtoul(argv[2], nullptr, 10)) : 50;
+
+	BenchSprites benchSprites(spritesTotal);
+
+	printf("sprites: %zu, runs: %u, vector kernel: %s\n\n", spritesTotal, runsTotal, Engine::GFX::getAffineKernelName());
+	printf("%-8s %12s %9s %12s\n", "path", "ns/sprite", "speedup", "max error");
+
+	const double glmTime = measure(spritesTotal, runsTotal, [&benchSprites]() { buildModelMatrices(benchSprites); });
+
+	printf("%-8s %12.2f %8.2fx %12s\n", "glm", glmTime, 1.0, "-");
+
+	const double scalarTime = measure(spritesTotal, runsTotal, [&benchSprites, spritesTotal]()
+	{
+		Engine::GFX::computeSpriteAffinesScalar(benchSprites.transforms(), benchSprites.affines(), spritesTotal);
+	});
+
+	printf("%-8s %12.2f %8.2fx %12g\n", "scalar", scalarTime, glmTime / scalarTime, getLargestError(benchSprites));
+
+	const double vectorTime = measure(spritesTotal, runsTotal, [&benchSprites, spritesTotal]()
+	{
+		Engine::GFX::computeSpriteAffines(benchSprites.transforms(), benchSprites.affines(), spritesTotal);
+	});
+
+	printf("%-8s %12.2f %8.2fx %12g\n", Engine::GFX::getAffineKernelName(), vectorTime, glmTime / vectorTime, getLargestError(benchSprites));
+
+	return(0);
+}
@@ -1,50 +1,109 @@
 #include "AnimatedSprite.hpp"
 
-#define MIN(x, y) (x) > (y) ? (x) : (y)
-#define MAX(x, y) MIN(y, x)
+using namespace Engine::Animation;
 
 void Engine::GFX::AnimatedSprite::move(vec2 spriteDestination) {
-  auto spritePosition = getSpritePosition();
-  m_TargetDestination = spriteDestination; 
-  m_IsAnimated        = true;
-
-  if(m_TargetDestination.x > spritePosition.x)
-    m_MoveVector.x = -1.0f;
-  else
-    m_MoveVector.x = 1.0f;
-
-  if(m_TargetDestination.y > spritePosition.y)
-    m_MoveVector.y = -1.0f;
-  else
-    m_MoveVector.y = 1.0f;
+  auto& tweenSystem    = TweenSystem::instance();
+  auto  spritePosition = getSpritePosition();
+
+  m_TargetDestination = spriteDestination;
+  tweenSystem.cancel(m_PositionTween);
+
+  // The time that it takes to reach the destination with the
+  // sprite move speed(the slowest axis wins).
+  const vec2 distance = { fabsf(m_TargetDestination.x - spritePosition.x), fabsf(m_TargetDestination.y - spritePosition.y) };
+
+  GLfloat duration = 0.0f;
+
+  if (m_MoveSpeed.x > 0.0f)
+    duration = fmaxf(duration, distance.x / m_MoveSpeed.x);
+  if (m_MoveSpeed.y > 0.0f)
+    duration = fmaxf(duration, distance.y / m_MoveSpeed.y);
+
+  // The sprite is already there(or it cannot move at all).
+  if (duration <= 0.0f)
+  {
+    m_PositionTween = TweenHandle{};
+
+    setSpritePosition(m_TargetDestination);
+    animate();
+
+    return;
+  }
+
+  m_PositionTween = tweenSystem.tweenPosition(spritePosition, m_TargetDestination, duration, m_MoveEasing);
+  m_IsAnimated    = true;
 }
 
-void Engine::GFX::AnimatedSprite::animate(GLfloat elapsedTime) {
-  auto  spritePosition  = getSpritePosition();
-  float spritePositionX = spritePosition.x;
-  float spritePositionY = spritePosition.y;
+void Engine::GFX::AnimatedSprite::rotateTo(GLfloat targetRotation, GLfloat duration, Easing easing) {
+  auto& tweenSystem = TweenSystem::instance();
 
-  const bool finishedX = APPROX(spritePosition.x, m_TargetDestination.x, 2.0f);
-  const bool finishedY = APPROX(spritePosition.y, m_TargetDestination.y, 2.0f);
+  tweenSystem.cancel(m_RotationTween);
 
-  const float deltaX = spritePositionX / m_TargetDestination.x;
-  const float deltaY = spritePositionY / m_TargetDestination.y;
+  m_TargetRotation = targetRotation;
+  m_RotationTween  = tweenSystem.tweenRotation(getSpriteRotation(), targetRotation, duration, easing);
+  m_IsAnimated     = true;
+}
 
-  float stepX = (m_MoveSpeed.x * elapsedTime) * m_MoveVector.x;
-  float stepY = (m_MoveSpeed.y * elapsedTime) * m_MoveVector.y;
+void Engine::GFX::AnimatedSprite::resizeTo(vec2 targetSize, GLfloat duration, Easing easing) {
+  auto& tweenSystem = TweenSystem::instance();
 
-  stepX = stepX;
-  stepY = stepY;
-  
-  if (!finishedX)
-      spritePositionX = spritePosition.x + stepX;
-  if (!finishedY)
-      spritePositionY = spritePosition.y + stepY;
-     
-  if (finishedX && finishedY)
-      m_IsAnimated = false;
+  tweenSystem.cancel(m_ScaleTween);
 
-  setSpritePosition({ spritePositionX, spritePositionY });
+  m_TargetSize = targetSize;
+  m_ScaleTween = tweenSystem.tweenScale(getSpriteSize(), targetSize, duration, easing);
+  m_IsAnimated = true;
 }
 
+void Engine::GFX::AnimatedSprite::tintTo(vec3 targetColor, GLfloat duration, Easing easing) {
+  auto& tweenSystem = TweenSystem::instance();
 
+  tweenSystem.cancel(m_ColorTween);
+
+  m_TargetColor = targetColor;
+  m_ColorTween  = tweenSystem.tweenColor(getSpriteColor(), targetColor, duration, easing);
+  m_IsAnimated  = true;
+}
+
+void Engine::GFX::AnimatedSprite::animate() {
+  const auto& tweenSystem = TweenSystem::instance();
+
+  bool isAnimated = false;
+
+  // Sample the tween of the each channel, once the tween is finished
+  // the sprite attribute snaps to the target value of the channel.
+  auto sampleChannel = [&](TweenHandle& tweenHandle, auto&& applyValue, auto&& applyTarget)
+  {
+    if (!tweenHandle.isValid())
+      return;
+
+    if (const auto value = tweenSystem.sample(tweenHandle); value.has_value())
+    {
+      applyValue(*value);
+      isAnimated = true;
+    }
+    else
+    {
+      applyTarget();
+      tweenHandle = TweenHandle{};
+    }
+  };
+
+  sampleChannel(m_PositionTween,
+    [&](const vec4& value) { setSpritePosition({ value.x, value.y }); },
+    [&]()                  { setSpritePosition(m_TargetDestination);  });
+
+  sampleChannel(m_RotationTween,
+    [&](const vec4& value) { setSpriteRotation(value.x);        },
+    [&]()                  { setSpriteRotation(m_TargetRotation); });
+
+  sampleChannel(m_ScaleTween,
+    [&](const vec4& value) { setSpriteSize({ value.x, value.y }); },
+    [&]()                  { setSpriteSize(m_TargetSize);         });
+
+  sampleChannel(m_ColorTween,
+    [&](const vec4& value) { setSpriteColor({ value.x, value.y, value.z }); },
+    [&]()                  { setSpriteColor(m_TargetColor);                 });
+
+  m_IsAnimated = isAnimated;
+}
@@ -6,6 +6,8 @@
 #include "rendering/SpriteRenderer.hpp"
 #include "rendering/TextureWrapper.hpp"
 
+#include "animation/TweenSystem.hpp"
+
 #include "Sprite.hpp"
 
 using namespace std;
@@ -17,35 +19,58 @@ namespace Engine::GFX
   // This class is a wrapper around a static sprite class.
   //
   // This class purpose is to give the animation ability
-  // to the sprites
+  // to the sprites. The actual interpolation is done by the
+  // ::TweenSystem, the sprite only keeps the handles to its
+  // tweens and samples them.
   class AnimatedSprite: public Sprite
   {
   public:
     AnimatedSprite()
-      : Sprite(), m_MoveSpeed({0.0f, 0.0f}), m_MoveVector({1.0f, 1.0f})
+      : Sprite(), m_IsAnimated(false), m_TargetDestination({0.0f, 0.0f}), m_TargetSize({0.0f, 0.0f}), m_TargetColor({1.0f, 1.0f, 1.0f}),
+        m_TargetRotation(0.0f), m_MoveSpeed({0.0f, 0.0f}), m_MoveEasing(Animation::Easing::Linear)
     {
     }
 
     // Getter and setter for the move speed class attribute.
     #define __gettersettertype glm::vec2
-    makeGetterAndSetter(m_MoveSpeed,  MoveSpeed);
-    makeGetterAndSetter(m_MoveVector, MoveVector);
+    makeGetterAndSetter(m_MoveSpeed, MoveSpeed);
+
+    #define __gettersettertype Animation::Easing
+    makeGetterAndSetter(m_MoveEasing, MoveEasing);
 
     #define __gettersettertype bool
     makeGetter(m_IsAnimated, IsAnimated);
     #undef  __gettersettertype
 
-    // Actually set the move direction to the sprite.
+    // Actually set the move direction to the sprite, the move duration
+    // is derived from the sprite move speed(in pixels per second).
     void move(vec2 spriteDesination);
-    
-    // Perform move step for the sprite
-    void animate(GLfloat elapsedTime);
+
+    // Start the rotation/size/color transitions of the sprite.
+    void rotateTo(GLfloat targetRotation, GLfloat duration, Animation::Easing easing = Animation::Easing::Linear);
+    void resizeTo(vec2    targetSize,     GLfloat duration, Animation::Easing easing = Animation::Easing::Linear);
+    void tintTo  (vec3    targetColor,    GLfloat duration, Animation::Easing easing = Animation::Easing::Linear);
+
+    // Pull the current animation state of the sprite from the tween system.
+    void animate();
 
   protected:
     bool m_IsAnimated;
 
-    vec2 m_TargetDestination;
-    vec2 m_MoveVector;
+    vec2    m_TargetDestination;
+    vec2    m_TargetSize;
+    vec3    m_TargetColor;
+    GLfloat m_TargetRotation;
+
     vec2 m_MoveSpeed;
+
+    Animation::Easing m_MoveEasing;
+
+    Animation::TweenHandle m_PositionTween;
+    Animation::TweenHandle m_RotationTween;
+    Animation::TweenHandle m_ScaleTween;
+    Animation::TweenHandle m_ColorTween;
   };
+
+  static_assert(is_trivially_copyable_v<AnimatedSprite>, "The animated sprite must be trivially copyable");
 }
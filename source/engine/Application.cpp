@@ -3,8 +3,22 @@
 // The `Application` class is the core class of the engine API, and the only
 // data structure that can be seen and used by the endpoint graphics API user.
 #include "Application.hpp"
+#include "DynamicResolution.hpp"
+#include "FrameArena.hpp"
+#include "GpuProfiler.hpp"
+#include "HeadlessRunner.hpp"
+#include "JobSystem.hpp"
+#include "LatencyTracker.hpp"
 #include "Logger.hpp"
+#include "Metrics.hpp"
+#include "MetricsServer.hpp"
+#include "Profiler.hpp"
 #include "Sprite.hpp"
+#include "TraceLog.hpp"
+#include "WarmStartCache.hpp"
+
+#include "animation/TweenSystem.hpp"
+#include "rendering/RenderDevice.hpp"
 
 // Apple does not support modern OpenGL.
 #ifdef __APPLE__
@@ -27,17 +41,78 @@ static constexpr const char* _SPRITESHADER_FRAG_RELPATH = "shaders/engine_sprite
 
 static constexpr const char* _IMGUI_DEFAULT_FONT_RELPATH = "data/fonts/roboto_regular.ttf";
 
+// The binary trace log of the session(decoded by the `log-decode` tool).
+static constexpr const char* _TRACE_LOG_RELPATH = "logs/trace.etrc";
+
+// The metrics snapshot is appended to the file every N seconds.
+static constexpr const char*  _METRICS_DUMP_RELPATH = "logs/metrics.csv";
+static constexpr const double _METRICS_DUMP_PERIOD  = 10.0;
+
+// The environment variable with the localhost port of the Prometheus metrics endpoint.
+static constexpr const char* _METRICS_PORT_VARIABLE = "ENGINE_METRICS_PORT";
+
+// The environment variable with the render device backend(gl, null, record, record-null), and
+// the file the recording backends write the command stream to(replayed by the `render-replay` tool).
+static constexpr const char* _RENDER_DEVICE_VARIABLE  = "ENGINE_RENDER_DEVICE";
+static constexpr const char* _RENDER_COMMANDS_RELPATH = "logs/render_commands.rcmd";
+
+// The environment variable with the texture memory budget(megabytes), the least recently used
+// textures over it are evicted and loaded again when they are drawn.
+static constexpr const char* _TEXTURE_BUDGET_VARIABLE = "ENGINE_TEXTURE_BUDGET_MB";
+
+// The environment variables with the GPU frame time the dynamic resolution keeps the frame in
+// (milliseconds, the refresh period of the monitor by default), and the smallest scale of the
+// scene resolution(one disables the dynamic resolution).
+static constexpr const char* _TARGET_FRAME_TIME_VARIABLE = "ENGINE_TARGET_FRAME_MS";
+static constexpr const char* _RENDER_SCALE_MIN_VARIABLE  = "ENGINE_RENDER_SCALE_MIN";
+
+// The directory of the warm start cache(the linked shader programs).
+static constexpr const char* _WARM_START_CACHE_RELPATH = "cache";
+
+// The size of the ImGui font(points, before the HighDPI scaling).
+static constexpr const float _IMGUI_DEFAULT_FONT_SIZE = 23.0f;
+
 using namespace std;
+using Engine::operator""_sid;
 
 namespace One
 {
 	Engine::Error Application::initializeGameEngine(void) noexcept
 	{
+		m_StartupTimestamp = Engine::InputQueue::timestamp();
+
 		Engine::Logger::initialize();
 
 		Engine::Logger::m_ApplicationLogger -> info("Engine started\n\n");
 		Engine::Logger::m_GraphicsLogger    -> info("Graphics logger started");
 
+		// Start the worker threads before anything is able to schedule the jobs.
+		if (!FunctionSuccessA(Engine::JobSystem::instance().initialize()))
+		{
+			Engine::Logger::m_ApplicationLogger->error("Unable to start the job system");
+
+			return(Engine::Error::InitializationError);
+		}
+
+		// The engine is able to run without the trace log, the error is already logged.
+		Engine::TraceLog::instance().open(_TRACE_LOG_RELPATH);
+
+		Engine::MetricsRegistry::instance().startDump(_METRICS_DUMP_RELPATH, _METRICS_DUMP_PERIOD);
+
+		// The metrics endpoint is only served when it is asked for(the kiosk machines).
+		if (const char* metricsPort = getenv(_METRICS_PORT_VARIABLE); metricsPort != nullptr)
+		{
+			const int portNumber = atoi(metricsPort);
+
+			if (portNumber > 0 && portNumber <= UINT16_MAX)
+				Engine::MetricsServer::instance().start(static_cast<uint16_t>(portNumber));
+			else
+				Engine::Logger::m_ApplicationLogger->warn("{}={} is not a valid port", _METRICS_PORT_VARIABLE, metricsPort);
+		}
+
+		// The headless mode needs no display server.
+		Engine::HeadlessRunner::instance().initializePlatform();
+
 		// Try to initialize the GLFW platform layer.
 		if (glfwInit() != GLFW_TRUE)
 		{
@@ -45,7 +120,7 @@ namespace One
 
 			return(Engine::Error::ValidationError);
 		}
-		Engine::Logger::m_ApplicationLogger->debug("GLFW library has been initialized");
+		ENGINE_LOG_DEBUG(m_ApplicationLogger, "GLFW library has been initialized");
 		
 		// Set the OpenGL context and profile versions.
 		glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, _GLFW_CONTEXT_VERSION_MAJOR);
@@ -57,6 +132,13 @@ namespace One
 		glfwWindowHint(GLFW_DEPTH_BITS,   24);
 		glfwWindowHint(GLFW_STENCIL_BITS, 8);
 
+		// The MSAA is off by default(the card edges are anti-aliased by the sprite shader), the
+		// headless render target is multisampled by the ::HeadlessRunner itself.
+		const int multisampleCount = Engine::HeadlessRunner::instance().getSettings().samples;
+
+		if (multisampleCount > 1 && !Engine::HeadlessRunner::instance().isEnabled())
+			glfwWindowHint(GLFW_SAMPLES, multisampleCount);
+
 		// Set the window non-resizable
 		glfwWindowHint(GLFW_RESIZABLE, false);
 
@@ -69,20 +151,24 @@ namespace One
 
 		if (FunctionSuccess(windowInstance.make))
 		{
-			Engine::Logger::m_ApplicationLogger->debug("Binding GLFW context");
+			ENGINE_LOG_DEBUG(m_ApplicationLogger, "Binding GLFW context");
 			
 			// Bind the context of the window, so all OpenGL functions are gonna affect this window instance
 			glfwMakeContextCurrent(Engine::Window::instance().getWindowPointerKHR());
 			
-			// Set the callback on the mouse move action and press action.
-			glfwSetInputMode          (Engine::Window::instance().getWindowPointerKHR(), GLFW_STICKY_MOUSE_BUTTONS, GLFW_TRUE);
+			// Let the static callbacks find this application instance.
+			glfwSetWindowUserPointer(Engine::Window::instance().getWindowPointerKHR(), this);
+
+			// Set the callback on the mouse move action, press action and keyboard action(it has
+			// to happen before the ImGui initialization, so ImGui chains these callbacks).
 			glfwSetCursorPosCallback  (Engine::Window::instance().getWindowPointerKHR(), Application::setCursorPosCallback);
+			glfwSetMouseButtonCallback(Engine::Window::instance().getWindowPointerKHR(), Application::setMouseButtonCallback);
+			glfwSetKeyCallback        (Engine::Window::instance().getWindowPointerKHR(), Application::setKeyCallback);
 		} else
 		{
 			Engine::Logger::m_ApplicationLogger->error("Encountered error on window creation");
-			
-			glfwTerminate();
 
+			// The GLFW is terminated by the ::destroyGameEngine.
 			return(Engine::Error::ValidationError);
 		}
 
@@ -91,11 +177,49 @@ namespace One
 		{
 			Engine::Logger::m_ApplicationLogger->error("Unable to initialize GLAD(load function returned FALSE)");
 
-			glfwTerminate();
-
 			return(Engine::Error::ValidationError);
 		}
-		Engine::Logger::m_ApplicationLogger->debug("GLAD has been initialized");
+		ENGINE_LOG_DEBUG(m_ApplicationLogger, "GLAD has been initialized");
+
+		// Create the offscreen render target, everything below is drawn into it.
+		if (Engine::HeadlessRunner::instance().isEnabled() && !FunctionSuccess(Engine::HeadlessRunner::instance().initialize))
+		{
+			Engine::Logger::m_ApplicationLogger->error("Unable to initialize the headless mode");
+
+			// The render target is released with the context by the ::destroyGameEngine.
+			return(Engine::Error::InitializationError);
+		}
+
+		// Select the render device before any GPU resource is created(the OpenGL one stays when
+		// the variable is not set or the device can't be created).
+		Engine::GFX::RenderDeviceType renderDeviceType = Engine::GFX::RenderDeviceType::OpenGL;
+
+		if (const char* deviceName = getenv(_RENDER_DEVICE_VARIABLE); deviceName != nullptr)
+		{
+			Engine::GFX::RenderDeviceType deviceType;
+
+			if (!Engine::GFX::RenderDevice::parseType(deviceName, deviceType))
+				Engine::Logger::m_ApplicationLogger->warn("{}={} is not a valid render device", _RENDER_DEVICE_VARIABLE, deviceName);
+			else if (FunctionSuccessA(Engine::GFX::RenderDevice::select(deviceType, _RENDER_COMMANDS_RELPATH)))
+			{
+				Engine::Logger::m_ApplicationLogger->info("Using the {} render device", deviceName);
+
+				renderDeviceType = deviceType;
+			}
+		}
+
+		// The engine starts cold without the cache, the error is already logged.
+		Engine::WarmStartCache::instance().initialize(_WARM_START_CACHE_RELPATH);
+
+		if (const char* textureBudget = getenv(_TEXTURE_BUDGET_VARIABLE); textureBudget != nullptr)
+		{
+			const long long budgetMegabytes = atoll(textureBudget);
+
+			if (budgetMegabytes > 0)
+				Engine::ResourceManager::setTextureBudget(static_cast<size_t>(budgetMegabytes) * 1024 * 1024);
+			else
+				Engine::Logger::m_ApplicationLogger->warn("{}={} is not a valid texture budget", _TEXTURE_BUDGET_VARIABLE, textureBudget);
+		}
 
 		// Workaround with HighDPI scaling. 
 		m_monitorHighDPIScaleFactor = 1.0f;
@@ -141,7 +265,9 @@ namespace One
 
 		// Initialize the ImGui IO and load the fancy Google font.
 		ImGuiIO& imguiIO = ImGui::GetIO();
-		imguiIO.Fonts->AddFontFromFileTTF(_IMGUI_DEFAULT_FONT_RELPATH, 23.0f * m_monitorHighDPIScaleFactor, NULL, NULL);
+
+		// The glyphs are rasterized on demand by ImGui(1.92+), there is no atlas to bake at startup.
+		imguiIO.Fonts->AddFontFromFileTTF(_IMGUI_DEFAULT_FONT_RELPATH, _IMGUI_DEFAULT_FONT_SIZE * m_monitorHighDPIScaleFactor, NULL, NULL);
 
 		// pass the DPI scaling to the ImGUI renderer.
 		applyImGuiStyles();
@@ -151,59 +277,82 @@ namespace One
 
 		const auto windowDimensions = windowInstance.getWindowDimensionsKHR();
 		// Set the render area(viewport) where we want to render the object.
-		glViewport(0, 0, windowDimensions.x, windowDimensions.y);
+		auto& renderDevice = Engine::GFX::RenderDevice::instance();
+		renderDevice.setViewport(0, 0, windowDimensions.x, windowDimensions.y);
 		
 		// Enable the blending stage in the OpenGL rendering pipeline, to make objects appear
 		// transparent on the screen.
-		glEnable   (GL_BLEND);
-		glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+		renderDevice.setCapability   (GL_BLEND, true);
+		renderDevice.setBlendFunction(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+
+		// The rasterization uses the samples only when the render target has them.
+		renderDevice.setCapability(GL_MULTISAMPLE, multisampleCount > 1);
 
-		// Load the shaders, that are used for rendering Sprites on the screen.
+		// Load the shaders, that are used for rendering Sprites on the screen(the variants of the
+		// effects are compiled when they are drawn for the first time).
 		Engine::Logger::m_ApplicationLogger->info("Loading shaders");
-		Engine::ResourceManager::loadShader(_SPRITESHADER_VERT_RELPATH, _SPRITESHADER_FRAG_RELPATH, nullptr, "spriteShader");
+		auto shaderWrapperOrError = Engine::ResourceManager::loadShaderVariants(_SPRITESHADER_VERT_RELPATH, _SPRITESHADER_FRAG_RELPATH, nullptr, "spriteShader", Engine::GFX::SpriteRenderer::getShaderVariantDefines());
 
-		// Try to get the shaders from the global shader/texture storage, if the get request fails
-		// exit the program.
-		auto shaderWrapperOrError = Engine::ResourceManager::getShader("spriteShader");
-		
-		// Check the return value of the function.
-		if (shaderWrapperOrError.has_value())
-		{
-			(*shaderWrapperOrError).useShader();
-
-			// Setup the projection matrix for the current shader.
-			auto projectionMatrix = glm::ortho(
-				0.0f, 
-				static_cast<GLfloat>(windowDimensions.x),
-				static_cast<GLfloat>(windowDimensions.y),
-				0.0f,
-				-1.0f,
-				1.0f
-			);
-			
-			// Set this matrix as a uniform value for the shader.
-			(*shaderWrapperOrError).useShader().setInteger("image", 0);
-			(*shaderWrapperOrError).setMatrix4("projectionMatrix", projectionMatrix);
-		}
-		else 
+		// Check the return value of the function, if the shader failed to load exit the program.
+		if (!shaderWrapperOrError.has_value())
 		{
 			Engine::Logger::m_ApplicationLogger->error("Program failed due to an shader loading error");
 
-			// Or safely quit the program.
-			auto windowPointerKHR = Engine::Window::instance().getWindowPointerKHR();
-
-			if(windowPointerKHR) 
-				glfwDestroyWindow(windowPointerKHR);
-
-			glfwTerminate();
-		
+			// The ImGui bindings are still using the window, so it is destroyed(with the rest of
+			// the engine, in the right order) by the ::destroyGameEngine.
 			return(Engine::Error::ValidationError);
 		}
 		
+		// Start following the input events through the frame pipeline.
+		Engine::LatencyTracker::instance().initialize();
+
 		Engine::Logger::m_ApplicationLogger->info("Creating sprite renderer");
 
 		// Allocate and initialize the class that is used to render Sprites on the screen.
-		m_SpriteRenderer = shared_ptr<Engine::GFX::SpriteRenderer>(new Engine::GFX::SpriteRenderer(*shaderWrapperOrError));
+		m_SpriteRenderer = shared_ptr<Engine::GFX::SpriteRenderer>(new Engine::GFX::SpriteRenderer("spriteShader"_sid));
+
+		// Setup the projection matrix for the sprite shader(it is passed to every variant).
+		auto projectionMatrix = glm::ortho(
+			0.0f, 
+			static_cast<GLfloat>(windowDimensions.x),
+			static_cast<GLfloat>(windowDimensions.y),
+			0.0f,
+			-1.0f,
+			1.0f
+		);
+
+		m_SpriteRenderer->setProjectionMatrix(projectionMatrix);
+
+		// The scene is rendered with the lower resolution when the GPU does not keep up with the
+		// monitor. The headless frames must be the same on every run, and the other devices are
+		// not drawing(or recording) the render targets, so the resolution is native there(and
+		// wherever the application measures the rendering itself).
+		if (m_IsDynamicResolutionAllowed && !Engine::HeadlessRunner::instance().isEnabled() && renderDeviceType == Engine::GFX::RenderDeviceType::OpenGL)
+		{
+			Engine::DynamicResolutionSettings resolutionSettings;
+
+			if (const GLFWvidmode* videoMode = glfwGetVideoMode(glfwGetPrimaryMonitor()); videoMode != nullptr && videoMode->refreshRate > 0)
+				resolutionSettings.targetFrameTime = 1000.0 / videoMode->refreshRate;
+
+			if (const char* targetFrameTime = getenv(_TARGET_FRAME_TIME_VARIABLE); targetFrameTime != nullptr)
+			{
+				if (atof(targetFrameTime) > 0.0)
+					resolutionSettings.targetFrameTime = atof(targetFrameTime);
+				else
+					Engine::Logger::m_ApplicationLogger->warn("{}={} is not a valid frame time", _TARGET_FRAME_TIME_VARIABLE, targetFrameTime);
+			}
+
+			if (const char* minScale = getenv(_RENDER_SCALE_MIN_VARIABLE); minScale != nullptr)
+			{
+				if (atof(minScale) > 0.0 && atof(minScale) <= 1.0)
+					resolutionSettings.minScale = static_cast<float>(atof(minScale));
+				else
+					Engine::Logger::m_ApplicationLogger->warn("{}={} is not a valid render scale", _RENDER_SCALE_MIN_VARIABLE, minScale);
+			}
+
+			// The native resolution is used when it fails, the error is already logged.
+			Engine::DynamicResolution::instance().initialize(windowDimensions, resolutionSettings);
+		}
  
 		Engine::Logger::m_ApplicationLogger->info("Application is initialized");
 
@@ -217,48 +366,179 @@ namespace One
 		auto& windowInstance = Engine::Window::instance();
 		auto  windowPointer  = windowInstance.getWindowPointerKHR();
 
-		// Catch and process keyboard input from the user.
-		processInput(windowPointer);
-
-		// Process events and trigger theirs binded callbacks
+		// Process events and trigger theirs binded callbacks(the input events are queued
+		// and consumed at the start of the next update).
 		glfwPollEvents();
 
-		// Render ImGui elements.
-		ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
+		auto& gpuProfiler = Engine::GpuProfiler::instance();
+
+		// The scene is upscaled to the native resolution before the ImGui is drawn on top of it.
+		Engine::DynamicResolution::instance().endScene();
+
+		// Render ImGui elements(every command of the draw lists is the draw call).
+		gpuProfiler.beginPass(Engine::GpuPass::ImGui);
+
+		ImDrawData* imguiDrawData = ImGui::GetDrawData();
+		ImGui_ImplOpenGL3_RenderDrawData(imguiDrawData);
+
+		if (imguiDrawData != nullptr)
+		{
+			for (int drawListIndex = 0; drawListIndex < imguiDrawData->CmdListsCount; ++drawListIndex)
+				gpuProfiler.countDrawCalls(static_cast<uint32_t>(imguiDrawData->CmdLists[drawListIndex]->CmdBuffer.Size));
+		}
+
+		gpuProfiler.endFrame();
+
+		// Close the frame of the recorded command stream.
+		Engine::GFX::RenderDevice::instance().endFrame();
+
+		auto& latencyTracker = Engine::LatencyTracker::instance();
+		latencyTracker.markSubmitEnd();
+
+		// The headless frame stays in the render target(there is nothing to present).
+		if (Engine::HeadlessRunner::instance().isEnabled())
+			Engine::HeadlessRunner::instance().endFrame();
+		else
+			glfwSwapBuffers(windowPointer);
+
+		latencyTracker.markSwapEnd();
+
+		// Report the time from the start to the first presented frame(the warm start cache
+		// shortens it on the later launches).
+		if (m_StartupTimestamp != 0)
+		{
+			const double startupSeconds = static_cast<double>(Engine::InputQueue::timestamp() - m_StartupTimestamp) * 1e-9;
+
+			Engine::MetricsRegistry::instance().gauge("engine_startup_seconds", "The time from the engine start to the first presented frame").set(startupSeconds);
+			Engine::Logger::m_ApplicationLogger->info("The first frame was presented in {:.3f} s", startupSeconds);
 
-		// Swap the front and back buffers of the current window.
-		glfwSwapBuffers(windowPointer);
+			m_StartupTimestamp = 0;
+		}
 
 		return(Engine::Error::Ok);
 	}
 
-	void One::Application::processInput(GLFWwindow* windowPointer) noexcept
-	{		
-		// Handle the exit key binding
-		if (glfwGetKey(windowPointer, GLFW_KEY_ESCAPE) == GLFW_PRESS)
-			m_escapeButtonPressed = true;
-		else
-			m_escapeButtonPressed = false;
+	void One::Application::processInput() noexcept
+	{
+		// The smoothing factor of the average latency.
+		constexpr double averageLatencyWeight = 0.05;
 
-		if (glfwGetMouseButton(windowPointer, GLFW_MOUSE_BUTTON_LEFT) == GLFW_PRESS)
-			m_mouseButtonPressed = true;
-		else
-			m_mouseButtonPressed = false;
+		const uint64_t   consumeTimestamp = Engine::InputQueue::timestamp();
+		Engine::InputEvent inputEvent;
+
+		m_InputEvents.clear();
+		m_FrameInputTimestamp = 0;
+
+		while (m_InputQueue.pop(inputEvent))
+		{
+			// Track the time that the event spent in the queue.
+			const double eventLatency = static_cast<double>(consumeTimestamp - inputEvent.timestamp) * 1e-9;
+
+			m_InputLatencyStats.eventsConsumed++;
+			m_InputLatencyStats.lastLatency    = eventLatency;
+			m_InputLatencyStats.maxLatency     = std::max(m_InputLatencyStats.maxLatency, eventLatency);
+			m_InputLatencyStats.averageLatency = m_InputLatencyStats.eventsConsumed == 1 
+				? eventLatency 
+				: m_InputLatencyStats.averageLatency + (eventLatency - m_InputLatencyStats.averageLatency) * averageLatencyWeight;
+
+			// The events are queued in order, so the first one is the oldest.
+			if (m_FrameInputTimestamp == 0)
+				m_FrameInputTimestamp = inputEvent.timestamp;
+
+			ENGINE_TRACE("Input event {} code {} at ({:.1f}, {:.1f}), latency {:.3f} ms",
+				inputEvent.eventType, inputEvent.eventCode, inputEvent.positionX, inputEvent.positionY, eventLatency * 1e3);
+
+			// Update the held state of the buttons.
+			switch (inputEvent.eventType)
+			{
+				case Engine::InputEventType::CursorMove:
+				{
+					onMouseMove(inputEvent.positionX, inputEvent.positionY);
+				} break;
+
+				case Engine::InputEventType::MouseButtonPress:
+				case Engine::InputEventType::MouseButtonRelease:
+				{
+					if (inputEvent.eventCode == GLFW_MOUSE_BUTTON_LEFT)
+						m_mouseButtonPressed = inputEvent.eventType == Engine::InputEventType::MouseButtonPress;
+				} break;
+
+				case Engine::InputEventType::KeyPress:
+				case Engine::InputEventType::KeyRelease:
+				{
+					if (inputEvent.eventCode == GLFW_KEY_ESCAPE)
+						m_escapeButtonPressed = inputEvent.eventType == Engine::InputEventType::KeyPress;
+				} break;
+			}
+
+			m_InputEvents.push_back(inputEvent);
+		}
+	}
+
+	bool One::Application::wasKeyPressed(int key) const noexcept
+	{
+		for (const auto& inputEvent : m_InputEvents)
+			if (inputEvent.eventType == Engine::InputEventType::KeyPress && inputEvent.eventCode == key)
+				return(true);
+
+		return(false);
+	}
+
+	bool One::Application::wasMouseButtonPressed(int button) const noexcept
+	{
+		for (const auto& inputEvent : m_InputEvents)
+			if (inputEvent.eventType == Engine::InputEventType::MouseButtonPress && inputEvent.eventCode == button)
+				return(true);
+
+		return(false);
 	}
 
 	Engine::Error One::Application::destroyGameEngine(void) noexcept
 	{
+		// Finish the jobs that are still running(they may be touching the resources).
+		Engine::JobSystem::instance().release();
+
+		// No thread is tracing anymore, so the partial chunks can be written out.
+		Engine::TraceLog::instance().close();
+
+		Engine::MetricsServer::instance().stop();
+		Engine::MetricsRegistry::instance().stopDump();
+
+		// Save the latency statistics of the session and release the GL queries.
+		auto& latencyTracker = Engine::LatencyTracker::instance();
+		latencyTracker.dumpReport();
+		latencyTracker.release();
+
+		Engine::GpuProfiler::instance().release();
+		Engine::DynamicResolution::instance().release();
+
+		// Write the frame times of the headless run.
+		Engine::HeadlessRunner::instance().release();
+
 		// Free all the resources that was allocated during the program execution
 		Engine::ResourceManager::release();
 
-		// Exit ImGui Library.
-		ImGui_ImplOpenGL3_Shutdown();
-		ImGui_ImplGlfw_Shutdown();
-		ImGui::DestroyContext();
+		// Close the command stream of the recording render device.
+		Engine::GFX::RenderDevice::release();
+
+		// Exit ImGui Library(the initialization may have failed before or in the middle of it).
+		if (ImGui::GetCurrentContext() != nullptr)
+		{
+			if (ImGui::GetIO().BackendRendererUserData != nullptr)
+				ImGui_ImplOpenGL3_Shutdown();
+
+			if (ImGui::GetIO().BackendPlatformUserData != nullptr)
+				ImGui_ImplGlfw_Shutdown();
+
+			ImGui::DestroyContext();
+		}
 
 		// Exit GLFW library
 		glfwTerminate();
 
+		// Write out the queued messages, nothing is logged after this point.
+		Engine::Logger::release();
+
 		return(Engine::Error::Ok);
 	}
 
@@ -294,7 +574,15 @@ namespace One
 				return(Engine::Error::ValidationError);
 			}
 		}
+		else
+		{
+			// There is no window to run the loop in(the headless run reports the failure too).
+			Engine::Logger::m_ApplicationLogger->error("Unable to initialize the game engine");
 
+			destroyGameEngine();
+
+			return(Engine::Error::InitializationError);
+		}
 
 		// Get the reference to the window instance, and GLFW window instance pointer, so
 		// not to call the singleton ::instance() function every loop iteration.
@@ -303,21 +591,69 @@ namespace One
 
 		Engine::Logger::m_GameLogger->error("Starting game loop");
 
+		auto&      headlessRunner = Engine::HeadlessRunner::instance();
+		const bool isHeadless     = headlessRunner.isEnabled();
+
 		// Continue the program execution until the user presses the quit button on the window
-		// (in his window manager), or press the quit hotkey.
-        double lastTimeStamp    = glfwGetTime();
+		// (in his window manager), or press the quit hotkey(or the headless run is over).
+        double lastTimeStamp    = isHeadless ? -headlessRunner.getSettings().frameStep : glfwGetTime();
         double currentTimeStamp = lastTimeStamp;
 
-		while (!glfwWindowShouldClose(windowPointer))
+		ENGINE_PROFILE_THREAD("Main Thread");
+
+		auto& frameTimeMetric = Engine::MetricsRegistry::instance().histogram("engine_frame_seconds", "The time between the frames");
+		auto& framesMetric    = Engine::MetricsRegistry::instance().counter  ("engine_frames_total",  "The rendered frames");
+
+		while (!glfwWindowShouldClose(windowPointer) && !(isHeadless && headlessRunner.isFinished()))
 		{
+			// Start(or finish) the profiler capture on the frame boundary.
+			Engine::Profiler::instance().beginFrame();
+
+			ENGINE_PROFILE_SCOPE("Application::execute");
+
+			// The headless time advances with the fixed step, so every run renders the same
+			// frames(the clock is set, so the glfwGetTime users are seeing the same time).
+			if (isHeadless)
+			{
+				glfwSetTime(headlessRunner.getFrameTime());
+
+				// Replay the scripted input, the events are queued by the callbacks.
+				headlessRunner.beginFrame(windowPointer);
+			}
+
             // Get elapsed time.
             currentTimeStamp = glfwGetTime();
-            m_elapsedTime    = lastTimeStamp - currentTimeStamp;
+            m_elapsedTime    = currentTimeStamp - lastTimeStamp;
             lastTimeStamp    = currentTimeStamp;
 
+			// Consume the input events that were received since the previous update.
+			processInput();
+
+			Engine::LatencyTracker::instance().beginFrame(m_FrameInputTimestamp);
+			Engine::GpuProfiler::instance().beginFrame();
+
+			// Evict the textures that are over the budget before anything is drawn.
+			Engine::ResourceManager::beginFrame();
+
+			// Run the OpenGL work that was scheduled by the jobs.
+			Engine::JobSystem::instance().pumpMainThread();
+
+			// Advance all the running tweens at once, before the user code samples them.
+			Engine::Animation::TweenSystem::instance().update(currentTimeStamp);
+
+			// Render the scene with the resolution the GPU keeps up with(the ImGui stays native).
+			Engine::DynamicResolution::instance().beginScene();
+
+			// The screen is not cleared(the background covers it), but the heat of the overdraw
+			// view is summed up from black.
+			if (m_SpriteRenderer->isOverdrawView())
+				Engine::GFX::RenderDevice::instance().clear({ 0.0f, 0.0f, 0.0f, 1.0f });
+
 			// Try initialize update.
 			const Engine::Error userUpdateResult = onUserUpdate(m_elapsedTime);
 
+			Engine::LatencyTracker::instance().markUpdateEnd();
+
 			// If the functions encountered an error break the program and report an error.
 			if(ValidationError(userUpdateResult) || InitializationError(userUpdateResult))
 			{
@@ -328,6 +664,14 @@ namespace One
 
 			// Update the actual engine.
 			updateGameEngine();
+
+			// All the transient data of the frame is gone.
+			Engine::FrameArena::instance().reset();
+
+			frameTimeMetric.record(static_cast<uint64_t>(m_elapsedTime * 1e9));
+			framesMetric   .increment();
+
+			Engine::MetricsRegistry::instance().update();
 		}
 
 		Engine::Logger::m_GameLogger->info("Executing onUserDestroy()");
@@ -7,6 +7,7 @@
 #include "_EngineIncludes.hpp"
 
 #include "Window.hpp"
+#include "InputQueue.hpp"
 #include "ResourseManager.hpp"
 
 #include "rendering/SpriteRenderer.hpp"
@@ -40,23 +41,45 @@ namespace One
 			return(_instance);
 		}
 
-		// The formal(by the parameters) callback that is used for the GLFW window callbacks.
-		// This function(static formal function, that is calling an internal function) is kinda
+		// The formal(by the parameters) callbacks that are used for the GLFW window callbacks.
+		// This functions(static formal functions, that are calling an internal function) are kinda
 		// workaround about the C background of the GLFW library.
+		//
+		// The callbacks only timestamp the event and push it into the input queue, the events
+		// are consumed at the start of the next update.
 	    static void setCursorPosCallback(GLFWwindow* window, double positionX, double positionY)
 	    {
-		  UnreferencedParameter(window);
-
-		  // Call the internal callback function(that has access to the class members).
-		  instance().onMouseMove(positionX, positionY);
+		  fromWindow(window).m_InputQueue.push({ Engine::InputEventType::CursorMove, 0, 0, positionX, positionY, Engine::InputQueue::timestamp() });
 	    }
 
+		static void setMouseButtonCallback(GLFWwindow* window, int button, int action, int modifiers)
+		{
+		  const auto eventType = (action == GLFW_PRESS) ? Engine::InputEventType::MouseButtonPress : Engine::InputEventType::MouseButtonRelease;
+
+		  double positionX, positionY;
+		  glfwGetCursorPos(window, &positionX, &positionY);
+
+		  fromWindow(window).m_InputQueue.push({ eventType, button, modifiers, positionX, positionY, Engine::InputQueue::timestamp() });
+		}
+
+		static void setKeyCallback(GLFWwindow* window, int key, int scancode, int action, int modifiers)
+		{
+		  UnreferencedParameter(scancode);
+
+		  // Key repeats are not the edges, skip them.
+		  if (action == GLFW_REPEAT)
+			  return;
+
+		  const auto eventType = (action == GLFW_PRESS) ? Engine::InputEventType::KeyPress : Engine::InputEventType::KeyRelease;
+
+		  fromWindow(window).m_InputQueue.push({ eventType, key, modifiers, 0.0, 0.0, Engine::InputQueue::timestamp() });
+		}
+
 	public:
 		// Clear the screen with solid color.
 		inline void ClearScreen(GLfloat r, GLfloat g, GLfloat b)
 		{
-			glClearColor(r, g, b, 1.0f);
-			glClear     (GL_COLOR_BUFFER_BIT);
+			Engine::GFX::RenderDevice::instance().clear({ r, g, b, 1.0f });
 		}
 
 		// Create new frame in the ImGUI library, with the OpenGL and GLFW bindings.
@@ -78,6 +101,23 @@ namespace One
 			return(Engine::Window::instance().getWindowDimensionsKHR());
 		}
 
+		// Get the input events that were consumed at the start of the current update.
+		inline const std::vector<Engine::InputEvent>& getInputEvents() const
+		{
+			return(m_InputEvents);
+		}
+
+		// Get the statistics of the time between the input event and its consumption.
+		inline const Engine::InputLatencyStats& getInputLatencyStats() const
+		{
+			return(m_InputLatencyStats);
+		}
+
+		// Find out if the key/mouse button went down since the previous update(the press
+		// is reported even if the button was already released again).
+		bool wasKeyPressed(int key) const noexcept;
+		bool wasMouseButtonPressed(int button) const noexcept;
+
 		// Here starts the interfaces, that endpoint user must override.
 		// It is the bridge between the engine itself and the user.
 		//
@@ -108,20 +148,43 @@ namespace One
 		Engine::Error updateGameEngine(void) noexcept;
 
 	private:
+		// Get the application that owns the GLFW window.
+		static Application& fromWindow(GLFWwindow* window)
+		{
+			auto applicationPointer = static_cast<Application*>(glfwGetWindowUserPointer(window));
+
+			return(applicationPointer != nullptr ? *applicationPointer : instance());
+		}
+
 		// Stylish the Dear ImGUI
 		void applyImGuiStyles();
 
-		// Gather the input from the keyboard.
-		void processInput(GLFWwindow* windowPointer) noexcept;
+		// Drain the input queue, update the input state and the latency statistics.
+		void processInput() noexcept;
 
 	protected:
 		GLfloat m_monitorHighDPIScaleFactor;
 
+		// The current(held) state of the buttons.
 		bool   m_mouseButtonPressed  = false;
 		bool   m_escapeButtonPressed = false;
 
-        double m_mousePositionX;
-        double m_mousePositionY;
+		Engine::InputQueue             m_InputQueue;
+		std::vector<Engine::InputEvent> m_InputEvents;
+		Engine::InputLatencyStats      m_InputLatencyStats;
+
+		// The timestamp of the oldest input event consumed by the current frame(zero if none).
+		uint64_t m_FrameInputTimestamp = 0;
+
+		// The timestamp of the engine start(zero once the first frame is presented).
+		uint64_t m_StartupTimestamp = 0;
+
+		// The scene resolution may follow the GPU frame time(the benchmarks are measuring the
+		// native resolution, so their numbers can be compared between the runs).
+		bool m_IsDynamicResolutionAllowed = true;
+
+        double m_mousePositionX = 0.0;
+        double m_mousePositionY = 0.0;
 
         double m_elapsedTime;
 
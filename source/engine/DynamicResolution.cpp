@@ -0,0 +1,229 @@
+// This file implements the `DynamicResolution` class.
+#include "DynamicResolution.hpp"
+#include "GpuProfiler.hpp"
+#include "Logger.hpp"
+#include "Metrics.hpp"
+#include "ResourseManager.hpp"
+
+#include "rendering/RenderDevice.hpp"
+
+#include "algorithm"
+#include "cmath"
+
+using namespace std;
+
+// The upscale shader(the triangle that covers the screen and the sharpening filter).
+static constexpr const char* _UPSCALE_SHADER_VERT_RELPATH = "shaders/engine_upscale_shader.vert";
+static constexpr const char* _UPSCALE_SHADER_FRAG_RELPATH = "shaders/engine_upscale_shader.frag";
+
+// The strength of the sharpening(zero is the plain bilinear upscale).
+static constexpr const GLfloat _UPSCALE_SHARPNESS = 0.5f;
+
+// The scale changes by the steps, and not again until the GPU time of the new scale is
+// averaged over this many frames(the averages are reset on the change, so the frames that
+// are still in flight with the previous scale are not counted).
+static constexpr const float    _RESOLUTION_SCALE_STEP    = 0.05f;
+static constexpr const uint64_t _RESOLUTION_SETTLE_FRAMES = 30;
+
+// The part of the target frame time the new scale is chosen to take. The larger scale is chosen
+// only when it is expected to fit into it, so the measurement noise does not flip the scale.
+static constexpr const double _RESOLUTION_FRAME_TIME_MARGIN = 0.85;
+
+// The scale of the scene resolution that is used now.
+static Engine::Gauge& renderScaleMetric()
+{
+	static auto& _metric = Engine::MetricsRegistry::instance().gauge("engine_render_scale", "The scale of the scene resolution(one is the native resolution)");
+	return(_metric);
+}
+
+namespace Engine
+{
+	Error DynamicResolution::initialize(glm::ivec2 nativeDimensions, const DynamicResolutionSettings& resolutionSettings) noexcept
+	{
+		m_Settings          = resolutionSettings;
+		m_Settings.minScale = std::clamp(m_Settings.minScale, _RESOLUTION_SCALE_STEP, 1.0f);
+		m_NativeDimensions  = nativeDimensions;
+		m_Scale             = 1.0f;
+
+		renderScaleMetric().set(1.0);
+
+		if (m_Settings.minScale >= 1.0f || m_Settings.targetFrameTime <= 0.0)
+		{
+			Logger::m_GraphicsLogger->info("The dynamic resolution is disabled");
+
+			return(Error::Ok);
+		}
+
+		auto shaderOrError = ResourceManager::loadShader(_UPSCALE_SHADER_VERT_RELPATH, _UPSCALE_SHADER_FRAG_RELPATH, nullptr, "upscaleShader");
+
+		if (!shaderOrError.has_value())
+			return(Error::InitializationError);
+
+		m_UpscaleShader = *shaderOrError;
+
+		// The scene target of the native size, the scaled scene takes its corner.
+		glGenTextures(1, &m_SceneTexture);
+		glBindTexture(GL_TEXTURE_2D, m_SceneTexture);
+		glTexImage2D (GL_TEXTURE_2D, 0, GL_RGBA8, m_NativeDimensions.x, m_NativeDimensions.y, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S,     GL_CLAMP_TO_EDGE);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T,     GL_CLAMP_TO_EDGE);
+		glBindTexture  (GL_TEXTURE_2D, 0);
+
+		GLint previousFramebuffer = 0;
+		glGetIntegerv(GL_FRAMEBUFFER_BINDING, &previousFramebuffer);
+
+		glGenFramebuffers     (1, &m_SceneFramebuffer);
+		glBindFramebuffer     (GL_FRAMEBUFFER, m_SceneFramebuffer);
+		glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, m_SceneTexture, 0);
+
+		const bool isComplete = glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE;
+
+		glBindFramebuffer(GL_FRAMEBUFFER, previousFramebuffer);
+
+		if (!isComplete)
+		{
+			Logger::m_GraphicsLogger->error("The scene framebuffer is incomplete, the dynamic resolution is disabled");
+
+			release();
+
+			return(Error::InitializationError);
+		}
+
+		// The triangle of the upscale pass is generated by the vertex shader(the core profile
+		// still needs the vertex array to be bound).
+		m_UpscaleVertexArray = GFX::RenderDevice::instance().createVertexArray();
+
+		Logger::m_GraphicsLogger->info("The dynamic resolution targets {:.2f} ms of the GPU time, the scale goes down to {:.2f}",
+			m_Settings.targetFrameTime, m_Settings.minScale);
+
+		return(Error::Ok);
+	}
+
+	void DynamicResolution::release() noexcept
+	{
+		if (m_UpscaleVertexArray != 0)
+			GFX::RenderDevice::instance().deleteVertexArray(m_UpscaleVertexArray);
+
+		if (m_SceneFramebuffer != 0)
+			glDeleteFramebuffers(1, &m_SceneFramebuffer);
+
+		if (m_SceneTexture != 0)
+			glDeleteTextures(1, &m_SceneTexture);
+
+		m_UpscaleVertexArray = 0;
+		m_SceneFramebuffer   = 0;
+		m_SceneTexture       = 0;
+		m_Scale              = 1.0f;
+	}
+
+	void DynamicResolution::updateScale(double sceneTime, double gpuFrameTime) noexcept
+	{
+		// The time of the current scale is not measured yet.
+		if (GpuProfiler::instance().getAveragedFrames() < _RESOLUTION_SETTLE_FRAMES || gpuFrameTime <= 0.0)
+			return;
+
+		// The fill rate is the limit, so the time of the scene passes follows the amount of the
+		// pixels(the square of the scale), the rest of the frame(the upscale and the ImGui) is drawn
+		// with the native resolution and stays the same.
+		const double targetFrameTime = m_Settings.targetFrameTime * _RESOLUTION_FRAME_TIME_MARGIN;
+		const double fixedFrameTime  = std::max(gpuFrameTime - sceneTime, 0.0);
+		float        nextScale       = m_Scale;
+
+		if (gpuFrameTime > m_Settings.targetFrameTime)
+		{
+			// Go down at once to the scale that is expected to fit(at least by the step), or to the
+			// smallest one when the rest of the frame alone does not fit.
+			const double targetSceneTime = targetFrameTime - fixedFrameTime;
+			const float  fittingScale    = (targetSceneTime > 0.0 && sceneTime > 0.0)
+				? m_Scale * static_cast<float>(std::sqrt(targetSceneTime / sceneTime))
+				: m_Settings.minScale;
+
+			nextScale = std::min(std::floor(fittingScale / _RESOLUTION_SCALE_STEP) * _RESOLUTION_SCALE_STEP, m_Scale - _RESOLUTION_SCALE_STEP);
+		}
+		else if (m_Scale < 1.0f)
+		{
+			// Go up by the step, when the larger scale is expected to fit.
+			const float  largerScale     = std::min(m_Scale + _RESOLUTION_SCALE_STEP, 1.0f);
+			const double largerFrameTime = fixedFrameTime + sceneTime * (largerScale * largerScale) / (m_Scale * m_Scale);
+
+			if (largerFrameTime < targetFrameTime)
+				nextScale = largerScale;
+		}
+
+		nextScale = std::clamp(nextScale, m_Settings.minScale, 1.0f);
+
+		if (std::abs(nextScale - m_Scale) < 0.5f * _RESOLUTION_SCALE_STEP)
+			return;
+
+		ENGINE_LOG_DEBUG(m_GraphicsLogger, "The GPU frame time is {:.2f} ms({:.2f} ms of the scene), the resolution scale goes from {:.2f} to {:.2f}",
+			gpuFrameTime, sceneTime, m_Scale, nextScale);
+
+		m_Scale = nextScale;
+
+		// The smoothed times of the previous scale would hold the next change back(or trigger it).
+		GpuProfiler::instance().resetAverages();
+
+		renderScaleMetric().set(static_cast<double>(m_Scale));
+	}
+
+	void DynamicResolution::beginScene() noexcept
+	{
+		if (!isEnabled())
+			return;
+
+		const auto& gpuProfiler = GpuProfiler::instance();
+
+		updateScale(gpuProfiler.getSceneTime(), gpuProfiler.getGpuFrameTime());
+
+		// The native scale is drawn right into the screen.
+		if (m_Scale >= 1.0f)
+			return;
+
+		glGetIntegerv(GL_FRAMEBUFFER_BINDING, &m_TargetFramebuffer);
+		glBindFramebuffer(GL_FRAMEBUFFER, m_SceneFramebuffer);
+
+		const glm::ivec2 sceneDimensions = getSceneDimensions();
+
+		GFX::RenderDevice::instance().setViewport(0, 0, sceneDimensions.x, sceneDimensions.y);
+
+		m_IsSceneBound = true;
+	}
+
+	void DynamicResolution::endScene() noexcept
+	{
+		if (!m_IsSceneBound)
+			return;
+
+		m_IsSceneBound = false;
+
+		auto& renderDevice = GFX::RenderDevice::instance();
+
+		GpuProfiler::instance().beginPass(GpuPass::Upscale);
+
+		glBindFramebuffer(GL_FRAMEBUFFER, m_TargetFramebuffer);
+		renderDevice.setViewport(0, 0, m_NativeDimensions.x, m_NativeDimensions.y);
+
+		// The upscaled scene replaces the screen(the overdraw view blends additively).
+		renderDevice.setCapability(GL_BLEND, false);
+
+		m_UpscaleShader.useShader();
+		m_UpscaleShader.setInteger ("scene",      0);
+		m_UpscaleShader.setVector2f("sceneScale", glm::vec2(getSceneDimensions()) / glm::vec2(m_NativeDimensions));
+		m_UpscaleShader.setFloat   ("sharpness",  _UPSCALE_SHARPNESS);
+
+		renderDevice.activeTexture  (GL_TEXTURE0);
+		renderDevice.bindTexture    (m_SceneTexture);
+		renderDevice.bindVertexArray(m_UpscaleVertexArray);
+		renderDevice.drawArrays     (GL_TRIANGLES, GL_ZERO, 3);
+		renderDevice.bindVertexArray(GL_ZERO);
+
+		renderDevice.setCapability(GL_BLEND, true);
+
+		// The shader, the texture and the vertex array.
+		GpuProfiler::instance().countDrawCalls(1);
+		GpuProfiler::instance().countStateChanges(3);
+	}
+}
@@ -0,0 +1,104 @@
+// This file declares the `DynamicResolution` class.
+#pragma once
+
+#include "_EngineIncludes.hpp"
+
+#include "rendering/ShaderWrapper.hpp"
+
+// This namespace is polluted with code for the game engine
+namespace Engine
+{
+	// The settings of the dynamic resolution(see ::DynamicResolution::initialize).
+	struct DynamicResolutionSettings
+	{
+		double targetFrameTime = 1000.0 / 60.0; // the GPU time of the frame to fit into(milliseconds)
+		float  minScale        = 0.5f;          // the smallest scale of the scene resolution
+	};
+
+	// This class renders the scene(the sprites, not the ImGui) into the offscreen target with the
+	// part of the native resolution, and upscales it to the screen with the sharpening filter. The
+	// scale follows the measured GPU time of the scene passes: it goes down as soon as the frame
+	// does not fit into the target time, and up only when the larger scale is expected to fit with
+	// the margin(so it does not flip between the two scales every second).
+	//
+	// The target has the native size, the scene is drawn into its corner(the viewport), so the
+	// scale changes without reallocating it. The native scale draws right into the screen.
+	class DynamicResolution
+	{
+	private:
+		DynamicResolution() = default;
+
+	public:
+		DynamicResolution(const DynamicResolution&)            = delete;
+		DynamicResolution& operator=(const DynamicResolution&) = delete;
+
+		// This function is the way to realize the Singleton OOP programming pattern,
+		// so that this class can only be instantiated only once.
+		static DynamicResolution& instance()
+		{
+			static DynamicResolution _instance;
+			return(_instance);
+		}
+
+	public:
+		// Create the scene target of the native size and load the upscale shader(the OpenGL
+		// functions must be loaded). The scale stays native when it fails.
+		Error initialize(glm::ivec2 nativeDimensions, const DynamicResolutionSettings& resolutionSettings) noexcept;
+
+		// Release the scene target.
+		void release() noexcept;
+
+		// Adapt the scale to the GPU frame time, and bind the scene target with the scaled
+		// viewport(the projection stays the same, the scene is scaled by the viewport).
+		void beginScene() noexcept;
+
+		// Upscale the scene into the framebuffer that was bound before the ::beginScene, and set
+		// the native viewport back(the ImGui is drawn after it with the native resolution).
+		void endScene() noexcept;
+
+		inline bool isEnabled() const noexcept
+		{
+			return(m_SceneFramebuffer != 0);
+		}
+
+		// Get the scale of the scene resolution(one is the native resolution).
+		inline float getScale() const noexcept
+		{
+			return(m_Scale);
+		}
+
+		inline glm::ivec2 getSceneDimensions() const noexcept
+		{
+			return(getScaledDimensions(m_Scale));
+		}
+
+		inline const DynamicResolutionSettings& getSettings() const noexcept
+		{
+			return(m_Settings);
+		}
+
+	private:
+		// Change the scale when the GPU frame time does not fit the target, only the time of the
+		// scene passes follows the scale(milliseconds).
+		void updateScale(double sceneTime, double gpuFrameTime) noexcept;
+
+		inline glm::ivec2 getScaledDimensions(float resolutionScale) const noexcept
+		{
+			return(glm::max(glm::ivec2(glm::vec2(m_NativeDimensions) * resolutionScale + 0.5f), glm::ivec2(1)));
+		}
+
+	private:
+		DynamicResolutionSettings m_Settings;
+
+		glm::ivec2 m_NativeDimensions = { 0, 0 };
+		float      m_Scale            = 1.0f;
+
+		GLuint m_SceneFramebuffer   = 0;
+		GLuint m_SceneTexture       = 0;
+		GLuint m_UpscaleVertexArray = 0;
+		GLint  m_TargetFramebuffer  = 0; // the framebuffer the scene is upscaled into
+		bool   m_IsSceneBound       = false;
+
+		GFX::Core::ShaderWrapper m_UpscaleShader;
+	};
+}
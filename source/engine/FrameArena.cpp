@@ -0,0 +1,86 @@
+// This file implements the `FrameArena` class.
+#include "FrameArena.hpp"
+#include "Logger.hpp"
+
+#include "bit"
+
+using namespace std;
+
+namespace Engine
+{
+	FrameArena::~FrameArena()
+	{
+		// The loggers may be already destroyed here, so the memory is released silently.
+		for (const auto& overflowAllocation : m_Overflows)
+			pmr::new_delete_resource()->deallocate(overflowAllocation.pointer, overflowAllocation.bytes, overflowAllocation.alignment);
+
+		if (m_Buffer != nullptr)
+			pmr::new_delete_resource()->deallocate(m_Buffer, m_Capacity, alignof(max_align_t));
+	}
+
+	void FrameArena::reset() noexcept
+	{
+		const size_t frameBytes = getUsedBytes();
+
+		if (frameBytes > m_PeakBytes)
+		{
+			m_PeakBytes = frameBytes;
+
+			ENGINE_LOG_DEBUG(m_ApplicationLogger, "Frame arena peak usage is {} bytes(frame {}, capacity {} bytes, {} overflow allocations)",
+				m_PeakBytes, m_FrameNumber, m_Capacity, m_Overflows.size());
+		}
+
+		for (const auto& overflowAllocation : m_Overflows)
+			pmr::new_delete_resource()->deallocate(overflowAllocation.pointer, overflowAllocation.bytes, overflowAllocation.alignment);
+
+		// Nothing is alive anymore, so this is the only moment the buffer can be replaced.
+		// The arena is grown to fit the whole frame, so the overflow happens only once.
+		if (!m_Overflows.empty())
+			grow(std::bit_ceil(frameBytes + frameBytes / 2));
+
+		m_Overflows.clear();
+		m_OverflowBytes = 0;
+		m_Offset        = 0;
+
+		++m_FrameNumber;
+	}
+
+	void* FrameArena::do_allocate(size_t bytes, size_t alignment)
+	{
+		if (m_Buffer == nullptr)
+			grow(DefaultCapacity);
+
+		// Align the address(the alignment is always the power of two).
+		const uintptr_t currentAddress = reinterpret_cast<uintptr_t>(m_Buffer) + m_Offset;
+		const size_t    alignedOffset  = m_Offset + (((currentAddress + alignment - 1) & ~(uintptr_t(alignment) - 1)) - currentAddress);
+
+		if (alignedOffset + bytes <= m_Capacity)
+		{
+			m_Offset = alignedOffset + bytes;
+
+			return(m_Buffer + alignedOffset);
+		}
+
+		// Fall back to the heap until the end of the frame.
+		void* overflowPointer = pmr::new_delete_resource()->allocate(bytes, alignment);
+
+		m_Overflows.push_back({ overflowPointer, bytes, alignment });
+		m_OverflowBytes += bytes;
+
+		return(overflowPointer);
+	}
+
+	void FrameArena::grow(size_t capacity)
+	{
+		if (capacity <= m_Capacity)
+			return;
+
+		if (m_Buffer != nullptr)
+			pmr::new_delete_resource()->deallocate(m_Buffer, m_Capacity, alignof(max_align_t));
+
+		m_Buffer   = static_cast<byte*>(pmr::new_delete_resource()->allocate(capacity, alignof(max_align_t)));
+		m_Capacity = capacity;
+
+		Engine::Logger::m_ApplicationLogger->info("Frame arena capacity is {} bytes", m_Capacity);
+	}
+}
@@ -0,0 +1,110 @@
+// This file declares the `FrameArena` class.
+#pragma once
+
+#include "_EngineIncludes.hpp"
+
+#include "vector"
+#include "memory_resource"
+
+// This namespace is polluted with code for the game engine
+namespace Engine
+{
+	// This class is the linear(bump) allocator for the data that lives no longer than
+	// a single frame. The memory is never freed piece by piece, the whole arena is reset
+	// at the end of the frame instead, so the transient containers never touch the heap.
+	//
+	// The arena is the `std::pmr::memory_resource`, so any `std::pmr` container can opt in:
+	//
+	//   FrameVector<Card> ownerGroup(&FrameArena::instance());
+	//
+	// The allocations that do not fit into the arena are served by the heap for the current
+	// frame, and the arena grows to fit them during the next reset. The arena belongs to
+	// the main thread, the jobs must not allocate from it.
+	class FrameArena : public std::pmr::memory_resource
+	{
+	private:
+		FrameArena() = default;
+
+	public:
+		FrameArena(const FrameArena&)            = delete;
+		FrameArena& operator=(const FrameArena&) = delete;
+
+		~FrameArena();
+
+		// This function is the way to realize the Singleton OOP programming pattern,
+		// so that this class can only be instantiated only once.
+		static FrameArena& instance()
+		{
+			static FrameArena _instance;
+			return(_instance);
+		}
+
+	public:
+		// The capacity of the arena before the first frame.
+		static constexpr const size_t DefaultCapacity = 256 * 1024;
+
+		// Invalidate all the allocations of the frame, must be called once per frame
+		// when none of the frame containers is alive anymore.
+		void reset() noexcept;
+
+		// Get the amount of the bytes that were allocated during the current frame.
+		inline size_t getUsedBytes() const noexcept
+		{
+			return(m_Offset + m_OverflowBytes);
+		}
+
+		// Get the size of the arena buffer.
+		inline size_t getCapacity() const noexcept
+		{
+			return(m_Capacity);
+		}
+
+		// Get the largest per-frame usage since the start of the program.
+		inline size_t getPeakBytes() const noexcept
+		{
+			return(m_PeakBytes);
+		}
+
+	private:
+		void* do_allocate(size_t bytes, size_t alignment) override;
+
+		// The memory is released all at once by the ::reset.
+		void do_deallocate(void* pointer, size_t bytes, size_t alignment) override
+		{
+			UnreferencedParameter(pointer);
+			UnreferencedParameter(bytes);
+			UnreferencedParameter(alignment);
+		}
+
+		bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override
+		{
+			return(this == &other);
+		}
+
+		// Replace the arena buffer with the larger one.
+		void grow(size_t capacity);
+
+	private:
+		// The heap allocation that did not fit into the arena.
+		struct OverflowAllocation
+		{
+			void*  pointer;
+			size_t bytes;
+			size_t alignment;
+		};
+
+		std::byte* m_Buffer   = nullptr;
+		size_t     m_Capacity = 0;
+		size_t     m_Offset   = 0;
+
+		std::vector<OverflowAllocation> m_Overflows;
+		size_t                          m_OverflowBytes = 0;
+
+		size_t   m_PeakBytes   = 0;
+		uint64_t m_FrameNumber = 0;
+	};
+
+	// The vector that allocates its storage from the frame arena.
+	template<typename T>
+	using FrameVector = std::pmr::vector<T>;
+}
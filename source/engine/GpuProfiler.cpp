@@ -0,0 +1,236 @@
+// This file implements the `GpuProfiler` class.
+#include "GpuProfiler.hpp"
+#include "DynamicResolution.hpp"
+#include "InputQueue.hpp"
+#include "ResourseManager.hpp"
+
+using namespace std;
+
+// The smoothing factor of the displayed times.
+static constexpr const double _GPU_PROFILER_AVERAGE_WEIGHT = 0.05;
+
+// Blend the new sample into the exponential moving average.
+static inline void blendAverage(double& average, double sample)
+{
+	average = (average == 0.0) ? sample : average + (sample - average) * _GPU_PROFILER_AVERAGE_WEIGHT;
+}
+
+namespace Engine
+{
+	void GpuProfiler::release() noexcept
+	{
+		endPass();
+
+		for (auto& frameQueries : m_Frames)
+		{
+			if (!frameQueries.queries.empty())
+				glDeleteQueries(static_cast<GLsizei>(frameQueries.queries.size()), frameQueries.queries.data());
+
+			frameQueries = FrameQueries();
+		}
+
+		m_IsFrameActive = false;
+	}
+
+	void GpuProfiler::beginFrame() noexcept
+	{
+		collectFinishedFrames();
+
+		m_FrameStats   = m_CurrentStats;
+		m_CurrentStats = RenderStats();
+
+		m_FrameBeginTimestamp = InputQueue::timestamp();
+		m_CurrentFrame        = (m_CurrentFrame + 1) % FramesInFlight;
+
+		auto& frameQueries = m_Frames[m_CurrentFrame];
+
+		// The GPU is more than ::FramesInFlight frames behind, do not wait for it,
+		// the queries are simply restarted.
+		if (frameQueries.isPending)
+		{
+			frameQueries.isPending = false;
+
+			m_DroppedFrames++;
+		}
+
+		frameQueries.usedQueries = 0;
+
+		m_IsFrameActive = m_IsEnabled;
+	}
+
+	void GpuProfiler::endFrame() noexcept
+	{
+		endPass();
+
+		blendAverage(m_CpuFrameTime, static_cast<double>(InputQueue::timestamp() - m_FrameBeginTimestamp) * 1e-6);
+
+		auto& frameQueries = m_Frames[m_CurrentFrame];
+		frameQueries.isPending = frameQueries.usedQueries > 0;
+
+		m_IsFrameActive = false;
+	}
+
+	void GpuProfiler::resetAverages() noexcept
+	{
+		// The queries are simply reused without reading their results.
+		for (auto& frameQueries : m_Frames)
+			frameQueries.isPending = false;
+
+		m_PassTimes      = {};
+		m_GpuFrameTime   = 0.0;
+		m_AveragedFrames = 0;
+	}
+
+	void GpuProfiler::beginPass(GpuPass gpuPass) noexcept
+	{
+		// The consecutive draw calls of the same pass are sharing the query.
+		if (!m_IsFrameActive || m_ActivePass == gpuPass)
+			return;
+
+		endPass();
+
+		auto& frameQueries = m_Frames[m_CurrentFrame];
+
+		if (frameQueries.usedQueries == frameQueries.queries.size())
+		{
+			GLuint queryID = 0;
+			glGenQueries(1, &queryID);
+
+			frameQueries.queries    .push_back(queryID);
+			frameQueries.queryPasses.push_back(gpuPass);
+		}
+
+		frameQueries.queryPasses[frameQueries.usedQueries] = gpuPass;
+
+		glBeginQuery(GL_TIME_ELAPSED, frameQueries.queries[frameQueries.usedQueries++]);
+
+		m_ActivePass = gpuPass;
+	}
+
+	void GpuProfiler::endPass() noexcept
+	{
+		if (m_ActivePass == GpuPass::Count)
+			return;
+
+		glEndQuery(GL_TIME_ELAPSED);
+
+		m_ActivePass = GpuPass::Count;
+	}
+
+	void GpuProfiler::collectFinishedFrames() noexcept
+	{
+		for (auto& frameQueries : m_Frames)
+		{
+			if (!frameQueries.isPending)
+				continue;
+
+			// The queries finish in order, so the last one tells about the whole frame.
+			GLint isAvailable = GL_FALSE;
+			glGetQueryObjectiv(frameQueries.queries[frameQueries.usedQueries - 1], GL_QUERY_RESULT_AVAILABLE, &isAvailable);
+
+			if (isAvailable == GL_FALSE)
+				continue;
+
+			array<double, static_cast<size_t>(GpuPass::Count)> passTimes = {};
+
+			for (size_t queryIndex = 0; queryIndex < frameQueries.usedQueries; ++queryIndex)
+			{
+				GLuint64 elapsedTime = 0;
+				glGetQueryObjectui64v(frameQueries.queries[queryIndex], GL_QUERY_RESULT, &elapsedTime);
+
+				passTimes[static_cast<size_t>(frameQueries.queryPasses[queryIndex])] += static_cast<double>(elapsedTime) * 1e-6;
+			}
+
+			double gpuFrameTime = 0.0;
+
+			for (size_t passIndex = 0; passIndex < passTimes.size(); ++passIndex)
+			{
+				blendAverage(m_PassTimes[passIndex], passTimes[passIndex]);
+				gpuFrameTime += passTimes[passIndex];
+			}
+
+			blendAverage(m_GpuFrameTime, gpuFrameTime);
+
+			m_MeasuredGpuTime += gpuFrameTime;
+			m_MeasuredFrames++;
+			m_AveragedFrames++;
+
+			frameQueries.isPending = false;
+		}
+	}
+
+	void GpuProfiler::renderDebugUI(bool* isOpened) noexcept
+	{
+		if (!ImGui::Begin("Debug Window", isOpened, ImGuiWindowFlags_AlwaysAutoResize))
+		{
+			ImGui::End();
+
+			return;
+		}
+
+		const double frameTime = ImGui::GetIO().Framerate > 0.0f ? 1000.0 / ImGui::GetIO().Framerate : 0.0;
+
+		ImGui::Text("Frame time:     %6.2f ms (%.0f FPS)", frameTime, ImGui::GetIO().Framerate);
+		ImGui::Text("CPU frame time: %6.2f ms", m_CpuFrameTime);
+		ImGui::Text("GPU frame time: %6.2f ms", m_GpuFrameTime);
+
+		// The side that takes longer limits the frame rate(the rest is the vsync wait).
+		if (m_GpuFrameTime > 0.0)
+			ImGui::Text("The frame is %s bound", m_GpuFrameTime > m_CpuFrameTime ? "GPU" : "CPU");
+
+		if (ImGui::BeginTable("GPU passes", 2, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg))
+		{
+			ImGui::TableSetupColumn("Pass");
+			ImGui::TableSetupColumn("GPU, ms");
+			ImGui::TableHeadersRow();
+
+			for (size_t passIndex = 0; passIndex < m_PassTimes.size(); ++passIndex)
+			{
+				ImGui::TableNextColumn(); ImGui::Text("%s",   getPassName(static_cast<GpuPass>(passIndex)));
+				ImGui::TableNextColumn(); ImGui::Text("%.3f", m_PassTimes[passIndex]);
+			}
+
+			ImGui::EndTable();
+		}
+
+		ImGui::Separator();
+
+		if (DynamicResolution::instance().isEnabled())
+		{
+			const glm::ivec2 sceneDimensions = DynamicResolution::instance().getSceneDimensions();
+
+			ImGui::Text("Render scale:   %.2f (%dx%d)", DynamicResolution::instance().getScale(), sceneDimensions.x, sceneDimensions.y);
+		}
+
+		ImGui::Text("Draw calls:     %u", m_FrameStats.drawCalls);
+		ImGui::Text("State changes:  %u", m_FrameStats.stateChanges);
+
+		const auto textureResidency = ResourceManager::getTextureResidency();
+
+		ImGui::Text("Texture memory: %.2f MB", static_cast<double>(textureResidency.residentBytes) / (1024.0 * 1024.0));
+
+		if (textureResidency.budgetBytes != 0)
+			ImGui::Text("Texture budget: %.2f MB", static_cast<double>(textureResidency.budgetBytes) / (1024.0 * 1024.0));
+
+		ImGui::Text("Textures:       %zu resident, %zu evicted", textureResidency.residentTextures, textureResidency.evictedTextures);
+		ImGui::Text("Evictions:      %llu (%llu reloads)",
+			static_cast<unsigned long long>(textureResidency.evictionsTotal),
+			static_cast<unsigned long long>(textureResidency.reloadsTotal));
+		ImGui::Text("Frames dropped from GPU timing: %llu", static_cast<unsigned long long>(m_DroppedFrames));
+
+		ImGui::End();
+	}
+
+	const char* GpuProfiler::getPassName(GpuPass gpuPass) noexcept
+	{
+		switch (gpuPass)
+		{
+			case GpuPass::Background: return("Background");
+			case GpuPass::Cards:      return("Cards");
+			case GpuPass::Effects:    return("Shadows/Effects");
+			case GpuPass::Upscale:    return("Upscale");
+			case GpuPass::ImGui:      return("ImGui");
+			default:                  return("Unknown");
+		}
+	}
+}
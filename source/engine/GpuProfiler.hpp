@@ -0,0 +1,186 @@
+// This file declares the `GpuProfiler` class.
+#pragma once
+
+#include "_EngineIncludes.hpp"
+
+#include "array"
+#include "vector"
+
+// This namespace is polluted with code for the game engine
+namespace Engine
+{
+	// The render passes that are timed on the GPU.
+	enum class GpuPass : uint8_t
+	{
+		Background, // the background and the static board sprites
+		Cards,      // the card sprites
+		Effects,    // the shadows, the glowing and the motion blur copies of the cards
+		Upscale,    // the upscale of the scene that was rendered with the lower resolution
+		ImGui,      // the Dear ImGui draw data
+		Count,
+	};
+
+	// The counters of the single frame.
+	struct RenderStats
+	{
+		uint32_t drawCalls    = 0;
+		uint32_t stateChanges = 0; // the shader, texture and vertex array binds
+	};
+
+	// This class measures the GPU time of the render passes with the GL_TIME_ELAPSED
+	// queries. The queries of the frame are read back ::FramesInFlight frames later(only
+	// when the results are available), so the profiler never stalls the pipeline.
+	//
+	// The pass may be entered many times per frame(the shadows and the cards are
+	// interleaved), the times are summed up. The queries are issued only while the
+	// profiler is enabled(the Debug Window is shown), the counters are always gathered.
+	class GpuProfiler
+	{
+	private:
+		GpuProfiler() = default;
+
+	public:
+		GpuProfiler(const GpuProfiler&)            = delete;
+		GpuProfiler& operator=(const GpuProfiler&) = delete;
+
+		// This function is the way to realize the Singleton OOP programming pattern,
+		// so that this class can only be instantiated only once.
+		static GpuProfiler& instance()
+		{
+			static GpuProfiler _instance;
+			return(_instance);
+		}
+
+	public:
+		// Destroy the GL query objects.
+		void release() noexcept;
+
+		// Start or stop issuing the queries(takes effect on the next frame).
+		inline void setEnabled(bool isEnabled) noexcept
+		{
+			m_IsEnabled = isEnabled;
+		}
+
+		// Start the frame, gathers the results of the frames that the GPU has finished.
+		void beginFrame() noexcept;
+
+		// Finish the frame(after the last draw call and before the buffer swap).
+		void endFrame() noexcept;
+
+		// Time the following draw calls as the `gpuPass`(the previous pass is ended).
+		void beginPass(GpuPass gpuPass) noexcept;
+
+		// Stop timing the current pass.
+		void endPass() noexcept;
+
+		// Count the draw calls and the state changes of the current frame.
+		inline void countDrawCalls(uint32_t drawCalls) noexcept
+		{
+			m_CurrentStats.drawCalls += drawCalls;
+		}
+
+		inline void countStateChanges(uint32_t stateChanges) noexcept
+		{
+			m_CurrentStats.stateChanges += stateChanges;
+		}
+
+		// Get the smoothed GPU time of the pass(milliseconds).
+		inline double getPassTime(GpuPass gpuPass) const noexcept
+		{
+			return(m_PassTimes[static_cast<size_t>(gpuPass)]);
+		}
+
+		// Get the smoothed GPU time of the whole frame(milliseconds).
+		inline double getGpuFrameTime() const noexcept
+		{
+			return(m_GpuFrameTime);
+		}
+
+		// Get the smoothed GPU time of the scene passes(milliseconds), that is the frame without
+		// the upscale and the ImGui, which take the same time whatever the scene resolution is.
+		inline double getSceneTime() const noexcept
+		{
+			return(getPassTime(GpuPass::Background) + getPassTime(GpuPass::Cards) + getPassTime(GpuPass::Effects));
+		}
+
+		// Get the amount of the frames the smoothed times are averaged over(since ::resetAverages).
+		inline uint64_t getAveragedFrames() const noexcept
+		{
+			return(m_AveragedFrames);
+		}
+
+		// Forget the smoothed GPU times and the results of the frames that are still in flight, so
+		// the following times are measured only from the frames that are issued after it(the way the
+		// frames are rendered has changed). Must be called before the first pass of the frame.
+		void resetAverages() noexcept;
+
+		// Get the smoothed CPU time from the ::beginFrame to the ::endFrame(milliseconds).
+		inline double getCpuFrameTime() const noexcept
+		{
+			return(m_CpuFrameTime);
+		}
+
+		// Get the unsmoothed GPU time of all the measured frames(milliseconds) and the amount
+		// of these frames(the benchmarks are averaging the time over the run with them).
+		inline double getMeasuredGpuTime() const noexcept
+		{
+			return(m_MeasuredGpuTime);
+		}
+
+		inline uint64_t getMeasuredFrames() const noexcept
+		{
+			return(m_MeasuredFrames);
+		}
+
+		// Get the counters of the previous frame.
+		inline const RenderStats& getRenderStats() const noexcept
+		{
+			return(m_FrameStats);
+		}
+
+		// Render the Debug Window with the Dear ImGui(must be called between the ImGui::NewFrame/EndFrame).
+		void renderDebugUI(bool* isOpened) noexcept;
+
+		// Get the human readable name of the pass.
+		static const char* getPassName(GpuPass gpuPass) noexcept;
+
+	private:
+		// The frames that are in flight at the same time.
+		static constexpr const size_t FramesInFlight = 4;
+
+		// The queries of the single frame, the pool grows to the largest amount of
+		// the pass switches per frame and is reused afterwards.
+		struct FrameQueries
+		{
+			std::vector<GLuint>  queries;
+			std::vector<GpuPass> queryPasses;
+			size_t               usedQueries = 0;
+			bool                 isPending   = false;
+		};
+
+		// Read the results of the frames that the GPU has already finished.
+		void collectFinishedFrames() noexcept;
+
+	private:
+		bool m_IsEnabled     = false;
+		bool m_IsFrameActive = false;
+
+		std::array<FrameQueries, FramesInFlight> m_Frames;
+		size_t                                   m_CurrentFrame  = 0;
+		uint64_t                                 m_DroppedFrames = 0;
+		GpuPass                                  m_ActivePass    = GpuPass::Count;
+
+		uint64_t m_FrameBeginTimestamp = 0;
+
+		std::array<double, static_cast<size_t>(GpuPass::Count)> m_PassTimes = {};
+		double                                                  m_GpuFrameTime = 0.0;
+		double                                                  m_CpuFrameTime = 0.0;
+
+		double   m_MeasuredGpuTime = 0.0;
+		uint64_t m_MeasuredFrames  = 0;
+		uint64_t m_AveragedFrames  = 0;
+
+		RenderStats m_CurrentStats;
+		RenderStats m_FrameStats;
+	};
+}
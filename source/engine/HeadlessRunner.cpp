@@ -0,0 +1,484 @@
+// This file implements the `HeadlessRunner` class.
+#include "HeadlessRunner.hpp"
+#include "InputQueue.hpp"
+#include "Logger.hpp"
+
+#include "utility/PngWriter.hpp"
+
+#include "algorithm"
+#include "filesystem"
+#include "cstring"
+#include "cstdio"
+
+using namespace std;
+
+// The file the frame times of the run are written to(inside of the output directory).
+static constexpr const char* _HEADLESS_FRAME_TIMES_FILENAME = "frame_times.csv";
+
+// The most frame times the memory is reserved for up front(the unbounded and the long runs
+// grow past it).
+static constexpr const uint64_t _HEADLESS_FRAMES_RESERVED = 36000;
+
+// Get the value of the `--name=value` argument, or nullptr if the argument has another name.
+static const char* getArgumentValue(const char* argument, const char* argumentName)
+{
+	const size_t nameLength = strlen(argumentName);
+
+	if (strncmp(argument, argumentName, nameLength) != 0 || argument[nameLength] != '=')
+		return(nullptr);
+
+	return(argument + nameLength + 1);
+}
+
+// Translate the mouse button name of the script into the GLFW button.
+static int getMouseButton(const string& buttonName)
+{
+	if (buttonName == "right")  return(GLFW_MOUSE_BUTTON_RIGHT);
+	if (buttonName == "middle") return(GLFW_MOUSE_BUTTON_MIDDLE);
+
+	return(GLFW_MOUSE_BUTTON_LEFT);
+}
+
+// Get the percentile of the sorted samples.
+static double getSortedPercentile(const vector<double>& sortedSamples, double percentile)
+{
+	if (sortedSamples.empty())
+		return(0.0);
+
+	const size_t sampleIndex = static_cast<size_t>(percentile * static_cast<double>(sortedSamples.size() - 1) + 0.5);
+
+	return(sortedSamples[sampleIndex]);
+}
+
+namespace Engine
+{
+	Error HeadlessRunner::parseArguments(int argc, char* argv[]) noexcept
+	{
+		for (int argumentIndex = 1; argumentIndex < argc; ++argumentIndex)
+		{
+			const char* argument = argv[argumentIndex];
+			const char* argumentValue;
+
+			if (strcmp(argument, "--headless") == 0)
+			{
+				m_Settings.isEnabled = true;
+			}
+			else if ((argumentValue = getArgumentValue(argument, "--frames")) != nullptr)
+			{
+				m_Settings.framesTotal = strtoull(argumentValue, nullptr, 10);
+			}
+			else if ((argumentValue = getArgumentValue(argument, "--size")) != nullptr)
+			{
+				if (sscanf(argumentValue, "%dx%d", &m_Settings.dimensions.x, &m_Settings.dimensions.y) != 2 ||
+					m_Settings.dimensions.x <= 0 || m_Settings.dimensions.y <= 0)
+				{
+					fprintf(stderr, "The size must look like 1920x1080, got %s\n", argumentValue);
+
+					return(Error::ValidationError);
+				}
+			}
+			else if ((argumentValue = getArgumentValue(argument, "--step")) != nullptr)
+			{
+				m_Settings.frameStep = strtod(argumentValue, nullptr);
+			}
+			else if ((argumentValue = getArgumentValue(argument, "--seed")) != nullptr)
+			{
+				m_Settings.randomSeed = static_cast<uint32_t>(strtoul(argumentValue, nullptr, 10));
+			}
+			else if ((argumentValue = getArgumentValue(argument, "--script")) != nullptr)
+			{
+				m_Settings.scriptPath = argumentValue;
+			}
+			else if ((argumentValue = getArgumentValue(argument, "--output")) != nullptr)
+			{
+				m_Settings.outputDirectory = argumentValue;
+			}
+			else if ((argumentValue = getArgumentValue(argument, "--capture-every")) != nullptr)
+			{
+				m_Settings.captureEvery = strtoull(argumentValue, nullptr, 10);
+			}
+			else if ((argumentValue = getArgumentValue(argument, "--msaa")) != nullptr)
+			{
+				m_Settings.samples = atoi(argumentValue);
+			}
+			else
+			{
+				// The logger is not initialized yet, the message goes straight to the console.
+				fprintf(stderr, "Unknown argument %s\n", argument);
+
+				return(Error::ValidationError);
+			}
+		}
+
+		if (m_Settings.frameStep <= 0.0)
+		{
+			fprintf(stderr, "The frame step must be positive\n");
+
+			return(Error::ValidationError);
+		}
+
+		return(Error::Ok);
+	}
+
+	void HeadlessRunner::initializePlatform() noexcept
+	{
+		if (!m_Settings.isEnabled)
+			return;
+
+		// The "null" platform needs no display server(it appeared in the GLFW 3.4).
+#ifdef GLFW_PLATFORM_NULL
+		glfwInitHint(GLFW_PLATFORM, GLFW_PLATFORM_NULL);
+#endif
+	}
+
+	GLFWwindow* HeadlessRunner::createWindow(const char* windowTitle) noexcept
+	{
+		glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+
+		// The EGL surfaceless context runs on the GPU(or the llvmpipe) when it is there.
+		glfwWindowHint(GLFW_CONTEXT_CREATION_API, GLFW_EGL_CONTEXT_API);
+
+		GLFWwindow* offscreenWindow = glfwCreateWindow(m_Settings.dimensions.x, m_Settings.dimensions.y, windowTitle, nullptr, nullptr);
+
+		if (offscreenWindow != nullptr)
+		{
+			Logger::m_ApplicationLogger->info("Created the offscreen EGL context");
+
+			return(offscreenWindow);
+		}
+
+		Logger::m_ApplicationLogger->warn("Unable to create the EGL context, falling back to the OSMesa");
+
+		glfwWindowHint(GLFW_CONTEXT_CREATION_API, GLFW_OSMESA_CONTEXT_API);
+
+		offscreenWindow = glfwCreateWindow(m_Settings.dimensions.x, m_Settings.dimensions.y, windowTitle, nullptr, nullptr);
+
+		if (offscreenWindow != nullptr)
+			Logger::m_ApplicationLogger->info("Created the offscreen OSMesa context");
+
+		return(offscreenWindow);
+	}
+
+	Error HeadlessRunner::initialize() noexcept
+	{
+		std::error_code directoryError;
+		filesystem::create_directories(m_Settings.outputDirectory, directoryError);
+
+		if (directoryError)
+		{
+			Logger::m_ApplicationLogger->error("Unable to create the output directory {}", m_Settings.outputDirectory);
+
+			return(Error::InitializationError);
+		}
+
+		if (!m_Settings.scriptPath.empty() && !FunctionSuccessA(loadScript(m_Settings.scriptPath)))
+			return(Error::InitializationError);
+
+		// The samples are limited by the driver.
+		GLint maxSamples = 0;
+		glGetIntegerv(GL_MAX_SAMPLES, &maxSamples);
+
+		const GLsizei renderSamples = m_Settings.samples > 1 ? std::min(m_Settings.samples, static_cast<int>(maxSamples)) : 0;
+
+		// The render target replaces the default framebuffer, that the offscreen context may not have.
+		glGenFramebuffers (1, &m_Framebuffer);
+		glGenRenderbuffers(1, &m_ColorRenderbuffer);
+		glGenRenderbuffers(1, &m_DepthRenderbuffer);
+
+		glBindRenderbuffer(GL_RENDERBUFFER, m_ColorRenderbuffer);
+		glRenderbufferStorageMultisample(GL_RENDERBUFFER, renderSamples, GL_RGBA8, m_Settings.dimensions.x, m_Settings.dimensions.y);
+
+		glBindRenderbuffer(GL_RENDERBUFFER, m_DepthRenderbuffer);
+		glRenderbufferStorageMultisample(GL_RENDERBUFFER, renderSamples, GL_DEPTH24_STENCIL8, m_Settings.dimensions.x, m_Settings.dimensions.y);
+
+		glBindFramebuffer(GL_FRAMEBUFFER, m_Framebuffer);
+		glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0,        GL_RENDERBUFFER, m_ColorRenderbuffer);
+		glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, m_DepthRenderbuffer);
+
+		if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+		{
+			Logger::m_ApplicationLogger->error("The offscreen framebuffer is incomplete");
+
+			return(Error::InitializationError);
+		}
+
+		// The multisampled target is resolved at the end of every frame(the same work the
+		// driver does for the multisampled window), the captures are read from the resolved one.
+		if (renderSamples > 1)
+		{
+			glGenFramebuffers (1, &m_ResolveFramebuffer);
+			glGenRenderbuffers(1, &m_ResolveRenderbuffer);
+
+			glBindRenderbuffer(GL_RENDERBUFFER, m_ResolveRenderbuffer);
+			glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, m_Settings.dimensions.x, m_Settings.dimensions.y);
+
+			glBindFramebuffer(GL_FRAMEBUFFER, m_ResolveFramebuffer);
+			glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, m_ResolveRenderbuffer);
+
+			if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+			{
+				Logger::m_ApplicationLogger->error("The offscreen resolve framebuffer is incomplete");
+
+				return(Error::InitializationError);
+			}
+
+			glBindFramebuffer(GL_FRAMEBUFFER, m_Framebuffer);
+
+			Logger::m_ApplicationLogger->info("The offscreen framebuffer has {} samples", renderSamples);
+		}
+
+		const uint64_t framesReserved = m_Settings.framesTotal == 0 ? _HEADLESS_FRAMES_RESERVED : std::min(m_Settings.framesTotal, _HEADLESS_FRAMES_RESERVED);
+
+		m_SubmitTimes.reserve(static_cast<size_t>(framesReserved));
+		m_FinishTimes.reserve(static_cast<size_t>(framesReserved));
+
+		const string framesDescription = m_Settings.framesTotal == 0 ? string("unbounded") : to_string(m_Settings.framesTotal);
+
+		Logger::m_ApplicationLogger->info("Running headless: {} frames of {}x{}, {} script events, the output goes to {}",
+			framesDescription, m_Settings.dimensions.x, m_Settings.dimensions.y, m_ScriptEvents.size(), m_Settings.outputDirectory);
+
+		return(Error::Ok);
+	}
+
+	void HeadlessRunner::release() noexcept
+	{
+		if (m_Framebuffer == 0)
+			return;
+
+		glDeleteFramebuffers (1, &m_Framebuffer);
+		glDeleteRenderbuffers(1, &m_ColorRenderbuffer);
+		glDeleteRenderbuffers(1, &m_DepthRenderbuffer);
+
+		m_Framebuffer = m_ColorRenderbuffer = m_DepthRenderbuffer = 0;
+
+		if (m_ResolveFramebuffer != 0)
+		{
+			glDeleteFramebuffers (1, &m_ResolveFramebuffer);
+			glDeleteRenderbuffers(1, &m_ResolveRenderbuffer);
+
+			m_ResolveFramebuffer = m_ResolveRenderbuffer = 0;
+		}
+
+		// Write every frame, so the regressions can be found on the exact frame.
+		const string frameTimesPath = (filesystem::path(m_Settings.outputDirectory) / _HEADLESS_FRAME_TIMES_FILENAME).string();
+
+		if (FILE* frameTimesFile = fopen(frameTimesPath.c_str(), "w"); frameTimesFile != nullptr)
+		{
+			fputs("frame,submit_ms,finish_ms\n", frameTimesFile);
+
+			for (size_t frameIndex = 0; frameIndex < m_SubmitTimes.size(); ++frameIndex)
+				fprintf(frameTimesFile, "%zu,%.4f,%.4f\n", frameIndex, m_SubmitTimes[frameIndex], m_FinishTimes[frameIndex]);
+
+			fclose(frameTimesFile);
+		}
+		else
+		{
+			Logger::m_ApplicationLogger->error("Unable to write the frame times into {}", frameTimesPath);
+		}
+
+		// Print the summary to the console as well, that is what the build server shows.
+		vector<double> sortedTimes = m_FinishTimes;
+		sort(sortedTimes.begin(), sortedTimes.end());
+
+		const string frameSummary = fmt::format("Headless run: {} frames, frame time p50 {:.3f} ms, p95 {:.3f} ms, p99 {:.3f} ms, max {:.3f} ms",
+			sortedTimes.size(),
+			getSortedPercentile(sortedTimes, 0.50),
+			getSortedPercentile(sortedTimes, 0.95),
+			getSortedPercentile(sortedTimes, 0.99),
+			sortedTimes.empty() ? 0.0 : sortedTimes.back());
+
+		Logger::m_ApplicationLogger->info(frameSummary);
+		fprintf(stdout, "%s\n", frameSummary.c_str());
+	}
+
+	void HeadlessRunner::beginFrame(GLFWwindow* window) noexcept
+	{
+		m_FrameTimestamp  = InputQueue::timestamp();
+		m_IsCaptureWanted = m_Settings.captureEvery > 0 && m_FrameIndex % m_Settings.captureEvery == 0;
+
+		glBindFramebuffer(GL_FRAMEBUFFER, m_Framebuffer);
+
+		// The events are fed through the ImGui callbacks, they are chained to the engine
+		// ones, so both the UI and the game see them exactly as the real input.
+		for (; m_NextScriptEvent < m_ScriptEvents.size() && m_ScriptEvents[m_NextScriptEvent].frameIndex <= m_FrameIndex; ++m_NextScriptEvent)
+		{
+			const auto& scriptEvent = m_ScriptEvents[m_NextScriptEvent];
+
+			switch (scriptEvent.scriptCommand)
+			{
+				case ScriptCommand::CursorMove:
+				{
+					glfwSetCursorPos(window, scriptEvent.positionX, scriptEvent.positionY);
+					ImGui_ImplGlfw_CursorPosCallback(window, scriptEvent.positionX, scriptEvent.positionY);
+				} break;
+
+				case ScriptCommand::MouseButtonPress:
+				case ScriptCommand::MouseButtonRelease:
+				{
+					const int buttonAction = scriptEvent.scriptCommand == ScriptCommand::MouseButtonPress ? GLFW_PRESS : GLFW_RELEASE;
+
+					ImGui_ImplGlfw_MouseButtonCallback(window, scriptEvent.eventCode, buttonAction, 0);
+				} break;
+
+				case ScriptCommand::KeyPress:
+				case ScriptCommand::KeyRelease:
+				{
+					const int keyAction = scriptEvent.scriptCommand == ScriptCommand::KeyPress ? GLFW_PRESS : GLFW_RELEASE;
+
+					ImGui_ImplGlfw_KeyCallback(window, scriptEvent.eventCode, 0, keyAction, 0);
+				} break;
+
+				case ScriptCommand::Capture:
+				{
+					m_IsCaptureWanted = true;
+				} break;
+
+				case ScriptCommand::Quit:
+				{
+					m_IsQuitRequested = true;
+				} break;
+			}
+		}
+	}
+
+	void HeadlessRunner::endFrame() noexcept
+	{
+		// Resolve the samples, the way the swap of the multisampled window does.
+		if (m_ResolveFramebuffer != 0)
+		{
+			glBindFramebuffer(GL_READ_FRAMEBUFFER, m_Framebuffer);
+			glBindFramebuffer(GL_DRAW_FRAMEBUFFER, m_ResolveFramebuffer);
+			glBlitFramebuffer(0, 0, m_Settings.dimensions.x, m_Settings.dimensions.y, 0, 0, m_Settings.dimensions.x, m_Settings.dimensions.y, GL_COLOR_BUFFER_BIT, GL_NEAREST);
+			glBindFramebuffer(GL_FRAMEBUFFER, m_Framebuffer);
+		}
+
+		const uint64_t submitTimestamp = InputQueue::timestamp();
+
+		// There is no swap to pace the frames, so wait for the GPU to get the real frame time.
+		glFinish();
+
+		const uint64_t finishTimestamp = InputQueue::timestamp();
+
+		m_SubmitTimes.push_back(static_cast<double>(submitTimestamp - m_FrameTimestamp) * 1e-6);
+		m_FinishTimes.push_back(static_cast<double>(finishTimestamp - m_FrameTimestamp) * 1e-6);
+
+		if (m_IsCaptureWanted)
+			captureFrame();
+
+		m_FrameIndex++;
+	}
+
+	Error HeadlessRunner::loadScript(const string& scriptPath) noexcept
+	{
+		ifstream scriptFile(scriptPath);
+
+		if (!scriptFile.is_open())
+		{
+			Logger::m_ApplicationLogger->error("Unable to open the input script {}", scriptPath);
+
+			return(Error::InitializationError);
+		}
+
+		string scriptLine;
+		size_t lineNumber = 0;
+
+		while (getline(scriptFile, scriptLine))
+		{
+			lineNumber++;
+
+			// Skip the comments and the empty lines.
+			const size_t commentOffset = scriptLine.find('#');
+
+			if (commentOffset != string::npos)
+				scriptLine.resize(commentOffset);
+
+			istringstream lineStream(scriptLine);
+
+			ScriptEvent scriptEvent = {};
+			string      commandName;
+
+			if (!(lineStream >> scriptEvent.frameIndex >> commandName))
+				continue;
+
+			bool isValid = true;
+
+			if (commandName == "move")
+			{
+				scriptEvent.scriptCommand = ScriptCommand::CursorMove;
+				isValid = static_cast<bool>(lineStream >> scriptEvent.positionX >> scriptEvent.positionY);
+			}
+			else if (commandName == "press" || commandName == "release")
+			{
+				string buttonName = "left";
+				lineStream >> buttonName;
+
+				scriptEvent.scriptCommand = commandName == "press" ? ScriptCommand::MouseButtonPress : ScriptCommand::MouseButtonRelease;
+				scriptEvent.eventCode     = getMouseButton(buttonName);
+			}
+			else if (commandName == "keydown" || commandName == "keyup")
+			{
+				scriptEvent.scriptCommand = commandName == "keydown" ? ScriptCommand::KeyPress : ScriptCommand::KeyRelease;
+				isValid = static_cast<bool>(lineStream >> scriptEvent.eventCode);
+			}
+			else if (commandName == "capture")
+			{
+				scriptEvent.scriptCommand = ScriptCommand::Capture;
+			}
+			else if (commandName == "quit")
+			{
+				scriptEvent.scriptCommand = ScriptCommand::Quit;
+			}
+			else
+			{
+				isValid = false;
+			}
+
+			if (!isValid)
+			{
+				Logger::m_ApplicationLogger->error("{}:{}: unable to parse the script line", scriptPath, lineNumber);
+
+				return(Error::ValidationError);
+			}
+
+			m_ScriptEvents.push_back(scriptEvent);
+		}
+
+		// Keep the order of the events of the same frame.
+		stable_sort(m_ScriptEvents.begin(), m_ScriptEvents.end(), [](const ScriptEvent& left, const ScriptEvent& right)
+		{
+			return(left.frameIndex < right.frameIndex);
+		});
+
+		return(Error::Ok);
+	}
+
+	void HeadlessRunner::captureFrame() noexcept
+	{
+		const size_t rowSize = static_cast<size_t>(m_Settings.dimensions.x) * 4;
+
+		m_CapturePixels.resize(rowSize * m_Settings.dimensions.y);
+
+		glBindFramebuffer(GL_READ_FRAMEBUFFER, m_ResolveFramebuffer != 0 ? m_ResolveFramebuffer : m_Framebuffer);
+		glPixelStorei(GL_PACK_ALIGNMENT, 1);
+		glReadPixels(0, 0, m_Settings.dimensions.x, m_Settings.dimensions.y, GL_RGBA, GL_UNSIGNED_BYTE, m_CapturePixels.data());
+
+		// The blending leaves the destination alpha below one under the shadows, the trails and the
+		// smooth edges, the screen ignores it, so the captured frame is opaque as well.
+		for (size_t pixelOffset = 3; pixelOffset < m_CapturePixels.size(); pixelOffset += 4)
+			m_CapturePixels[pixelOffset] = 0xFF;
+
+		// The OpenGL rows go from the bottom up, the PNG ones from the top down.
+		for (int rowIndex = 0; rowIndex < m_Settings.dimensions.y / 2; ++rowIndex)
+		{
+			swap_ranges(
+				m_CapturePixels.begin() + rowIndex * rowSize,
+				m_CapturePixels.begin() + (rowIndex + 1) * rowSize,
+				m_CapturePixels.begin() + (m_Settings.dimensions.y - rowIndex - 1) * rowSize);
+		}
+
+		const string capturePath = (filesystem::path(m_Settings.outputDirectory) / fmt::format("frame_{:05}.png", m_FrameIndex)).string();
+
+		if (FunctionSuccessA(writePng(capturePath.c_str(), m_Settings.dimensions.x, m_Settings.dimensions.y, m_CapturePixels.data())))
+			ENGINE_LOG_DEBUG(m_ApplicationLogger, "Captured the frame {} into {}", m_FrameIndex, capturePath);
+	}
+}
@@ -0,0 +1,151 @@
+// This file declares the `HeadlessRunner` class.
+//
+// The headless mode renders the game without the display: the OpenGL context is created
+// offscreen(the EGL surfaceless or the OSMesa context of the GLFW "null" platform), the
+// frames are rendered into the framebuffer object, the input is read from the script and
+// the time advances with the fixed step, so the run is reproducible on any Linux box:
+//
+//   101 --headless --frames=600 --size=1280x720 --script=tests/menu.script --output=out
+#pragma once
+
+#include "_EngineIncludes.hpp"
+
+#include "vector"
+
+// This namespace is polluted with code for the game engine
+namespace Engine
+{
+	// The command of the input script.
+	enum class ScriptCommand : uint8_t
+	{
+		CursorMove,         // move <x> <y>
+		MouseButtonPress,   // press <left|right|middle>
+		MouseButtonRelease, // release <left|right|middle>
+		KeyPress,           // keydown <GLFW key code>
+		KeyRelease,         // keyup <GLFW key code>
+		Capture,            // capture(dump the frame into the PNG file)
+		Quit,               // quit(stop the run after this frame)
+	};
+
+	// The single line of the input script, it is executed at the start of the frame.
+	struct ScriptEvent
+	{
+		uint64_t      frameIndex;
+		ScriptCommand scriptCommand;
+		int           eventCode = 0;
+		double        positionX = 0.0;
+		double        positionY = 0.0;
+	};
+
+	// The settings of the headless run(see ::HeadlessRunner::parseArguments).
+	struct HeadlessSettings
+	{
+		bool        isEnabled       = false;
+		glm::ivec2  dimensions      = { 1920, 1080 };
+		uint64_t    framesTotal     = 300;        // zero runs until the quit(the script or the end of the stream)
+		double      frameStep       = 1.0 / 60.0; // seconds of the simulated time per frame
+		uint32_t    randomSeed      = 101;
+		uint64_t    captureEvery    = 0;          // zero captures the scripted frames only
+		int         samples         = 0;          // the MSAA samples of the render target(zero is no MSAA), the window gets them too
+		std::string scriptPath;
+		std::string outputDirectory = "headless";
+	};
+
+	// This class drives the headless run: it creates the offscreen render target, replays
+	// the input script, dumps the requested frames into the PNG files and measures the
+	// frame times(the CPU time of the frame and the time until the GPU finished it).
+	class HeadlessRunner
+	{
+	private:
+		HeadlessRunner() = default;
+
+	public:
+		HeadlessRunner(const HeadlessRunner&)            = delete;
+		HeadlessRunner& operator=(const HeadlessRunner&) = delete;
+
+		// This function is the way to realize the Singleton OOP programming pattern,
+		// so that this class can only be instantiated only once.
+		static HeadlessRunner& instance()
+		{
+			static HeadlessRunner _instance;
+			return(_instance);
+		}
+
+	public:
+		// Parse the command line(--headless, --frames=N, --size=WxH, --step=S, --seed=N,
+		// --script=PATH, --output=DIR, --capture-every=N, --msaa=N). The zero frames run until
+		// the quit.
+		Error parseArguments(int argc, char* argv[]) noexcept;
+
+		// Select the offscreen platform(must be called before the glfwInit).
+		void initializePlatform() noexcept;
+
+		// Create the offscreen window, the EGL context is tried first, then the OSMesa one.
+		GLFWwindow* createWindow(const char* windowTitle) noexcept;
+
+		// Create the render target and load the script(the OpenGL functions must be loaded).
+		Error initialize() noexcept;
+
+		// Write the frame times and release the render target.
+		void release() noexcept;
+
+		// Bind the render target and replay the script events of the frame.
+		void beginFrame(GLFWwindow* window) noexcept;
+
+		// Wait for the GPU, record the frame time and capture the frame if it was asked for.
+		void endFrame() noexcept;
+
+		// Get the simulated time of the current frame(in seconds).
+		inline double getFrameTime() const noexcept
+		{
+			return(static_cast<double>(m_FrameIndex) * m_Settings.frameStep);
+		}
+
+		inline bool isFinished() const noexcept
+		{
+			return(m_IsQuitRequested || (m_Settings.framesTotal != 0 && m_FrameIndex >= m_Settings.framesTotal));
+		}
+
+		inline bool isEnabled() const noexcept
+		{
+			return(m_Settings.isEnabled);
+		}
+
+		inline const HeadlessSettings& getSettings() const noexcept
+		{
+			return(m_Settings);
+		}
+
+	private:
+		// Read the script file into the ::m_ScriptEvents(sorted by the frame).
+		Error loadScript(const std::string& scriptPath) noexcept;
+
+		// Read the pixels of the render target and write them into the PNG file.
+		void captureFrame() noexcept;
+
+	private:
+		HeadlessSettings m_Settings;
+
+		std::vector<ScriptEvent> m_ScriptEvents;
+		size_t                   m_NextScriptEvent = 0;
+
+		GLuint m_Framebuffer        = 0;
+		GLuint m_ColorRenderbuffer  = 0;
+		GLuint m_DepthRenderbuffer  = 0;
+
+		// The single sample target the multisampled one is resolved into(when the MSAA is on).
+		GLuint m_ResolveFramebuffer  = 0;
+		GLuint m_ResolveRenderbuffer = 0;
+
+		uint64_t m_FrameIndex       = 0;
+		uint64_t m_FrameTimestamp   = 0;
+		bool     m_IsCaptureWanted  = false;
+		bool     m_IsQuitRequested  = false;
+
+		// The time until the frame was submitted and until the GPU finished it(milliseconds).
+		std::vector<double> m_SubmitTimes;
+		std::vector<double> m_FinishTimes;
+
+		std::vector<uint8_t> m_CapturePixels;
+	};
+}
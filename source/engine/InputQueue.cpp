@@ -0,0 +1,44 @@
+// This file implements the `InputQueue` class.
+#include "InputQueue.hpp"
+
+using namespace std;
+
+namespace Engine
+{
+	bool InputQueue::push(const InputEvent& inputEvent) noexcept
+	{
+		const size_t head = m_Head.load(memory_order_relaxed);
+		const size_t tail = m_Tail.load(memory_order_acquire);
+
+		// The queue is full, the consumer is too slow.
+		if (head - tail == Capacity)
+		{
+			m_DroppedCount.fetch_add(1, memory_order_relaxed);
+
+			return(false);
+		}
+
+		m_Events[head % Capacity] = inputEvent;
+
+		// Publish the event to the consumer.
+		m_Head.store(head + 1, memory_order_release);
+
+		return(true);
+	}
+
+	bool InputQueue::pop(InputEvent& inputEvent) noexcept
+	{
+		const size_t tail = m_Tail.load(memory_order_relaxed);
+		const size_t head = m_Head.load(memory_order_acquire);
+
+		if (tail == head)
+			return(false);
+
+		inputEvent = m_Events[tail % Capacity];
+
+		// Give the slot back to the producer.
+		m_Tail.store(tail + 1, memory_order_release);
+
+		return(true);
+	}
+}
@@ -0,0 +1,77 @@
+// This file declares the `InputQueue` class.
+#pragma once
+
+#include "_EngineIncludes.hpp"
+
+#include "array"
+#include "atomic"
+#include "chrono"
+
+// This namespace is polluted with code for the game engine
+namespace Engine
+{
+	// The kind of the user input event.
+	enum class InputEventType : uint8_t
+	{
+		KeyPress,
+		KeyRelease,
+		MouseButtonPress,
+		MouseButtonRelease,
+		CursorMove,
+	};
+
+	// The single user input event, stamped with the time it was received from the platform layer.
+	struct InputEvent
+	{
+		InputEventType eventType;
+		int            eventCode; // GLFW key or the mouse button
+		int            modifiers; // GLFW modifier bits
+		double         positionX;
+		double         positionY;
+		uint64_t       timestamp; // nanoseconds, see ::InputQueue::timestamp()
+	};
+
+	// The latency(time from the event to its consumption) statistics.
+	struct InputLatencyStats
+	{
+		uint64_t eventsConsumed = 0;
+		double   lastLatency    = 0.0; // seconds
+		double   averageLatency = 0.0; // seconds, exponential moving average
+		double   maxLatency     = 0.0; // seconds
+	};
+
+	// This class is the bounded single-producer/single-consumer lock-free queue of the input
+	// events. The GLFW callbacks push the events as they are received, and the game drains
+	// them at the start of the update, so the short clicks between two frames are not lost.
+	class InputQueue
+	{
+	public:
+		static constexpr const size_t Capacity = 1024;
+
+		// Get the monotonic timestamp(in nanoseconds) for the input events.
+		static inline uint64_t timestamp() noexcept
+		{
+			return(static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count()));
+		}
+
+		// Push the event into the queue(producer side), the event is dropped if the queue is full.
+		bool push(const InputEvent& inputEvent) noexcept;
+
+		// Pop the oldest event from the queue(consumer side).
+		bool pop(InputEvent& inputEvent) noexcept;
+
+		// Get the amount of the events that were dropped because the queue was full.
+		inline uint64_t getDroppedCount() const noexcept
+		{
+			return(m_DroppedCount.load(std::memory_order_relaxed));
+		}
+
+	private:
+		std::array<InputEvent, Capacity> m_Events;
+
+		// The producer and the consumer indices live on the separate cache lines.
+		alignas(64) std::atomic<size_t>   m_Head = 0; // next slot to write
+		alignas(64) std::atomic<size_t>   m_Tail = 0; // next slot to read
+		alignas(64) std::atomic<uint64_t> m_DroppedCount = 0;
+	};
+}
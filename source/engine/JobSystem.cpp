@@ -0,0 +1,335 @@
+// This file implements the `JobSystem` class.
+#include "JobSystem.hpp"
+#include "Logger.hpp"
+#include "Profiler.hpp"
+
+using namespace std;
+
+// The index of the worker that runs on the current thread(-1 for the threads that
+// are not owned by the job system, e.g. the main thread).
+static thread_local int32_t t_WorkerIndex = -1;
+
+namespace Engine
+{
+	Error JobSystem::initialize(uint32_t workerCount) noexcept
+	{
+		if (m_IsRunning.load())
+		{
+			Engine::Logger::m_ApplicationLogger->error("The job system is already running");
+
+			return(Error::ValidationError);
+		}
+
+		// Leave one core to the main thread.
+		if (workerCount == 0)
+			workerCount = std::max(thread::hardware_concurrency(), 2u) - 1u;
+
+		m_MainThreadID = this_thread::get_id();
+		m_NextWorker   = 0;
+		m_QueuedJobs   = 0;
+		m_IsRunning    = true;
+
+		// Create all the workers before starting the threads, so the stealing
+		// loop never observes the partially filled workers array.
+		m_Workers.clear();
+		for (uint32_t workerIndex = 0; workerIndex < workerCount; ++workerIndex)
+			m_Workers.push_back(make_unique<Worker>());
+
+		try
+		{
+			for (uint32_t workerIndex = 0; workerIndex < workerCount; ++workerIndex)
+				m_Workers[workerIndex]->workerThread = thread(&JobSystem::workerLoop, this, workerIndex);
+		}
+		catch (const system_error& systemError)
+		{
+			Engine::Logger::m_ApplicationLogger->error("Unable to start the job system worker thread({})", systemError.what());
+
+			release();
+
+			return(Error::InitializationError);
+		}
+
+		Engine::Logger::m_ApplicationLogger->info("Job system started with {} worker threads", workerCount);
+
+		return(Error::Ok);
+	}
+
+	void JobSystem::release() noexcept
+	{
+		if (!m_IsRunning.exchange(false))
+			return;
+
+		// Wake up the sleeping workers, they will drain theirs deques and exit.
+		{
+			lock_guard<mutex> sleepLock(m_SleepMutex);
+		}
+		m_SleepCondition.notify_all();
+
+		for (auto& worker : m_Workers)
+		{
+			if (worker->workerThread.joinable())
+				worker->workerThread.join();
+		}
+
+		// The jobs that were scheduled on the main thread are not lost either.
+		pumpMainThread();
+
+		m_Workers.clear();
+
+		Engine::Logger::m_ApplicationLogger->info("Job system has been stopped");
+	}
+
+	void JobSystem::schedule(JobFunction jobFunction, JobCounter* signalCounter, JobCounter* dependency)
+	{
+		if (signalCounter != nullptr)
+			signalCounter->m_Pending.fetch_add(1, memory_order_relaxed);
+
+		Job job = { std::move(jobFunction), signalCounter };
+
+		// Park the job until its dependency has finished. The counter is re-checked under
+		// the lock, so the job is never parked after the continuations were released.
+		if (dependency != nullptr)
+		{
+			lock_guard<mutex> continuationLock(dependency->m_ContinuationMutex);
+
+			if (!dependency->isDone())
+			{
+				dependency->m_Continuations.push_back(std::move(job));
+
+				return;
+			}
+		}
+
+		enqueue(std::move(job));
+	}
+
+	void JobSystem::parallelFor(size_t count, size_t batchSize, const function<void(size_t, size_t)>& batchFunction, JobCounter* signalCounter)
+	{
+		batchSize = std::max<size_t>(batchSize, 1);
+
+		// All the batches share the single copy of the function.
+		const auto sharedFunction = make_shared<function<void(size_t, size_t)>>(batchFunction);
+
+		for (size_t batchBegin = 0; batchBegin < count; batchBegin += batchSize)
+		{
+			const size_t batchEnd = std::min(batchBegin + batchSize, count);
+
+			schedule([sharedFunction, batchBegin, batchEnd]() { (*sharedFunction)(batchBegin, batchEnd); }, signalCounter);
+		}
+	}
+
+	void JobSystem::scheduleOnMainThread(JobFunction jobFunction, JobCounter* signalCounter)
+	{
+		if (signalCounter != nullptr)
+			signalCounter->m_Pending.fetch_add(1, memory_order_relaxed);
+
+		lock_guard<mutex> mainThreadLock(m_MainThreadMutex);
+		m_MainThreadJobs.push_back({ std::move(jobFunction), signalCounter });
+	}
+
+	void JobSystem::pumpMainThread() noexcept
+	{
+		// Take the jobs out of the queue first, so the jobs are free to schedule new
+		// main thread jobs(they are executed during the next pump).
+		vector<Job> mainThreadJobs;
+		{
+			lock_guard<mutex> mainThreadLock(m_MainThreadMutex);
+			mainThreadJobs.swap(m_MainThreadJobs);
+		}
+
+		for (auto& job : mainThreadJobs)
+			execute(job);
+	}
+
+	void JobSystem::wait(JobCounter& jobCounter) noexcept
+	{
+		Job job;
+
+		while (!jobCounter.isDone())
+		{
+			// The main thread jobs would never finish if the main thread is the one waiting.
+			if (isMainThread())
+				pumpMainThread();
+
+			if (acquire(job, t_WorkerIndex))
+				execute(job);
+			else
+				this_thread::yield();
+		}
+
+		// Let the last signaling job leave the counter before the caller is free to destroy it.
+		lock_guard<mutex> continuationLock(jobCounter.m_ContinuationMutex);
+	}
+
+	JobWorkerStats JobSystem::getWorkerStats(uint32_t workerIndex) const noexcept
+	{
+		if (workerIndex >= m_Workers.size())
+			return(JobWorkerStats{});
+
+		const auto& worker = m_Workers[workerIndex];
+
+		return(JobWorkerStats{ worker->jobsExecuted.load(memory_order_relaxed), worker->jobsStolen.load(memory_order_relaxed) });
+	}
+
+	void JobSystem::workerLoop(uint32_t workerIndex) noexcept
+	{
+		t_WorkerIndex = static_cast<int32_t>(workerIndex);
+
+		ENGINE_PROFILE_THREAD(fmt::format("Job Worker {}", workerIndex));
+
+		Job job;
+
+		while (true)
+		{
+			if (acquire(job, t_WorkerIndex))
+			{
+				execute(job);
+				m_Workers[workerIndex]->jobsExecuted.fetch_add(1, memory_order_relaxed);
+
+				continue;
+			}
+
+			// Nothing to do, and nothing will be scheduled anymore.
+			if (!m_IsRunning.load())
+				break;
+
+			// The sleeping counter is published before the queue is re-checked, so the
+			// scheduler either sees the sleeper and notifies it, or the sleeper sees the job.
+			unique_lock<mutex> sleepLock(m_SleepMutex);
+
+			m_SleepingWorkers.fetch_add(1);
+			m_SleepCondition.wait(sleepLock, [this]() { return(m_QueuedJobs.load() > 0 || !m_IsRunning.load()); });
+			m_SleepingWorkers.fetch_sub(1);
+		}
+
+		t_WorkerIndex = -1;
+	}
+
+	void JobSystem::enqueue(Job&& job)
+	{
+		// Run the job in place if the job system has not been started.
+		if (m_Workers.empty())
+		{
+			execute(job);
+
+			return;
+		}
+
+		const size_t workerIndex = t_WorkerIndex >= 0
+			? static_cast<size_t>(t_WorkerIndex)
+			: m_NextWorker.fetch_add(1, memory_order_relaxed) % m_Workers.size();
+
+		auto& worker = m_Workers[workerIndex];
+		{
+			lock_guard<mutex> queueLock(worker->queueMutex);
+			worker->jobQueue.push_back(std::move(job));
+		}
+
+		m_QueuedJobs.fetch_add(1);
+
+		if (m_SleepingWorkers.load() > 0)
+		{
+			{
+				lock_guard<mutex> sleepLock(m_SleepMutex);
+			}
+			m_SleepCondition.notify_one();
+		}
+	}
+
+	bool JobSystem::acquire(Job& job, int32_t workerIndex) noexcept
+	{
+		const size_t workersTotal = m_Workers.size();
+
+		if (workersTotal == 0 || m_QueuedJobs.load(memory_order_relaxed) <= 0)
+			return(false);
+
+		// Pop the most recent job from the own deque.
+		if (workerIndex >= 0)
+		{
+			auto& worker = m_Workers[workerIndex];
+
+			lock_guard<mutex> queueLock(worker->queueMutex);
+
+			if (!worker->jobQueue.empty())
+			{
+				job = std::move(worker->jobQueue.back());
+				worker->jobQueue.pop_back();
+
+				m_QueuedJobs.fetch_sub(1);
+
+				return(true);
+			}
+		}
+
+		// Steal the oldest job from the other workers, starting with the neighbour, so
+		// the thieves do not all hit the same victim.
+		const size_t firstVictim = workerIndex >= 0 ? static_cast<size_t>(workerIndex) + 1 : 0;
+
+		for (size_t victimOffset = 0; victimOffset < workersTotal; ++victimOffset)
+		{
+			const size_t victimIndex = (firstVictim + victimOffset) % workersTotal;
+
+			if (static_cast<int32_t>(victimIndex) == workerIndex)
+				continue;
+
+			auto& victim = m_Workers[victimIndex];
+
+			// Do not wait for the busy victim, there are the others.
+			unique_lock<mutex> queueLock(victim->queueMutex, try_to_lock);
+
+			if (!queueLock.owns_lock() || victim->jobQueue.empty())
+				continue;
+
+			job = std::move(victim->jobQueue.front());
+			victim->jobQueue.pop_front();
+
+			m_QueuedJobs.fetch_sub(1);
+
+			if (workerIndex >= 0)
+				m_Workers[workerIndex]->jobsStolen.fetch_add(1, memory_order_relaxed);
+
+			return(true);
+		}
+
+		return(false);
+	}
+
+	void JobSystem::execute(Job& job) noexcept
+	{
+		ENGINE_PROFILE_SCOPE("JobSystem::execute");
+
+		try
+		{
+			job.jobFunction();
+		}
+		catch (const exception& jobException)
+		{
+			Engine::Logger::m_ApplicationLogger->error("Unhandled exception in the job: {}", jobException.what());
+		}
+
+		// Drop the captured state before the waiter is released.
+		job.jobFunction = nullptr;
+
+		if (job.signalCounter != nullptr)
+			signal(*job.signalCounter);
+	}
+
+	void JobSystem::signal(JobCounter& jobCounter) noexcept
+	{
+		// The counter is decremented under the lock, so the waiter(that takes the same lock
+		// once the counter is zero) can not destroy the counter while it is still in use here.
+		vector<Job> continuations;
+		{
+			lock_guard<mutex> continuationLock(jobCounter.m_ContinuationMutex);
+
+			if (jobCounter.m_Pending.fetch_sub(1, memory_order_acq_rel) != 1)
+				return;
+
+			// The counter has hit zero, release the jobs that were depending on it.
+			continuations.swap(jobCounter.m_Continuations);
+		}
+
+		for (auto& continuation : continuations)
+			enqueue(std::move(continuation));
+	}
+}
@@ -0,0 +1,182 @@
+// This file declares the `JobSystem` class.
+//
+// The `JobSystem` class owns the worker threads of the engine, so the asset decoding,
+// the AI search, the animation and the simulation code can spread the work across all
+// the cores instead of spawning theirs own threads.
+#pragma once
+
+#include "_EngineIncludes.hpp"
+
+#include "vector"
+#include "deque"
+#include "atomic"
+#include "mutex"
+#include "thread"
+#include "functional"
+#include "condition_variable"
+
+// This namespace is polluted with code for the game engine
+namespace Engine
+{
+	// The unit of the work that is executed by the job system.
+	using JobFunction = std::function<void()>;
+
+	// The job that is parked until its counter is decremented to zero(or is ready to run).
+	struct Job
+	{
+		JobFunction        jobFunction;
+		class JobCounter*  signalCounter = nullptr; // decremented once the job has finished
+	};
+
+	// This class tracks the amount of the unfinished jobs. The counter is used to wait
+	// for a group of jobs, and as the dependency of the other jobs(the dependent jobs
+	// are parked in the counter and released when it hits zero).
+	//
+	// The counter must outlive all the jobs that are signaling it or depending on it, so
+	// it is only safe to destroy the counter after the ::JobSystem::wait call.
+	class JobCounter
+	{
+	public:
+		JobCounter() = default;
+
+		JobCounter(const JobCounter&)            = delete;
+		JobCounter& operator=(const JobCounter&) = delete;
+
+		// Find out whether all the jobs that are tracked by the counter have finished.
+		inline bool isDone() const noexcept
+		{
+			return(m_Pending.load(std::memory_order_acquire) == 0);
+		}
+
+		inline uint32_t getPending() const noexcept
+		{
+			return(m_Pending.load(std::memory_order_acquire));
+		}
+
+	private:
+		friend class JobSystem;
+
+		std::atomic<uint32_t> m_Pending = 0;
+
+		// The jobs that are waiting for this counter to hit zero.
+		std::mutex       m_ContinuationMutex;
+		std::vector<Job> m_Continuations;
+	};
+
+	// The statistics of the single worker thread.
+	struct JobWorkerStats
+	{
+		uint64_t jobsExecuted = 0;
+		uint64_t jobsStolen   = 0;
+	};
+
+	// This class is the work-stealing job system.
+	//
+	// Every worker owns the deque of the jobs: the worker pushes and pops the jobs at the
+	// back of its own deque(the most recent job is the hottest in the cache), while the
+	// idle workers steal the oldest jobs from the front of the others' deques. The jobs
+	// that must touch the OpenGL context are scheduled into the separate queue, that is
+	// drained by the main thread once per frame(see ::pumpMainThread).
+	class JobSystem
+	{
+	private:
+		JobSystem() = default;
+
+	public:
+		JobSystem(const JobSystem&)            = delete;
+		JobSystem& operator=(const JobSystem&) = delete;
+
+		// This function is the way to realize the Singleton OOP programming pattern,
+		// so that this class can only be instantiated only once.
+		static JobSystem& instance()
+		{
+			static JobSystem _instance;
+			return(_instance);
+		}
+
+	public:
+		// Start the worker threads, zero means one worker per core(minus the main thread).
+		// Must be called from the main thread.
+		Error initialize(uint32_t workerCount = 0) noexcept;
+
+		// Finish all the scheduled jobs and join the worker threads.
+		void release() noexcept;
+
+		// Schedule the job, the `signalCounter`(if any) is incremented now and decremented
+		// once the job has finished. The job is not started until the `dependency` counter(if any) is zero.
+		void schedule(JobFunction jobFunction, JobCounter* signalCounter = nullptr, JobCounter* dependency = nullptr);
+
+		// Split the [0, count) range into the batches of `batchSize` and schedule the job per batch.
+		void parallelFor(size_t count, size_t batchSize, const std::function<void(size_t, size_t)>& batchFunction, JobCounter* signalCounter);
+
+		// Schedule the job that is executed on the main thread during the ::pumpMainThread call.
+		void scheduleOnMainThread(JobFunction jobFunction, JobCounter* signalCounter = nullptr);
+
+		// Run the jobs that were scheduled on the main thread, must be called from the main thread.
+		void pumpMainThread() noexcept;
+
+		// Wait until the counter hits zero, the calling thread executes the pending jobs meanwhile.
+		void wait(JobCounter& jobCounter) noexcept;
+
+		// Get the amount of the worker threads(the main thread is not counted).
+		inline uint32_t getWorkerCount() const noexcept
+		{
+			return(static_cast<uint32_t>(m_Workers.size()));
+		}
+
+		// Find out whether the calling thread is the one that has initialized the job system.
+		inline bool isMainThread() const noexcept
+		{
+			return(std::this_thread::get_id() == m_MainThreadID);
+		}
+
+		// Get the statistics of the worker(used by the benchmarks and the diagnostics).
+		JobWorkerStats getWorkerStats(uint32_t workerIndex) const noexcept;
+
+	private:
+		// The deque of the single worker, guarded by its own mutex so the owner and
+		// the thieves only contend when they touch the same worker.
+		struct Worker
+		{
+			std::thread     workerThread;
+			std::mutex      queueMutex;
+			std::deque<Job> jobQueue;
+
+			std::atomic<uint64_t> jobsExecuted = 0;
+			std::atomic<uint64_t> jobsStolen   = 0;
+		};
+
+		// The loop of the worker thread.
+		void workerLoop(uint32_t workerIndex) noexcept;
+
+		// Put the ready job into the deque of the calling worker(or the next worker in
+		// the round-robin order when called from the outside of the job system).
+		void enqueue(Job&& job);
+
+		// Take the job from the own deque, or steal it from the other worker.
+		bool acquire(Job& job, int32_t workerIndex) noexcept;
+
+		// Run the job and signal its counter.
+		void execute(Job& job) noexcept;
+
+		// Decrement the counter and release its continuations when it hits zero.
+		void signal(JobCounter& jobCounter) noexcept;
+
+	private:
+		std::vector<std::unique_ptr<Worker>> m_Workers;
+		std::thread::id                      m_MainThreadID;
+
+		std::atomic<bool>     m_IsRunning       = false;
+		std::atomic<uint32_t> m_NextWorker      = 0;
+		std::atomic<int64_t>  m_QueuedJobs      = 0;
+		std::atomic<uint32_t> m_SleepingWorkers = 0;
+
+		// The sleeping workers are woken up when the new job is scheduled.
+		std::mutex              m_SleepMutex;
+		std::condition_variable m_SleepCondition;
+
+		// The jobs that are executed on the main thread(the OpenGL work).
+		std::mutex       m_MainThreadMutex;
+		std::vector<Job> m_MainThreadJobs;
+	};
+}
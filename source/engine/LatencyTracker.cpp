@@ -0,0 +1,314 @@
+// This file implements the `LatencyTracker` class.
+#include "LatencyTracker.hpp"
+#include "InputQueue.hpp"
+#include "Logger.hpp"
+
+#include "algorithm"
+
+using namespace std;
+
+// Re-estimate the GPU/CPU clock offset every N frames.
+static constexpr const uint64_t _CLOCK_CALIBRATION_PERIOD = 120;
+
+// Convert the nanoseconds interval to the milliseconds.
+static inline double nanosecondsToMilliseconds(uint64_t begin, uint64_t end)
+{
+	return(end > begin ? static_cast<double>(end - begin) * 1e-6 : 0.0);
+}
+
+namespace Engine
+{
+	void LatencyHistogram::record(double milliseconds) noexcept
+	{
+		const auto bucket = lower_bound(BucketBounds.begin(), BucketBounds.end(), milliseconds);
+
+		m_Buckets[distance(BucketBounds.begin(), bucket)] += 1.0f;
+
+		m_Minimum = (m_Count == 0) ? milliseconds : std::min(m_Minimum, milliseconds);
+		m_Maximum = std::max(m_Maximum, milliseconds);
+		m_Sum    += milliseconds;
+		m_Count++;
+	}
+
+	double LatencyHistogram::getPercentile(double percentile) const noexcept
+	{
+		if (m_Count == 0)
+			return(0.0);
+
+		const double targetCount = percentile * static_cast<double>(m_Count);
+		double       runningCount = 0.0;
+
+		for (size_t bucketIndex = 0; bucketIndex < BucketBounds.size(); ++bucketIndex)
+		{
+			runningCount += m_Buckets[bucketIndex];
+
+			if (runningCount >= targetCount)
+				return(std::min(BucketBounds[bucketIndex], m_Maximum));
+		}
+
+		return(m_Maximum);
+	}
+
+	void LatencyHistogram::reset() noexcept
+	{
+		*this = LatencyHistogram();
+	}
+
+	void LatencyTracker::initialize() noexcept
+	{
+		Logger::m_GraphicsLogger->info("Initializing latency tracker");
+
+		for (auto& frameRecord : m_Frames)
+			glGenQueries(1, &frameRecord.timestampQuery);
+
+		calibrateClocks();
+
+		m_IsInitialized = true;
+	}
+
+	void LatencyTracker::release() noexcept
+	{
+		if (!m_IsInitialized)
+			return;
+
+		for (auto& frameRecord : m_Frames)
+		{
+			glDeleteQueries(1, &frameRecord.timestampQuery);
+
+			if (frameRecord.completionFence != nullptr)
+				glDeleteSync(frameRecord.completionFence);
+
+			frameRecord = FrameRecord();
+		}
+
+		m_IsInitialized = false;
+	}
+
+	void LatencyTracker::beginFrame(uint64_t oldestInputTimestamp) noexcept
+	{
+		if (!m_IsInitialized)
+			return;
+
+		collectFinishedFrames();
+
+		if (m_FrameCounter++ % _CLOCK_CALIBRATION_PERIOD == 0)
+			calibrateClocks();
+
+		m_CurrentFrame = (m_CurrentFrame + 1) % FramesInFlight;
+
+		auto& frameRecord = m_Frames[m_CurrentFrame];
+
+		// The GPU is more than ::FramesInFlight frames behind, do not wait for it, 
+		// just forget the oldest frame.
+		if (frameRecord.isPending)
+		{
+			glDeleteSync(frameRecord.completionFence);
+
+			frameRecord.completionFence = nullptr;
+			frameRecord.isPending       = false;
+
+			m_DroppedFrames++;
+		}
+
+		frameRecord.inputTimestamp = oldestInputTimestamp;
+		frameRecord.updateBegin    = InputQueue::timestamp();
+	}
+
+	void LatencyTracker::markUpdateEnd() noexcept
+	{
+		if (m_IsInitialized)
+			m_Frames[m_CurrentFrame].updateEnd = InputQueue::timestamp();
+	}
+
+	void LatencyTracker::markSubmitEnd() noexcept
+	{
+		if (!m_IsInitialized)
+			return;
+
+		auto& frameRecord = m_Frames[m_CurrentFrame];
+
+		frameRecord.submitEnd = InputQueue::timestamp();
+
+		// The query is written when the GPU reaches this point of the command stream.
+		glQueryCounter(frameRecord.timestampQuery, GL_TIMESTAMP);
+		frameRecord.completionFence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+	}
+
+	void LatencyTracker::markSwapEnd() noexcept
+	{
+		if (!m_IsInitialized)
+			return;
+
+		auto& frameRecord = m_Frames[m_CurrentFrame];
+
+		frameRecord.swapEnd   = InputQueue::timestamp();
+		frameRecord.isPending = true;
+	}
+
+	void LatencyTracker::reset() noexcept
+	{
+		for (auto& stageHistogram : m_Histograms)
+			stageHistogram.reset();
+
+		m_DroppedFrames = 0;
+	}
+
+	void LatencyTracker::collectFinishedFrames() noexcept
+	{
+		for (auto& frameRecord : m_Frames)
+		{
+			if (!frameRecord.isPending)
+				continue;
+
+			// Poll the fence without waiting.
+			const GLenum waitResult = glClientWaitSync(frameRecord.completionFence, 0, 0);
+
+			if (waitResult != GL_ALREADY_SIGNALED && waitResult != GL_CONDITION_SATISFIED)
+				continue;
+
+			glDeleteSync(frameRecord.completionFence);
+			frameRecord.completionFence = nullptr;
+			frameRecord.isPending       = false;
+
+			// The fence is signaled, so the query result is available without the stall.
+			GLuint64 gpuTimestamp = 0;
+			glGetQueryObjectui64v(frameRecord.timestampQuery, GL_QUERY_RESULT, &gpuTimestamp);
+
+			const uint64_t gpuComplete = static_cast<uint64_t>(static_cast<int64_t>(gpuTimestamp) + m_ClockOffset);
+
+			// The frame can not be on the screen before both the swap returned and the GPU finished it.
+			const uint64_t presentEstimate = std::max(frameRecord.swapEnd, gpuComplete);
+
+			histogram(LatencyStage::Update)     .record(nanosecondsToMilliseconds(frameRecord.updateBegin, frameRecord.updateEnd));
+			histogram(LatencyStage::Submit)     .record(nanosecondsToMilliseconds(frameRecord.updateEnd,   frameRecord.submitEnd));
+			histogram(LatencyStage::Swap)       .record(nanosecondsToMilliseconds(frameRecord.submitEnd,   frameRecord.swapEnd));
+			histogram(LatencyStage::GpuComplete).record(nanosecondsToMilliseconds(frameRecord.submitEnd,   gpuComplete));
+
+			// The input stages are only tracked for the frames that consumed some input.
+			if (frameRecord.inputTimestamp != 0)
+			{
+				histogram(LatencyStage::InputToUpdate) .record(nanosecondsToMilliseconds(frameRecord.inputTimestamp, frameRecord.updateBegin));
+				histogram(LatencyStage::InputToPresent).record(nanosecondsToMilliseconds(frameRecord.inputTimestamp, presentEstimate));
+			}
+		}
+	}
+
+	void LatencyTracker::calibrateClocks() noexcept
+	{
+		// Sample both clocks as close to each other as possible.
+		GLint64 gpuTimestamp = 0;
+
+		const uint64_t cpuBefore = InputQueue::timestamp();
+		glGetInteger64v(GL_TIMESTAMP, &gpuTimestamp);
+		const uint64_t cpuAfter  = InputQueue::timestamp();
+
+		m_ClockOffset = static_cast<int64_t>(cpuBefore + (cpuAfter - cpuBefore) / 2) - static_cast<int64_t>(gpuTimestamp);
+	}
+
+	const char* LatencyTracker::getStageName(LatencyStage latencyStage) noexcept
+	{
+		switch (latencyStage)
+		{
+			case LatencyStage::InputToUpdate:  return("Input -> Update");
+			case LatencyStage::Update:         return("Update");
+			case LatencyStage::Submit:         return("Submit");
+			case LatencyStage::Swap:           return("Swap");
+			case LatencyStage::GpuComplete:    return("GPU Complete");
+			case LatencyStage::InputToPresent: return("Input -> Present");
+			default:                           return("Unknown");
+		}
+	}
+
+	void LatencyTracker::renderReportUI(bool* isOpened) noexcept
+	{
+		if (!ImGui::Begin("Latency Report", isOpened))
+		{
+			ImGui::End();
+
+			return;
+		}
+
+		ImGui::Text("Frames dropped from tracking: %llu", static_cast<unsigned long long>(m_DroppedFrames));
+
+		if (ImGui::BeginTable("Latency stages", 6, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg))
+		{
+			ImGui::TableSetupColumn("Stage");
+			ImGui::TableSetupColumn("Samples");
+			ImGui::TableSetupColumn("Avg, ms");
+			ImGui::TableSetupColumn("p50, ms");
+			ImGui::TableSetupColumn("p95, ms");
+			ImGui::TableSetupColumn("Max, ms");
+			ImGui::TableHeadersRow();
+
+			for (size_t stageIndex = 0; stageIndex < m_Histograms.size(); ++stageIndex)
+			{
+				const auto& stageHistogram = m_Histograms[stageIndex];
+
+				ImGui::TableNextColumn(); ImGui::Text("%s",    getStageName(static_cast<LatencyStage>(stageIndex)));
+				ImGui::TableNextColumn(); ImGui::Text("%llu",  static_cast<unsigned long long>(stageHistogram.getCount()));
+				ImGui::TableNextColumn(); ImGui::Text("%.2f",  stageHistogram.getAverage());
+				ImGui::TableNextColumn(); ImGui::Text("<%.2f", stageHistogram.getPercentile(0.50));
+				ImGui::TableNextColumn(); ImGui::Text("<%.2f", stageHistogram.getPercentile(0.95));
+				ImGui::TableNextColumn(); ImGui::Text("%.2f",  stageHistogram.getMaximum());
+			}
+
+			ImGui::EndTable();
+		}
+
+		// The distribution of the each stage over the buckets.
+		for (size_t stageIndex = 0; stageIndex < m_Histograms.size(); ++stageIndex)
+		{
+			const auto& buckets = m_Histograms[stageIndex].getBuckets();
+
+			ImGui::PlotHistogram(getStageName(static_cast<LatencyStage>(stageIndex)), buckets.data(), static_cast<int>(buckets.size()), 0, nullptr, 0.0f, 3.4e38f, ImVec2(0, 40));
+		}
+
+		if (ImGui::Button("Reset"))
+			reset();
+
+		ImGui::End();
+	}
+
+	Error LatencyTracker::dumpReport(const char* filename) const noexcept
+	{
+		ofstream reportFile(filename);
+
+		if (!reportFile.is_open())
+		{
+			Logger::m_ApplicationLogger->error("Unable to open the latency report file {}", filename);
+
+			return(Error::ValidationError);
+		}
+
+		// Header: stage statistics followed by the bucket counts.
+		reportFile << "stage,samples,min_ms,avg_ms,p50_ms,p95_ms,p99_ms,max_ms";
+
+		for (const auto bucketBound : LatencyHistogram::BucketBounds)
+			reportFile << ",le_" << bucketBound;
+
+		reportFile << ",le_inf\n";
+
+		for (size_t stageIndex = 0; stageIndex < m_Histograms.size(); ++stageIndex)
+		{
+			const auto& stageHistogram = m_Histograms[stageIndex];
+
+			reportFile << getStageName(static_cast<LatencyStage>(stageIndex)) << ','
+				<< stageHistogram.getCount()   << ','
+				<< stageHistogram.getMinimum() << ','
+				<< stageHistogram.getAverage() << ','
+				<< stageHistogram.getPercentile(0.50) << ','
+				<< stageHistogram.getPercentile(0.95) << ','
+				<< stageHistogram.getPercentile(0.99) << ','
+				<< stageHistogram.getMaximum();
+
+			for (const auto bucketCount : stageHistogram.getBuckets())
+				reportFile << ',' << static_cast<uint64_t>(bucketCount);
+
+			reportFile << '\n';
+		}
+
+		Logger::m_ApplicationLogger->info("Latency report is written to {}", filename);
+
+		return(Error::Ok);
+	}
+}
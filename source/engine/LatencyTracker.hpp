@@ -0,0 +1,162 @@
+// This file declares the `LatencyTracker` class.
+#pragma once
+
+#include "_EngineIncludes.hpp"
+
+#include "array"
+
+// This namespace is polluted with code for the game engine
+namespace Engine
+{
+	// The stages that the input event passes on its way to the screen.
+	enum class LatencyStage : uint8_t
+	{
+		InputToUpdate,  // the event waits in the input queue until the update starts
+		Update,         // the game logic and the scene submission(::onUserUpdate)
+		Submit,         // the engine submission(ImGui) up to the buffer swap
+		Swap,           // the glfwSwapBuffers call(blocks on vsync)
+		GpuComplete,    // from the end of submission until the GPU finished the frame
+		InputToPresent, // the total estimated input-to-photon latency
+		Count,
+	};
+
+	// The fixed bucket histogram of the latency samples(in milliseconds).
+	class LatencyHistogram
+	{
+	public:
+		// The upper bounds of the buckets, the last bucket is unbounded.
+		static constexpr const std::array<double, 12> BucketBounds = { 0.25, 0.5, 1.0, 2.0, 4.0, 8.0, 16.7, 33.3, 50.0, 100.0, 250.0, 1000.0 };
+		static constexpr const size_t                 BucketsTotal = BucketBounds.size() + 1;
+
+		// Add the sample(in milliseconds).
+		void record(double milliseconds) noexcept;
+
+		// Estimate the percentile value(the upper bound of the bucket that contains it).
+		double getPercentile(double percentile) const noexcept;
+
+		// Forget all the samples.
+		void reset() noexcept;
+
+		inline uint64_t getCount()   const noexcept { return(m_Count); }
+		inline double   getMinimum() const noexcept { return(m_Count > 0 ? m_Minimum : 0.0); }
+		inline double   getMaximum() const noexcept { return(m_Maximum); }
+		inline double   getAverage() const noexcept { return(m_Count > 0 ? m_Sum / static_cast<double>(m_Count) : 0.0); }
+
+		inline const std::array<float, BucketsTotal>& getBuckets() const noexcept
+		{
+			return(m_Buckets);
+		}
+
+	private:
+		std::array<float, BucketsTotal> m_Buckets = {};
+
+		uint64_t m_Count   = 0;
+		double   m_Sum     = 0.0;
+		double   m_Minimum = 0.0;
+		double   m_Maximum = 0.0;
+	};
+
+	// This class follows the input events through the frame pipeline: the update, the
+	// render submission, the buffer swap and the GPU execution(measured with the GL
+	// timestamp queries, the fences are used to find out when the results are ready
+	// without stalling the pipeline). The per-stage latencies are gathered into the histograms.
+	class LatencyTracker
+	{
+	private:
+		LatencyTracker() = default;
+
+	public:
+		LatencyTracker(const LatencyTracker&)            = delete;
+		LatencyTracker& operator=(const LatencyTracker&) = delete;
+
+		// This function is the way to realize the Singleton OOP programming pattern,
+		// so that this class can only be instantiated only once.
+		static LatencyTracker& instance()
+		{
+			static LatencyTracker _instance;
+			return(_instance);
+		}
+
+	public:
+		// The file the report is written to by default.
+		static constexpr const char* DefaultReportRelPath = "logs/latency_report.csv";
+
+		// Create the GL query objects, requires the current OpenGL context.
+		void initialize() noexcept;
+
+		// Destroy the GL query objects and fences.
+		void release() noexcept;
+
+		// Start tracking the frame, the timestamp of the oldest input event consumed by
+		// this frame is passed(or zero if there was no input).
+		void beginFrame(uint64_t oldestInputTimestamp) noexcept;
+
+		// Mark the end of the ::onUserUpdate.
+		void markUpdateEnd() noexcept;
+
+		// Mark the end of the render submission, issues the GPU timestamp query and the fence.
+		void markSubmitEnd() noexcept;
+
+		// Mark the return from the glfwSwapBuffers.
+		void markSwapEnd() noexcept;
+
+		// Get the histogram of the stage.
+		inline const LatencyHistogram& getHistogram(LatencyStage latencyStage) const noexcept
+		{
+			return(m_Histograms[static_cast<size_t>(latencyStage)]);
+		}
+
+		// Forget all the gathered samples.
+		void reset() noexcept;
+
+		// Render the report window with the Dear ImGui(must be called between the ImGui::NewFrame/EndFrame).
+		void renderReportUI(bool* isOpened) noexcept;
+
+		// Write the report(CSV, one row per stage) into the file.
+		Error dumpReport(const char* filename = DefaultReportRelPath) const noexcept;
+
+		// Get the human readable name of the stage.
+		static const char* getStageName(LatencyStage latencyStage) noexcept;
+
+	private:
+		// The frames that are in flight at the same time.
+		static constexpr const size_t FramesInFlight = 4;
+
+		// The timestamps(nanoseconds, ::InputQueue::timestamp clock) of the single frame.
+		struct FrameRecord
+		{
+			bool     isPending      = false;
+			uint64_t inputTimestamp = 0;
+			uint64_t updateBegin    = 0;
+			uint64_t updateEnd      = 0;
+			uint64_t submitEnd      = 0;
+			uint64_t swapEnd        = 0;
+			GLuint   timestampQuery = 0;
+			GLsync   completionFence = nullptr;
+		};
+
+		// Gather the frames that the GPU has already finished.
+		void collectFinishedFrames() noexcept;
+
+		// Re-estimate the offset between the GPU and the CPU clocks.
+		void calibrateClocks() noexcept;
+
+		inline LatencyHistogram& histogram(LatencyStage latencyStage) noexcept
+		{
+			return(m_Histograms[static_cast<size_t>(latencyStage)]);
+		}
+
+	private:
+		bool m_IsInitialized = false;
+
+		std::array<FrameRecord, FramesInFlight> m_Frames;
+		size_t                                  m_CurrentFrame = 0;
+		uint64_t                                m_FrameCounter = 0;
+		uint64_t                                m_DroppedFrames = 0;
+
+		// CPU time minus the GPU time(nanoseconds).
+		int64_t m_ClockOffset = 0;
+
+		std::array<LatencyHistogram, static_cast<size_t>(LatencyStage::Count)> m_Histograms;
+	};
+}
@@ -3,6 +3,9 @@
 
 using namespace std;
 
+// The queue and the thread are declared before the loggers, so they are destroyed after them.
+shared_ptr<spdlog::details::thread_pool> Engine::Logger::m_ThreadPool;
+
 // Initialize the static sinks that was declared in the `Logger` class.
 shared_ptr<spdlog::sinks::basic_file_sink_mt> Engine::Logger::m_ApplicationSink;
 shared_ptr<spdlog::sinks::basic_file_sink_mt> Engine::Logger::m_GraphicsSink;
@@ -22,7 +25,7 @@ static constexpr const char* LOGGER_GAM_LOGFILE = "logs/game.log";
 
 namespace Engine
 {
-	void Logger::initialize()
+	void Logger::initialize(const LoggerConfig& loggerConfig)
 	{
 		// Bind the sinks to the corresponding files.
 		m_ApplicationSink = make_shared<spdlog::sinks::basic_file_sink_mt>(LOGGER_APP_LOGFILE);
@@ -44,17 +47,68 @@ namespace Engine
 		gameSink.push_back(m_GeneralSink);
 		gameSink.push_back(m_GameSink);
 
+		// All the loggers are sharing the single queue and the single writer thread, so
+		// the shared `general` sink is never written from the two threads at once.
+		if (loggerConfig.isAsynchronous)
+			m_ThreadPool = make_shared<spdlog::details::thread_pool>(loggerConfig.queueCapacity, 1);
+
 		// Create the loggers and assign theirs names.
-		m_ApplicationLogger = make_unique<spdlog::logger>("Application General",  applicationSinks.begin(), applicationSinks.end());
-		m_GraphicsLogger    = make_unique<spdlog::logger>("Graphics General",     graphicsSink.begin(),     graphicsSink.end());
-		m_ResourceLogger    = make_unique<spdlog::logger>("Resource Manager",     graphicsSink.begin(),     graphicsSink.end());
-		m_GameLogger        = make_unique<spdlog::logger>("Game General",         gameSink.begin(),         gameSink.end());
-
-		// Set the logging level for each logger(the trace level means that
-		// we are printing all the messages into the sink).
-		m_ApplicationLogger -> set_level(spdlog::level::trace);
-		m_GraphicsLogger    -> set_level(spdlog::level::trace);
-		m_ResourceLogger    -> set_level(spdlog::level::trace);
-		m_GameLogger        -> set_level(spdlog::level::trace);
+		m_ApplicationLogger = makeLogger("Application General", applicationSinks, loggerConfig);
+		m_GraphicsLogger    = makeLogger("Graphics General",    graphicsSink,     loggerConfig);
+		m_ResourceLogger    = makeLogger("Resource Manager",    graphicsSink,     loggerConfig);
+		m_GameLogger        = makeLogger("Game General",        gameSink,         loggerConfig);
+	}
+
+	void Logger::release()
+	{
+		const size_t droppedCount = getDroppedCount();
+
+		if (droppedCount > 0)
+			m_ApplicationLogger->warn("{} log messages were dropped because the logger queue was full", droppedCount);
+
+		for (auto& logger : { m_ApplicationLogger, m_GraphicsLogger, m_ResourceLogger, m_GameLogger })
+		{
+			if (logger != nullptr)
+				logger->flush();
+		}
+
+		// The thread pool destructor processes the queued messages and joins the writer thread.
+		m_ApplicationLogger.reset();
+		m_GraphicsLogger   .reset();
+		m_ResourceLogger   .reset();
+		m_GameLogger       .reset();
+		m_ThreadPool       .reset();
+	}
+
+	size_t Logger::getDroppedCount()
+	{
+		return(m_ThreadPool != nullptr ? m_ThreadPool->overrun_counter() : 0);
+	}
+
+	shared_ptr<spdlog::logger> Logger::makeLogger(const char* loggerName, const vector<spdlog::sink_ptr>& loggerSinks, const LoggerConfig& loggerConfig)
+	{
+		shared_ptr<spdlog::logger> logger;
+
+		if (m_ThreadPool != nullptr)
+		{
+			const auto overflowPolicy = loggerConfig.overflowPolicy == LogOverflowPolicy::Block
+				? spdlog::async_overflow_policy::block
+				: spdlog::async_overflow_policy::overrun_oldest;
+
+			logger = make_shared<spdlog::async_logger>(loggerName, loggerSinks.begin(), loggerSinks.end(), m_ThreadPool, overflowPolicy);
+		}
+		else
+		{
+			logger = make_shared<spdlog::logger>(loggerName, loggerSinks.begin(), loggerSinks.end());
+		}
+
+		// Set the logging level for each logger(the trace level means that we are printing
+		// all the messages into the sink, the stripped levels would never arrive anyway).
+		logger->set_level(static_cast<spdlog::level::level_enum>(ENGINE_LOG_ACTIVE_LEVEL));
+
+		// The errors are written out as soon as possible, so they survive the crash.
+		logger->flush_on(spdlog::level::err);
+
+		return(logger);
 	}
 }
@@ -3,19 +3,97 @@
 
 #include "_EngineIncludes.hpp"
 
+#include "spdlog/async.h"
+#include "spdlog/async_logger.h"
+
+// The log levels(matching the spdlog ones) for the compile-time level stripping.
+#define ENGINE_LOG_LEVEL_TRACE    0
+#define ENGINE_LOG_LEVEL_DEBUG    1
+#define ENGINE_LOG_LEVEL_INFO     2
+#define ENGINE_LOG_LEVEL_WARN     3
+#define ENGINE_LOG_LEVEL_ERROR    4
+#define ENGINE_LOG_LEVEL_CRITICAL 5
+
+// The calls below this level are removed by the preprocessor(arguments are not evaluated too),
+// the release builds are keeping the info level and above.
+#ifndef ENGINE_LOG_ACTIVE_LEVEL
+	#ifdef NDEBUG
+		#define ENGINE_LOG_ACTIVE_LEVEL ENGINE_LOG_LEVEL_INFO
+	#else
+		#define ENGINE_LOG_ACTIVE_LEVEL ENGINE_LOG_LEVEL_TRACE
+	#endif
+#endif
+
+#if ENGINE_LOG_ACTIVE_LEVEL <= ENGINE_LOG_LEVEL_TRACE
+	#define ENGINE_LOG_TRACE(logger, ...) Engine::Logger::logger->trace(__VA_ARGS__)
+#else
+	#define ENGINE_LOG_TRACE(logger, ...) (void)0
+#endif
+
+#if ENGINE_LOG_ACTIVE_LEVEL <= ENGINE_LOG_LEVEL_DEBUG
+	#define ENGINE_LOG_DEBUG(logger, ...) Engine::Logger::logger->debug(__VA_ARGS__)
+#else
+	#define ENGINE_LOG_DEBUG(logger, ...) (void)0
+#endif
+
+#if ENGINE_LOG_ACTIVE_LEVEL <= ENGINE_LOG_LEVEL_INFO
+	#define ENGINE_LOG_INFO(logger, ...) Engine::Logger::logger->info(__VA_ARGS__)
+#else
+	#define ENGINE_LOG_INFO(logger, ...) (void)0
+#endif
+
+#if ENGINE_LOG_ACTIVE_LEVEL <= ENGINE_LOG_LEVEL_WARN
+	#define ENGINE_LOG_WARN(logger, ...) Engine::Logger::logger->warn(__VA_ARGS__)
+#else
+	#define ENGINE_LOG_WARN(logger, ...) (void)0
+#endif
+
+#define ENGINE_LOG_ERROR(logger, ...)    Engine::Logger::logger->error(__VA_ARGS__)
+#define ENGINE_LOG_CRITICAL(logger, ...) Engine::Logger::logger->critical(__VA_ARGS__)
+
 // This namespace is polluted with code for the game engine
 namespace Engine
 {
-	// The `Logger` class responsible for simplification of tracing the 
-	// program errors. It provides the API for writing formatted log 
+	// What happens with the message when the asynchronous queue is full.
+	enum class LogOverflowPolicy : uint8_t
+	{
+		Block,      // the logging thread waits for the free slot(nothing is lost)
+		DropOldest, // the oldest queued message is overwritten and counted as dropped
+	};
+
+	// The logger setup.
+	struct LoggerConfig
+	{
+		// Format and write the messages on the background thread.
+		bool isAsynchronous = true;
+
+		// The amount of the messages that the preallocated queue holds.
+		size_t queueCapacity = 8192;
+
+		LogOverflowPolicy overflowPolicy = LogOverflowPolicy::DropOldest;
+	};
+
+	// The `Logger` class responsible for simplification of tracing the
+	// program errors. It provides the API for writing formatted log
 	// messages to the files(every logger logs into the specific file,
 	// for instance `application_logs.log` and the global `general.log`
 	// file).
+	//
+	// In the asynchronous mode the messages are pushed into the bounded ring buffer
+	// and the files are written by the single background thread, so the frame never
+	// waits for the disk. Use the ENGINE_LOG_* macros on the hot paths, so the verbose
+	// messages are stripped from the release builds at compile time.
 	class Logger
 	{
 	public:
 		// Initialize the memory that is used by the logger sinks and loggers itself
-		static void initialize();
+		static void initialize(const LoggerConfig& loggerConfig = LoggerConfig{});
+
+		// Flush the queued messages and stop the background thread.
+		static void release();
+
+		// Get the amount of the messages that were dropped because the queue was full.
+		static size_t getDroppedCount();
 
 		// Declare different types of loggers.
 		static std::shared_ptr<spdlog::logger> m_ApplicationLogger;
@@ -24,10 +102,16 @@ namespace Engine
 		static std::shared_ptr<spdlog::logger> m_GameLogger;
 
 	private:
+		// Create the logger that is writing into the sinks.
+		static std::shared_ptr<spdlog::logger> makeLogger(const char* loggerName, const std::vector<spdlog::sink_ptr>& loggerSinks, const LoggerConfig& loggerConfig);
+
+		// The queue and the thread of the asynchronous mode.
+		static std::shared_ptr<spdlog::details::thread_pool> m_ThreadPool;
+
 		// Declare different types of logger sinks.
 		static std::shared_ptr<spdlog::sinks::basic_file_sink_mt> m_ApplicationSink;
 		static std::shared_ptr<spdlog::sinks::basic_file_sink_mt> m_GraphicsSink;
 		static std::shared_ptr<spdlog::sinks::basic_file_sink_mt> m_GeneralSink;
 		static std::shared_ptr<spdlog::sinks::basic_file_sink_mt> m_GameSink;
 	};
-}
\ No newline at end of file
+}
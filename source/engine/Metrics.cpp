@@ -0,0 +1,289 @@
+// This file implements the `MetricsRegistry` class and the metric types.
+#include "Metrics.hpp"
+#include "InputQueue.hpp"
+#include "Logger.hpp"
+
+#include "algorithm"
+
+using namespace std;
+
+// The quantiles that are exported for the histograms.
+static constexpr const array<double, 3> _METRICS_QUANTILES = { 0.5, 0.95, 0.99 };
+
+// The next shard that is handed to the new thread.
+static atomic<size_t> _METRICS_NEXT_SHARD = 0;
+
+// Find the metric with the name, or create it.
+template<typename Metric>
+static Metric& findOrCreate(vector<unique_ptr<Metric>>& metrics, string_view name, string_view help)
+{
+	for (auto& metric : metrics)
+		if (metric->getName() == name)
+			return(*metric);
+
+	metrics.push_back(make_unique<Metric>(name, help));
+
+	return(*metrics.back());
+}
+
+namespace Engine
+{
+	uint64_t Counter::getValue() const noexcept
+	{
+		uint64_t counterValue = 0;
+
+		for (const auto& counterShard : m_Shards)
+			counterValue += counterShard.value.load(memory_order_relaxed);
+
+		return(counterValue);
+	}
+
+	size_t Counter::getShardIndex() noexcept
+	{
+		static thread_local const size_t shardIndex = std::min(_METRICS_NEXT_SHARD.fetch_add(1, memory_order_relaxed), SharedShard);
+
+		return(shardIndex);
+	}
+
+	void Gauge::add(double amount) noexcept
+	{
+		double gaugeValue = m_Value.load(memory_order_relaxed);
+
+		while (!m_Value.compare_exchange_weak(gaugeValue, gaugeValue + amount, memory_order_relaxed))
+			;
+	}
+
+	uint64_t Histogram::getCount() const noexcept
+	{
+		uint64_t sampleCount = 0;
+
+		for (const auto& bucket : m_Buckets)
+			sampleCount += bucket.load(memory_order_relaxed);
+
+		return(sampleCount);
+	}
+
+	uint64_t Histogram::getPercentile(double percentile) const noexcept
+	{
+		const uint64_t sampleCount = getCount();
+
+		if (sampleCount == 0)
+			return(0);
+
+		const uint64_t targetCount  = static_cast<uint64_t>(percentile * static_cast<double>(sampleCount));
+		uint64_t       runningCount = 0;
+
+		for (size_t bucketIndex = 0; bucketIndex < BucketsTotal; ++bucketIndex)
+		{
+			runningCount += m_Buckets[bucketIndex].load(memory_order_relaxed);
+
+			if (runningCount > targetCount)
+			{
+				const uint64_t lowerBound = getBucketLowerBound(bucketIndex);
+				const uint64_t upperBound = bucketIndex + 1 < BucketsTotal ? getBucketLowerBound(bucketIndex + 1) : lowerBound;
+
+				return(std::min(lowerBound + (upperBound - lowerBound) / 2, getMaximum()));
+			}
+		}
+
+		return(getMaximum());
+	}
+
+	Counter& MetricsRegistry::counter(string_view name, string_view help)
+	{
+		lock_guard<mutex> metricsLock(m_MetricsMutex);
+
+		return(findOrCreate(m_Counters, name, help));
+	}
+
+	Gauge& MetricsRegistry::gauge(string_view name, string_view help)
+	{
+		lock_guard<mutex> metricsLock(m_MetricsMutex);
+
+		return(findOrCreate(m_Gauges, name, help));
+	}
+
+	Histogram& MetricsRegistry::histogram(string_view name, string_view help)
+	{
+		lock_guard<mutex> metricsLock(m_MetricsMutex);
+
+		return(findOrCreate(m_Histograms, name, help));
+	}
+
+	Error MetricsRegistry::startDump(const char* filename, double periodSeconds) noexcept
+	{
+		if (m_DumpFile != nullptr)
+			stopDump();
+
+		m_DumpFile = fopen(filename, "w");
+
+		if (m_DumpFile == nullptr)
+		{
+			Logger::m_ApplicationLogger->error("Unable to open the metrics dump file {}", filename);
+
+			return(Error::InitializationError);
+		}
+
+		fputs("time_s,metric,type,value,count,p50,p95,p99,max\n", m_DumpFile);
+
+		m_DumpPeriod     = static_cast<uint64_t>(periodSeconds * 1e9);
+		m_StartTimestamp = InputQueue::timestamp();
+		m_DumpTimestamp  = m_StartTimestamp;
+
+		Logger::m_ApplicationLogger->info("Dumping the metrics into {} every {} seconds", filename, periodSeconds);
+
+		return(Error::Ok);
+	}
+
+	void MetricsRegistry::stopDump() noexcept
+	{
+		if (m_DumpFile == nullptr)
+			return;
+
+		writeSnapshot();
+
+		fclose(m_DumpFile);
+		m_DumpFile = nullptr;
+	}
+
+	void MetricsRegistry::update() noexcept
+	{
+		if (m_DumpFile == nullptr)
+			return;
+
+		const uint64_t currentTimestamp = InputQueue::timestamp();
+
+		if (currentTimestamp - m_DumpTimestamp < m_DumpPeriod)
+			return;
+
+		m_DumpTimestamp = currentTimestamp;
+
+		writeSnapshot();
+	}
+
+	void MetricsRegistry::writeSnapshot() noexcept
+	{
+		const double snapshotTime = static_cast<double>(InputQueue::timestamp() - m_StartTimestamp) * 1e-9;
+
+		lock_guard<mutex> metricsLock(m_MetricsMutex);
+
+		for (const auto& counter : m_Counters)
+			fprintf(m_DumpFile, "%.3f,%s,counter,%llu,,,,,\n", snapshotTime, counter->getName().c_str(), static_cast<unsigned long long>(counter->getValue()));
+
+		for (const auto& gauge : m_Gauges)
+			fprintf(m_DumpFile, "%.3f,%s,gauge,%g,,,,,\n", snapshotTime, gauge->getName().c_str(), gauge->getValue());
+
+		// The histogram values are written in seconds.
+		for (const auto& histogram : m_Histograms)
+		{
+			fprintf(m_DumpFile, "%.3f,%s,histogram,%.9f,%llu,%.9f,%.9f,%.9f,%.9f\n",
+				snapshotTime,
+				histogram->getName().c_str(),
+				static_cast<double>(histogram->getSum()) * 1e-9,
+				static_cast<unsigned long long>(histogram->getCount()),
+				static_cast<double>(histogram->getPercentile(0.50)) * 1e-9,
+				static_cast<double>(histogram->getPercentile(0.95)) * 1e-9,
+				static_cast<double>(histogram->getPercentile(0.99)) * 1e-9,
+				static_cast<double>(histogram->getMaximum())        * 1e-9);
+		}
+
+		fflush(m_DumpFile);
+	}
+
+	string MetricsRegistry::formatPrometheus()
+	{
+		string metricsText;
+
+		auto appendHeader = [&metricsText](const string& name, const string& help, const char* type)
+		{
+			metricsText += fmt::format("# HELP {} {}\n# TYPE {} {}\n", name, help, name, type);
+		};
+
+		lock_guard<mutex> metricsLock(m_MetricsMutex);
+
+		for (const auto& counter : m_Counters)
+		{
+			appendHeader(counter->getName(), counter->getHelp(), "counter");
+			metricsText += fmt::format("{} {}\n", counter->getName(), counter->getValue());
+		}
+
+		for (const auto& gauge : m_Gauges)
+		{
+			appendHeader(gauge->getName(), gauge->getHelp(), "gauge");
+			metricsText += fmt::format("{} {}\n", gauge->getName(), gauge->getValue());
+		}
+
+		// The histograms are exported as the summaries(the HDR buckets are too many for
+		// the Prometheus buckets), the values are in seconds.
+		for (const auto& histogram : m_Histograms)
+		{
+			appendHeader(histogram->getName(), histogram->getHelp(), "summary");
+
+			for (const double quantile : _METRICS_QUANTILES)
+				metricsText += fmt::format("{}{{quantile=\"{}\"}} {:.9f}\n", histogram->getName(), quantile, static_cast<double>(histogram->getPercentile(quantile)) * 1e-9);
+
+			metricsText += fmt::format("{}_sum {:.9f}\n", histogram->getName(), static_cast<double>(histogram->getSum()) * 1e-9);
+			metricsText += fmt::format("{}_count {}\n",   histogram->getName(), histogram->getCount());
+		}
+
+		return(metricsText);
+	}
+
+	void MetricsRegistry::renderMetricsUI(bool* isOpened) noexcept
+	{
+		if (!ImGui::Begin("Metrics", isOpened))
+		{
+			ImGui::End();
+
+			return;
+		}
+
+		lock_guard<mutex> metricsLock(m_MetricsMutex);
+
+		if (ImGui::BeginTable("Counters and gauges", 2, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg))
+		{
+			ImGui::TableSetupColumn("Metric");
+			ImGui::TableSetupColumn("Value");
+			ImGui::TableHeadersRow();
+
+			for (const auto& counter : m_Counters)
+			{
+				ImGui::TableNextColumn(); ImGui::Text("%s",   counter->getName().c_str());
+				ImGui::TableNextColumn(); ImGui::Text("%llu", static_cast<unsigned long long>(counter->getValue()));
+			}
+
+			for (const auto& gauge : m_Gauges)
+			{
+				ImGui::TableNextColumn(); ImGui::Text("%s", gauge->getName().c_str());
+				ImGui::TableNextColumn(); ImGui::Text("%g", gauge->getValue());
+			}
+
+			ImGui::EndTable();
+		}
+
+		if (ImGui::BeginTable("Histograms", 6, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg))
+		{
+			ImGui::TableSetupColumn("Histogram");
+			ImGui::TableSetupColumn("Count");
+			ImGui::TableSetupColumn("p50, ms");
+			ImGui::TableSetupColumn("p95, ms");
+			ImGui::TableSetupColumn("p99, ms");
+			ImGui::TableSetupColumn("Max, ms");
+			ImGui::TableHeadersRow();
+
+			for (const auto& histogram : m_Histograms)
+			{
+				ImGui::TableNextColumn(); ImGui::Text("%s",   histogram->getName().c_str());
+				ImGui::TableNextColumn(); ImGui::Text("%llu", static_cast<unsigned long long>(histogram->getCount()));
+				ImGui::TableNextColumn(); ImGui::Text("%.3f", static_cast<double>(histogram->getPercentile(0.50)) * 1e-6);
+				ImGui::TableNextColumn(); ImGui::Text("%.3f", static_cast<double>(histogram->getPercentile(0.95)) * 1e-6);
+				ImGui::TableNextColumn(); ImGui::Text("%.3f", static_cast<double>(histogram->getPercentile(0.99)) * 1e-6);
+				ImGui::TableNextColumn(); ImGui::Text("%.3f", static_cast<double>(histogram->getMaximum())        * 1e-6);
+			}
+
+			ImGui::EndTable();
+		}
+
+		ImGui::End();
+	}
+}
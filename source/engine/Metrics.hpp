@@ -0,0 +1,231 @@
+// This file declares the `MetricsRegistry` class and the metric types.
+//
+// The metrics are registered once(the call site keeps the reference) and updated with
+// the relaxed atomic operations only:
+//
+//   static auto& drawCalls = Engine::MetricsRegistry::instance().counter("engine_draw_calls_total", "The issued draw calls");
+//   drawCalls.increment();
+#pragma once
+
+#include "_EngineIncludes.hpp"
+
+#include "bit"
+#include "array"
+#include "mutex"
+#include "atomic"
+#include "memory"
+#include "string"
+#include "vector"
+#include "cstdio"
+#include "string_view"
+
+// This namespace is polluted with code for the game engine
+namespace Engine
+{
+	// The monotonically increasing value. The value is split into the per-thread shards, so
+	// the threads that are updating the same counter are not fighting for the cache line.
+	class Counter
+	{
+	public:
+		// The amount of the shards. The first threads own theirs shards exclusively(the
+		// increment is the plain load and store), the rest share the last one.
+		static constexpr const size_t ShardsTotal = 16;
+		static constexpr const size_t SharedShard = ShardsTotal - 1;
+
+		Counter(std::string_view name, std::string_view help) : m_Name(name), m_Help(help)
+		{
+		}
+
+		inline void increment(uint64_t amount = 1) noexcept
+		{
+			const size_t shardIndex = getShardIndex();
+			auto&        shardValue = m_Shards[shardIndex].value;
+
+			if (shardIndex != SharedShard)
+				shardValue.store(shardValue.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+			else
+				shardValue.fetch_add(amount, std::memory_order_relaxed);
+		}
+
+		// Sum up all the shards.
+		uint64_t getValue() const noexcept;
+
+		inline const std::string& getName() const noexcept { return(m_Name); }
+		inline const std::string& getHelp() const noexcept { return(m_Help); }
+
+	private:
+		struct alignas(64) CounterShard
+		{
+			std::atomic<uint64_t> value = 0;
+		};
+
+		// Get the shard of the calling thread.
+		static size_t getShardIndex() noexcept;
+
+	private:
+		std::array<CounterShard, ShardsTotal> m_Shards;
+
+		std::string m_Name;
+		std::string m_Help;
+	};
+
+	// The value that goes up and down(the last written one wins).
+	class Gauge
+	{
+	public:
+		Gauge(std::string_view name, std::string_view help) : m_Name(name), m_Help(help)
+		{
+		}
+
+		inline void set(double value) noexcept
+		{
+			m_Value.store(value, std::memory_order_relaxed);
+		}
+
+		void add(double amount) noexcept;
+
+		inline double getValue() const noexcept
+		{
+			return(m_Value.load(std::memory_order_relaxed));
+		}
+
+		inline const std::string& getName() const noexcept { return(m_Name); }
+		inline const std::string& getHelp() const noexcept { return(m_Help); }
+
+	private:
+		std::atomic<double> m_Value = 0.0;
+
+		std::string m_Name;
+		std::string m_Help;
+	};
+
+	// The HDR-style latency histogram(nanoseconds). The bucket is picked by the highest set
+	// bit of the value and the next ::SubBucketBits bits below it, so the relative error is
+	// below 1/16 over the whole range of the 64-bit values, and recording is the bucket
+	// and the sum increments only.
+	class Histogram
+	{
+	public:
+		static constexpr const uint32_t SubBucketBits  = 4;
+		static constexpr const uint32_t SubBucketCount = 1u << SubBucketBits;
+		static constexpr const size_t   BucketsTotal   = (64 - SubBucketBits + 1) * SubBucketCount;
+
+		Histogram(std::string_view name, std::string_view help) : m_Name(name), m_Help(help)
+		{
+		}
+
+		inline void record(uint64_t nanoseconds) noexcept
+		{
+			m_Buckets[getBucketIndex(nanoseconds)].fetch_add(1, std::memory_order_relaxed);
+			m_Sum.fetch_add(nanoseconds, std::memory_order_relaxed);
+
+			uint64_t maximum = m_Maximum.load(std::memory_order_relaxed);
+
+			while (nanoseconds > maximum && !m_Maximum.compare_exchange_weak(maximum, nanoseconds, std::memory_order_relaxed))
+				;
+		}
+
+		// Estimate the percentile value(the middle of the bucket that contains it).
+		uint64_t getPercentile(double percentile) const noexcept;
+
+		// Get the amount of the samples(the sum of the buckets, so the recording is cheaper).
+		uint64_t getCount() const noexcept;
+
+		inline uint64_t getSum()     const noexcept { return(m_Sum    .load(std::memory_order_relaxed)); }
+		inline uint64_t getMaximum() const noexcept { return(m_Maximum.load(std::memory_order_relaxed)); }
+
+		inline const std::string& getName() const noexcept { return(m_Name); }
+		inline const std::string& getHelp() const noexcept { return(m_Help); }
+
+		// Get the bucket of the value.
+		static constexpr size_t getBucketIndex(uint64_t value) noexcept
+		{
+			if (value < SubBucketCount)
+				return(static_cast<size_t>(value));
+
+			const uint32_t exponent = static_cast<uint32_t>(std::bit_width(value)) - 1;
+			const uint64_t subIndex = (value >> (exponent - SubBucketBits)) & (SubBucketCount - 1);
+
+			return(static_cast<size_t>((exponent - SubBucketBits + 1) * SubBucketCount + subIndex));
+		}
+
+		// Get the smallest value of the bucket.
+		static constexpr uint64_t getBucketLowerBound(size_t bucketIndex) noexcept
+		{
+			if (bucketIndex < SubBucketCount)
+				return(bucketIndex);
+
+			const uint32_t exponent = static_cast<uint32_t>(bucketIndex / SubBucketCount) + SubBucketBits - 1;
+			const uint64_t subIndex = bucketIndex % SubBucketCount;
+
+			return((SubBucketCount + subIndex) << (exponent - SubBucketBits));
+		}
+
+	private:
+		std::array<std::atomic<uint64_t>, BucketsTotal> m_Buckets = {};
+
+		std::atomic<uint64_t> m_Sum     = 0;
+		std::atomic<uint64_t> m_Maximum = 0;
+
+		std::string m_Name;
+		std::string m_Help;
+	};
+
+	// This class owns all the metrics of the engine and the game, and exports them into the
+	// ImGui window, the periodic CSV dump and the Prometheus text format(see ::MetricsServer).
+	class MetricsRegistry
+	{
+	private:
+		MetricsRegistry() = default;
+
+	public:
+		MetricsRegistry(const MetricsRegistry&)            = delete;
+		MetricsRegistry& operator=(const MetricsRegistry&) = delete;
+
+		// This function is the way to realize the Singleton OOP programming pattern,
+		// so that this class can only be instantiated only once.
+		static MetricsRegistry& instance()
+		{
+			static MetricsRegistry _instance;
+			return(_instance);
+		}
+
+	public:
+		// Get the metric with the name, it is created on the first call. The reference stays
+		// valid until the program exits, so the call sites are keeping it.
+		Counter&   counter  (std::string_view name, std::string_view help);
+		Gauge&     gauge    (std::string_view name, std::string_view help);
+		Histogram& histogram(std::string_view name, std::string_view help);
+
+		// Start appending the snapshot of all the metrics into the CSV file every `periodSeconds`.
+		Error startDump(const char* filename, double periodSeconds) noexcept;
+
+		// Write the final snapshot and close the dump file.
+		void stopDump() noexcept;
+
+		// Write the snapshot when the dump period is over(called once per frame).
+		void update() noexcept;
+
+		// Format all the metrics in the Prometheus text exposition format.
+		std::string formatPrometheus();
+
+		// Render the metrics window with the Dear ImGui(must be called between the ImGui::NewFrame/EndFrame).
+		void renderMetricsUI(bool* isOpened) noexcept;
+
+	private:
+		// Append the snapshot to the dump file.
+		void writeSnapshot() noexcept;
+
+	private:
+		// The metrics are never removed, so the references are never invalidated.
+		std::mutex                              m_MetricsMutex;
+		std::vector<std::unique_ptr<Counter>>   m_Counters;
+		std::vector<std::unique_ptr<Gauge>>     m_Gauges;
+		std::vector<std::unique_ptr<Histogram>> m_Histograms;
+
+		FILE*    m_DumpFile         = nullptr;
+		uint64_t m_DumpPeriod       = 0;
+		uint64_t m_DumpTimestamp    = 0;
+		uint64_t m_StartTimestamp   = 0;
+	};
+}
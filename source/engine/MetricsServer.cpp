@@ -0,0 +1,221 @@
+// This file implements the `MetricsServer` class.
+
+// The sockets API has to be included before anything pulls the <windows.h> in.
+#ifdef _WIN32
+	#include "winsock2.h"
+	#include "ws2tcpip.h"
+
+	using SocketHandle = SOCKET;
+
+	static constexpr const SocketHandle _METRICS_INVALID_SOCKET = INVALID_SOCKET;
+
+	static constexpr const int _METRICS_SEND_FLAGS = 0;
+
+	static inline void closeSocket(SocketHandle socketHandle)
+	{
+		closesocket(socketHandle);
+	}
+#else
+	#include "unistd.h"
+	#include "sys/time.h"
+	#include "sys/socket.h"
+	#include "sys/select.h"
+	#include "netinet/in.h"
+
+	using SocketHandle = int;
+
+	static constexpr const SocketHandle _METRICS_INVALID_SOCKET = -1;
+
+	// Do not raise the SIGPIPE when the scraper drops the connection.
+	static constexpr const int _METRICS_SEND_FLAGS = MSG_NOSIGNAL;
+
+	static inline void closeSocket(SocketHandle socketHandle)
+	{
+		close(socketHandle);
+	}
+#endif
+
+#include "MetricsServer.hpp"
+#include "Metrics.hpp"
+#include "Logger.hpp"
+
+#include "string"
+
+using namespace std;
+
+// The largest request that is read(the scrapers send the short GET requests).
+static constexpr const size_t _METRICS_MAX_REQUEST_SIZE = 4096;
+
+// How often the server thread checks if it has to stop.
+static constexpr const long _METRICS_POLL_MICROSECONDS = 250000;
+
+// Send the whole buffer.
+static bool sendAll(SocketHandle clientSocket, const string& data)
+{
+	size_t sentBytes = 0;
+
+	while (sentBytes < data.size())
+	{
+		const auto sendResult = send(clientSocket, data.data() + sentBytes, static_cast<int>(data.size() - sentBytes), _METRICS_SEND_FLAGS);
+
+		if (sendResult <= 0)
+			return(false);
+
+		sentBytes += static_cast<size_t>(sendResult);
+	}
+
+	return(true);
+}
+
+namespace Engine
+{
+	Error MetricsServer::start(uint16_t port) noexcept
+	{
+		if (isRunning())
+			return(Error::ValidationError);
+
+#ifdef _WIN32
+		WSADATA socketsData;
+
+		if (WSAStartup(MAKEWORD(2, 2), &socketsData) != 0)
+		{
+			Logger::m_ApplicationLogger->error("Unable to initialize the Windows sockets");
+
+			return(Error::InitializationError);
+		}
+#endif
+
+		const SocketHandle listenSocket = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+
+		if (listenSocket == _METRICS_INVALID_SOCKET)
+		{
+			Logger::m_ApplicationLogger->error("Unable to create the metrics socket");
+
+#ifdef _WIN32
+			WSACleanup();
+#endif
+			return(Error::InitializationError);
+		}
+
+		// Only the local clients are accepted, the metrics are not exposed to the network.
+		sockaddr_in listenAddress = {};
+		listenAddress.sin_family      = AF_INET;
+		listenAddress.sin_port        = htons(port);
+		listenAddress.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+		const int reuseAddress = 1;
+		setsockopt(listenSocket, SOL_SOCKET, SO_REUSEADDR, reinterpret_cast<const char*>(&reuseAddress), sizeof(reuseAddress));
+
+		if (bind  (listenSocket, reinterpret_cast<const sockaddr*>(&listenAddress), sizeof(listenAddress)) != 0 ||
+			listen(listenSocket, 4) != 0)
+		{
+			Logger::m_ApplicationLogger->error("Unable to listen on the metrics port {}", port);
+
+			closeSocket(listenSocket);
+
+#ifdef _WIN32
+			WSACleanup();
+#endif
+			return(Error::InitializationError);
+		}
+
+		m_ListenSocket = static_cast<intptr_t>(listenSocket);
+		m_IsRunning.store(true);
+		m_ServerThread = thread(&MetricsServer::serverLoop, this);
+
+		Logger::m_ApplicationLogger->info("Serving the metrics on http://127.0.0.1:{}/metrics", port);
+
+		return(Error::Ok);
+	}
+
+	void MetricsServer::stop() noexcept
+	{
+		if (!m_IsRunning.exchange(false))
+			return;
+
+		m_ServerThread.join();
+
+		closeSocket(static_cast<SocketHandle>(m_ListenSocket));
+		m_ListenSocket = -1;
+
+#ifdef _WIN32
+		WSACleanup();
+#endif
+	}
+
+	void MetricsServer::serverLoop() noexcept
+	{
+		const SocketHandle listenSocket = static_cast<SocketHandle>(m_ListenSocket);
+
+		while (m_IsRunning.load())
+		{
+			// Wait for the connection with the timeout, so the stop request is noticed.
+			fd_set readSockets;
+			FD_ZERO(&readSockets);
+			FD_SET(listenSocket, &readSockets);
+
+			timeval pollTimeout = { 0, _METRICS_POLL_MICROSECONDS };
+
+			if (select(static_cast<int>(listenSocket) + 1, &readSockets, nullptr, nullptr, &pollTimeout) <= 0)
+				continue;
+
+			const SocketHandle clientSocket = accept(listenSocket, nullptr, nullptr);
+
+			if (clientSocket == _METRICS_INVALID_SOCKET)
+				continue;
+
+			handleClient(static_cast<intptr_t>(clientSocket));
+
+			closeSocket(clientSocket);
+		}
+	}
+
+	void MetricsServer::handleClient(intptr_t clientHandle) noexcept
+	{
+		const SocketHandle clientSocket = static_cast<SocketHandle>(clientHandle);
+
+		// The stuck client must not block the server forever.
+#ifdef _WIN32
+		const DWORD receiveTimeout = 1000;
+#else
+		const timeval receiveTimeout = { 1, 0 };
+#endif
+		setsockopt(clientSocket, SOL_SOCKET, SO_RCVTIMEO, reinterpret_cast<const char*>(&receiveTimeout), sizeof(receiveTimeout));
+
+		// Read the request line and the headers.
+		string request;
+		char   receiveBuffer[512];
+
+		while (request.size() < _METRICS_MAX_REQUEST_SIZE && request.find("\r\n\r\n") == string::npos)
+		{
+			const auto receivedBytes = recv(clientSocket, receiveBuffer, sizeof(receiveBuffer), 0);
+
+			if (receivedBytes <= 0)
+				break;
+
+			request.append(receiveBuffer, static_cast<size_t>(receivedBytes));
+		}
+
+		string responseBody;
+		string responseStatus;
+
+		if (request.starts_with("GET /metrics ") || request.starts_with("GET /metrics?"))
+		{
+			responseStatus = "200 OK";
+			responseBody   = MetricsRegistry::instance().formatPrometheus();
+		}
+		else
+		{
+			responseStatus = "404 Not Found";
+			responseBody   = "Only GET /metrics is served\n";
+		}
+
+		const string responseHeader = "HTTP/1.1 " + responseStatus + "\r\n"
+			"Content-Type: text/plain; version=0.0.4; charset=utf-8\r\n"
+			"Content-Length: " + to_string(responseBody.size()) + "\r\n"
+			"Connection: close\r\n\r\n";
+
+		if (sendAll(clientSocket, responseHeader))
+			sendAll(clientSocket, responseBody);
+	}
+}
@@ -0,0 +1,58 @@
+// This file declares the `MetricsServer` class.
+#pragma once
+
+#include "_EngineIncludes.hpp"
+
+#include "atomic"
+#include "thread"
+
+// This namespace is polluted with code for the game engine
+namespace Engine
+{
+	// This class serves the metrics of the ::MetricsRegistry in the Prometheus text format
+	// on the localhost port(GET /metrics), so the scraper that runs on the same machine
+	// can collect them. The requests are handled one by one on the background thread.
+	class MetricsServer
+	{
+	private:
+		MetricsServer() = default;
+
+	public:
+		MetricsServer(const MetricsServer&)            = delete;
+		MetricsServer& operator=(const MetricsServer&) = delete;
+
+		// This function is the way to realize the Singleton OOP programming pattern,
+		// so that this class can only be instantiated only once.
+		static MetricsServer& instance()
+		{
+			static MetricsServer _instance;
+			return(_instance);
+		}
+
+	public:
+		// Start listening on the 127.0.0.1:`port`.
+		Error start(uint16_t port) noexcept;
+
+		// Stop the server thread.
+		void stop() noexcept;
+
+		inline bool isRunning() const noexcept
+		{
+			return(m_IsRunning.load(std::memory_order_relaxed));
+		}
+
+	private:
+		// The loop of the server thread.
+		void serverLoop() noexcept;
+
+		// Read the request from the client socket and send the response.
+		void handleClient(intptr_t clientSocket) noexcept;
+
+	private:
+		std::atomic<bool> m_IsRunning = false;
+
+		// The listening socket(SOCKET on Windows, the file descriptor elsewhere).
+		intptr_t    m_ListenSocket = -1;
+		std::thread m_ServerThread;
+	};
+}
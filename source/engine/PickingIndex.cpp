@@ -0,0 +1,168 @@
+// This file implements the `PickingIndex` class.
+#include "PickingIndex.hpp"
+#include "Logger.hpp"
+#include "Sprite.hpp"
+
+#include "algorithm"
+
+using namespace std;
+
+namespace Engine::GFX
+{
+	void PickingIndex::beginUpdate() noexcept
+	{
+		m_PendingEntries.clear();
+	}
+
+	void PickingIndex::submit(GLuint pickingID, vec2 position, vec2 size, GLfloat rotation) noexcept
+	{
+		const GLfloat rotationRadians = glm::radians(rotation);
+
+		PickingEntry pickingEntry;
+		pickingEntry.pickingID   = pickingID;
+		pickingEntry.halfExtents = size * 0.5f;
+		pickingEntry.center      = position + pickingEntry.halfExtents;
+		pickingEntry.sine        = sinf(rotationRadians);
+		pickingEntry.cosine      = cosf(rotationRadians);
+
+		m_PendingEntries.push_back(pickingEntry);
+	}
+
+	void PickingIndex::endUpdate() noexcept
+	{
+		// Nothing has moved since the last update, the grid is still valid.
+		if (m_PendingEntries == m_Entries)
+			return;
+
+		swap(m_Entries, m_PendingEntries);
+		rebuild();
+	}
+
+	optional<GLuint> PickingIndex::pick(vec2 point) const noexcept
+	{
+		const optional<GLuint> pickedID = pickFromGrid(point);
+
+#ifndef NDEBUG
+		// The entries are in the draw order, so the last one under the point is the sprite the
+		// user sees on top, the cell lists must have kept that order.
+		optional<GLuint> drawnID;
+
+		for (size_t entryIndex = m_Entries.size(); entryIndex-- > 0;)
+		{
+			if (contains(m_Entries[entryIndex], point))
+			{
+				drawnID = m_Entries[entryIndex].pickingID;
+				break;
+			}
+		}
+
+		if (pickedID != drawnID)
+			ENGINE_LOG_ERROR(m_GraphicsLogger, "The picked sprite {} is not the drawn one {} at ({}, {})", pickedID.value_or(Sprite::InvalidPickingID), drawnID.value_or(Sprite::InvalidPickingID), point.x, point.y);
+#endif
+
+		return(pickedID);
+	}
+
+	optional<GLuint> PickingIndex::pickFromGrid(vec2 point) const noexcept
+	{
+		const ivec2 cell = {
+			static_cast<int>(floorf(point.x / m_CellSize)) - m_GridOrigin.x,
+			static_cast<int>(floorf(point.y / m_CellSize)) - m_GridOrigin.y
+		};
+
+		if (cell.x < 0 || cell.y < 0 || cell.x >= m_GridSize.x || cell.y >= m_GridSize.y)
+			return(nullopt);
+
+		const size_t cellIndex = static_cast<size_t>(cell.y) * m_GridSize.x + cell.x;
+
+		// Walk the cell from the topmost sprite down to the bottom one.
+		for (size_t entryIndex = m_CellStart[cellIndex + 1]; entryIndex-- > m_CellStart[cellIndex];)
+		{
+			const auto& pickingEntry = m_Entries[m_CellEntries[entryIndex]];
+
+			if (contains(pickingEntry, point))
+				return(pickingEntry.pickingID);
+		}
+
+		return(nullopt);
+	}
+
+	bool PickingIndex::contains(const PickingEntry& pickingEntry, vec2 point) noexcept
+	{
+		// Move the point into the sprite local space(undo the sprite rotation around its center).
+		const vec2    offset = point - pickingEntry.center;
+		const GLfloat localX =  pickingEntry.cosine * offset.x + pickingEntry.sine * offset.y;
+		const GLfloat localY = -pickingEntry.sine   * offset.x + pickingEntry.cosine * offset.y;
+
+		return(fabsf(localX) <= pickingEntry.halfExtents.x && fabsf(localY) <= pickingEntry.halfExtents.y);
+	}
+
+	void PickingIndex::rebuild() noexcept
+	{
+		++m_RebuildCount;
+
+		m_CellStart  .clear();
+		m_CellEntries.clear();
+
+		if (m_Entries.empty())
+		{
+			m_GridSize = { 0, 0 };
+			return;
+		}
+
+		// Calculate the cell range covered by the axis aligned bounds of the each entry.
+		vector<ivec4> entryCells;
+		entryCells.reserve(m_Entries.size());
+
+		ivec2 gridMin = { numeric_limits<int>::max(), numeric_limits<int>::max() };
+		ivec2 gridMax = { numeric_limits<int>::min(), numeric_limits<int>::min() };
+
+		for (const auto& pickingEntry : m_Entries)
+		{
+			const vec2 boundsExtents = {
+				fabsf(pickingEntry.cosine) * pickingEntry.halfExtents.x + fabsf(pickingEntry.sine)   * pickingEntry.halfExtents.y,
+				fabsf(pickingEntry.sine)   * pickingEntry.halfExtents.x + fabsf(pickingEntry.cosine) * pickingEntry.halfExtents.y
+			};
+
+			const ivec4 cells = {
+				static_cast<int>(floorf((pickingEntry.center.x - boundsExtents.x) / m_CellSize)),
+				static_cast<int>(floorf((pickingEntry.center.y - boundsExtents.y) / m_CellSize)),
+				static_cast<int>(floorf((pickingEntry.center.x + boundsExtents.x) / m_CellSize)),
+				static_cast<int>(floorf((pickingEntry.center.y + boundsExtents.y) / m_CellSize))
+			};
+
+			gridMin = { std::min(gridMin.x, cells.x), std::min(gridMin.y, cells.y) };
+			gridMax = { std::max(gridMax.x, cells.z), std::max(gridMax.y, cells.w) };
+
+			entryCells.push_back(cells);
+		}
+
+		m_GridOrigin = gridMin;
+		m_GridSize   = { gridMax.x - gridMin.x + 1, gridMax.y - gridMin.y + 1 };
+
+		const size_t cellsTotal = static_cast<size_t>(m_GridSize.x) * m_GridSize.y;
+
+		// Counting sort of the entries by the cells: count, prefix sum, scatter. The entries
+		// are scattered in the z-order, so each cell list stays sorted bottom to top.
+		m_CellStart.assign(cellsTotal + 1, 0u);
+
+		auto forEachCell = [&](const ivec4& cells, auto&& function)
+		{
+			for (int cellY = cells.y; cellY <= cells.w; ++cellY)
+				for (int cellX = cells.x; cellX <= cells.z; ++cellX)
+					function(static_cast<size_t>(cellY - m_GridOrigin.y) * m_GridSize.x + (cellX - m_GridOrigin.x));
+		};
+
+		for (const auto& cells : entryCells)
+			forEachCell(cells, [&](size_t cellIndex) { m_CellStart[cellIndex + 1]++; });
+
+		for (size_t cellIndex = 0; cellIndex < cellsTotal; ++cellIndex)
+			m_CellStart[cellIndex + 1] += m_CellStart[cellIndex];
+
+		vector<GLuint> cellCursor(m_CellStart.begin(), m_CellStart.end() - 1);
+		m_CellEntries.resize(m_CellStart.back());
+
+		for (size_t entryIndex = 0; entryIndex < entryCells.size(); ++entryIndex)
+			forEachCell(entryCells[entryIndex], [&](size_t cellIndex) { m_CellEntries[cellCursor[cellIndex]++] = static_cast<GLuint>(entryIndex); });
+	}
+}
@@ -0,0 +1,89 @@
+// This file declares the `PickingIndex` class.
+#pragma once
+
+#include "_EngineIncludes.hpp"
+
+#include "vector"
+#include "optional"
+
+
+using namespace std;
+using namespace glm;
+
+// This namespace is populated with all graphics-related stuff.
+namespace Engine::GFX
+{
+	// This class answers the question "which sprite is under the cursor".
+	//
+	// The sprites are submitted by the ::SpriteRenderer::flushSprites in the order they are
+	// drawn in(see ::SpriteRenderer::setPickingIndex), so the submission index is the sprite
+	// z-order and the topmost hit always matches what the user sees.
+	// The sprite bounds(rotation included) are bucketed into the uniform grid, so the query
+	// only tests the few sprites that are overlapping the cursor cell. The grid is rebuilt
+	// only when the submitted sprites differ from the previous update.
+	class PickingIndex
+	{
+	public:
+		PickingIndex(GLfloat cellSize = 64.0f) : m_CellSize(cellSize)
+		{
+		}
+
+		// Start collecting the sprites of the current frame.
+		void beginUpdate() noexcept;
+
+		// Submit the rectangle rotated around its center(in degrees) with the user defined ID.
+		void submit(GLuint pickingID, vec2 position, vec2 size, GLfloat rotation) noexcept;
+
+		// Finish collecting the sprites and rebuild the grid if anything has changed.
+		void endUpdate() noexcept;
+
+		// Get the picking ID of the topmost sprite under the `point`(the debug builds check it is
+		// the last drawn sprite under the point).
+		optional<GLuint> pick(vec2 point) const noexcept;
+
+		// Get the total amount of the grid rebuilds(used for the diagnostics).
+		inline size_t getRebuildCount() const noexcept
+		{
+			return(m_RebuildCount);
+		}
+
+	private:
+		// The sprite oriented bounding box.
+		struct PickingEntry
+		{
+			GLuint  pickingID;
+			vec2    center;
+			vec2    halfExtents;
+			GLfloat sine;
+			GLfloat cosine;
+
+			bool operator==(const PickingEntry&) const = default;
+		};
+
+		// Test if the point is inside the oriented bounding box.
+		static bool contains(const PickingEntry& pickingEntry, vec2 point) noexcept;
+
+		// Bucket the entries into the grid cells.
+		void rebuild() noexcept;
+
+		// Find the topmost entry through the grid cell of the point.
+		optional<GLuint> pickFromGrid(vec2 point) const noexcept;
+
+	private:
+		GLfloat m_CellSize;
+
+		vector<PickingEntry> m_Entries;
+		vector<PickingEntry> m_PendingEntries;
+
+		// The grid bounds(in cells), covering all the entries.
+		ivec2 m_GridOrigin = { 0, 0 };
+		ivec2 m_GridSize   = { 0, 0 };
+
+		// The compressed grid, the entries of the cell `i` are stored in
+		// m_CellEntries[m_CellStart[i]..m_CellStart[i + 1]) in the z-order.
+		vector<GLuint> m_CellStart;
+		vector<GLuint> m_CellEntries;
+
+		size_t m_RebuildCount = 0;
+	};
+}
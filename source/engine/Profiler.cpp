@@ -0,0 +1,197 @@
+// This file implements the `Profiler` class.
+#include "Profiler.hpp"
+#include "Logger.hpp"
+
+#include "cstdio"
+
+using namespace std;
+
+// The oldest slots of the wrapped ring are skipped on export, the zones that were still
+// open when the capture stopped may be writing there.
+static constexpr const uint64_t PROFILE_RING_SLACK = 256;
+
+// Write the string into the JSON file(the quotes and backslashes are escaped).
+static void writeJsonString(FILE* file, const char* string)
+{
+	fputc('"', file);
+
+	for (; *string != '\0'; ++string)
+	{
+		if (*string == '"' || *string == '\\')
+			fputc('\\', file);
+
+		fputc(*string, file);
+	}
+
+	fputc('"', file);
+}
+
+namespace Engine
+{
+	Error Profiler::requestCapture(uint32_t frameCount, string filename)
+	{
+		if (frameCount == 0 || getRemainingFrames() > 0)
+		{
+			Logger::m_ApplicationLogger->warn("The profiler capture is already running(or zero frames were requested)");
+
+			return(Error::ValidationError);
+		}
+
+		m_RequestedFrames = frameCount;
+		m_CaptureFilename = std::move(filename);
+
+		return(Error::Ok);
+	}
+
+	void Profiler::beginFrame() noexcept
+	{
+		if (m_RemainingFrames > 0 && --m_RemainingFrames == 0)
+		{
+			m_IsCapturing.store(false, memory_order_relaxed);
+
+			if (FunctionSuccessA(exportCapture(m_CaptureFilename)))
+				Logger::m_ApplicationLogger->info("The profiler capture has been written into {}", m_CaptureFilename);
+		}
+
+		if (m_RequestedFrames > 0)
+		{
+			// The zones of the previous capture are forgotten by their threads(only the owning
+			// thread writes its ring) on the first zone they record in the new one.
+			m_CaptureGeneration.fetch_add(1, memory_order_release);
+
+			m_RemainingFrames  = m_RequestedFrames;
+			m_RequestedFrames  = 0;
+			m_CaptureTimestamp = InputQueue::timestamp();
+
+			m_IsCapturing.store(true, memory_order_relaxed);
+		}
+	}
+
+	void Profiler::setThreadName(string threadName)
+	{
+		if (auto profileThread = getThread(); profileThread != nullptr)
+		{
+			lock_guard<mutex> threadLock(m_ThreadMutex);
+			profileThread->threadName = std::move(threadName);
+		}
+	}
+
+	void Profiler::record(const char* zoneName, uint64_t beginTimestamp, uint64_t endTimestamp) noexcept
+	{
+		auto profileThread = getThread();
+
+		if (profileThread == nullptr)
+			return;
+
+		// Start the ring over when the zone is the first one of the new capture. The count is
+		// reset before the generation is published, so the exporter that sees the new generation
+		// never reads the count of the previous capture.
+		const uint64_t captureGeneration = m_CaptureGeneration.load(memory_order_acquire);
+
+		if (profileThread->captureGeneration.load(memory_order_relaxed) != captureGeneration)
+		{
+			profileThread->writtenZones     .store(0,                 memory_order_relaxed);
+			profileThread->captureGeneration.store(captureGeneration, memory_order_release);
+		}
+
+		// Only the owning thread writes, the exporter reads the zones below the published count.
+		const uint64_t zoneIndex = profileThread->writtenZones.load(memory_order_relaxed);
+
+		profileThread->zones[zoneIndex % RingCapacity] = { zoneName, beginTimestamp, endTimestamp };
+		profileThread->writtenZones.store(zoneIndex + 1, memory_order_release);
+	}
+
+	Profiler::ProfileThread* Profiler::getThread() noexcept
+	{
+		static thread_local ProfileThread* threadRing = nullptr;
+
+		if (threadRing == nullptr)
+		{
+			auto profileThread = unique_ptr<ProfileThread>(new (nothrow) ProfileThread());
+
+			if (profileThread == nullptr)
+				return(nullptr);
+
+			lock_guard<mutex> threadLock(m_ThreadMutex);
+
+			profileThread->threadIndex = static_cast<uint32_t>(m_Threads.size());
+			threadRing                 = profileThread.get();
+
+			m_Threads.push_back(std::move(profileThread));
+		}
+
+		return(threadRing);
+	}
+
+	Error Profiler::exportCapture(const string& filename) noexcept
+	{
+		FILE* file = fopen(filename.c_str(), "w");
+
+		if (file == nullptr)
+		{
+			Logger::m_ApplicationLogger->error("Unable to open the profiler capture file {}", filename);
+
+			return(Error::InitializationError);
+		}
+
+		lock_guard<mutex> threadLock(m_ThreadMutex);
+
+		const uint64_t captureGeneration = m_CaptureGeneration.load(memory_order_relaxed);
+
+		uint64_t lostZones = 0;
+		bool     isFirst   = true;
+
+		fputs("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n", file);
+
+		for (const auto& profileThread : m_Threads)
+		{
+			// The thread has not recorded anything since the capture started, the zones are old.
+			if (profileThread->captureGeneration.load(memory_order_acquire) != captureGeneration)
+				continue;
+
+			const uint64_t writtenZones = profileThread->writtenZones.load(memory_order_acquire);
+
+			if (writtenZones == 0)
+				continue;
+
+			// The thread name is the metadata event.
+			const string threadName = profileThread->threadName.empty() ? "Thread " + to_string(profileThread->threadIndex) : profileThread->threadName;
+
+			fprintf(file, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":", isFirst ? "" : ",\n", profileThread->threadIndex);
+			writeJsonString(file, threadName.c_str());
+			fputs("}}", file);
+
+			isFirst = false;
+
+			// The ring has wrapped, only the newest zones are left.
+			uint64_t firstZone = 0;
+
+			if (writtenZones > RingCapacity)
+			{
+				firstZone  = writtenZones - RingCapacity + PROFILE_RING_SLACK;
+				lostZones += firstZone;
+			}
+
+			for (uint64_t zoneIndex = firstZone; zoneIndex < writtenZones; ++zoneIndex)
+			{
+				const auto& profileZone = profileThread->zones[zoneIndex % RingCapacity];
+
+				// The complete event, the time is in microseconds from the capture start.
+				fputs(",\n{\"name\":", file);
+				writeJsonString(file, profileZone.zoneName);
+				fprintf(file, ",\"cat\":\"engine\",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f}",
+					profileThread->threadIndex,
+					static_cast<double>(static_cast<int64_t>(profileZone.beginTimestamp - m_CaptureTimestamp)) * 1e-3,
+					static_cast<double>(profileZone.endTimestamp - profileZone.beginTimestamp) * 1e-3);
+			}
+		}
+
+		fputs("\n]}\n", file);
+		fclose(file);
+
+		if (lostZones > 0)
+			Logger::m_ApplicationLogger->warn("{} profiler zones were overwritten, capture less frames to keep them", lostZones);
+
+		return(Error::Ok);
+	}
+}
@@ -0,0 +1,158 @@
+// This file declares the `Profiler` class.
+//
+// The `Profiler` class collects the CPU timing zones(see ENGINE_PROFILE_SCOPE) into the
+// per-thread ring buffers. The capture of the few frames is exported as the Chrome
+// trace-event JSON, that can be opened in Perfetto(ui.perfetto.dev) or chrome://tracing.
+#pragma once
+
+#include "_EngineIncludes.hpp"
+
+#include "array"
+#include "mutex"
+#include "atomic"
+#include "memory"
+#include "string"
+#include "vector"
+
+#include "InputQueue.hpp"
+
+// Set to zero to remove all the profiling zones from the build.
+#ifndef ENGINE_PROFILE_ENABLED
+	#define ENGINE_PROFILE_ENABLED 1
+#endif
+
+#define ENGINE_PROFILE_CONCAT_IMPL(left, right) left##right
+#define ENGINE_PROFILE_CONCAT(left, right)      ENGINE_PROFILE_CONCAT_IMPL(left, right)
+
+// Measure the time until the end of the enclosing scope(the name must be the string literal):
+//
+//   ENGINE_PROFILE_SCOPE("SpriteRenderer::renderSprite");
+//
+// Name the calling thread in the exported capture with ENGINE_PROFILE_THREAD.
+#if ENGINE_PROFILE_ENABLED
+	#define ENGINE_PROFILE_SCOPE(name)  const Engine::ProfileScope ENGINE_PROFILE_CONCAT(_profileScope, __LINE__)(name)
+	#define ENGINE_PROFILE_THREAD(name) Engine::Profiler::instance().setThreadName(name)
+#else
+	#define ENGINE_PROFILE_SCOPE(name)  (void)0
+	#define ENGINE_PROFILE_THREAD(name) (void)0
+#endif
+
+// This namespace is polluted with code for the game engine
+namespace Engine
+{
+	// The measured zone.
+	struct ProfileZone
+	{
+		const char* zoneName;
+		uint64_t    beginTimestamp; // nanoseconds, see ::InputQueue::timestamp()
+		uint64_t    endTimestamp;
+	};
+
+	// This class records the zones only while the capture is running, so the zones
+	// cost a single relaxed load the rest of the time.
+	class Profiler
+	{
+	private:
+		Profiler() = default;
+
+	public:
+		Profiler(const Profiler&)            = delete;
+		Profiler& operator=(const Profiler&) = delete;
+
+		// This function is the way to realize the Singleton OOP programming pattern,
+		// so that this class can only be instantiated only once.
+		static Profiler& instance()
+		{
+			static Profiler _instance;
+			return(_instance);
+		}
+
+	public:
+		// The amount of the zones that each thread keeps, the oldest ones are overwritten.
+		static constexpr const size_t RingCapacity = 64 * 1024;
+
+		// The default length of the capture.
+		static constexpr const uint32_t DefaultCaptureFrames = 120;
+
+		// Record the next `frameCount` frames and write them into the `filename`. The
+		// capture starts on the next frame boundary.
+		Error requestCapture(uint32_t frameCount, std::string filename);
+
+		// Mark the frame boundary(called by the application before the frame starts),
+		// starts the requested capture and exports the finished one.
+		void beginFrame() noexcept;
+
+		inline bool isCapturing() const noexcept
+		{
+			return(m_IsCapturing.load(std::memory_order_relaxed));
+		}
+
+		// Get the amount of the frames that are left to capture(including the requested capture).
+		inline uint32_t getRemainingFrames() const noexcept
+		{
+			return(m_RemainingFrames + m_RequestedFrames);
+		}
+
+		// Set the name of the calling thread in the exported capture.
+		void setThreadName(std::string threadName);
+
+		// Store the zone of the calling thread(used by the ::ProfileScope).
+		void record(const char* zoneName, uint64_t beginTimestamp, uint64_t endTimestamp) noexcept;
+
+	private:
+		// The ring buffer of the thread.
+		struct ProfileThread
+		{
+			std::array<ProfileZone, RingCapacity> zones;
+			std::atomic<uint64_t>                 writtenZones      = 0;
+			std::atomic<uint64_t>                 captureGeneration = 0; // the capture the zones belong to
+			uint32_t                              threadIndex       = 0;
+			std::string                           threadName;
+		};
+
+		// Get the ring buffer of the calling thread(nullptr if it can not be allocated).
+		ProfileThread* getThread() noexcept;
+
+		// Write the recorded zones of all the threads into the file.
+		Error exportCapture(const std::string& filename) noexcept;
+
+	private:
+		std::atomic<bool> m_IsCapturing = false;
+
+		// Incremented by each capture, the threads forget their zones when they see it change.
+		std::atomic<uint64_t> m_CaptureGeneration = 0;
+
+		// The capture state, only touched by the main thread.
+		uint32_t    m_RequestedFrames = 0;
+		uint32_t    m_RemainingFrames = 0;
+		uint64_t    m_CaptureTimestamp = 0;
+		std::string m_CaptureFilename;
+
+		// The threads are never unregistered, so their zones survive the thread exit.
+		std::mutex                                  m_ThreadMutex;
+		std::vector<std::unique_ptr<ProfileThread>> m_Threads;
+	};
+
+	// The RAII zone, see the ENGINE_PROFILE_SCOPE macro.
+	class ProfileScope
+	{
+	public:
+		explicit ProfileScope(const char* zoneName) noexcept
+			: m_ZoneName(zoneName), m_BeginTimestamp(Profiler::instance().isCapturing() ? InputQueue::timestamp() : 0)
+		{
+		}
+
+		~ProfileScope() noexcept
+		{
+			if (m_BeginTimestamp != 0)
+				Profiler::instance().record(m_ZoneName, m_BeginTimestamp, InputQueue::timestamp());
+		}
+
+		ProfileScope(const ProfileScope&)            = delete;
+		ProfileScope& operator=(const ProfileScope&) = delete;
+
+	private:
+		const char* m_ZoneName;
+		uint64_t    m_BeginTimestamp;
+	};
+}
@@ -3,6 +3,14 @@
 
 #include "ResourseManager.hpp"
 #include "Logger.hpp"
+#include "Profiler.hpp"
+#include "Metrics.hpp"
+#include "InputQueue.hpp"
+#include "utility/ImageResize.hpp"
+#include "utility/ImageOpacity.hpp"
+
+#include "algorithm"
+#include "vector"
 
 #define STB_IMAGE_IMPLEMENTATION
 #include "vendor/stb_image.h"
@@ -10,36 +18,145 @@
 using namespace std;
 
 // Initialize the static std::unordered_map's that was declared in the `ResourceManager` class.
-unordered_map<string, Engine::GFX::Core::ShaderWrapper>  Engine::ResourceManager::m_Shaders;
-unordered_map<string, Engine::GFX::Core::TextureWrapper> Engine::ResourceManager::m_Textures;
+unordered_map<Engine::StringID, Engine::GFX::Core::ShaderWrapper>  Engine::ResourceManager::m_Shaders;
+unordered_map<Engine::StringID, Engine::ResourceManager::ShaderVariantSource> Engine::ResourceManager::m_ShaderVariantSources;
+unordered_map<uint64_t, Engine::GFX::Core::ShaderWrapper>          Engine::ResourceManager::m_ShaderVariants;
+unordered_set<uint64_t>                                            Engine::ResourceManager::m_FailedShaderVariants;
+unordered_map<Engine::StringID, Engine::GFX::Core::TextureWrapper> Engine::ResourceManager::m_Textures;
+unordered_map<Engine::StringID, Engine::ResourceManager::TextureRecord> Engine::ResourceManager::m_TextureRecords;
+
+size_t   Engine::ResourceManager::m_TextureMemory    = 0;
+size_t   Engine::ResourceManager::m_TextureBudget    = 0;
+uint64_t Engine::ResourceManager::m_FrameIndex       = 0;
+uint64_t Engine::ResourceManager::m_TextureEvictions = 0;
+uint64_t Engine::ResourceManager::m_TextureReloads   = 0;
+
+// The textures that were used in the last frames are never evicted(they are likely to be drawn
+// again, and the GPU may still be reading them).
+static constexpr const uint64_t _TEXTURE_EVICTION_MIN_AGE = 3;
+
+// The amount of the defines the shader variants may have(the bits of the variant mask).
+static constexpr const size_t _SHADER_VARIANT_DEFINES_MAX = 16;
+
+// The metrics of the resource manager.
+struct ResourceMetrics
+{
+	Engine::Counter&   loads         = Engine::MetricsRegistry::instance().counter  ("engine_resource_loads_total",        "The loaded shaders and textures");
+	Engine::Counter&   loadedBytes   = Engine::MetricsRegistry::instance().counter  ("engine_resource_loaded_bytes_total", "The bytes of the uploaded texture images");
+	Engine::Counter&   cacheHits     = Engine::MetricsRegistry::instance().counter  ("engine_resource_cache_hits_total",   "The lookups of the loaded resources");
+	Engine::Counter&   cacheMisses   = Engine::MetricsRegistry::instance().counter  ("engine_resource_cache_misses_total", "The lookups of the resources that are not loaded");
+	Engine::Gauge&     textureMemory = Engine::MetricsRegistry::instance().gauge    ("engine_texture_memory_bytes",        "The video memory taken by the loaded textures");
+	Engine::Histogram& loadTime      = Engine::MetricsRegistry::instance().histogram("engine_resource_load_seconds",       "The time to load the shader or the texture from the file");
+	Engine::Gauge&     textureBudget = Engine::MetricsRegistry::instance().gauge    ("engine_texture_budget_bytes",        "The video memory the textures may take(zero is no limit)");
+	Engine::Counter&   evictions     = Engine::MetricsRegistry::instance().counter  ("engine_texture_evictions_total",     "The textures that were evicted to fit into the budget");
+	Engine::Counter&   reloads       = Engine::MetricsRegistry::instance().counter  ("engine_texture_reloads_total",       "The evicted textures that were loaded again");
+	Engine::Gauge&     variants      = Engine::MetricsRegistry::instance().gauge    ("engine_shader_variants",             "The compiled variants of the shaders(the base variants are not counted)");
+};
+
+static ResourceMetrics& resourceMetrics()
+{
+	static ResourceMetrics _metrics;
+	return(_metrics);
+}
+
+// The key of the shader variant(the name in the high bits, the variant mask in the low ones).
+static uint64_t getShaderVariantKey(Engine::StringID shaderName, uint32_t variantMask) noexcept
+{
+	return((static_cast<uint64_t>(shaderName.getHash()) << 32) | variantMask);
+}
+
+// Add the defines of the variant right after the `#version` directive(it must stay the first one).
+static string defineShaderVariant(const string& sourceCode, uint32_t variantMask, const vector<string>& variantDefines)
+{
+	string defineLines;
+
+	for (size_t defineIndex = 0; defineIndex < variantDefines.size(); ++defineIndex)
+	{
+		if ((variantMask & (1u << defineIndex)) != 0)
+			defineLines += "#define " + variantDefines[defineIndex] + "\n";
+	}
+
+	if (defineLines.empty())
+		return(sourceCode);
+
+	string variantCode = sourceCode;
+
+	const size_t versionBegin = variantCode.find("#version");
+	const size_t versionEnd   = versionBegin != string::npos ? variantCode.find('\n', versionBegin) : string::npos;
+
+	if (versionBegin == string::npos)
+		variantCode.insert(0, defineLines);
+	else if (versionEnd == string::npos)
+		variantCode += "\n" + defineLines;
+	else
+		variantCode.insert(versionEnd + 1, defineLines);
+
+	return(variantCode);
+}
+
+// The texel the opaque rect of the texture is moved inside by, on the sides where the filtering
+// blends it with the transparent texels(the texture borders are clamped, they are kept).
+static constexpr const GLfloat _TEXTURE_OPAQUE_RECT_INSET = 1.0f;
+
+// Get the opaque rect of the texture image in the texture coordinates(see ::TextureWrapper::setOpaqueRect).
+static glm::vec4 getTextureOpaqueRect(const GLubyte* imagePixels, GLuint imageWidth, GLuint imageHeight, GLint channelsTotal) noexcept
+{
+	const Engine::ImageRect opaqueRect = Engine::findOpaqueRect(imagePixels, imageWidth, imageHeight, channelsTotal);
+
+	if (opaqueRect.isEmpty())
+		return(glm::vec4(0.0f));
+
+	const GLfloat left   = opaqueRect.left   > 0           ? opaqueRect.left   + _TEXTURE_OPAQUE_RECT_INSET : 0.0f;
+	const GLfloat top    = opaqueRect.top    > 0           ? opaqueRect.top    + _TEXTURE_OPAQUE_RECT_INSET : 0.0f;
+	const GLfloat right  = opaqueRect.right  < imageWidth  ? opaqueRect.right  - _TEXTURE_OPAQUE_RECT_INSET : static_cast<GLfloat>(imageWidth);
+	const GLfloat bottom = opaqueRect.bottom < imageHeight ? opaqueRect.bottom - _TEXTURE_OPAQUE_RECT_INSET : static_cast<GLfloat>(imageHeight);
+
+	if (left >= right || top >= bottom)
+		return(glm::vec4(0.0f));
+
+	return(glm::vec4(left / imageWidth, top / imageHeight, right / imageWidth, bottom / imageHeight));
+}
 
 namespace Engine
 {
-	ResourceManager::ShaderOrError ResourceManager::loadShader(const char* vertShaderFilename, const char* fragShaderFilename, const char* geomShaderFilename, const string& name) noexcept
+	ResourceManager::ShaderOrError ResourceManager::loadShader(const char* vertShaderFilename, const char* fragShaderFilename, const char* geomShaderFilename, string_view shaderName) noexcept
 	{
+		ENGINE_PROFILE_SCOPE("ResourceManager::loadShader");
+
+		const auto nameOrError = StringInterner::instance().intern(shaderName);
+
+		if (!nameOrError.has_value())
+			return(unexpected(nameOrError.error()));
+
+		const StringID name = *nameOrError;
+
 		// If the shader in-class container already holds some data by the provided 
 		// descriptor, safely destroy this shader and place the new one in place of
 		// a previous.
 		if (m_Shaders.contains(name))
 		{
-			Logger::m_ResourceLogger->warn("Reassigning shader {}", name);
+			Logger::m_ResourceLogger->warn("Reassigning shader {}", name.c_str());
 		
-			glDeleteProgram(m_Shaders[name].getShaderID());
+			GFX::RenderDevice::instance().deleteProgram(m_Shaders[name].getShaderID());
 		}
 
-		Logger::m_ResourceLogger->info("Loading shader {}", name);
+		Logger::m_ResourceLogger->info("Loading shader {}", name.c_str());
 
 		// Try to load the shader from the file, retrieve std::expected container that contains either the ::ShaderWrapper or the ::Error.
+		const uint64_t loadTimestamp = InputQueue::timestamp();
 		auto shaderLoadingResultOrError = loadShaderFromFile(vertShaderFilename, fragShaderFilename, geomShaderFilename);
 		
 		// If we succesfully loaded the shader assign it to the map, if not raise an ::InitializationError.
 		if (shaderLoadingResultOrError.has_value())
 		{
 			m_Shaders[name] = *shaderLoadingResultOrError;
+
+			resourceMetrics().loads   .increment();
+			resourceMetrics().loadTime.record(InputQueue::timestamp() - loadTimestamp);
 		}
 		else
 		{
-			Logger::m_ResourceLogger->warn("Shader {} is not assigned due to an error", name);
+			Logger::m_ResourceLogger->warn("Shader {} is not assigned due to an error", name.c_str());
 		
 			return unexpected(Engine::Error::InitializationError);
 		}
@@ -47,69 +164,340 @@ namespace Engine
 		return(m_Shaders[name]);
 	}
 
-	ResourceManager::ShaderOrError ResourceManager::getShader(const std::string& name) noexcept
+	ResourceManager::ShaderOrError ResourceManager::getShader(StringID name) noexcept
 	{
 		// If the shader in-class container does not holds the descriptor associated with some loaded shader,
 		// raise an ::InitializationError.
 		if (!m_Shaders.contains(name))
 		{
-			Logger::m_ResourceLogger->warn("Attempted to get the shader that does not exists in the map({})", name);
+			Logger::m_ResourceLogger->warn("Attempted to get the shader that does not exists in the map({})", name.c_str());
+			resourceMetrics().cacheMisses.increment();
 		
 			return(unexpected(Engine::Error::InitializationError));
 		}
 
+		resourceMetrics().cacheHits.increment();
+
 		// If not just return the shader associated with passed descriptor.
 		return(m_Shaders[name]);
 	}
 
-	ResourceManager::TextureOrError ResourceManager::loadTexture(const char* textureFileName, GLboolean alphaChannel, const string& name) noexcept
+	ResourceManager::ShaderOrError ResourceManager::loadShaderVariants(const char* vertShaderFilename, const char* fragShaderFilename, const char* geomShaderFilename, string_view shaderName, span<const char* const> variantDefines) noexcept
+	{
+		ENGINE_PROFILE_SCOPE("ResourceManager::loadShaderVariants");
+
+		const auto nameOrError = StringInterner::instance().intern(shaderName);
+
+		if (!nameOrError.has_value())
+			return(unexpected(nameOrError.error()));
+
+		const StringID name = *nameOrError;
+
+		if (variantDefines.size() > _SHADER_VARIANT_DEFINES_MAX)
+		{
+			Logger::m_ResourceLogger->error("Shader {} has {} variant defines, only {} are supported", name.c_str(), variantDefines.size(), _SHADER_VARIANT_DEFINES_MAX);
+
+			return(unexpected(Engine::Error::ValidationError));
+		}
+
+		Logger::m_ResourceLogger->info("Loading shader {} with {} variant defines", name.c_str(), variantDefines.size());
+
+		// The sources are kept, so the variants are compiled from them later.
+		ShaderVariantSource variantSource;
+		variantSource.hasGeometry = geomShaderFilename != nullptr;
+
+		if (!readShaderFile(vertShaderFilename, variantSource.vertexSource)     ||
+			!readShaderFile(fragShaderFilename, variantSource.fragmentSource)   ||
+			(variantSource.hasGeometry && !readShaderFile(geomShaderFilename, variantSource.geometrySource)))
+		{
+			Logger::m_ResourceLogger->error("Unable to read shader files");
+
+			return(unexpected(Engine::Error::InitializationError));
+		}
+
+		variantSource.variantDefines.assign(variantDefines.begin(), variantDefines.end());
+
+		// The variants of the previous shader with this name are compiled from the other sources.
+		for (auto variantIterator = m_ShaderVariants.begin(); variantIterator != m_ShaderVariants.end();)
+		{
+			if ((variantIterator->first >> 32) == name.getHash())
+			{
+				GFX::RenderDevice::instance().deleteProgram(variantIterator->second.getShaderID());
+				variantIterator = m_ShaderVariants.erase(variantIterator);
+			}
+			else
+			{
+				++variantIterator;
+			}
+		}
+
+		// The failed variants may compile from the other sources.
+		erase_if(m_FailedShaderVariants, [name](uint64_t variantKey) { return((variantKey >> 32) == name.getHash()); });
+
+		m_ShaderVariantSources[name] = std::move(variantSource);
+		resourceMetrics().variants.set(static_cast<double>(m_ShaderVariants.size()));
+
+		const uint64_t loadTimestamp = InputQueue::timestamp();
+		auto baseVariantOrError = compileShaderVariant(name, 0);
+
+		if (!baseVariantOrError.has_value())
+		{
+			Logger::m_ResourceLogger->warn("Shader {} is not assigned due to an error", name.c_str());
+
+			m_ShaderVariantSources.erase(name);
+
+			return(unexpected(Engine::Error::InitializationError));
+		}
+
+		// The base variant takes the place of the shader with this name.
+		if (m_Shaders.contains(name))
+		{
+			Logger::m_ResourceLogger->warn("Reassigning shader {}", name.c_str());
+
+			GFX::RenderDevice::instance().deleteProgram(m_Shaders[name].getShaderID());
+		}
+
+		m_Shaders[name] = *baseVariantOrError;
+
+		resourceMetrics().loads   .increment();
+		resourceMetrics().loadTime.record(InputQueue::timestamp() - loadTimestamp);
+
+		return(m_Shaders[name]);
+	}
+
+	ResourceManager::ShaderOrError ResourceManager::getShaderVariant(StringID name, uint32_t variantMask) noexcept
 	{
+		// The base variant is the shader itself.
+		if (variantMask == 0)
+			return(getShader(name));
+
+		const uint64_t variantKey = getShaderVariantKey(name, variantMask);
+
+		if (auto variantIterator = m_ShaderVariants.find(variantKey); variantIterator != m_ShaderVariants.end())
+		{
+			resourceMetrics().cacheHits.increment();
+
+			return(variantIterator->second);
+		}
+
+		// The variant has failed to compile already(the error is logged once), it would only hitch
+		// the frame every time it is drawn.
+		if (m_FailedShaderVariants.contains(variantKey))
+			return(unexpected(Engine::Error::InitializationError));
+
+		resourceMetrics().cacheMisses.increment();
+
+		const auto sourceIterator = m_ShaderVariantSources.find(name);
+
+		if (sourceIterator == m_ShaderVariantSources.end() || (variantMask >> sourceIterator->second.variantDefines.size()) != 0)
+		{
+			Logger::m_ResourceLogger->warn("Attempted to get the variant {:#x} the shader {} does not have", variantMask, name.c_str());
+
+			return(unexpected(Engine::Error::ValidationError));
+		}
+
+		ENGINE_PROFILE_SCOPE("ResourceManager::getShaderVariant");
+
+		const uint64_t loadTimestamp = InputQueue::timestamp();
+		auto variantOrError = compileShaderVariant(name, variantMask);
+
+		if (!variantOrError.has_value())
+		{
+			m_FailedShaderVariants.insert(variantKey);
+
+			return(unexpected(Engine::Error::InitializationError));
+		}
+
+		m_ShaderVariants[variantKey] = *variantOrError;
+
+		resourceMetrics().loads   .increment();
+		resourceMetrics().loadTime.record(InputQueue::timestamp() - loadTimestamp);
+		resourceMetrics().variants.set(static_cast<double>(m_ShaderVariants.size()));
+
+		return(m_ShaderVariants[variantKey]);
+	}
+
+	ResourceManager::TextureOrError ResourceManager::loadTexture(const char* textureFileName, GLboolean alphaChannel, string_view textureName, const TextureLoadOptions& loadOptions) noexcept
+	{
+		ENGINE_PROFILE_SCOPE("ResourceManager::loadTexture");
+
+		const auto nameOrError = StringInterner::instance().intern(textureName);
+
+		if (!nameOrError.has_value())
+			return(unexpected(nameOrError.error()));
+
+		const StringID name = *nameOrError;
+
 		// If the texture in-class container already holds some data by the provided 
 		// descriptor, safely destroy this texture and place the new one in place of
 		// a previous.
 		if (m_Textures.contains(name))
 		{
-			Logger::m_ResourceLogger->warn("Reassigning texture {}", name);
+			Logger::m_ResourceLogger->warn("Reassigning texture {}", name.c_str());
+
+			m_TextureMemory -= m_Textures[name].getMemorySize();
 
-			const auto textureID = m_Textures[name].getTextureID();
-			glDeleteTextures(1, &textureID);
+			GFX::RenderDevice::instance().deleteTexture(m_Textures[name].getTextureID());
+			m_Textures.erase(name);
 		}
 
-		Logger::m_ResourceLogger->info("Loading texture {}", name);
+		Logger::m_ResourceLogger->info("Loading texture {}", name.c_str());
 
 		// Try to load the shader from the file, retrieve std::expected container that contains either the ::TextureWrapper or
 		// the ::Error.
-		auto textureLoadingResultOrError = loadTextureFromFile(textureFileName, alphaChannel);
+		const uint64_t loadTimestamp = InputQueue::timestamp();
+		auto textureLoadingResultOrError = loadTextureFromFile(textureFileName, alphaChannel, loadOptions);
 		
 		// If we succesfully loaded the texture assign it to the map, if not raise an ::InitializationError.
 		if (textureLoadingResultOrError.has_value())
 		{
-			m_Textures[name] = *textureLoadingResultOrError;
+			m_Textures[name]        = *textureLoadingResultOrError;
+			m_TextureRecords[name]  = { textureFileName, alphaChannel != GL_FALSE, loadOptions, m_FrameIndex };
+			m_TextureMemory        += textureLoadingResultOrError->getMemorySize();
+
+			resourceMetrics().loads        .increment();
+			resourceMetrics().loadedBytes  .increment(textureLoadingResultOrError->getMemorySize());
+			resourceMetrics().loadTime     .record(InputQueue::timestamp() - loadTimestamp);
+			resourceMetrics().textureMemory.set(static_cast<double>(m_TextureMemory));
 		}
 		else 
 		{
-			Logger::m_ResourceLogger->warn("Texture {} is not loaded due to an error", name);
+			Logger::m_ResourceLogger->warn("Texture {} is not loaded due to an error", name.c_str());
 			return(unexpected(Engine::Error::InitializationError));
 		}
 
 		return(m_Textures[name]);
 	}
 	
-	ResourceManager::TextureOrError ResourceManager::getTexture(const std::string& name) noexcept
+	ResourceManager::TextureOrError ResourceManager::getTexture(StringID name) noexcept
 	{
 		// If the shader in-class container does not holds the descriptor associated with some loaded texture,
 		// raise an ::InitializationError.
-		if (!m_Textures.contains(name))
+		auto recordIterator = m_TextureRecords.find(name);
+
+		if (recordIterator == m_TextureRecords.end())
 		{
-			Logger::m_ResourceLogger->warn("Attempted to get the texture that does not exists in the map({})", name);
+			Logger::m_ResourceLogger->warn("Attempted to get the texture that does not exists in the map({})", name.c_str());
+			resourceMetrics().cacheMisses.increment();
 		
 			return(unexpected(Engine::Error::InitializationError));
 		}
 
-		// If not just return the texture associated with passed descriptor.
+		recordIterator->second.lastUsedFrame = m_FrameIndex;
+
+		if (auto textureIterator = m_Textures.find(name); textureIterator != m_Textures.end())
+		{
+			resourceMetrics().cacheHits.increment();
+
+			// If not just return the texture associated with passed descriptor.
+			return(textureIterator->second);
+		}
+
+		// The texture was evicted, load it again(it is evicted next time the budget is checked,
+		// if it is not used anymore).
+		ENGINE_PROFILE_SCOPE("ResourceManager::reloadTexture");
+
+		const auto& textureRecord = recordIterator->second;
+
+		Logger::m_ResourceLogger->info("Reloading evicted texture {}", name.c_str());
+
+		auto textureLoadingResultOrError = loadTextureFromFile(textureRecord.filename.c_str(), textureRecord.alphaChannel, textureRecord.loadOptions);
+
+		if (!textureLoadingResultOrError.has_value())
+		{
+			Logger::m_ResourceLogger->warn("Texture {} is not reloaded due to an error", name.c_str());
+			resourceMetrics().cacheMisses.increment();
+
+			return(unexpected(Engine::Error::InitializationError));
+		}
+
+		m_Textures[name]  = *textureLoadingResultOrError;
+		m_TextureMemory  += textureLoadingResultOrError->getMemorySize();
+		m_TextureReloads += 1;
+
+		resourceMetrics().reloads      .increment();
+		resourceMetrics().loadedBytes  .increment(textureLoadingResultOrError->getMemorySize());
+		resourceMetrics().textureMemory.set(static_cast<double>(m_TextureMemory));
+
 		return(m_Textures[name]);
 	}
 
+	size_t ResourceManager::getTextureMemory() noexcept
+	{
+		return(m_TextureMemory);
+	}
+
+	void ResourceManager::setTextureBudget(size_t budgetBytes) noexcept
+	{
+		Logger::m_ResourceLogger->info("Texture budget is set to {} bytes", budgetBytes);
+
+		m_TextureBudget = budgetBytes;
+
+		resourceMetrics().textureBudget.set(static_cast<double>(budgetBytes));
+	}
+
+	void ResourceManager::beginFrame() noexcept
+	{
+		m_FrameIndex++;
+
+		if (m_TextureBudget != 0 && m_TextureMemory > m_TextureBudget)
+			evictTextures();
+	}
+
+	TextureResidency ResourceManager::getTextureResidency() noexcept
+	{
+		TextureResidency textureResidency;
+		textureResidency.residentTextures = m_Textures.size();
+		textureResidency.evictedTextures  = m_TextureRecords.size() - m_Textures.size();
+		textureResidency.residentBytes    = m_TextureMemory;
+		textureResidency.budgetBytes      = m_TextureBudget;
+		textureResidency.evictionsTotal   = m_TextureEvictions;
+		textureResidency.reloadsTotal     = m_TextureReloads;
+
+		return(textureResidency);
+	}
+
+	void ResourceManager::evictTextures() noexcept
+	{
+		ENGINE_PROFILE_SCOPE("ResourceManager::evictTextures");
+
+		// The resident textures that were not used recently, the least recently used go first.
+		vector<pair<uint64_t, StringID>> evictionCandidates;
+
+		for (const auto& texture : m_Textures)
+		{
+			const uint64_t lastUsedFrame = m_TextureRecords[texture.first].lastUsedFrame;
+
+			if (lastUsedFrame + _TEXTURE_EVICTION_MIN_AGE <= m_FrameIndex)
+				evictionCandidates.emplace_back(lastUsedFrame, texture.first);
+		}
+
+		std::sort(evictionCandidates.begin(), evictionCandidates.end(), [](const auto& left, const auto& right)
+		{
+			return(left.first < right.first);
+		});
+
+		for (const auto& [lastUsedFrame, name] : evictionCandidates)
+		{
+			if (m_TextureMemory <= m_TextureBudget)
+				break;
+
+			auto& texture = m_Textures[name];
+
+			Logger::m_ResourceLogger->info("Evicting texture {}(not used for {} frames)", name.c_str(), m_FrameIndex - lastUsedFrame);
+
+			m_TextureMemory -= texture.getMemorySize();
+
+			GFX::RenderDevice::instance().deleteTexture(texture.getTextureID());
+			m_Textures.erase(name);
+
+			m_TextureEvictions++;
+			resourceMetrics().evictions.increment();
+		}
+
+		resourceMetrics().textureMemory.set(static_cast<double>(m_TextureMemory));
+	}
+
 	void ResourceManager::release() noexcept
 	{
 		Logger::m_ResourceLogger->info("Releasing shaders");
@@ -119,9 +507,19 @@ namespace Engine
 		{
 			const GLuint shaderProgramID = shader.second.getShaderID();
 
-			glDeleteProgram(shaderProgramID);
+			GFX::RenderDevice::instance().deleteProgram(shaderProgramID);
+		}
+
+		// And the programs of the shader variants.
+		for (auto& shaderVariant : m_ShaderVariants)
+		{
+			GFX::RenderDevice::instance().deleteProgram(shaderVariant.second.getShaderID());
 		}
 
+		m_ShaderVariants      .clear();
+		m_ShaderVariantSources.clear();
+		m_FailedShaderVariants.clear();
+
 		Logger::m_ResourceLogger->info("Releasing textures");
 
 		// For each texture delete it is.
@@ -129,8 +527,12 @@ namespace Engine
 		{
 			const GLuint textureID = texture.second.getTextureID();
 		
-			glDeleteTextures(1, &textureID);
+			GFX::RenderDevice::instance().deleteTexture(textureID);
 		}
+
+		m_Textures      .clear();
+		m_TextureRecords.clear();
+		m_TextureMemory = 0;
 	}
 
 	ResourceManager::ShaderOrError ResourceManager::loadShaderFromFile(const char* vertShaderFilename, const char* fragShaderFilename, const char* geomShaderFilename) noexcept
@@ -199,20 +601,68 @@ namespace Engine
 		return(shaderWrapper);
 	}
 
-	ResourceManager::TextureOrError ResourceManager::loadTextureFromFile(const char* textureFilename, bool alpaChannel) noexcept
+	bool ResourceManager::readShaderFile(const char* shaderFilename, string& sourceCode) noexcept
+	{
+		ifstream shaderFile(shaderFilename);
+
+		if (!shaderFile.is_open())
+			return(false);
+
+		stringstream shaderStream;
+		shaderStream << shaderFile.rdbuf();
+
+		sourceCode = shaderStream.str();
+
+		return(true);
+	}
+
+	ResourceManager::ShaderOrError ResourceManager::compileShaderVariant(StringID name, uint32_t variantMask) noexcept
+	{
+		const auto& variantSource = m_ShaderVariantSources[name];
+
+		const string vertexSource   = defineShaderVariant(variantSource.vertexSource,   variantMask, variantSource.variantDefines);
+		const string fragmentSource = defineShaderVariant(variantSource.fragmentSource, variantMask, variantSource.variantDefines);
+		const string geometrySource = defineShaderVariant(variantSource.geometrySource, variantMask, variantSource.variantDefines);
+
+		GFX::Core::ShaderWrapper shaderWrapper;
+
+		Logger::m_ResourceLogger->info("Compiling variant {:#x} of shader {}", variantMask, name.c_str());
+
+		if (shaderWrapper.compileShader(vertexSource.c_str(), fragmentSource.c_str(), variantSource.hasGeometry ? geometrySource.c_str() : nullptr) != Engine::Error::Ok)
+		{
+			Logger::m_ResourceLogger->error("Unable to compile variant {:#x} of shader {}", variantMask, name.c_str());
+
+			return(unexpected(Engine::Error::InitializationError));
+		}
+
+		return(shaderWrapper);
+	}
+
+	ResourceManager::TextureOrError ResourceManager::loadTextureFromFile(const char* textureFilename, bool alpaChannel, const TextureLoadOptions& loadOptions) noexcept
 	{
 		GFX::Core::TextureWrapper textureWrapper;
 		
-		// Enable the transparency effect for the texture.
+		// Enable the transparency effect for the texture, the sized internal formats are used so
+		// the driver does not pick the precision itself.
 		if (alpaChannel) 
 		{
-			textureWrapper.setTexFormat(GL_RGBA);
+			textureWrapper.setTexFormat(loadOptions.isSRGB ? GL_SRGB8_ALPHA8 : GL_RGBA8);
 			textureWrapper.setImgFormat(GL_RGBA);
 		}
+		else
+		{
+			textureWrapper.setTexFormat(loadOptions.isSRGB ? GL_SRGB8 : GL_RGB8);
+			textureWrapper.setImgFormat(GL_RGB);
+		}
+
+		textureWrapper.setFiltering(loadOptions.filtering);
+
+		// Load the texture using the stbi_image library created by Sean Barrett(converted to the
+		// channels of the image format).
+		const GLint channelsTotal = alpaChannel ? 4 : 3;
 
-		// Load the texture using the stbi_image library created by Sean Barrett.
 		GLint    imageWidth, imageHeight, imageChannels;
-		GLubyte* imageData = stbi_load(textureFilename, &imageWidth, &imageHeight, &imageChannels, 0);
+		GLubyte* imageData = stbi_load(textureFilename, &imageWidth, &imageHeight, &imageChannels, channelsTotal);
 
 		// Assert that the image is loaded correctly and there is no errors.
 		if (imageData == nullptr)
@@ -222,8 +672,27 @@ namespace Engine
 			return(unexpected(Engine::Error::InitializationError));
 		}
 
-		// Create the texture wrapper from the data retrieved from the image.
-		textureWrapper.make(imageWidth, imageHeight, imageData);
+		// Downscale the image to the size it is drawn with, so the full size image does not
+		// waste the video memory and the bandwidth.
+		const GLuint textureWidth  = loadOptions.targetSize.x != 0 ? std::min<GLuint>(loadOptions.targetSize.x, imageWidth)  : imageWidth;
+		const GLuint textureHeight = loadOptions.targetSize.y != 0 ? std::min<GLuint>(loadOptions.targetSize.y, imageHeight) : imageHeight;
+
+		if (textureWidth != static_cast<GLuint>(imageWidth) || textureHeight != static_cast<GLuint>(imageHeight))
+		{
+			Logger::m_ResourceLogger->info("Downscaling texture {} from {}x{} to {}x{}", textureFilename, imageWidth, imageHeight, textureWidth, textureHeight);
+
+			vector<GLubyte> resizedImage(static_cast<size_t>(textureWidth) * textureHeight * channelsTotal);
+			downscaleImage(imageData, imageWidth, imageHeight, channelsTotal, resizedImage.data(), textureWidth, textureHeight);
+
+			textureWrapper.make(textureWidth, textureHeight, resizedImage.data());
+			textureWrapper.setOpaqueRect(getTextureOpaqueRect(resizedImage.data(), textureWidth, textureHeight, channelsTotal));
+		}
+		else
+		{
+			// Create the texture wrapper from the data retrieved from the image.
+			textureWrapper.make(imageWidth, imageHeight, imageData);
+			textureWrapper.setOpaqueRect(getTextureOpaqueRect(imageData, imageWidth, imageHeight, channelsTotal));
+		}
 
 		// Free the image data as it is already binded to the ::TextureWrapper
 		stbi_image_free(imageData);
@@ -8,14 +8,44 @@
 #include "rendering/ShaderWrapper.hpp"
 #include "rendering/TextureWrapper.hpp"
 
+#include "span"
+#include "unordered_set"
+#include "vector"
+
 using namespace std;
 
 // This namespace is polluted with code for the game engine
 namespace Engine
 {
+	// The options of the texture that is loaded from the file.
+	struct TextureLoadOptions
+	{
+		// The size the image is downscaled to when it is loaded(the zero keeps the size of the
+		// image, the image is never upscaled).
+		glm::uvec2 targetSize = { 0, 0 };
+
+		GFX::Core::TextureFiltering filtering = GFX::Core::TextureFiltering::Bilinear;
+
+		// The colors of the image are sRGB-encoded, so the sampler decodes them(the framebuffer
+		// must be the sRGB one to show the same colors).
+		bool isSRGB = false;
+	};
+
+	// The residency of the loaded textures(see ::ResourceManager::setTextureBudget).
+	struct TextureResidency
+	{
+		size_t   residentTextures = 0;
+		size_t   evictedTextures  = 0;
+		size_t   residentBytes    = 0;
+		size_t   budgetBytes      = 0;
+		uint64_t evictionsTotal   = 0;
+		uint64_t reloadsTotal     = 0;
+	};
+
 	// The resource manager is responsible for managing resources that are used in the game(shaders and
 	// textures in that case). Basically this class is the safe wrapper around to unordered_maps that are
-	// containing either shader or texture and its descriptor.
+	// containing either shader or texture and its descriptor. The names are interned when the resource
+	// is loaded, and the resources are looked up by the ::StringID afterwards.
 	class ResourceManager
 	{
 		// Typedef the std::expected containers for better readability.
@@ -24,16 +54,40 @@ namespace Engine
 
 	public:
 		// Load the shader and get either an error or a shader packed into the ::ShaderWrapper class.
-		static ShaderOrError loadShader(const char* vertShaderFilename, const char* fragShaderFilename, const char* geomShaderFilename, const string& name) noexcept;
+		static ShaderOrError loadShader(const char* vertShaderFilename, const char* fragShaderFilename, const char* geomShaderFilename, string_view name) noexcept;
 
 		// Retrieve the loaded shader and get either an error or a shader packed into the ::ShaderWrapper class.
-		static ShaderOrError getShader(const string& shaderName) noexcept;
+		static ShaderOrError getShader(StringID shaderName) noexcept;
+
+		// Load the shader that has the compile-time variants, the bit `N` of the variant mask adds
+		// the `#define` of the `variantDefines[N]` to the sources. The base variant(no defines) is
+		// compiled right away and is retrieved with ::getShader as well, the rest are compiled
+		// when they are used for the first time.
+		static ShaderOrError loadShaderVariants(const char* vertShaderFilename, const char* fragShaderFilename, const char* geomShaderFilename, string_view name, span<const char* const> variantDefines) noexcept;
+
+		// Retrieve the variant of the shader, the variant is compiled and cached on the first use.
+		static ShaderOrError getShaderVariant(StringID shaderName, uint32_t variantMask) noexcept;
 
 		// Load the texture and get either an error or a shader packed into the ::TextureWrapper class.
-		static TextureOrError loadTexture(const char* textureFileName, GLboolean alphaChannel, const string& name) noexcept;
+		static TextureOrError loadTexture(const char* textureFileName, GLboolean alphaChannel, string_view name, const TextureLoadOptions& loadOptions = {}) noexcept;
 
 		// Retrieve the loaded texture and get either an error or a shader packed into the ::TextureWrapper class.
-		static TextureOrError getTexture(const string& name) noexcept;
+		// The texture that was evicted is loaded from its file again.
+		static TextureOrError getTexture(StringID name) noexcept;
+
+		// Get the amount of the video memory that is taken by the resident textures(bytes).
+		static size_t getTextureMemory() noexcept;
+
+		// Set the amount of the video memory the textures may take(bytes, zero is no limit). The
+		// least recently used textures over the budget are evicted on the frame boundary.
+		static void setTextureBudget(size_t budgetBytes) noexcept;
+
+		// Start the new frame and evict the textures that are over the budget(the ones that were
+		// used in the last few frames are kept).
+		static void beginFrame() noexcept;
+
+		// Get the residency statistics of the textures.
+		static TextureResidency getTextureResidency() noexcept;
 
 		// Destroy all the loaded shaders and textures.
 		static void release() noexcept;
@@ -42,11 +96,49 @@ namespace Engine
 		// Load the shaders from the file.
 		static ShaderOrError  loadShaderFromFile(const char* vertShaderFilename, const char* fragShaderFilename, const char* geomShaderFilename = nullptr) noexcept;
 
+		// Read the whole shader source file.
+		static bool readShaderFile(const char* shaderFilename, string& sourceCode) noexcept;
+
+		// Compile the variant of the shader from its sources.
+		static ShaderOrError compileShaderVariant(StringID shaderName, uint32_t variantMask) noexcept;
+
 		// Load the texture from the file.
-		static TextureOrError loadTextureFromFile(const char* textureFilename, bool alpaChannel) noexcept;
+		static TextureOrError loadTextureFromFile(const char* textureFilename, bool alpaChannel, const TextureLoadOptions& loadOptions) noexcept;
+
+		// Evict the least recently used textures until they fit into the budget.
+		static void evictTextures() noexcept;
 		
 	private:
-		static std::unordered_map<string, GFX::Core::ShaderWrapper>  m_Shaders;
-		static std::unordered_map<string, GFX::Core::TextureWrapper> m_Textures;
+		// The source of the loaded texture, so it can be loaded again after the eviction.
+		struct TextureRecord
+		{
+			std::string        filename;
+			bool               alphaChannel  = false;
+			TextureLoadOptions loadOptions;
+			uint64_t           lastUsedFrame = 0;
+		};
+
+		// The sources of the shader with the variants.
+		struct ShaderVariantSource
+		{
+			std::string              vertexSource;
+			std::string              fragmentSource;
+			std::string              geometrySource;
+			bool                     hasGeometry = false;
+			std::vector<std::string> variantDefines;
+		};
+
+		static std::unordered_map<StringID, GFX::Core::ShaderWrapper>  m_Shaders;
+		static std::unordered_map<StringID, ShaderVariantSource>       m_ShaderVariantSources;
+		static std::unordered_map<uint64_t, GFX::Core::ShaderWrapper>  m_ShaderVariants; // the name in the high bits, the mask in the low ones
+		static std::unordered_set<uint64_t>                            m_FailedShaderVariants; // not compiled again until the sources are reloaded
+		static std::unordered_map<StringID, GFX::Core::TextureWrapper> m_Textures;
+		static std::unordered_map<StringID, TextureRecord>             m_TextureRecords;
+
+		static size_t   m_TextureMemory;
+		static size_t   m_TextureBudget;
+		static uint64_t m_FrameIndex;
+		static uint64_t m_TextureEvictions;
+		static uint64_t m_TextureReloads;
 	};
 }
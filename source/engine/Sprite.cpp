@@ -7,31 +7,30 @@ using namespace std;
 
 namespace Engine::GFX
 {
-	void Sprite::render(shared_ptr<Engine::GFX::SpriteRenderer>& spriteRenderer) const noexcept
+	void Sprite::render(shared_ptr<Engine::GFX::SpriteRenderer>& spriteRenderer, uint32_t effectFlags) const noexcept
 	{
-		// Use the sprite shader that is compiled only for rendering sprites.
-		auto shaderOrError = Engine::ResourceManager::getShader("spriteShader");
-
-		if (shaderOrError.has_value())
-		{
-			shaderOrError.value().useShader();
-		}
-		else
-		{
-			// Well, actually the shader cannot be destroyed, but defensive coding thing, whatever
-			Engine::Logger::m_GraphicsLogger->error("Attempted to render the sprite without its shader");
+		// The renderer uses the variant of the sprite shader the effects select.
+		spriteRenderer->renderSprite(m_BindedTexture, m_SpritePosition, m_SpriteSize, m_SpriteRotation, m_SpriteColor, effectFlags);
+	}
 
-			return;
-		}
+	void Sprite::queue(shared_ptr<Engine::GFX::SpriteRenderer>& spriteRenderer, uint32_t instanceFlags) const
+	{
+		SpriteBatchItem batchItem;
+		batchItem.textureName    = m_BindedTexture;
+		batchItem.spritePosition = m_SpritePosition;
+		batchItem.spriteSize     = m_SpriteSize;
+		batchItem.spriteRotation = m_SpriteRotation;
+		batchItem.spriteColor    = m_SpriteColor;
+		batchItem.instanceFlags  = instanceFlags;
+		batchItem.pickingID      = m_PickingID;
 
-		// And finally, render the sprite!
-		spriteRenderer->renderSprite(m_BindedTextureName, m_SpritePosition, m_SpriteSize, m_SpriteRotation, m_SpriteColor);
+		spriteRenderer->queueSprite(batchItem);
 	}
 
     // Bind the ::TextureWrapper descriptor to this sprite.
-    void Sprite::bindTexture(const string& textureName) noexcept
+    void Sprite::bindTexture(StringID textureName) noexcept
 	{
-		m_BindedTextureName = textureName;
+		m_BindedTexture = textureName;
 	}
 
     bool Sprite::isHovered(vec2 mousePosition, vec2 range) const
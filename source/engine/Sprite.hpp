@@ -18,7 +18,10 @@ namespace Engine::GFX
 	class Sprite
 	{
 	public:
-		Sprite() : m_SpritePosition({ 0.0f, 0.0f }), m_SpriteSize({ 0.0f, 0.0f }), m_SpriteColor({ 1.0f, 1.0f, 1.0f }), m_SpriteRotation(0.0f)
+		// The sprites with this ID are ignored by the ::PickingIndex.
+		static constexpr const GLuint InvalidPickingID = SpriteBatchItem::InvalidPickingID;
+
+		Sprite() : m_SpritePosition({ 0.0f, 0.0f }), m_SpriteSize({ 0.0f, 0.0f }), m_SpriteColor({ 1.0f, 1.0f, 1.0f }), m_SpriteRotation(0.0f), m_PickingID(InvalidPickingID)
 		{
 		}
 
@@ -32,19 +35,24 @@ namespace Engine::GFX
 		
 		#define __gettersettertype GLuint
 		makeGetterAndSetter(m_RenderFlag, RenderFlag);
+		makeGetterAndSetter(m_PickingID,  PickingID);
 
-		#define __gettersettertype string
-		makeGetter(m_BindedTextureName, BindedTexture);
+		#define __gettersettertype StringID
+		makeGetter(m_BindedTexture, BindedTexture);
 
 		#define __gettersettertype GLfloat		
 		makeGetterAndSetter(m_SpriteRotation,    SpriteRotation);
 		#undef __gettersettertype
 
-		// Render the sprite on the screen using the ::SpriteRenderer tool.
-		void render(shared_ptr<Engine::GFX::SpriteRenderer>& spriteRenderer) const noexcept;
+		// Render the sprite on the screen using the ::SpriteRenderer tool(the effects select the
+		// variant of the sprite shader).
+		void render(shared_ptr<Engine::GFX::SpriteRenderer>& spriteRenderer, uint32_t effectFlags = SpriteInstanceNone) const noexcept;
+
+		// Queue the sprite for the batched rendering(drawn by the ::SpriteRenderer::flushSprites).
+		void queue(shared_ptr<Engine::GFX::SpriteRenderer>& spriteRenderer, uint32_t instanceFlags = SpriteInstanceNone) const;
 
         // Bind the ::TextureWrapper descriptor to this sprite.
-        void bindTexture(const string& textureName) noexcept;
+        void bindTexture(StringID textureName) noexcept;
 
         // Find out if the sprite is hovered by the mouse.
         bool isHovered(vec2 mousePosition, vec2 range) const;
@@ -55,7 +63,11 @@ namespace Engine::GFX
 		vec3      m_SpriteColor;
 		GLfloat   m_SpriteRotation;
 
-		GLuint m_RenderFlag;
-		string m_BindedTextureName;
+		GLuint   m_PickingID;
+		GLuint   m_RenderFlag;
+		StringID m_BindedTexture;
 	};
+
+	// The sprites are copied around every frame, so they must stay plain data.
+	static_assert(is_trivially_copyable_v<Sprite>, "The sprite must be trivially copyable");
 }
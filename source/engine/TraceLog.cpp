@@ -0,0 +1,294 @@
+// This file implements the `TraceLog` class.
+#include "TraceLog.hpp"
+#include "Logger.hpp"
+
+using namespace std;
+
+// The memory limit of the trace log, the records are dropped when the writer falls behind.
+static constexpr const size_t TRACE_MAX_CHUNKS = 256;
+
+namespace Engine
+{
+	Error TraceLog::open(const char* filename) noexcept
+	{
+		if (isOpen())
+		{
+			Logger::m_ApplicationLogger->error("The trace log is already open");
+
+			return(Error::ValidationError);
+		}
+
+		m_File = fopen(filename, "wb");
+
+		if (m_File == nullptr)
+		{
+			Logger::m_ApplicationLogger->error("Unable to open the trace log file {}", filename);
+
+			return(Error::InitializationError);
+		}
+
+		// The decoder prints the time relative to this timestamp.
+		const uint32_t fileHeader[2] = { TraceFile::HeaderTag, TraceFile::Version };
+		const uint64_t startTimestamp = InputQueue::timestamp();
+
+		fwrite(fileHeader,      sizeof(fileHeader),     1, m_File);
+		fwrite(&startTimestamp, sizeof(startTimestamp), 1, m_File);
+
+		// The formats that were registered during the previous sessions are written again.
+		{
+			lock_guard<mutex> formatLock(m_FormatMutex);
+			m_WrittenFormats = 0;
+		}
+
+		m_IsStopping   = false;
+		m_WriterThread = thread(&TraceLog::writerLoop, this);
+
+		m_IsOpen.store(true);
+
+		Logger::m_ApplicationLogger->info("Writing the trace log into {}", filename);
+
+		return(Error::Ok);
+	}
+
+	void TraceLog::close() noexcept
+	{
+		if (!m_IsOpen.exchange(false))
+			return;
+
+		// Hand over the partially filled chunks of all the threads.
+		{
+			lock_guard<mutex> threadLock(m_ThreadMutex);
+
+			for (auto traceThread : m_Threads)
+			{
+				if (traceThread->currentChunk != nullptr)
+				{
+					submit(traceThread->currentChunk);
+					traceThread->currentChunk = nullptr;
+				}
+			}
+		}
+
+		{
+			lock_guard<mutex> chunkLock(m_ChunkMutex);
+			m_IsStopping = true;
+		}
+		m_ChunkCondition.notify_one();
+
+		m_WriterThread.join();
+
+		fclose(m_File);
+		m_File = nullptr;
+
+		// The log is idle, so the chunks are not needed anymore.
+		for (auto traceChunk : m_FreeChunks)
+			delete traceChunk;
+		m_FreeChunks.clear();
+
+		if (getDroppedCount() > 0)
+			Logger::m_ApplicationLogger->warn("{} trace records were dropped", getDroppedCount());
+
+		Logger::m_ApplicationLogger->info("The trace log has been closed");
+	}
+
+	uint32_t TraceLog::registerFormat(const TraceSite& traceSite, const char* formatString, vector<TraceArgType> argTypes)
+	{
+		lock_guard<mutex> formatLock(m_FormatMutex);
+
+		// The records of this call site are dropped.
+		if (m_Formats.size() >= MaxFormats)
+		{
+			Logger::m_ApplicationLogger->error("Too many trace log formats, {}:{} is ignored", traceSite.fileName, traceSite.lineNumber);
+
+			return(MaxFormats);
+		}
+
+		m_Formats.push_back({ traceSite, formatString, std::move(argTypes) });
+
+		return(static_cast<uint32_t>(m_Formats.size() - 1));
+	}
+
+	TraceLog::TraceThread::~TraceThread()
+	{
+		auto& traceLog = TraceLog::instance();
+
+		lock_guard<mutex> threadLock(traceLog.m_ThreadMutex);
+
+		// The thread is leaving, its records are written out now.
+		if (currentChunk != nullptr)
+			traceLog.submit(currentChunk);
+
+		erase(traceLog.m_Threads, this);
+	}
+
+	byte* TraceLog::beginRecord(uint32_t formatID, size_t maxArgumentsSize) noexcept
+	{
+		const uint16_t recordFormat = static_cast<uint16_t>(formatID);
+		const size_t   maxRecordSize = sizeof(uint16_t) + sizeof(uint32_t) + maxArgumentsSize;
+
+		if (!isOpen() || formatID >= MaxFormats || maxRecordSize > ChunkSize)
+		{
+			m_DroppedCount.fetch_add(1, memory_order_relaxed);
+
+			return(nullptr);
+		}
+
+		const uint64_t timestamp   = InputQueue::timestamp();
+		auto&          traceThread = getThread();
+
+		// The new chunk is started when the record does not fit, or when its timestamp
+		// can not be stored as the 32-bit delta from the chunk base(~4 seconds).
+		if (traceThread.currentChunk == nullptr ||
+			traceThread.currentChunk->usedBytes + maxRecordSize > ChunkSize ||
+			timestamp - traceThread.currentChunk->baseTimestamp > UINT32_MAX)
+		{
+			if (traceThread.currentChunk != nullptr)
+				submit(traceThread.currentChunk);
+
+			traceThread.currentChunk = acquireChunk();
+
+			if (traceThread.currentChunk == nullptr)
+			{
+				m_DroppedCount.fetch_add(1, memory_order_relaxed);
+
+				return(nullptr);
+			}
+
+			traceThread.currentChunk->threadIndex   = traceThread.threadIndex;
+			traceThread.currentChunk->baseTimestamp = timestamp;
+		}
+
+		auto& traceChunk = *traceThread.currentChunk;
+
+		const uint32_t timestampDelta = static_cast<uint32_t>(timestamp - traceChunk.baseTimestamp);
+
+		byte* recordData = traceChunk.chunkData.data() + traceChunk.usedBytes;
+
+		memcpy(recordData,                    &recordFormat,   sizeof(recordFormat));
+		memcpy(recordData + sizeof(uint16_t), &timestampDelta, sizeof(timestampDelta));
+
+		return(recordData + sizeof(uint16_t) + sizeof(uint32_t));
+	}
+
+	void TraceLog::commitRecord(byte* recordEnd) noexcept
+	{
+		// The record was written right after the used part of the current chunk.
+		auto& traceChunk = *getThread().currentChunk;
+
+		traceChunk.usedBytes = static_cast<size_t>(recordEnd - traceChunk.chunkData.data());
+	}
+
+	void TraceLog::submit(TraceChunk* traceChunk) noexcept
+	{
+		{
+			lock_guard<mutex> chunkLock(m_ChunkMutex);
+			m_SubmittedChunks.push_back(traceChunk);
+		}
+		m_ChunkCondition.notify_one();
+	}
+
+	TraceLog::TraceChunk* TraceLog::acquireChunk() noexcept
+	{
+		lock_guard<mutex> chunkLock(m_ChunkMutex);
+
+		if (!m_FreeChunks.empty())
+		{
+			TraceChunk* traceChunk = m_FreeChunks.back();
+			m_FreeChunks.pop_back();
+
+			return(traceChunk);
+		}
+
+		if (m_SubmittedChunks.size() >= TRACE_MAX_CHUNKS)
+			return(nullptr);
+
+		return(new (nothrow) TraceChunk());
+	}
+
+	TraceLog::TraceThread& TraceLog::getThread() noexcept
+	{
+		static thread_local TraceThread traceThread;
+		static thread_local bool        isRegistered = false;
+
+		if (!isRegistered)
+		{
+			traceThread.threadIndex = m_NextThread.fetch_add(1, memory_order_relaxed);
+
+			lock_guard<mutex> threadLock(m_ThreadMutex);
+			m_Threads.push_back(&traceThread);
+
+			isRegistered = true;
+		}
+
+		return(traceThread);
+	}
+
+	void TraceLog::writeFormat(uint32_t formatID, const TraceFormat& traceFormat) noexcept
+	{
+		const uint32_t formatHeader[3] = { TraceFile::FormatTag, formatID, traceFormat.traceSite.lineNumber };
+		const uint8_t  argCount        = static_cast<uint8_t>(traceFormat.argTypes.size());
+		const uint16_t fileLength      = static_cast<uint16_t>(strlen(traceFormat.traceSite.fileName));
+		const uint16_t formatLength    = static_cast<uint16_t>(traceFormat.formatString.size());
+
+		fwrite(formatHeader,                       sizeof(formatHeader), 1, m_File);
+		fwrite(&argCount,                          sizeof(argCount),     1, m_File);
+		fwrite(traceFormat.argTypes.data(),        sizeof(TraceArgType), argCount, m_File);
+		fwrite(&fileLength,                        sizeof(fileLength),   1, m_File);
+		fwrite(traceFormat.traceSite.fileName,     1, fileLength,           m_File);
+		fwrite(&formatLength,                      sizeof(formatLength), 1, m_File);
+		fwrite(traceFormat.formatString.data(),    1, formatLength,         m_File);
+	}
+
+	void TraceLog::writerLoop() noexcept
+	{
+		vector<TraceChunk*> writtenChunks;
+
+		auto writePendingFormats = [this]()
+		{
+			lock_guard<mutex> formatLock(m_FormatMutex);
+
+			for (; m_WrittenFormats < m_Formats.size(); ++m_WrittenFormats)
+				writeFormat(static_cast<uint32_t>(m_WrittenFormats), m_Formats[m_WrittenFormats]);
+		};
+
+		unique_lock<mutex> chunkLock(m_ChunkMutex);
+
+		while (true)
+		{
+			m_ChunkCondition.wait(chunkLock, [this]() { return(!m_SubmittedChunks.empty() || m_IsStopping); });
+
+			if (m_SubmittedChunks.empty())
+				break;
+
+			writtenChunks.swap(m_SubmittedChunks);
+			chunkLock.unlock();
+
+			// The formats are registered before the records that are using them, so
+			// the definitions always precede the records in the file.
+			writePendingFormats();
+
+			for (auto traceChunk : writtenChunks)
+			{
+				const uint32_t chunkHeader[2] = { TraceFile::ChunkTag, traceChunk->threadIndex };
+				const uint32_t chunkSize      = static_cast<uint32_t>(traceChunk->usedBytes);
+
+				fwrite(chunkHeader,                   sizeof(chunkHeader), 1, m_File);
+				fwrite(&traceChunk->baseTimestamp,    sizeof(uint64_t),    1, m_File);
+				fwrite(&chunkSize,                    sizeof(chunkSize),   1, m_File);
+				fwrite(traceChunk->chunkData.data(),  1, traceChunk->usedBytes, m_File);
+
+				traceChunk->usedBytes = 0;
+			}
+
+			chunkLock.lock();
+
+			m_FreeChunks.insert(m_FreeChunks.end(), writtenChunks.begin(), writtenChunks.end());
+			writtenChunks.clear();
+		}
+
+		chunkLock.unlock();
+
+		writePendingFormats();
+		fflush(m_File);
+	}
+}
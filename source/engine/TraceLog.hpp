@@ -0,0 +1,334 @@
+// This file declares the `TraceLog` class.
+//
+// The `TraceLog` class is the binary logging channel for the long running sessions: the
+// call site writes only the format ID and the raw argument bytes, the text is produced
+// offline by the `log-decode` tool.
+#pragma once
+
+#include "_EngineIncludes.hpp"
+
+#include "array"
+#include "vector"
+#include "mutex"
+#include "atomic"
+#include "thread"
+#include "cstring"
+#include "string_view"
+#include "type_traits"
+#include "condition_variable"
+
+#include "InputQueue.hpp"
+
+// Set to zero to remove all the ENGINE_TRACE calls from the build.
+#ifndef ENGINE_TRACE_ENABLED
+	#define ENGINE_TRACE_ENABLED 1
+#endif
+
+// Write the event into the trace log:
+//
+//   ENGINE_TRACE("Card {} moved to the player {}", cardRank, playerIndex);
+//
+// The format is registered once per call site, the arguments are copied as raw bytes.
+#if ENGINE_TRACE_ENABLED
+	#define ENGINE_TRACE(...) Engine::traceEvent([]() { return(Engine::TraceSite{ __FILE__, __LINE__ }); }, __VA_ARGS__)
+#else
+	#define ENGINE_TRACE(...) (void)0
+#endif
+
+// This namespace is polluted with code for the game engine
+namespace Engine
+{
+	// The file layout(all the integers are little-endian):
+	//
+	//   header:  'ETRC', version(u32), start timestamp(u64)
+	//   format:  'FRMT', format ID(u32), line(u32), argument count(u8), argument types(u8 each),
+	//            file length(u16), file, format length(u16), format
+	//   chunk:   'CHNK', thread index(u32), base timestamp(u64), size(u32), records
+	//   record:  format ID(u16), timestamp delta from the chunk base(u32), arguments
+	//
+	// The integer arguments are stored as the LEB128 varints(the signed ones are zigzag
+	// encoded first), so the small values take a single byte.
+	namespace TraceFile
+	{
+		static constexpr const uint32_t HeaderTag = 0x43525445u; // "ETRC"
+		static constexpr const uint32_t FormatTag = 0x544D5246u; // "FRMT"
+		static constexpr const uint32_t ChunkTag  = 0x4B4E4843u; // "CHNK"
+		static constexpr const uint32_t Version   = 1u;
+
+		// The largest varint(64-bit value).
+		static constexpr const size_t MaxVarintSize = 10;
+	}
+
+	// The type of the argument in the record.
+	enum class TraceArgType : uint8_t
+	{
+		Int32,  // zigzag varint
+		Int64,  // zigzag varint
+		UInt32, // varint
+		UInt64, // varint
+		Float,
+		Double,
+		Bool,
+		String, // length(u16), characters
+	};
+
+	// The location of the call site(the format string is passed along with the arguments).
+	struct TraceSite
+	{
+		const char* fileName;
+		uint32_t    lineNumber;
+	};
+
+	// Map the argument type to the record type.
+	template<typename T>
+	consteval TraceArgType getTraceArgType()
+	{
+		using ArgType = std::remove_cvref_t<T>;
+
+		if constexpr (std::is_same_v<ArgType, bool>)
+			return(TraceArgType::Bool);
+		else if constexpr (std::is_same_v<ArgType, StringID>)
+			return(TraceArgType::UInt32);
+		else if constexpr (std::is_enum_v<ArgType>)
+			return(getTraceArgType<std::underlying_type_t<ArgType>>());
+		else if constexpr (std::is_same_v<ArgType, float>)
+			return(TraceArgType::Float);
+		else if constexpr (std::is_floating_point_v<ArgType>)
+			return(TraceArgType::Double);
+		else if constexpr (std::is_integral_v<ArgType> && std::is_signed_v<ArgType>)
+			return(sizeof(ArgType) <= 4 ? TraceArgType::Int32 : TraceArgType::Int64);
+		else if constexpr (std::is_integral_v<ArgType>)
+			return(sizeof(ArgType) <= 4 ? TraceArgType::UInt32 : TraceArgType::UInt64);
+		else if constexpr (std::is_convertible_v<const ArgType&, std::string_view>)
+			return(TraceArgType::String);
+		else
+			static_assert(sizeof(ArgType) == 0, "The type can not be written into the trace log");
+	}
+
+	// This class collects the binary records into the per-thread chunks(no locks on the
+	// hot path), the full chunks are written into the file by the background thread.
+	class TraceLog
+	{
+	private:
+		TraceLog() = default;
+
+	public:
+		TraceLog(const TraceLog&)            = delete;
+		TraceLog& operator=(const TraceLog&) = delete;
+
+		// This function is the way to realize the Singleton OOP programming pattern,
+		// so that this class can only be instantiated only once.
+		static TraceLog& instance()
+		{
+			static TraceLog _instance;
+			return(_instance);
+		}
+
+	public:
+		// The size of the per-thread chunk.
+		static constexpr const size_t ChunkSize = 64 * 1024;
+
+		// The longest string argument, the longer ones are truncated.
+		static constexpr const size_t MaxStringLength = 256;
+
+		// The largest amount of the formats(the format ID is 16-bit in the file).
+		static constexpr const uint32_t MaxFormats = 0xFFFFu;
+
+		// Start writing the records into the file.
+		Error open(const char* filename) noexcept;
+
+		// Write out all the chunks and close the file. The other threads must not be
+		// tracing during the call(their partial chunks are flushed too).
+		void close() noexcept;
+
+		inline bool isOpen() const noexcept
+		{
+			return(m_IsOpen.load(std::memory_order_relaxed));
+		}
+
+		// Remember the format of the call site and get its ID.
+		uint32_t registerFormat(const TraceSite& traceSite, const char* formatString, std::vector<TraceArgType> argTypes);
+
+		// Write the record(the format must be registered).
+		template<typename... Args>
+		void write(uint32_t formatID, const Args&... args) noexcept
+		{
+			const size_t maxArgumentsSize = (getMaxArgumentSize(args) + ... + 0);
+
+			std::byte* recordData = beginRecord(formatID, maxArgumentsSize);
+			if (recordData == nullptr)
+				return;
+
+			((recordData = writeArgument(recordData, args)), ...);
+
+			commitRecord(recordData);
+		}
+
+		// Get the amount of the records that were lost(the string was too long, the log was closing etc.).
+		inline uint64_t getDroppedCount() const noexcept
+		{
+			return(m_DroppedCount.load(std::memory_order_relaxed));
+		}
+
+	private:
+		// The per-thread chunk that is filled by the hot path.
+		struct TraceChunk
+		{
+			uint32_t                          threadIndex   = 0;
+			uint64_t                          baseTimestamp = 0;
+			size_t                            usedBytes     = 0;
+			std::array<std::byte, ChunkSize>  chunkData;
+		};
+
+		// The state of the thread that is writing the records.
+		struct TraceThread
+		{
+			TraceChunk* currentChunk = nullptr;
+			uint32_t    threadIndex  = 0;
+
+			~TraceThread();
+		};
+
+		// The registered call site.
+		struct TraceFormat
+		{
+			TraceSite                 traceSite;
+			std::string_view          formatString;
+			std::vector<TraceArgType> argTypes;
+		};
+
+		template<typename T>
+		static size_t getMaxArgumentSize(const T& arg) noexcept
+		{
+			constexpr TraceArgType argType = getTraceArgType<T>();
+
+			if constexpr (argType == TraceArgType::String)
+				return(sizeof(uint16_t) + std::min(std::string_view(arg).size(), MaxStringLength));
+			else if constexpr (argType == TraceArgType::Bool)
+				return(sizeof(uint8_t));
+			else if constexpr (argType == TraceArgType::Float)
+				return(sizeof(float));
+			else if constexpr (argType == TraceArgType::Double)
+				return(sizeof(double));
+			else
+				return(TraceFile::MaxVarintSize);
+		}
+
+		static std::byte* writeVarint(std::byte* recordData, uint64_t value) noexcept
+		{
+			while (value >= 0x80u)
+			{
+				*recordData++ = static_cast<std::byte>((value & 0x7Fu) | 0x80u);
+				value >>= 7;
+			}
+
+			*recordData++ = static_cast<std::byte>(value);
+
+			return(recordData);
+		}
+
+		template<typename T>
+		static std::byte* writeArgument(std::byte* recordData, const T& arg) noexcept
+		{
+			constexpr TraceArgType argType = getTraceArgType<T>();
+
+			if constexpr (argType == TraceArgType::String)
+			{
+				const std::string_view stringArg    = arg;
+				const uint16_t         stringLength = static_cast<uint16_t>(std::min(stringArg.size(), MaxStringLength));
+
+				std::memcpy(recordData, &stringLength, sizeof(stringLength));
+				std::memcpy(recordData + sizeof(stringLength), stringArg.data(), stringLength);
+
+				return(recordData + sizeof(stringLength) + stringLength);
+			}
+			else if constexpr (argType == TraceArgType::Int32 || argType == TraceArgType::Int64)
+			{
+				const int64_t signedArg = static_cast<int64_t>(arg);
+
+				// Zigzag: the small negative values are small too.
+				return(writeVarint(recordData, (static_cast<uint64_t>(signedArg) << 1) ^ static_cast<uint64_t>(signedArg >> 63)));
+			}
+			else if constexpr (argType == TraceArgType::UInt32 || argType == TraceArgType::UInt64)
+			{
+				if constexpr (std::is_same_v<std::remove_cvref_t<T>, StringID>)
+					return(writeVarint(recordData, arg.getHash()));
+				else
+					return(writeVarint(recordData, static_cast<uint64_t>(arg)));
+			}
+			else
+			{
+				// Convert the argument to the exact type that is declared in the format.
+				using StoredType = std::conditional_t<argType == TraceArgType::Float,  float,
+				                   std::conditional_t<argType == TraceArgType::Double, double, uint8_t>>;
+
+				const StoredType storedArg = static_cast<StoredType>(arg);
+
+				std::memcpy(recordData, &storedArg, sizeof(storedArg));
+
+				return(recordData + sizeof(storedArg));
+			}
+		}
+
+		// Write the record header into the chunk of the calling thread and get the space
+		// for the arguments(or nullptr if the record is dropped).
+		std::byte* beginRecord(uint32_t formatID, size_t maxArgumentsSize) noexcept;
+
+		// Finish the record, the `recordEnd` points past the last written argument.
+		void commitRecord(std::byte* recordEnd) noexcept;
+
+		// Hand the chunk over to the writer thread.
+		void submit(TraceChunk* traceChunk) noexcept;
+
+		// Get the empty chunk.
+		TraceChunk* acquireChunk() noexcept;
+
+		// Get the state of the calling thread.
+		TraceThread& getThread() noexcept;
+
+		// Write the format definition into the file(the file mutex must be locked).
+		void writeFormat(uint32_t formatID, const TraceFormat& traceFormat) noexcept;
+
+		// The loop of the writer thread.
+		void writerLoop() noexcept;
+
+	private:
+		std::atomic<bool>     m_IsOpen       = false;
+		std::atomic<uint64_t> m_DroppedCount = 0;
+		std::atomic<uint32_t> m_NextThread   = 0;
+
+		// The registered formats, the format ID is the index in this array.
+		std::mutex               m_FormatMutex;
+		std::vector<TraceFormat> m_Formats;
+		size_t                   m_WrittenFormats = 0;
+
+		// The threads that have the chunks(used to flush them on close).
+		std::mutex                 m_ThreadMutex;
+		std::vector<TraceThread*>  m_Threads;
+
+		// The chunks that are waiting to be written, and the empty ones.
+		std::mutex                  m_ChunkMutex;
+		std::condition_variable     m_ChunkCondition;
+		std::vector<TraceChunk*>    m_SubmittedChunks;
+		std::vector<TraceChunk*>    m_FreeChunks;
+		bool                        m_IsStopping = false;
+
+		std::thread m_WriterThread;
+		FILE*       m_File = nullptr;
+	};
+
+	// Write the event of the call site(used by the ENGINE_TRACE macro).
+	template<typename SiteFunction, size_t FormatLength, typename... Args>
+	inline void traceEvent(SiteFunction siteFunction, const char (&formatString)[FormatLength], const Args&... args) noexcept
+	{
+		auto& traceLog = TraceLog::instance();
+
+		if (!traceLog.isOpen())
+			return;
+
+		// The lambda type is unique per call site, so is this static.
+		static const uint32_t formatID = traceLog.registerFormat(siteFunction(), formatString, { getTraceArgType<Args>()... });
+
+		traceLog.write(formatID, args...);
+	}
+}
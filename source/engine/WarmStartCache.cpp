@@ -0,0 +1,238 @@
+// This file implements the `WarmStartCache` class.
+#include "WarmStartCache.hpp"
+#include "Logger.hpp"
+#include "Metrics.hpp"
+#include "Profiler.hpp"
+#include "rendering/RenderDevice.hpp"
+
+#include "cstdio"
+#include "cstring"
+
+using namespace std;
+
+// The tags and the version of the cache entries(the entries of the other version are ignored).
+static constexpr const uint32_t _PROGRAM_ENTRY_TAG = 0x4E494250u; // "PBIN"
+static constexpr const uint32_t _ENTRY_VERSION     = 1u;
+
+// The offset basis of the 64-bit FNV-1a hash.
+static constexpr const uint64_t _HASH_SEED = 14695981039346656037ull;
+
+// The metrics of the warm start cache.
+struct WarmStartMetrics
+{
+	Engine::Counter& hits   = Engine::MetricsRegistry::instance().counter("engine_warm_start_hits_total",   "The programs that were loaded from the warm start cache");
+	Engine::Counter& misses = Engine::MetricsRegistry::instance().counter("engine_warm_start_misses_total", "The programs that were not found in the warm start cache");
+};
+
+static WarmStartMetrics& warmStartMetrics()
+{
+	static WarmStartMetrics _metrics;
+	return(_metrics);
+}
+
+// Hash the bytes with the 64-bit FNV-1a function(continuing the given hash).
+static uint64_t hashBytes(const void* data, size_t size, uint64_t hash) noexcept
+{
+	const auto* bytes = static_cast<const uint8_t*>(data);
+
+	for (size_t byteIndex = 0; byteIndex < size; ++byteIndex)
+	{
+		hash ^= bytes[byteIndex];
+		hash *= 1099511628211ull;
+	}
+
+	return(hash);
+}
+
+// Hash the string including its terminator, so the neighbour strings can't be mixed up.
+static uint64_t hashText(const char* text, uint64_t hash) noexcept
+{
+	return(text != nullptr ? hashBytes(text, strlen(text) + 1, hash) : hashBytes("", 1, hash));
+}
+
+// Append the raw value to the entry.
+template<typename T>
+static void appendValue(vector<uint8_t>& entryData, const T& value)
+{
+	const auto* valueBytes = reinterpret_cast<const uint8_t*>(&value);
+	entryData.insert(entryData.end(), valueBytes, valueBytes + sizeof(T));
+}
+
+// Reads the raw values of the entry, every read fails after the end of the entry.
+class EntryReader
+{
+public:
+	explicit EntryReader(const vector<uint8_t>& entryData) noexcept : m_EntryData(entryData)
+	{
+	}
+
+	template<typename T>
+	bool read(T& value) noexcept
+	{
+		return(readBytes(&value, sizeof(T)));
+	}
+
+	bool readBytes(void* destination, size_t size) noexcept
+	{
+		if (m_EntryData.size() - m_Offset < size)
+			return(false);
+
+		memcpy(destination, m_EntryData.data() + m_Offset, size);
+		m_Offset += size;
+
+		return(true);
+	}
+
+	inline size_t getRemaining() const noexcept
+	{
+		return(m_EntryData.size() - m_Offset);
+	}
+
+private:
+	const vector<uint8_t>& m_EntryData;
+	size_t                 m_Offset = 0;
+};
+
+namespace Engine
+{
+	Error WarmStartCache::initialize(const char* directoryPath) noexcept
+	{
+		error_code errorCode;
+		filesystem::create_directories(directoryPath, errorCode);
+
+		if (errorCode)
+		{
+			Logger::m_ResourceLogger->warn("Unable to create the warm start cache directory {}({})", directoryPath, errorCode.message());
+
+			return(Error::InitializationError);
+		}
+
+		m_Directory = directoryPath;
+		m_IsEnabled = true;
+
+		return(Error::Ok);
+	}
+
+	uint64_t WarmStartCache::getProgramKey(const char* vertexSource, const char* fragmentSource, const char* geometrySource) noexcept
+	{
+		if (m_DriverSignature.empty())
+			m_DriverSignature = GFX::RenderDevice::instance().getDriverSignature();
+
+		uint64_t programKey = hashText(m_DriverSignature.c_str(), _HASH_SEED);
+		programKey = hashText(vertexSource,   programKey);
+		programKey = hashText(fragmentSource, programKey);
+		programKey = hashText(geometrySource, programKey);
+
+		return(programKey);
+	}
+
+	bool WarmStartCache::loadProgram(uint64_t programKey, GLenum& binaryFormat, vector<uint8_t>& programBinary) noexcept
+	{
+		if (!m_IsEnabled)
+			return(false);
+
+		ENGINE_PROFILE_SCOPE("WarmStartCache::loadProgram");
+
+		vector<uint8_t> entryData;
+
+		if (!readEntry(getEntryPath("program", programKey), entryData))
+		{
+			warmStartMetrics().misses.increment();
+
+			return(false);
+		}
+
+		EntryReader entryReader(entryData);
+
+		uint32_t entryTag = 0, entryVersion = 0, binarySize = 0;
+		uint64_t entryKey = 0;
+
+		const bool isValid =
+			entryReader.read(entryTag)     && entryTag     == _PROGRAM_ENTRY_TAG &&
+			entryReader.read(entryVersion) && entryVersion == _ENTRY_VERSION     &&
+			entryReader.read(entryKey)     && entryKey     == programKey         &&
+			entryReader.read(binaryFormat) &&
+			entryReader.read(binarySize)   && binarySize   == entryReader.getRemaining();
+
+		if (!isValid)
+		{
+			Logger::m_ResourceLogger->warn("The cached program {:016x} is broken", programKey);
+			warmStartMetrics().misses.increment();
+
+			return(false);
+		}
+
+		programBinary.resize(binarySize);
+		entryReader.readBytes(programBinary.data(), binarySize);
+
+		warmStartMetrics().hits.increment();
+
+		return(true);
+	}
+
+	void WarmStartCache::storeProgram(uint64_t programKey, GLenum binaryFormat, const vector<uint8_t>& programBinary) noexcept
+	{
+		if (!m_IsEnabled)
+			return;
+
+		vector<uint8_t> entryData;
+		entryData.reserve(programBinary.size() + 32);
+
+		appendValue(entryData, _PROGRAM_ENTRY_TAG);
+		appendValue(entryData, _ENTRY_VERSION);
+		appendValue(entryData, programKey);
+		appendValue(entryData, binaryFormat);
+		appendValue(entryData, static_cast<uint32_t>(programBinary.size()));
+
+		entryData.insert(entryData.end(), programBinary.begin(), programBinary.end());
+
+		writeEntry(getEntryPath("program", programKey), entryData);
+	}
+
+	filesystem::path WarmStartCache::getEntryPath(const char* entryKind, uint64_t entryKey) const noexcept
+	{
+		char entryFilename[64];
+		snprintf(entryFilename, sizeof(entryFilename), "%s-%016llx.bin", entryKind, static_cast<unsigned long long>(entryKey));
+
+		return(m_Directory / entryFilename);
+	}
+
+	bool WarmStartCache::readEntry(const filesystem::path& entryPath, vector<uint8_t>& entryData) noexcept
+	{
+		ifstream entryFile(entryPath, ios::binary | ios::ate);
+
+		if (!entryFile.is_open())
+			return(false);
+
+		entryData.resize(static_cast<size_t>(entryFile.tellg()));
+
+		entryFile.seekg(0);
+		entryFile.read(reinterpret_cast<char*>(entryData.data()), static_cast<streamsize>(entryData.size()));
+
+		return(entryFile.good());
+	}
+
+	void WarmStartCache::writeEntry(const filesystem::path& entryPath, const vector<uint8_t>& entryData) noexcept
+	{
+		filesystem::path temporaryPath = entryPath;
+		temporaryPath += ".tmp";
+
+		{
+			ofstream entryFile(temporaryPath, ios::binary | ios::trunc);
+
+			if (!entryFile.is_open())
+				return;
+
+			entryFile.write(reinterpret_cast<const char*>(entryData.data()), static_cast<streamsize>(entryData.size()));
+
+			if (!entryFile.good())
+				return;
+		}
+
+		error_code errorCode;
+		filesystem::rename(temporaryPath, entryPath, errorCode);
+
+		if (errorCode)
+			Logger::m_ResourceLogger->warn("Unable to write the warm start cache entry {}({})", entryPath.string(), errorCode.message());
+	}
+}
@@ -0,0 +1,64 @@
+// This file declares the `WarmStartCache` class.
+#pragma once
+
+#include "_EngineIncludes.hpp"
+
+#include "filesystem"
+#include "vector"
+
+namespace Engine
+{
+	// This class keeps the work of the engine startup on the disk, so the later launches skip
+	// it: the linked shader program binaries(keyed by the driver and the shader sources). The
+	// entries that do not match are ignored, and the caller does the usual work.
+	class WarmStartCache
+	{
+	private:
+		WarmStartCache() = default;
+
+	public:
+		WarmStartCache(const WarmStartCache&)            = delete;
+		WarmStartCache& operator=(const WarmStartCache&) = delete;
+
+		// This function is the way to realize the Singleton OOP programming pattern,
+		// so that this class can only be instantiated only once.
+		static WarmStartCache& instance()
+		{
+			static WarmStartCache _instance;
+			return(_instance);
+		}
+
+	public:
+		// Keep the cache in the directory(it is created when it does not exist). Nothing is
+		// loaded or stored until the cache is initialized.
+		Error initialize(const char* directoryPath) noexcept;
+
+		inline bool isEnabled() const noexcept
+		{
+			return(m_IsEnabled);
+		}
+
+		// Get the key of the program(the hash of the driver signature and the sources).
+		uint64_t getProgramKey(const char* vertexSource, const char* fragmentSource, const char* geometrySource) noexcept;
+
+		// Load or store the binary of the linked program.
+		bool loadProgram(uint64_t programKey, GLenum& binaryFormat, std::vector<uint8_t>& programBinary) noexcept;
+		void storeProgram(uint64_t programKey, GLenum binaryFormat, const std::vector<uint8_t>& programBinary) noexcept;
+
+	private:
+		// Get the path of the cache entry.
+		std::filesystem::path getEntryPath(const char* entryKind, uint64_t entryKey) const noexcept;
+
+		// Read the whole entry, or write it through the temporary file(so the entry that was
+		// written partially is never read).
+		bool readEntry(const std::filesystem::path& entryPath, std::vector<uint8_t>& entryData) noexcept;
+		void writeEntry(const std::filesystem::path& entryPath, const std::vector<uint8_t>& entryData) noexcept;
+
+	private:
+		std::filesystem::path m_Directory;
+		bool                  m_IsEnabled = false;
+
+		// The signature of the render device driver(queried once).
+		std::string m_DriverSignature;
+	};
+}
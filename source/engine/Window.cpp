@@ -1,5 +1,7 @@
 #include "Window.hpp"
 #include "Logger.hpp"
+#include "HeadlessRunner.hpp"
+#include "rendering/RenderDevice.hpp"
 
 static constexpr const char* DEF_WINDOW_TITLE  = "Game 101";
 
@@ -7,7 +9,11 @@ namespace Engine
 {
 	Error Window::make(void) noexcept
 	{
-		Logger::m_ApplicationLogger->debug("Initializing GLFW window");
+		ENGINE_LOG_DEBUG(m_ApplicationLogger, "Initializing GLFW window");
+
+		// There is no monitor in the headless mode, the window is the offscreen context only.
+		if (HeadlessRunner::instance().isEnabled())
+			return(makeOffscreen());
 
 		// Get the primary monitor(if the user uses multi-monitor setup), retrieve its mode.
 		auto primaryMonitor = glfwGetPrimaryMonitor();
@@ -33,7 +39,7 @@ namespace Engine
 		// Set the Vertical synchronization ON.
 		glfwSwapInterval(1);
 
-		Logger::m_ApplicationLogger->debug("Setting up window callbacks");
+		ENGINE_LOG_DEBUG(m_ApplicationLogger, "Setting up window callbacks");
 		
 		// Track the window dimensions internally
 		m_WindowDimensions = { monitorMode->width , monitorMode->height };
@@ -44,18 +50,36 @@ namespace Engine
 		return(Engine::Error::Ok);
 	}
 
+	Error Window::makeOffscreen(void) noexcept
+	{
+		auto& headlessRunner = HeadlessRunner::instance();
+
+		m_ApplicationWindow = headlessRunner.createWindow(DEF_WINDOW_TITLE);
+
+		if (m_ApplicationWindow == nullptr)
+		{
+			Logger::m_ApplicationLogger->error("Unable to create the offscreen context(neither EGL nor OSMesa is available)");
+
+			return(Engine::Error::ValidationError);
+		}
+
+		m_WindowDimensions = headlessRunner.getSettings().dimensions;
+
+		return(Engine::Error::Ok);
+	}
+
 	void Window::frameBufferResizeCallbackImplementation(int newWidth, int newHeight) noexcept
 	{
 		// Get the current(non-resized) window dimensions.
 		const auto windowDimensions = getWindowDimensionsKHR();
 
-		Logger::m_ApplicationLogger->debug(
-			"Window resized from (%d; %d) -> (%d; %d)",
+		ENGINE_LOG_DEBUG(m_ApplicationLogger,
+			"Window resized from ({}; {}) -> ({}; {})",
 			windowDimensions.x, windowDimensions.y,
 			newWidth, newHeight);
 		
 		// Update the viewport(drawing area) according to the new window size
-		glViewport(0, 0, newWidth, newHeight);
+		GFX::RenderDevice::instance().setViewport(0, 0, newWidth, newHeight);
 	}
 
 	Window::~Window()
@@ -58,6 +58,9 @@ namespace Engine
 		Error make(void) noexcept;
 
 	private:
+		// Create the invisible window of the headless mode(see ::HeadlessRunner).
+		Error makeOffscreen(void) noexcept;
+
 		// This function is called whenever the window is being resized.
 		void frameBufferResizeCallbackImplementation(int newWidth, int newHeight) noexcept;
 
@@ -6,6 +6,7 @@
 #include "utility/Error.hpp"
 #include "utility/CheckError.hpp"
 #include "utility/GetSetMacro.hpp"
+#include "utility/StringID.hpp"
 
 // Standard library
 #include "unordered_map"
@@ -0,0 +1,267 @@
+// This file implements the `TweenSystem` class.
+#include "TweenSystem.hpp"
+
+#include "algorithm"
+#include "numbers"
+
+using namespace std;
+
+namespace Engine::Animation
+{
+	TweenHandle TweenSystem::play(TweenChannel channel, const glm::vec4& from, const glm::vec4& to, GLfloat duration, Easing easing, TweenCallback onComplete)
+	{
+		// Reuse the slot of the finished tween if there is any, otherwise grow the slot table.
+		uint32_t slotIndex;
+
+		if (!m_FreeSlots.empty())
+		{
+			slotIndex = m_FreeSlots.back();
+			m_FreeSlots.pop_back();
+		}
+		else
+		{
+			slotIndex = static_cast<uint32_t>(m_DenseOfSlot.size());
+			m_DenseOfSlot   .push_back(TweenHandle::InvalidIndex);
+			m_SlotGeneration.push_back(0u);
+		}
+
+		const uint32_t denseIndex = static_cast<uint32_t>(m_SlotOfDense.size());
+		m_DenseOfSlot[slotIndex]  = denseIndex;
+
+		// Append the tween to the end of the dense arrays.
+		for (int component = 0; component < 4; ++component)
+		{
+			m_From [component].push_back(from[component]);
+			m_Delta[component].push_back(to[component] - from[component]);
+			m_Value[component].push_back(from[component]);
+		}
+
+		// The zero duration tween is finished on the next update.
+		m_StartTime      .push_back(m_CurrentTime);
+		m_InverseDuration.push_back(duration > 0.0f ? 1.0f / duration : numeric_limits<GLfloat>::max());
+		m_Progress       .push_back(0.0f);
+		m_Easing         .push_back(easing);
+		m_Channel        .push_back(channel);
+		m_Callback       .push_back(std::move(onComplete));
+		m_SlotOfDense    .push_back(slotIndex);
+
+		return(TweenHandle{ slotIndex, m_SlotGeneration[slotIndex] });
+	}
+
+	TweenHandle TweenSystem::tweenPosition(glm::vec2 from, glm::vec2 to, GLfloat duration, Easing easing, TweenCallback onComplete)
+	{
+		return(play(TweenChannel::Position, { from, 0.0f, 0.0f }, { to, 0.0f, 0.0f }, duration, easing, std::move(onComplete)));
+	}
+
+	TweenHandle TweenSystem::tweenRotation(GLfloat from, GLfloat to, GLfloat duration, Easing easing, TweenCallback onComplete)
+	{
+		return(play(TweenChannel::Rotation, { from, 0.0f, 0.0f, 0.0f }, { to, 0.0f, 0.0f, 0.0f }, duration, easing, std::move(onComplete)));
+	}
+
+	TweenHandle TweenSystem::tweenScale(glm::vec2 from, glm::vec2 to, GLfloat duration, Easing easing, TweenCallback onComplete)
+	{
+		return(play(TweenChannel::Scale, { from, 0.0f, 0.0f }, { to, 0.0f, 0.0f }, duration, easing, std::move(onComplete)));
+	}
+
+	TweenHandle TweenSystem::tweenColor(glm::vec3 from, glm::vec3 to, GLfloat duration, Easing easing, TweenCallback onComplete)
+	{
+		return(play(TweenChannel::Color, { from, 0.0f }, { to, 0.0f }, duration, easing, std::move(onComplete)));
+	}
+
+	void TweenSystem::update(double currentTime) noexcept
+	{
+		m_CurrentTime = currentTime;
+
+		const size_t tweensTotal = m_SlotOfDense.size();
+
+		if (tweensTotal == 0)
+			return;
+
+		const double*  startTime       = m_StartTime.data();
+		const GLfloat* inverseDuration = m_InverseDuration.data();
+		GLfloat*       progress        = m_Progress.data();
+
+		// First pass: the linear progress of the each tween.
+		for (size_t tweenIndex = 0; tweenIndex < tweensTotal; ++tweenIndex)
+		{
+			const GLfloat linearProgress = static_cast<GLfloat>(currentTime - startTime[tweenIndex]) * inverseDuration[tweenIndex];
+
+			progress[tweenIndex] = std::clamp(linearProgress, 0.0f, 1.0f);
+		}
+
+		// Second pass: map the progress through the easing curve(stored in the separate
+		// array so that the linear progress stays available for the completion test).
+		m_FinishedTweens.clear();
+
+		for (size_t tweenIndex = 0; tweenIndex < tweensTotal; ++tweenIndex)
+		{
+			if (progress[tweenIndex] >= 1.0f)
+				m_FinishedTweens.emplace_back(TweenHandle{ m_SlotOfDense[tweenIndex], m_SlotGeneration[m_SlotOfDense[tweenIndex]] }, nullptr);
+
+			if (m_Easing[tweenIndex] != Easing::Linear)
+				progress[tweenIndex] = applyEasing(m_Easing[tweenIndex], progress[tweenIndex]);
+		}
+
+		// Third pass: interpolate every component of the every tween.
+		for (int component = 0; component < 4; ++component)
+		{
+			const GLfloat* from  = m_From [component].data();
+			const GLfloat* delta = m_Delta[component].data();
+			GLfloat*       value = m_Value[component].data();
+
+			for (size_t tweenIndex = 0; tweenIndex < tweensTotal; ++tweenIndex)
+				value[tweenIndex] = from[tweenIndex] + delta[tweenIndex] * progress[tweenIndex];
+		}
+
+		// Remove the finished tweens before firing the callbacks, so that the callbacks
+		// are free to start the new tweens.
+		for (auto& finishedTween : m_FinishedTweens)
+		{
+			const uint32_t denseIndex = resolve(finishedTween.first);
+
+			finishedTween.second = std::move(m_Callback[denseIndex]);
+			removeDense(denseIndex);
+		}
+
+		for (auto& finishedTween : m_FinishedTweens)
+		{
+			if (finishedTween.second)
+				finishedTween.second(finishedTween.first);
+		}
+	}
+
+	void TweenSystem::cancel(TweenHandle tweenHandle) noexcept
+	{
+		const uint32_t denseIndex = resolve(tweenHandle);
+
+		if (denseIndex != TweenHandle::InvalidIndex)
+			removeDense(denseIndex);
+	}
+
+	void TweenSystem::clear() noexcept
+	{
+		while (!m_SlotOfDense.empty())
+			removeDense(static_cast<uint32_t>(m_SlotOfDense.size() - 1));
+	}
+
+	bool TweenSystem::isActive(TweenHandle tweenHandle) const noexcept
+	{
+		return(resolve(tweenHandle) != TweenHandle::InvalidIndex);
+	}
+
+	optional<glm::vec4> TweenSystem::sample(TweenHandle tweenHandle) const noexcept
+	{
+		const uint32_t denseIndex = resolve(tweenHandle);
+
+		if (denseIndex == TweenHandle::InvalidIndex)
+			return(nullopt);
+
+		return(glm::vec4(m_Value[0][denseIndex], m_Value[1][denseIndex], m_Value[2][denseIndex], m_Value[3][denseIndex]));
+	}
+
+	GLfloat TweenSystem::applyEasing(Easing easing, GLfloat progress) noexcept
+	{
+		switch (easing)
+		{
+			case Easing::QuadIn:
+				return(progress * progress);
+
+			case Easing::QuadOut:
+				return(progress * (2.0f - progress));
+
+			case Easing::QuadInOut:
+				return(progress < 0.5f ? 2.0f * progress * progress : -1.0f + (4.0f - 2.0f * progress) * progress);
+
+			case Easing::CubicIn:
+				return(progress * progress * progress);
+
+			case Easing::CubicOut:
+			{
+				const GLfloat inverse = progress - 1.0f;
+				return(inverse * inverse * inverse + 1.0f);
+			}
+
+			case Easing::CubicInOut:
+			{
+				if (progress < 0.5f)
+					return(4.0f * progress * progress * progress);
+
+				const GLfloat inverse = 2.0f * progress - 2.0f;
+				return(0.5f * inverse * inverse * inverse + 1.0f);
+			}
+
+			case Easing::SineInOut:
+				return(0.5f - 0.5f * cosf(numbers::pi_v<GLfloat> * progress));
+
+			case Easing::BackOut:
+			{
+				// The standard overshoot value(~10% overshoot).
+				constexpr GLfloat overshoot = 1.70158f;
+				const GLfloat     inverse   = progress - 1.0f;
+
+				return(1.0f + inverse * inverse * ((overshoot + 1.0f) * inverse + overshoot));
+			}
+
+			default:
+				return(progress);
+		}
+	}
+
+	uint32_t TweenSystem::resolve(TweenHandle tweenHandle) const noexcept
+	{
+		if (!tweenHandle.isValid() || tweenHandle.slotIndex >= m_DenseOfSlot.size())
+			return(TweenHandle::InvalidIndex);
+
+		if (m_SlotGeneration[tweenHandle.slotIndex] != tweenHandle.generation)
+			return(TweenHandle::InvalidIndex);
+
+		return(m_DenseOfSlot[tweenHandle.slotIndex]);
+	}
+
+	void TweenSystem::removeDense(uint32_t denseIndex) noexcept
+	{
+		const uint32_t lastIndex = static_cast<uint32_t>(m_SlotOfDense.size() - 1);
+		const uint32_t slotIndex = m_SlotOfDense[denseIndex];
+
+		// Move the last tween into the place of the removed one.
+		if (denseIndex != lastIndex)
+		{
+			for (int component = 0; component < 4; ++component)
+			{
+				m_From [component][denseIndex] = m_From [component][lastIndex];
+				m_Delta[component][denseIndex] = m_Delta[component][lastIndex];
+				m_Value[component][denseIndex] = m_Value[component][lastIndex];
+			}
+
+			m_StartTime      [denseIndex] = m_StartTime      [lastIndex];
+			m_InverseDuration[denseIndex] = m_InverseDuration[lastIndex];
+			m_Progress       [denseIndex] = m_Progress       [lastIndex];
+			m_Easing         [denseIndex] = m_Easing         [lastIndex];
+			m_Channel        [denseIndex] = m_Channel        [lastIndex];
+			m_Callback       [denseIndex] = std::move(m_Callback[lastIndex]);
+			m_SlotOfDense    [denseIndex] = m_SlotOfDense    [lastIndex];
+
+			m_DenseOfSlot[m_SlotOfDense[denseIndex]] = denseIndex;
+		}
+
+		for (int component = 0; component < 4; ++component)
+		{
+			m_From [component].pop_back();
+			m_Delta[component].pop_back();
+			m_Value[component].pop_back();
+		}
+
+		m_StartTime      .pop_back();
+		m_InverseDuration.pop_back();
+		m_Progress       .pop_back();
+		m_Easing         .pop_back();
+		m_Channel        .pop_back();
+		m_Callback       .pop_back();
+		m_SlotOfDense    .pop_back();
+
+		// Invalidate the handles that are pointing to this slot and recycle it.
+		m_DenseOfSlot[slotIndex] = TweenHandle::InvalidIndex;
+		m_SlotGeneration[slotIndex]++;
+		m_FreeSlots.push_back(slotIndex);
+	}
+}
@@ -0,0 +1,147 @@
+// This file declares the `TweenSystem` class.
+//
+// The `TweenSystem` class owns every active tween of the engine and updates them
+// all at once, so the per-sprite code only has to sample the current values.
+#pragma once
+
+#include "../_EngineIncludes.hpp"
+
+#include "vector"
+#include "functional"
+#include "optional"
+
+// This namespace is populated with all animation-related stuff.
+namespace Engine::Animation
+{
+	// The easing curves that can be applied to the tween progress.
+	enum class Easing : uint8_t
+	{
+		Linear,
+		QuadIn,
+		QuadOut,
+		QuadInOut,
+		CubicIn,
+		CubicOut,
+		CubicInOut,
+		SineInOut,
+		BackOut,
+	};
+
+	// The sprite attribute that is being animated by the tween. The tween system itself
+	// treats every channel as 4 floats, the channel is only a hint for the consumer.
+	enum class TweenChannel : uint8_t
+	{
+		Position,
+		Rotation,
+		Scale,
+		Color,
+	};
+
+	// The weak reference to the tween. The generation counter is used to detect the
+	// handles that are pointing to the already finished(and possibly reused) tween slot.
+	struct TweenHandle
+	{
+		static constexpr const uint32_t InvalidIndex = 0xFFFFFFFFu;
+
+		uint32_t slotIndex  = InvalidIndex;
+		uint32_t generation = 0u;
+
+		inline bool isValid() const
+		{
+			return(slotIndex != InvalidIndex);
+		}
+	};
+
+	// Invoked once the tween has reached its destination value.
+	using TweenCallback = std::function<void(TweenHandle)>;
+
+	// This class stores the active tweens in the structure-of-arrays layout(each tween
+	// attribute lives in its own tightly packed array), so the per-frame update is
+	// a few linear passes over the memory that the compiler is able to vectorize.
+	//
+	// Finished tweens are swap-removed from the dense arrays, the handles are resolved
+	// through the slot table so they stay valid while the tween is alive.
+	class TweenSystem
+	{
+	private:
+		TweenSystem() = default;
+
+	public:
+		TweenSystem(const TweenSystem&)            = delete;
+		TweenSystem& operator=(const TweenSystem&) = delete;
+
+		// This function is the way to realize the Singleton OOP programming pattern,
+		// so that this class can only be instantiated only once.
+		static TweenSystem& instance()
+		{
+			static TweenSystem _instance;
+			return(_instance);
+		}
+
+	public:
+		// Start the tween that interpolates between `from` and `to` values in `duration` seconds.
+		TweenHandle play(TweenChannel channel, const glm::vec4& from, const glm::vec4& to, GLfloat duration, Easing easing = Easing::Linear, TweenCallback onComplete = nullptr);
+
+		// Convenience wrappers around ::play for the each sprite attribute.
+		TweenHandle tweenPosition(glm::vec2 from, glm::vec2 to, GLfloat duration, Easing easing = Easing::Linear, TweenCallback onComplete = nullptr);
+		TweenHandle tweenRotation(GLfloat   from, GLfloat   to, GLfloat duration, Easing easing = Easing::Linear, TweenCallback onComplete = nullptr);
+		TweenHandle tweenScale   (glm::vec2 from, glm::vec2 to, GLfloat duration, Easing easing = Easing::Linear, TweenCallback onComplete = nullptr);
+		TweenHandle tweenColor   (glm::vec3 from, glm::vec3 to, GLfloat duration, Easing easing = Easing::Linear, TweenCallback onComplete = nullptr);
+
+		// Advance all the active tweens to the `currentTime`(in seconds), remove the
+		// finished ones and fire theirs completion callbacks.
+		void update(double currentTime) noexcept;
+
+		// Stop the tween without firing its completion callback.
+		void cancel(TweenHandle tweenHandle) noexcept;
+
+		// Stop all the tweens without firing theirs completion callbacks.
+		void clear() noexcept;
+
+		// Find out whether the tween is still running.
+		bool isActive(TweenHandle tweenHandle) const noexcept;
+
+		// Get the current value of the running tween, or nothing if the tween has finished.
+		std::optional<glm::vec4> sample(TweenHandle tweenHandle) const noexcept;
+
+		// Get the amount of the currently running tweens.
+		inline size_t getActiveCount() const noexcept
+		{
+			return(m_SlotOfDense.size());
+		}
+
+	private:
+		// Map the linear progress to the eased progress.
+		static GLfloat applyEasing(Easing easing, GLfloat progress) noexcept;
+
+		// Get the index in the dense arrays, or ::InvalidIndex when the handle is stale.
+		uint32_t resolve(TweenHandle tweenHandle) const noexcept;
+
+		// Swap-remove the tween from the dense arrays.
+		void removeDense(uint32_t denseIndex) noexcept;
+
+	private:
+		// The time of the last ::update call, used as the start time of the new tweens.
+		double m_CurrentTime = 0.0;
+
+		// Dense(per-tween) data.
+		std::vector<GLfloat>       m_From[4];
+		std::vector<GLfloat>       m_Delta[4];
+		std::vector<GLfloat>       m_Value[4];
+		std::vector<double>        m_StartTime;
+		std::vector<GLfloat>       m_InverseDuration;
+		std::vector<GLfloat>       m_Progress;
+		std::vector<Easing>        m_Easing;
+		std::vector<TweenChannel>  m_Channel;
+		std::vector<TweenCallback> m_Callback;
+		std::vector<uint32_t>      m_SlotOfDense;
+
+		// Slot table that is used to resolve the handles.
+		std::vector<uint32_t> m_DenseOfSlot;
+		std::vector<uint32_t> m_SlotGeneration;
+		std::vector<uint32_t> m_FreeSlots;
+
+		// Scratch storage for the tweens that finished during the ::update call.
+		std::vector<std::pair<TweenHandle, TweenCallback>> m_FinishedTweens;
+	};
+}
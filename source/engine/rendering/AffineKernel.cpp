@@ -0,0 +1,256 @@
+// This file implements the affine transform kernel of the sprites.
+#include "AffineKernel.hpp"
+
+#include "cmath"
+#include "cstdint"
+
+// The widest instruction set the compiler is allowed to use(/arch:AVX2 or -mavx2 enables
+// the AVX2 kernel, SSE2 is always there on x64).
+#if defined(__AVX2__)
+	#define ENGINE_AFFINE_KERNEL_AVX2
+	#include "immintrin.h"
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+	#define ENGINE_AFFINE_KERNEL_SSE2
+	#include "emmintrin.h"
+#endif
+
+using namespace std;
+
+// The degrees to the radians.
+static constexpr const float _DEGREES_TO_RADIANS = 3.14159265358979323846f / 180.0f;
+
+// The range reduction and the minimax polynomials of the sine and the cosine on [-pi/4, pi/4]
+// (the Cephes single precision ones). The pi/4 is split into three parts, so the reduction
+// of the angles up to a few thousands of the radians stays exact.
+static constexpr const float _FOUR_OVER_PI  = 1.27323954473516f;
+static constexpr const float _PI_OVER_FOUR1 = 0.78515625f;
+static constexpr const float _PI_OVER_FOUR2 = 2.4187564849853515625e-4f;
+static constexpr const float _PI_OVER_FOUR3 = 3.77489497744594108e-8f;
+
+static constexpr const float _SINE_COEFFICIENT0 = -1.9515295891e-4f;
+static constexpr const float _SINE_COEFFICIENT1 =  8.3321608736e-3f;
+static constexpr const float _SINE_COEFFICIENT2 = -1.6666654611e-1f;
+
+static constexpr const float _COSINE_COEFFICIENT0 =  2.443315711809948e-5f;
+static constexpr const float _COSINE_COEFFICIENT1 = -1.388731625493765e-3f;
+static constexpr const float _COSINE_COEFFICIENT2 =  4.166664568298827e-2f;
+
+// The single sprite, shared by the scalar kernel and the tails of the vectorized ones.
+static inline void computeSpriteAffine(const Engine::GFX::SpriteTransformsSoA& spriteTransforms, const Engine::GFX::SpriteAffinesSoA& spriteAffines, size_t spriteIndex) noexcept
+{
+	const float rotation = spriteTransforms.rotation[spriteIndex] * _DEGREES_TO_RADIANS;
+	const float cosine   = cos(rotation);
+	const float sine     = sin(rotation);
+	const float sizeX    = spriteTransforms.sizeX[spriteIndex];
+	const float sizeY    = spriteTransforms.sizeY[spriteIndex];
+
+	const float m00 =  cosine * sizeX;
+	const float m01 = -sine   * sizeY;
+	const float m10 =  sine   * sizeX;
+	const float m11 =  cosine * sizeY;
+
+	spriteAffines.m00[spriteIndex] = m00;
+	spriteAffines.m01[spriteIndex] = m01;
+	spriteAffines.m10[spriteIndex] = m10;
+	spriteAffines.m11[spriteIndex] = m11;
+
+	// The rotation is around the center of the sprite: position + half size - R * half size.
+	spriteAffines.m02[spriteIndex] = spriteTransforms.positionX[spriteIndex] + 0.5f * (sizeX - m00 - m01);
+	spriteAffines.m12[spriteIndex] = spriteTransforms.positionY[spriteIndex] + 0.5f * (sizeY - m10 - m11);
+}
+
+#if defined(ENGINE_AFFINE_KERNEL_AVX2)
+
+// Eight sines and cosines at once.
+static inline void sineCosine(__m256 angle, __m256& sine, __m256& cosine) noexcept
+{
+	const __m256  signMask = _mm256_castsi256_ps(_mm256_set1_epi32(static_cast<int>(0x80000000u)));
+	const __m256i one      = _mm256_set1_epi32(1);
+	const __m256i two      = _mm256_set1_epi32(2);
+	const __m256i four     = _mm256_set1_epi32(4);
+
+	__m256 sineSign = _mm256_and_ps   (angle, signMask);
+	__m256 x        = _mm256_andnot_ps(signMask, angle);
+
+	// The octant(rounded up to the even one) and the angle within [-pi/4, pi/4].
+	__m256i octant = _mm256_cvttps_epi32(_mm256_mul_ps(x, _mm256_set1_ps(_FOUR_OVER_PI)));
+	octant         = _mm256_andnot_si256(one, _mm256_add_epi32(octant, one));
+
+	const __m256 y = _mm256_cvtepi32_ps(octant);
+
+	x = _mm256_sub_ps(x, _mm256_mul_ps(y, _mm256_set1_ps(_PI_OVER_FOUR1)));
+	x = _mm256_sub_ps(x, _mm256_mul_ps(y, _mm256_set1_ps(_PI_OVER_FOUR2)));
+	x = _mm256_sub_ps(x, _mm256_mul_ps(y, _mm256_set1_ps(_PI_OVER_FOUR3)));
+
+	sineSign = _mm256_xor_ps(sineSign, _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_and_si256(octant, four), 29)));
+
+	const __m256 cosineSign   = _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_andnot_si256(_mm256_sub_epi32(octant, two), four), 29));
+	const __m256 isSwapped    = _mm256_castsi256_ps(_mm256_cmpeq_epi32(_mm256_and_si256(octant, two), two));
+	const __m256 z            = _mm256_mul_ps(x, x);
+
+	__m256 cosinePolynomial = _mm256_set1_ps(_COSINE_COEFFICIENT0);
+	cosinePolynomial = _mm256_add_ps(_mm256_mul_ps(cosinePolynomial, z), _mm256_set1_ps(_COSINE_COEFFICIENT1));
+	cosinePolynomial = _mm256_add_ps(_mm256_mul_ps(cosinePolynomial, z), _mm256_set1_ps(_COSINE_COEFFICIENT2));
+	cosinePolynomial = _mm256_mul_ps(_mm256_mul_ps(cosinePolynomial, z), z);
+	cosinePolynomial = _mm256_sub_ps(cosinePolynomial, _mm256_mul_ps(z, _mm256_set1_ps(0.5f)));
+	cosinePolynomial = _mm256_add_ps(cosinePolynomial, _mm256_set1_ps(1.0f));
+
+	__m256 sinePolynomial = _mm256_set1_ps(_SINE_COEFFICIENT0);
+	sinePolynomial = _mm256_add_ps(_mm256_mul_ps(sinePolynomial, z), _mm256_set1_ps(_SINE_COEFFICIENT1));
+	sinePolynomial = _mm256_add_ps(_mm256_mul_ps(sinePolynomial, z), _mm256_set1_ps(_SINE_COEFFICIENT2));
+	sinePolynomial = _mm256_add_ps(_mm256_mul_ps(_mm256_mul_ps(sinePolynomial, z), x), x);
+
+	sine   = _mm256_xor_ps(_mm256_blendv_ps(sinePolynomial, cosinePolynomial, isSwapped), sineSign);
+	cosine = _mm256_xor_ps(_mm256_blendv_ps(cosinePolynomial, sinePolynomial, isSwapped), cosineSign);
+}
+
+static size_t computeSpriteAffinesVectorized(const Engine::GFX::SpriteTransformsSoA& spriteTransforms, const Engine::GFX::SpriteAffinesSoA& spriteAffines, size_t spritesTotal) noexcept
+{
+	const __m256 degreesToRadians = _mm256_set1_ps(_DEGREES_TO_RADIANS);
+	const __m256 half             = _mm256_set1_ps(0.5f);
+
+	size_t spriteIndex = 0;
+
+	for (; spriteIndex + 8 <= spritesTotal; spriteIndex += 8)
+	{
+		__m256 sine, cosine;
+		sineCosine(_mm256_mul_ps(_mm256_loadu_ps(spriteTransforms.rotation + spriteIndex), degreesToRadians), sine, cosine);
+
+		const __m256 sizeX = _mm256_loadu_ps(spriteTransforms.sizeX + spriteIndex);
+		const __m256 sizeY = _mm256_loadu_ps(spriteTransforms.sizeY + spriteIndex);
+
+		const __m256 m00 = _mm256_mul_ps(cosine, sizeX);
+		const __m256 m01 = _mm256_sub_ps(_mm256_setzero_ps(), _mm256_mul_ps(sine, sizeY));
+		const __m256 m10 = _mm256_mul_ps(sine,   sizeX);
+		const __m256 m11 = _mm256_mul_ps(cosine, sizeY);
+
+		const __m256 m02 = _mm256_add_ps(_mm256_loadu_ps(spriteTransforms.positionX + spriteIndex), _mm256_mul_ps(half, _mm256_sub_ps(_mm256_sub_ps(sizeX, m00), m01)));
+		const __m256 m12 = _mm256_add_ps(_mm256_loadu_ps(spriteTransforms.positionY + spriteIndex), _mm256_mul_ps(half, _mm256_sub_ps(_mm256_sub_ps(sizeY, m10), m11)));
+
+		_mm256_storeu_ps(spriteAffines.m00 + spriteIndex, m00);
+		_mm256_storeu_ps(spriteAffines.m01 + spriteIndex, m01);
+		_mm256_storeu_ps(spriteAffines.m02 + spriteIndex, m02);
+		_mm256_storeu_ps(spriteAffines.m10 + spriteIndex, m10);
+		_mm256_storeu_ps(spriteAffines.m11 + spriteIndex, m11);
+		_mm256_storeu_ps(spriteAffines.m12 + spriteIndex, m12);
+	}
+
+	return(spriteIndex);
+}
+
+#elif defined(ENGINE_AFFINE_KERNEL_SSE2)
+
+// Four sines and cosines at once(SSE2 has no blend, so the polynomials are selected by the masks).
+static inline void sineCosine(__m128 angle, __m128& sine, __m128& cosine) noexcept
+{
+	const __m128  signMask = _mm_castsi128_ps(_mm_set1_epi32(static_cast<int>(0x80000000u)));
+	const __m128i one      = _mm_set1_epi32(1);
+	const __m128i two      = _mm_set1_epi32(2);
+	const __m128i four     = _mm_set1_epi32(4);
+
+	__m128 sineSign = _mm_and_ps   (angle, signMask);
+	__m128 x        = _mm_andnot_ps(signMask, angle);
+
+	// The octant(rounded up to the even one) and the angle within [-pi/4, pi/4].
+	__m128i octant = _mm_cvttps_epi32(_mm_mul_ps(x, _mm_set1_ps(_FOUR_OVER_PI)));
+	octant         = _mm_andnot_si128(one, _mm_add_epi32(octant, one));
+
+	const __m128 y = _mm_cvtepi32_ps(octant);
+
+	x = _mm_sub_ps(x, _mm_mul_ps(y, _mm_set1_ps(_PI_OVER_FOUR1)));
+	x = _mm_sub_ps(x, _mm_mul_ps(y, _mm_set1_ps(_PI_OVER_FOUR2)));
+	x = _mm_sub_ps(x, _mm_mul_ps(y, _mm_set1_ps(_PI_OVER_FOUR3)));
+
+	sineSign = _mm_xor_ps(sineSign, _mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(octant, four), 29)));
+
+	const __m128 cosineSign = _mm_castsi128_ps(_mm_slli_epi32(_mm_andnot_si128(_mm_sub_epi32(octant, two), four), 29));
+	const __m128 isSwapped  = _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(octant, two), two));
+	const __m128 z          = _mm_mul_ps(x, x);
+
+	__m128 cosinePolynomial = _mm_set1_ps(_COSINE_COEFFICIENT0);
+	cosinePolynomial = _mm_add_ps(_mm_mul_ps(cosinePolynomial, z), _mm_set1_ps(_COSINE_COEFFICIENT1));
+	cosinePolynomial = _mm_add_ps(_mm_mul_ps(cosinePolynomial, z), _mm_set1_ps(_COSINE_COEFFICIENT2));
+	cosinePolynomial = _mm_mul_ps(_mm_mul_ps(cosinePolynomial, z), z);
+	cosinePolynomial = _mm_sub_ps(cosinePolynomial, _mm_mul_ps(z, _mm_set1_ps(0.5f)));
+	cosinePolynomial = _mm_add_ps(cosinePolynomial, _mm_set1_ps(1.0f));
+
+	__m128 sinePolynomial = _mm_set1_ps(_SINE_COEFFICIENT0);
+	sinePolynomial = _mm_add_ps(_mm_mul_ps(sinePolynomial, z), _mm_set1_ps(_SINE_COEFFICIENT1));
+	sinePolynomial = _mm_add_ps(_mm_mul_ps(sinePolynomial, z), _mm_set1_ps(_SINE_COEFFICIENT2));
+	sinePolynomial = _mm_add_ps(_mm_mul_ps(_mm_mul_ps(sinePolynomial, z), x), x);
+
+	const __m128 sineSelected   = _mm_or_ps(_mm_and_ps(isSwapped, cosinePolynomial), _mm_andnot_ps(isSwapped, sinePolynomial));
+	const __m128 cosineSelected = _mm_or_ps(_mm_and_ps(isSwapped, sinePolynomial),   _mm_andnot_ps(isSwapped, cosinePolynomial));
+
+	sine   = _mm_xor_ps(sineSelected,   sineSign);
+	cosine = _mm_xor_ps(cosineSelected, cosineSign);
+}
+
+static size_t computeSpriteAffinesVectorized(const Engine::GFX::SpriteTransformsSoA& spriteTransforms, const Engine::GFX::SpriteAffinesSoA& spriteAffines, size_t spritesTotal) noexcept
+{
+	const __m128 degreesToRadians = _mm_set1_ps(_DEGREES_TO_RADIANS);
+	const __m128 half             = _mm_set1_ps(0.5f);
+
+	size_t spriteIndex = 0;
+
+	for (; spriteIndex + 4 <= spritesTotal; spriteIndex += 4)
+	{
+		__m128 sine, cosine;
+		sineCosine(_mm_mul_ps(_mm_loadu_ps(spriteTransforms.rotation + spriteIndex), degreesToRadians), sine, cosine);
+
+		const __m128 sizeX = _mm_loadu_ps(spriteTransforms.sizeX + spriteIndex);
+		const __m128 sizeY = _mm_loadu_ps(spriteTransforms.sizeY + spriteIndex);
+
+		const __m128 m00 = _mm_mul_ps(cosine, sizeX);
+		const __m128 m01 = _mm_sub_ps(_mm_setzero_ps(), _mm_mul_ps(sine, sizeY));
+		const __m128 m10 = _mm_mul_ps(sine,   sizeX);
+		const __m128 m11 = _mm_mul_ps(cosine, sizeY);
+
+		const __m128 m02 = _mm_add_ps(_mm_loadu_ps(spriteTransforms.positionX + spriteIndex), _mm_mul_ps(half, _mm_sub_ps(_mm_sub_ps(sizeX, m00), m01)));
+		const __m128 m12 = _mm_add_ps(_mm_loadu_ps(spriteTransforms.positionY + spriteIndex), _mm_mul_ps(half, _mm_sub_ps(_mm_sub_ps(sizeY, m10), m11)));
+
+		_mm_storeu_ps(spriteAffines.m00 + spriteIndex, m00);
+		_mm_storeu_ps(spriteAffines.m01 + spriteIndex, m01);
+		_mm_storeu_ps(spriteAffines.m02 + spriteIndex, m02);
+		_mm_storeu_ps(spriteAffines.m10 + spriteIndex, m10);
+		_mm_storeu_ps(spriteAffines.m11 + spriteIndex, m11);
+		_mm_storeu_ps(spriteAffines.m12 + spriteIndex, m12);
+	}
+
+	return(spriteIndex);
+}
+
+#endif
+
+namespace Engine::GFX
+{
+	void computeSpriteAffines(const SpriteTransformsSoA& spriteTransforms, const SpriteAffinesSoA& spriteAffines, size_t spritesTotal) noexcept
+	{
+		size_t spriteIndex = 0;
+
+#if defined(ENGINE_AFFINE_KERNEL_AVX2) || defined(ENGINE_AFFINE_KERNEL_SSE2)
+		spriteIndex = computeSpriteAffinesVectorized(spriteTransforms, spriteAffines, spritesTotal);
+#endif
+
+		// The tail(or everything on the targets with no vector kernel).
+		for (; spriteIndex < spritesTotal; ++spriteIndex)
+			computeSpriteAffine(spriteTransforms, spriteAffines, spriteIndex);
+	}
+
+	void computeSpriteAffinesScalar(const SpriteTransformsSoA& spriteTransforms, const SpriteAffinesSoA& spriteAffines, size_t spritesTotal) noexcept
+	{
+		for (size_t spriteIndex = 0; spriteIndex < spritesTotal; ++spriteIndex)
+			computeSpriteAffine(spriteTransforms, spriteAffines, spriteIndex);
+	}
+
+	const char* getAffineKernelName() noexcept
+	{
+#if defined(ENGINE_AFFINE_KERNEL_AVX2)
+		return("avx2");
+#elif defined(ENGINE_AFFINE_KERNEL_SSE2)
+		return("sse2");
+#else
+		return("scalar");
+#endif
+	}
+}
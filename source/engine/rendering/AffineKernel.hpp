@@ -0,0 +1,48 @@
+// This file declares the affine transform kernel of the sprites.
+//
+// The sprite transform(the scale, the rotation around the center and the translation) is
+// folded into the 2x3 affine rows, so the quad corner(x, y) in [0, 1] is transformed as:
+//
+//   x' = m00 * x + m01 * y + m02
+//   y' = m10 * x + m11 * y + m12
+//
+// The kernel works on the SoA arrays, eight sprites at a time with AVX2, four with SSE2,
+// and falls back to the scalar loop on the other targets(and for the tail of the arrays).
+#pragma once
+
+#include "cstddef"
+
+namespace Engine::GFX
+{
+	// The transforms of the sprites, the rotation is in degrees(the same as ::SpriteRenderer).
+	struct SpriteTransformsSoA
+	{
+		const float* positionX = nullptr;
+		const float* positionY = nullptr;
+		const float* sizeX     = nullptr;
+		const float* sizeY     = nullptr;
+		const float* rotation  = nullptr;
+	};
+
+	// The affine rows of the sprites.
+	struct SpriteAffinesSoA
+	{
+		float* m00 = nullptr;
+		float* m01 = nullptr;
+		float* m02 = nullptr;
+		float* m10 = nullptr;
+		float* m11 = nullptr;
+		float* m12 = nullptr;
+	};
+
+	// Compute the affine rows of the sprites with the widest kernel the engine is compiled with.
+	// The sine and the cosine are approximated by the polynomials in the vectorized kernels(the
+	// error is within a few ulps, far below the pixel).
+	void computeSpriteAffines(const SpriteTransformsSoA& spriteTransforms, const SpriteAffinesSoA& spriteAffines, size_t spritesTotal) noexcept;
+
+	// The reference kernel(the standard library sine and cosine, one sprite at a time).
+	void computeSpriteAffinesScalar(const SpriteTransformsSoA& spriteTransforms, const SpriteAffinesSoA& spriteAffines, size_t spritesTotal) noexcept;
+
+	// The name of the kernel ::computeSpriteAffines is using("avx2", "sse2" or "scalar").
+	const char* getAffineKernelName() noexcept;
+}
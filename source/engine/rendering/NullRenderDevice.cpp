@@ -0,0 +1,295 @@
+// This file implements the `NullRenderDevice` class.
+#include "NullRenderDevice.hpp"
+
+namespace Engine::GFX
+{
+	GLuint NullRenderDevice::createBuffer() noexcept
+	{
+		return(++m_LastObjectID);
+	}
+
+	void NullRenderDevice::deleteBuffer(GLuint bufferID) noexcept
+	{
+		UnreferencedParameter(bufferID);
+	}
+
+	void NullRenderDevice::bindBuffer(GLenum target, GLuint bufferID) noexcept
+	{
+		UnreferencedParameter(target);
+		UnreferencedParameter(bufferID);
+	}
+
+	void NullRenderDevice::bufferData(GLenum target, GLsizeiptr size, const void* data, GLenum usage) noexcept
+	{
+		UnreferencedParameter(target);
+		UnreferencedParameter(size);
+		UnreferencedParameter(data);
+		UnreferencedParameter(usage);
+	}
+
+	void NullRenderDevice::bufferSubData(GLenum target, GLintptr offset, GLsizeiptr size, const void* data) noexcept
+	{
+		UnreferencedParameter(target);
+		UnreferencedParameter(offset);
+		UnreferencedParameter(size);
+		UnreferencedParameter(data);
+	}
+
+	void* NullRenderDevice::mapBuffer(GLenum target, GLsizeiptr size) noexcept
+	{
+		UnreferencedParameter(target);
+
+		m_MappedMemory.resize(static_cast<size_t>(size));
+
+		return(m_MappedMemory.data());
+	}
+
+	bool NullRenderDevice::unmapBuffer(GLenum target) noexcept
+	{
+		UnreferencedParameter(target);
+
+		return(true);
+	}
+
+	GLuint NullRenderDevice::createVertexArray() noexcept
+	{
+		return(++m_LastObjectID);
+	}
+
+	void NullRenderDevice::deleteVertexArray(GLuint vertexArrayID) noexcept
+	{
+		UnreferencedParameter(vertexArrayID);
+	}
+
+	void NullRenderDevice::bindVertexArray(GLuint vertexArrayID) noexcept
+	{
+		UnreferencedParameter(vertexArrayID);
+	}
+
+	void NullRenderDevice::enableVertexAttribute(GLuint attributeIndex) noexcept
+	{
+		UnreferencedParameter(attributeIndex);
+	}
+
+	void NullRenderDevice::vertexAttributePointer(GLuint attributeIndex, GLint componentsTotal, GLsizei stride, size_t offset) noexcept
+	{
+		UnreferencedParameter(attributeIndex);
+		UnreferencedParameter(componentsTotal);
+		UnreferencedParameter(stride);
+		UnreferencedParameter(offset);
+	}
+
+	void NullRenderDevice::vertexAttributeDivisor(GLuint attributeIndex, GLuint divisor) noexcept
+	{
+		UnreferencedParameter(attributeIndex);
+		UnreferencedParameter(divisor);
+	}
+
+	GLuint NullRenderDevice::createTexture() noexcept
+	{
+		return(++m_LastObjectID);
+	}
+
+	void NullRenderDevice::deleteTexture(GLuint textureID) noexcept
+	{
+		UnreferencedParameter(textureID);
+	}
+
+	void NullRenderDevice::activeTexture(GLenum textureUnit) noexcept
+	{
+		UnreferencedParameter(textureUnit);
+	}
+
+	void NullRenderDevice::bindTexture(GLuint textureID) noexcept
+	{
+		UnreferencedParameter(textureID);
+	}
+
+	void NullRenderDevice::textureImage(GLint internalFormat, GLsizei width, GLsizei height, GLenum format, const void* pixels) noexcept
+	{
+		UnreferencedParameter(internalFormat);
+		UnreferencedParameter(width);
+		UnreferencedParameter(height);
+		UnreferencedParameter(format);
+		UnreferencedParameter(pixels);
+	}
+
+	void NullRenderDevice::textureParameter(GLenum parameterName, GLint parameterValue) noexcept
+	{
+		UnreferencedParameter(parameterName);
+		UnreferencedParameter(parameterValue);
+	}
+
+	void NullRenderDevice::textureParameterFloat(GLenum parameterName, GLfloat parameterValue) noexcept
+	{
+		UnreferencedParameter(parameterName);
+		UnreferencedParameter(parameterValue);
+	}
+
+	void NullRenderDevice::generateMipmap() noexcept
+	{
+	}
+
+	GLfloat NullRenderDevice::getMaxAnisotropy() noexcept
+	{
+		return(1.0f);
+	}
+
+	GLuint NullRenderDevice::createShader(GLenum shaderType) noexcept
+	{
+		UnreferencedParameter(shaderType);
+
+		return(++m_LastObjectID);
+	}
+
+	void NullRenderDevice::deleteShader(GLuint shaderID) noexcept
+	{
+		UnreferencedParameter(shaderID);
+	}
+
+	bool NullRenderDevice::compileShader(GLuint shaderID, const char* shaderSource, std::string& infoLog) noexcept
+	{
+		UnreferencedParameter(shaderID);
+		UnreferencedParameter(shaderSource);
+		UnreferencedParameter(infoLog);
+
+		return(true);
+	}
+
+	GLuint NullRenderDevice::createProgram() noexcept
+	{
+		return(++m_LastObjectID);
+	}
+
+	void NullRenderDevice::deleteProgram(GLuint programID) noexcept
+	{
+		UnreferencedParameter(programID);
+	}
+
+	void NullRenderDevice::attachShader(GLuint programID, GLuint shaderID) noexcept
+	{
+		UnreferencedParameter(programID);
+		UnreferencedParameter(shaderID);
+	}
+
+	bool NullRenderDevice::linkProgram(GLuint programID, std::string& infoLog) noexcept
+	{
+		UnreferencedParameter(programID);
+		UnreferencedParameter(infoLog);
+
+		return(true);
+	}
+
+	void NullRenderDevice::useProgram(GLuint programID) noexcept
+	{
+		UnreferencedParameter(programID);
+	}
+
+	bool NullRenderDevice::getProgramBinary(GLuint programID, GLenum& binaryFormat, std::vector<uint8_t>& programBinary) noexcept
+	{
+		UnreferencedParameter(programID);
+		UnreferencedParameter(binaryFormat);
+		UnreferencedParameter(programBinary);
+
+		return(false);
+	}
+
+	bool NullRenderDevice::programBinary(GLuint programID, GLenum binaryFormat, const void* programBinary, GLsizei binarySize) noexcept
+	{
+		UnreferencedParameter(programID);
+		UnreferencedParameter(binaryFormat);
+		UnreferencedParameter(programBinary);
+		UnreferencedParameter(binarySize);
+
+		return(false);
+	}
+
+	std::string NullRenderDevice::getDriverSignature() noexcept
+	{
+		return("null");
+	}
+
+	GLint NullRenderDevice::getUniformLocation(GLuint programID, const char* uniformName) noexcept
+	{
+		UnreferencedParameter(programID);
+		UnreferencedParameter(uniformName);
+
+		return(0);
+	}
+
+	void NullRenderDevice::setUniform(GLint location, GLint value) noexcept
+	{
+		UnreferencedParameter(location);
+		UnreferencedParameter(value);
+	}
+
+	void NullRenderDevice::setUniform(GLint location, GLfloat value) noexcept
+	{
+		UnreferencedParameter(location);
+		UnreferencedParameter(value);
+	}
+
+	void NullRenderDevice::setUniform(GLint location, const glm::vec2& value) noexcept
+	{
+		UnreferencedParameter(location);
+		UnreferencedParameter(value);
+	}
+
+	void NullRenderDevice::setUniform(GLint location, const glm::vec3& value) noexcept
+	{
+		UnreferencedParameter(location);
+		UnreferencedParameter(value);
+	}
+
+	void NullRenderDevice::setUniform(GLint location, const glm::vec4& value) noexcept
+	{
+		UnreferencedParameter(location);
+		UnreferencedParameter(value);
+	}
+
+	void NullRenderDevice::setUniform(GLint location, const glm::mat4& value) noexcept
+	{
+		UnreferencedParameter(location);
+		UnreferencedParameter(value);
+	}
+
+	void NullRenderDevice::drawArrays(GLenum drawMode, GLint firstVertex, GLsizei verticesTotal) noexcept
+	{
+		UnreferencedParameter(drawMode);
+		UnreferencedParameter(firstVertex);
+		UnreferencedParameter(verticesTotal);
+	}
+
+	void NullRenderDevice::drawArraysInstanced(GLenum drawMode, GLint firstVertex, GLsizei verticesTotal, GLsizei instancesTotal) noexcept
+	{
+		UnreferencedParameter(drawMode);
+		UnreferencedParameter(firstVertex);
+		UnreferencedParameter(verticesTotal);
+		UnreferencedParameter(instancesTotal);
+	}
+
+	void NullRenderDevice::setViewport(GLint positionX, GLint positionY, GLsizei width, GLsizei height) noexcept
+	{
+		UnreferencedParameter(positionX);
+		UnreferencedParameter(positionY);
+		UnreferencedParameter(width);
+		UnreferencedParameter(height);
+	}
+
+	void NullRenderDevice::setCapability(GLenum capability, bool isEnabled) noexcept
+	{
+		UnreferencedParameter(capability);
+		UnreferencedParameter(isEnabled);
+	}
+
+	void NullRenderDevice::setBlendFunction(GLenum sourceFactor, GLenum destinationFactor) noexcept
+	{
+		UnreferencedParameter(sourceFactor);
+		UnreferencedParameter(destinationFactor);
+	}
+
+	void NullRenderDevice::clear(const glm::vec4& clearColor) noexcept
+	{
+		UnreferencedParameter(clearColor);
+	}
+}
@@ -0,0 +1,78 @@
+// This file declares the `NullRenderDevice` class.
+#pragma once
+
+#include "RenderDevice.hpp"
+
+#include "vector"
+
+// This namespace is polluted with the Internals components of the graphics API.
+namespace Engine::GFX
+{
+	// The render device that does nothing(the created objects are just the
+	// increasing numbers), so the game runs with no GPU work at all.
+	class NullRenderDevice : public RenderDevice
+	{
+	public:
+		GLuint createBuffer() noexcept override;
+		void   deleteBuffer(GLuint bufferID) noexcept override;
+		void   bindBuffer(GLenum target, GLuint bufferID) noexcept override;
+		void   bufferData(GLenum target, GLsizeiptr size, const void* data, GLenum usage) noexcept override;
+		void   bufferSubData(GLenum target, GLintptr offset, GLsizeiptr size, const void* data) noexcept override;
+		void*  mapBuffer(GLenum target, GLsizeiptr size) noexcept override;
+		bool   unmapBuffer(GLenum target) noexcept override;
+
+		GLuint createVertexArray() noexcept override;
+		void   deleteVertexArray(GLuint vertexArrayID) noexcept override;
+		void   bindVertexArray(GLuint vertexArrayID) noexcept override;
+		void   enableVertexAttribute(GLuint attributeIndex) noexcept override;
+		void   vertexAttributePointer(GLuint attributeIndex, GLint componentsTotal, GLsizei stride, size_t offset) noexcept override;
+		void   vertexAttributeDivisor(GLuint attributeIndex, GLuint divisor) noexcept override;
+
+		GLuint createTexture() noexcept override;
+		void   deleteTexture(GLuint textureID) noexcept override;
+		void   activeTexture(GLenum textureUnit) noexcept override;
+		void   bindTexture(GLuint textureID) noexcept override;
+		void   textureImage(GLint internalFormat, GLsizei width, GLsizei height, GLenum format, const void* pixels) noexcept override;
+		void   textureParameter(GLenum parameterName, GLint parameterValue) noexcept override;
+		void   textureParameterFloat(GLenum parameterName, GLfloat parameterValue) noexcept override;
+		void   generateMipmap() noexcept override;
+
+		GLfloat getMaxAnisotropy() noexcept override;
+
+		GLuint createShader(GLenum shaderType) noexcept override;
+		void   deleteShader(GLuint shaderID) noexcept override;
+		bool   compileShader(GLuint shaderID, const char* shaderSource, std::string& infoLog) noexcept override;
+		GLuint createProgram() noexcept override;
+		void   deleteProgram(GLuint programID) noexcept override;
+		void   attachShader(GLuint programID, GLuint shaderID) noexcept override;
+		bool   linkProgram(GLuint programID, std::string& infoLog) noexcept override;
+		void   useProgram(GLuint programID) noexcept override;
+
+		bool        getProgramBinary(GLuint programID, GLenum& binaryFormat, std::vector<uint8_t>& programBinary) noexcept override;
+		bool        programBinary(GLuint programID, GLenum binaryFormat, const void* programBinary, GLsizei binarySize) noexcept override;
+		std::string getDriverSignature() noexcept override;
+
+		GLint getUniformLocation(GLuint programID, const char* uniformName) noexcept override;
+		void  setUniform(GLint location, GLint value) noexcept override;
+		void  setUniform(GLint location, GLfloat value) noexcept override;
+		void  setUniform(GLint location, const glm::vec2& value) noexcept override;
+		void  setUniform(GLint location, const glm::vec3& value) noexcept override;
+		void  setUniform(GLint location, const glm::vec4& value) noexcept override;
+		void  setUniform(GLint location, const glm::mat4& value) noexcept override;
+
+		void drawArrays(GLenum drawMode, GLint firstVertex, GLsizei verticesTotal) noexcept override;
+		void drawArraysInstanced(GLenum drawMode, GLint firstVertex, GLsizei verticesTotal, GLsizei instancesTotal) noexcept override;
+
+		void setViewport(GLint positionX, GLint positionY, GLsizei width, GLsizei height) noexcept override;
+		void setCapability(GLenum capability, bool isEnabled) noexcept override;
+		void setBlendFunction(GLenum sourceFactor, GLenum destinationFactor) noexcept override;
+		void clear(const glm::vec4& clearColor) noexcept override;
+
+	private:
+		// The memory that is handed out by the ::mapBuffer.
+		std::vector<uint8_t> m_MappedMemory;
+
+		// The last handed out object name(zero is never used, it means "no object" in GL).
+		GLuint m_LastObjectID = 0;
+	};
+}
@@ -0,0 +1,334 @@
+// This file implements the `OpenGLRenderDevice` class.
+#include "OpenGLRenderDevice.hpp"
+
+#include "algorithm"
+#include "cstring"
+
+// Read the info log of the shader or the program.
+template<typename InfoLogFunction>
+static void readInfoLog(GLuint objectID, GLint logLength, InfoLogFunction infoLogFunction, std::string& infoLog)
+{
+	infoLog.resize(static_cast<size_t>(std::max(logLength, 1)));
+	infoLogFunction(objectID, logLength, nullptr, infoLog.data());
+	infoLog.resize(strlen(infoLog.c_str()));
+}
+
+namespace Engine::GFX
+{
+	GLuint OpenGLRenderDevice::createBuffer() noexcept
+	{
+		GLuint bufferID = 0;
+		glGenBuffers(1, &bufferID);
+
+		return(bufferID);
+	}
+
+	void OpenGLRenderDevice::deleteBuffer(GLuint bufferID) noexcept
+	{
+		glDeleteBuffers(1, &bufferID);
+	}
+
+	void OpenGLRenderDevice::bindBuffer(GLenum target, GLuint bufferID) noexcept
+	{
+		glBindBuffer(target, bufferID);
+	}
+
+	void OpenGLRenderDevice::bufferData(GLenum target, GLsizeiptr size, const void* data, GLenum usage) noexcept
+	{
+		glBufferData(target, size, data, usage);
+	}
+
+	void OpenGLRenderDevice::bufferSubData(GLenum target, GLintptr offset, GLsizeiptr size, const void* data) noexcept
+	{
+		glBufferSubData(target, offset, size, data);
+	}
+
+	void* OpenGLRenderDevice::mapBuffer(GLenum target, GLsizeiptr size) noexcept
+	{
+		return(glMapBufferRange(target, 0, size, GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT));
+	}
+
+	bool OpenGLRenderDevice::unmapBuffer(GLenum target) noexcept
+	{
+		return(glUnmapBuffer(target) == GL_TRUE);
+	}
+
+	GLuint OpenGLRenderDevice::createVertexArray() noexcept
+	{
+		GLuint vertexArrayID = 0;
+		glGenVertexArrays(1, &vertexArrayID);
+
+		return(vertexArrayID);
+	}
+
+	void OpenGLRenderDevice::deleteVertexArray(GLuint vertexArrayID) noexcept
+	{
+		glDeleteVertexArrays(1, &vertexArrayID);
+	}
+
+	void OpenGLRenderDevice::bindVertexArray(GLuint vertexArrayID) noexcept
+	{
+		glBindVertexArray(vertexArrayID);
+	}
+
+	void OpenGLRenderDevice::enableVertexAttribute(GLuint attributeIndex) noexcept
+	{
+		glEnableVertexAttribArray(attributeIndex);
+	}
+
+	void OpenGLRenderDevice::vertexAttributePointer(GLuint attributeIndex, GLint componentsTotal, GLsizei stride, size_t offset) noexcept
+	{
+		glVertexAttribPointer(attributeIndex, componentsTotal, GL_FLOAT, GL_FALSE, stride, reinterpret_cast<const GLvoid*>(offset));
+	}
+
+	void OpenGLRenderDevice::vertexAttributeDivisor(GLuint attributeIndex, GLuint divisor) noexcept
+	{
+		glVertexAttribDivisor(attributeIndex, divisor);
+	}
+
+	GLuint OpenGLRenderDevice::createTexture() noexcept
+	{
+		GLuint textureID = 0;
+		glGenTextures(1, &textureID);
+
+		return(textureID);
+	}
+
+	void OpenGLRenderDevice::deleteTexture(GLuint textureID) noexcept
+	{
+		glDeleteTextures(1, &textureID);
+	}
+
+	void OpenGLRenderDevice::activeTexture(GLenum textureUnit) noexcept
+	{
+		glActiveTexture(textureUnit);
+	}
+
+	void OpenGLRenderDevice::bindTexture(GLuint textureID) noexcept
+	{
+		glBindTexture(GL_TEXTURE_2D, textureID);
+	}
+
+	void OpenGLRenderDevice::textureImage(GLint internalFormat, GLsizei width, GLsizei height, GLenum format, const void* pixels) noexcept
+	{
+		// The rows of the pixels are tightly packed(the RGB rows are not aligned by 4 bytes).
+		glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+		glTexImage2D (GL_TEXTURE_2D, 0, internalFormat, width, height, 0, format, GL_UNSIGNED_BYTE, pixels);
+	}
+
+	void OpenGLRenderDevice::textureParameter(GLenum parameterName, GLint parameterValue) noexcept
+	{
+		glTexParameteri(GL_TEXTURE_2D, parameterName, parameterValue);
+	}
+
+	void OpenGLRenderDevice::textureParameterFloat(GLenum parameterName, GLfloat parameterValue) noexcept
+	{
+		glTexParameterf(GL_TEXTURE_2D, parameterName, parameterValue);
+	}
+
+	void OpenGLRenderDevice::generateMipmap() noexcept
+	{
+		glGenerateMipmap(GL_TEXTURE_2D);
+	}
+
+	GLfloat OpenGLRenderDevice::getMaxAnisotropy() noexcept
+	{
+		if (!GLAD_GL_EXT_texture_filter_anisotropic && !GLAD_GL_ARB_texture_filter_anisotropic)
+			return(1.0f);
+
+		GLfloat maxAnisotropy = 1.0f;
+		glGetFloatv(GL_MAX_TEXTURE_MAX_ANISOTROPY_EXT, &maxAnisotropy);
+
+		return(maxAnisotropy);
+	}
+
+	GLuint OpenGLRenderDevice::createShader(GLenum shaderType) noexcept
+	{
+		return(glCreateShader(shaderType));
+	}
+
+	void OpenGLRenderDevice::deleteShader(GLuint shaderID) noexcept
+	{
+		glDeleteShader(shaderID);
+	}
+
+	bool OpenGLRenderDevice::compileShader(GLuint shaderID, const char* shaderSource, std::string& infoLog) noexcept
+	{
+		glShaderSource (shaderID, 1, &shaderSource, nullptr);
+		glCompileShader(shaderID);
+
+		GLint isCompiled = GL_FALSE;
+		glGetShaderiv(shaderID, GL_COMPILE_STATUS, &isCompiled);
+
+		if (isCompiled == GL_FALSE)
+		{
+			GLint logLength = 0;
+			glGetShaderiv(shaderID, GL_INFO_LOG_LENGTH, &logLength);
+
+			readInfoLog(shaderID, logLength, glGetShaderInfoLog, infoLog);
+		}
+
+		return(isCompiled != GL_FALSE);
+	}
+
+	GLuint OpenGLRenderDevice::createProgram() noexcept
+	{
+		return(glCreateProgram());
+	}
+
+	void OpenGLRenderDevice::deleteProgram(GLuint programID) noexcept
+	{
+		glDeleteProgram(programID);
+	}
+
+	void OpenGLRenderDevice::attachShader(GLuint programID, GLuint shaderID) noexcept
+	{
+		glAttachShader(programID, shaderID);
+	}
+
+	bool OpenGLRenderDevice::linkProgram(GLuint programID, std::string& infoLog) noexcept
+	{
+		// Keep the binary of the program, so it can be saved into the warm start cache.
+		if (GLAD_GL_ARB_get_program_binary)
+			glProgramParameteri(programID, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+
+		glLinkProgram(programID);
+
+		GLint isLinked = GL_FALSE;
+		glGetProgramiv(programID, GL_LINK_STATUS, &isLinked);
+
+		if (isLinked == GL_FALSE)
+		{
+			GLint logLength = 0;
+			glGetProgramiv(programID, GL_INFO_LOG_LENGTH, &logLength);
+
+			readInfoLog(programID, logLength, glGetProgramInfoLog, infoLog);
+		}
+
+		return(isLinked != GL_FALSE);
+	}
+
+	void OpenGLRenderDevice::useProgram(GLuint programID) noexcept
+	{
+		glUseProgram(programID);
+	}
+
+	bool OpenGLRenderDevice::getProgramBinary(GLuint programID, GLenum& binaryFormat, std::vector<uint8_t>& programBinary) noexcept
+	{
+		if (!GLAD_GL_ARB_get_program_binary)
+			return(false);
+
+		GLint binaryLength = 0;
+		glGetProgramiv(programID, GL_PROGRAM_BINARY_LENGTH, &binaryLength);
+
+		if (binaryLength <= 0)
+			return(false);
+
+		programBinary.resize(static_cast<size_t>(binaryLength));
+
+		GLsizei writtenLength = 0;
+		glGetProgramBinary(programID, binaryLength, &writtenLength, &binaryFormat, programBinary.data());
+
+		programBinary.resize(static_cast<size_t>(writtenLength));
+
+		return(writtenLength > 0);
+	}
+
+	bool OpenGLRenderDevice::programBinary(GLuint programID, GLenum binaryFormat, const void* programBinary, GLsizei binarySize) noexcept
+	{
+		if (!GLAD_GL_ARB_get_program_binary)
+			return(false);
+
+		glProgramBinary(programID, binaryFormat, programBinary, binarySize);
+
+		// The driver rejects the binary that it did not make(the link status is false then).
+		GLint isLinked = GL_FALSE;
+		glGetProgramiv(programID, GL_LINK_STATUS, &isLinked);
+
+		return(isLinked != GL_FALSE);
+	}
+
+	std::string OpenGLRenderDevice::getDriverSignature() noexcept
+	{
+		std::string driverSignature;
+
+		for (const GLenum driverString : { GL_VENDOR, GL_RENDERER, GL_VERSION })
+		{
+			const GLubyte* driverValue = glGetString(driverString);
+
+			driverSignature += driverValue != nullptr ? reinterpret_cast<const char*>(driverValue) : "";
+			driverSignature += '\n';
+		}
+
+		return(driverSignature);
+	}
+
+	GLint OpenGLRenderDevice::getUniformLocation(GLuint programID, const char* uniformName) noexcept
+	{
+		return(glGetUniformLocation(programID, uniformName));
+	}
+
+	void OpenGLRenderDevice::setUniform(GLint location, GLint value) noexcept
+	{
+		glUniform1i(location, value);
+	}
+
+	void OpenGLRenderDevice::setUniform(GLint location, GLfloat value) noexcept
+	{
+		glUniform1f(location, value);
+	}
+
+	void OpenGLRenderDevice::setUniform(GLint location, const glm::vec2& value) noexcept
+	{
+		glUniform2f(location, value.x, value.y);
+	}
+
+	void OpenGLRenderDevice::setUniform(GLint location, const glm::vec3& value) noexcept
+	{
+		glUniform3f(location, value.x, value.y, value.z);
+	}
+
+	void OpenGLRenderDevice::setUniform(GLint location, const glm::vec4& value) noexcept
+	{
+		glUniform4f(location, value.x, value.y, value.z, value.w);
+	}
+
+	void OpenGLRenderDevice::setUniform(GLint location, const glm::mat4& value) noexcept
+	{
+		glUniformMatrix4fv(location, 1, GL_FALSE, glm::value_ptr(value));
+	}
+
+	void OpenGLRenderDevice::drawArrays(GLenum drawMode, GLint firstVertex, GLsizei verticesTotal) noexcept
+	{
+		glDrawArrays(drawMode, firstVertex, verticesTotal);
+	}
+
+	void OpenGLRenderDevice::drawArraysInstanced(GLenum drawMode, GLint firstVertex, GLsizei verticesTotal, GLsizei instancesTotal) noexcept
+	{
+		glDrawArraysInstanced(drawMode, firstVertex, verticesTotal, instancesTotal);
+	}
+
+	void OpenGLRenderDevice::setViewport(GLint positionX, GLint positionY, GLsizei width, GLsizei height) noexcept
+	{
+		glViewport(positionX, positionY, width, height);
+	}
+
+	void OpenGLRenderDevice::setCapability(GLenum capability, bool isEnabled) noexcept
+	{
+		if (isEnabled)
+			glEnable(capability);
+		else
+			glDisable(capability);
+	}
+
+	void OpenGLRenderDevice::setBlendFunction(GLenum sourceFactor, GLenum destinationFactor) noexcept
+	{
+		glBlendFunc(sourceFactor, destinationFactor);
+	}
+
+	void OpenGLRenderDevice::clear(const glm::vec4& clearColor) noexcept
+	{
+		glClearColor(clearColor.x, clearColor.y, clearColor.z, clearColor.w);
+		glClear     (GL_COLOR_BUFFER_BIT);
+	}
+}
@@ -0,0 +1,824 @@
+// This file implements the `RecordingRenderDevice` and the `RenderCommandReplayer` classes.
+#include "RecordingRenderDevice.hpp"
+#include "../Logger.hpp"
+
+using namespace std;
+
+// Get the size of the pixels that the GL reads for the texture(the rows are aligned by the
+// default unpack alignment of the 4 bytes).
+static size_t getPixelsSize(GLsizei width, GLsizei height, GLenum format) noexcept
+{
+	size_t channelsTotal = 4;
+
+	switch (format)
+	{
+		case GL_RED: channelsTotal = 1; break;
+		case GL_RG:  channelsTotal = 2; break;
+		case GL_RGB: channelsTotal = 3; break;
+		default:                        break;
+	}
+
+	if (width <= 0 || height <= 0)
+		return(0);
+
+	const size_t rowSize        = static_cast<size_t>(width) * channelsTotal;
+	const size_t alignedRowSize = (rowSize + 3) & ~static_cast<size_t>(3);
+
+	return(alignedRowSize * static_cast<size_t>(height - 1) + rowSize);
+}
+
+namespace Engine::GFX
+{
+	RecordingRenderDevice::RecordingRenderDevice(unique_ptr<RenderDevice> targetDevice) noexcept :
+		m_TargetDevice(std::move(targetDevice))
+	{
+	}
+
+	RecordingRenderDevice::~RecordingRenderDevice()
+	{
+		if (m_File == nullptr)
+			return;
+
+		fclose(m_File);
+
+		Logger::m_GraphicsLogger->info("The render command stream has been closed({} frames recorded)", m_FramesRecorded);
+	}
+
+	Error RecordingRenderDevice::open(const char* filename) noexcept
+	{
+		m_File = fopen(filename, "wb");
+
+		if (m_File == nullptr)
+		{
+			Logger::m_GraphicsLogger->error("Unable to open the render command stream file {}", filename);
+
+			return(Error::InitializationError);
+		}
+
+		const uint32_t fileHeader[2] = { RenderCommandFile::HeaderTag, RenderCommandFile::Version };
+		fwrite(fileHeader, sizeof(fileHeader), 1, m_File);
+
+		Logger::m_GraphicsLogger->info("Recording the render commands into {}", filename);
+
+		return(Error::Ok);
+	}
+
+	void RecordingRenderDevice::writeBlob(const void* data, size_t size) noexcept
+	{
+		if (m_File == nullptr)
+			return;
+
+		const uint32_t blobSize = (data != nullptr) ? static_cast<uint32_t>(size) : 0u;
+
+		fwrite(&blobSize, sizeof(blobSize), 1, m_File);
+
+		if (blobSize != 0)
+			fwrite(data, 1, blobSize, m_File);
+	}
+
+	void RecordingRenderDevice::endFrame() noexcept
+	{
+		writeCommand(RenderCommand::EndFrame);
+		m_TargetDevice->endFrame();
+
+		m_FramesRecorded++;
+	}
+
+	GLuint RecordingRenderDevice::createBuffer() noexcept
+	{
+		const GLuint bufferID = m_TargetDevice->createBuffer();
+		writeCommand(RenderCommand::CreateBuffer, bufferID);
+
+		return(bufferID);
+	}
+
+	void RecordingRenderDevice::deleteBuffer(GLuint bufferID) noexcept
+	{
+		writeCommand(RenderCommand::DeleteBuffer, bufferID);
+		m_TargetDevice->deleteBuffer(bufferID);
+	}
+
+	void RecordingRenderDevice::bindBuffer(GLenum target, GLuint bufferID) noexcept
+	{
+		writeCommand(RenderCommand::BindBuffer, target, bufferID);
+		m_TargetDevice->bindBuffer(target, bufferID);
+	}
+
+	void RecordingRenderDevice::bufferData(GLenum target, GLsizeiptr size, const void* data, GLenum usage) noexcept
+	{
+		// The size is written separately, the buffer can be allocated with no data.
+		const uint64_t bufferSize = static_cast<uint64_t>(size);
+
+		writeCommand(RenderCommand::BufferData, target, usage, bufferSize);
+		writeBlob   (data, static_cast<size_t>(size));
+
+		m_TargetDevice->bufferData(target, size, data, usage);
+	}
+
+	void RecordingRenderDevice::bufferSubData(GLenum target, GLintptr offset, GLsizeiptr size, const void* data) noexcept
+	{
+		const uint64_t bufferOffset = static_cast<uint64_t>(offset);
+
+		writeCommand(RenderCommand::BufferSubData, target, bufferOffset);
+		writeBlob   (data, static_cast<size_t>(size));
+
+		m_TargetDevice->bufferSubData(target, offset, size, data);
+	}
+
+	void* RecordingRenderDevice::mapBuffer(GLenum target, GLsizeiptr size) noexcept
+	{
+		UnreferencedParameter(target);
+
+		m_MappedMemory.resize(static_cast<size_t>(size));
+
+		return(m_MappedMemory.data());
+	}
+
+	bool RecordingRenderDevice::unmapBuffer(GLenum target) noexcept
+	{
+		writeCommand(RenderCommand::UploadMappedBuffer, target);
+		writeBlob   (m_MappedMemory.data(), m_MappedMemory.size());
+
+		void* targetMemory = m_TargetDevice->mapBuffer(target, static_cast<GLsizeiptr>(m_MappedMemory.size()));
+
+		if (targetMemory == nullptr)
+			return(false);
+
+		memcpy(targetMemory, m_MappedMemory.data(), m_MappedMemory.size());
+
+		return(m_TargetDevice->unmapBuffer(target));
+	}
+
+	GLuint RecordingRenderDevice::createVertexArray() noexcept
+	{
+		const GLuint vertexArrayID = m_TargetDevice->createVertexArray();
+		writeCommand(RenderCommand::CreateVertexArray, vertexArrayID);
+
+		return(vertexArrayID);
+	}
+
+	void RecordingRenderDevice::deleteVertexArray(GLuint vertexArrayID) noexcept
+	{
+		writeCommand(RenderCommand::DeleteVertexArray, vertexArrayID);
+		m_TargetDevice->deleteVertexArray(vertexArrayID);
+	}
+
+	void RecordingRenderDevice::bindVertexArray(GLuint vertexArrayID) noexcept
+	{
+		writeCommand(RenderCommand::BindVertexArray, vertexArrayID);
+		m_TargetDevice->bindVertexArray(vertexArrayID);
+	}
+
+	void RecordingRenderDevice::enableVertexAttribute(GLuint attributeIndex) noexcept
+	{
+		writeCommand(RenderCommand::EnableVertexAttribute, attributeIndex);
+		m_TargetDevice->enableVertexAttribute(attributeIndex);
+	}
+
+	void RecordingRenderDevice::vertexAttributePointer(GLuint attributeIndex, GLint componentsTotal, GLsizei stride, size_t offset) noexcept
+	{
+		const uint64_t attributeOffset = static_cast<uint64_t>(offset);
+
+		writeCommand(RenderCommand::VertexAttributePointer, attributeIndex, componentsTotal, stride, attributeOffset);
+		m_TargetDevice->vertexAttributePointer(attributeIndex, componentsTotal, stride, offset);
+	}
+
+	void RecordingRenderDevice::vertexAttributeDivisor(GLuint attributeIndex, GLuint divisor) noexcept
+	{
+		writeCommand(RenderCommand::VertexAttributeDivisor, attributeIndex, divisor);
+		m_TargetDevice->vertexAttributeDivisor(attributeIndex, divisor);
+	}
+
+	GLuint RecordingRenderDevice::createTexture() noexcept
+	{
+		const GLuint textureID = m_TargetDevice->createTexture();
+		writeCommand(RenderCommand::CreateTexture, textureID);
+
+		return(textureID);
+	}
+
+	void RecordingRenderDevice::deleteTexture(GLuint textureID) noexcept
+	{
+		writeCommand(RenderCommand::DeleteTexture, textureID);
+		m_TargetDevice->deleteTexture(textureID);
+	}
+
+	void RecordingRenderDevice::activeTexture(GLenum textureUnit) noexcept
+	{
+		writeCommand(RenderCommand::ActiveTexture, textureUnit);
+		m_TargetDevice->activeTexture(textureUnit);
+	}
+
+	void RecordingRenderDevice::bindTexture(GLuint textureID) noexcept
+	{
+		writeCommand(RenderCommand::BindTexture, textureID);
+		m_TargetDevice->bindTexture(textureID);
+	}
+
+	void RecordingRenderDevice::textureImage(GLint internalFormat, GLsizei width, GLsizei height, GLenum format, const void* pixels) noexcept
+	{
+		writeCommand(RenderCommand::TextureImage, internalFormat, width, height, format);
+		writeBlob   (pixels, getPixelsSize(width, height, format));
+
+		m_TargetDevice->textureImage(internalFormat, width, height, format, pixels);
+	}
+
+	void RecordingRenderDevice::textureParameter(GLenum parameterName, GLint parameterValue) noexcept
+	{
+		writeCommand(RenderCommand::TextureParameter, parameterName, parameterValue);
+		m_TargetDevice->textureParameter(parameterName, parameterValue);
+	}
+
+	void RecordingRenderDevice::textureParameterFloat(GLenum parameterName, GLfloat parameterValue) noexcept
+	{
+		writeCommand(RenderCommand::TextureParameterFloat, parameterName, parameterValue);
+		m_TargetDevice->textureParameterFloat(parameterName, parameterValue);
+	}
+
+	void RecordingRenderDevice::generateMipmap() noexcept
+	{
+		writeCommand(RenderCommand::GenerateMipmap);
+		m_TargetDevice->generateMipmap();
+	}
+
+	GLfloat RecordingRenderDevice::getMaxAnisotropy() noexcept
+	{
+		// The queried value is not recorded, the texture parameter that is set with it is.
+		return(m_TargetDevice->getMaxAnisotropy());
+	}
+
+	GLuint RecordingRenderDevice::createShader(GLenum shaderType) noexcept
+	{
+		const GLuint shaderID = m_TargetDevice->createShader(shaderType);
+		writeCommand(RenderCommand::CreateShader, shaderType, shaderID);
+
+		return(shaderID);
+	}
+
+	void RecordingRenderDevice::deleteShader(GLuint shaderID) noexcept
+	{
+		writeCommand(RenderCommand::DeleteShader, shaderID);
+		m_TargetDevice->deleteShader(shaderID);
+	}
+
+	bool RecordingRenderDevice::compileShader(GLuint shaderID, const char* shaderSource, string& infoLog) noexcept
+	{
+		// The terminating zero is written too, so the replayer passes the source right
+		// from the stream.
+		writeCommand(RenderCommand::CompileShader, shaderID);
+		writeBlob   (shaderSource, strlen(shaderSource) + 1);
+
+		return(m_TargetDevice->compileShader(shaderID, shaderSource, infoLog));
+	}
+
+	GLuint RecordingRenderDevice::createProgram() noexcept
+	{
+		const GLuint programID = m_TargetDevice->createProgram();
+		writeCommand(RenderCommand::CreateProgram, programID);
+
+		return(programID);
+	}
+
+	void RecordingRenderDevice::deleteProgram(GLuint programID) noexcept
+	{
+		writeCommand(RenderCommand::DeleteProgram, programID);
+		m_TargetDevice->deleteProgram(programID);
+	}
+
+	void RecordingRenderDevice::attachShader(GLuint programID, GLuint shaderID) noexcept
+	{
+		writeCommand(RenderCommand::AttachShader, programID, shaderID);
+		m_TargetDevice->attachShader(programID, shaderID);
+	}
+
+	bool RecordingRenderDevice::linkProgram(GLuint programID, string& infoLog) noexcept
+	{
+		writeCommand(RenderCommand::LinkProgram, programID);
+
+		return(m_TargetDevice->linkProgram(programID, infoLog));
+	}
+
+	void RecordingRenderDevice::useProgram(GLuint programID) noexcept
+	{
+		writeCommand(RenderCommand::UseProgram, programID);
+		m_TargetDevice->useProgram(programID);
+	}
+
+	bool RecordingRenderDevice::getProgramBinary(GLuint programID, GLenum& binaryFormat, std::vector<uint8_t>& programBinary) noexcept
+	{
+		UnreferencedParameter(programID);
+		UnreferencedParameter(binaryFormat);
+		UnreferencedParameter(programBinary);
+
+		// The binaries are bound to the driver of the recording machine, so the programs are
+		// always compiled from the sources(the stream stays replayable everywhere).
+		return(false);
+	}
+
+	bool RecordingRenderDevice::programBinary(GLuint programID, GLenum binaryFormat, const void* programBinary, GLsizei binarySize) noexcept
+	{
+		UnreferencedParameter(programID);
+		UnreferencedParameter(binaryFormat);
+		UnreferencedParameter(programBinary);
+		UnreferencedParameter(binarySize);
+
+		return(false);
+	}
+
+	std::string RecordingRenderDevice::getDriverSignature() noexcept
+	{
+		return(m_TargetDevice->getDriverSignature());
+	}
+
+	GLint RecordingRenderDevice::getUniformLocation(GLuint programID, const char* uniformName) noexcept
+	{
+		const GLint location = m_TargetDevice->getUniformLocation(programID, uniformName);
+
+		writeCommand(RenderCommand::GetUniformLocation, programID, location);
+		writeBlob   (uniformName, strlen(uniformName) + 1);
+
+		return(location);
+	}
+
+	void RecordingRenderDevice::setUniform(GLint location, GLint value) noexcept
+	{
+		writeCommand(RenderCommand::SetUniformInt, location, value);
+		m_TargetDevice->setUniform(location, value);
+	}
+
+	void RecordingRenderDevice::setUniform(GLint location, GLfloat value) noexcept
+	{
+		writeCommand(RenderCommand::SetUniformFloat, location, value);
+		m_TargetDevice->setUniform(location, value);
+	}
+
+	void RecordingRenderDevice::setUniform(GLint location, const glm::vec2& value) noexcept
+	{
+		writeCommand(RenderCommand::SetUniformVec2, location, value);
+		m_TargetDevice->setUniform(location, value);
+	}
+
+	void RecordingRenderDevice::setUniform(GLint location, const glm::vec3& value) noexcept
+	{
+		writeCommand(RenderCommand::SetUniformVec3, location, value);
+		m_TargetDevice->setUniform(location, value);
+	}
+
+	void RecordingRenderDevice::setUniform(GLint location, const glm::vec4& value) noexcept
+	{
+		writeCommand(RenderCommand::SetUniformVec4, location, value);
+		m_TargetDevice->setUniform(location, value);
+	}
+
+	void RecordingRenderDevice::setUniform(GLint location, const glm::mat4& value) noexcept
+	{
+		writeCommand(RenderCommand::SetUniformMat4, location, value);
+		m_TargetDevice->setUniform(location, value);
+	}
+
+	void RecordingRenderDevice::drawArrays(GLenum drawMode, GLint firstVertex, GLsizei verticesTotal) noexcept
+	{
+		writeCommand(RenderCommand::DrawArrays, drawMode, firstVertex, verticesTotal);
+		m_TargetDevice->drawArrays(drawMode, firstVertex, verticesTotal);
+	}
+
+	void RecordingRenderDevice::drawArraysInstanced(GLenum drawMode, GLint firstVertex, GLsizei verticesTotal, GLsizei instancesTotal) noexcept
+	{
+		writeCommand(RenderCommand::DrawArraysInstanced, drawMode, firstVertex, verticesTotal, instancesTotal);
+		m_TargetDevice->drawArraysInstanced(drawMode, firstVertex, verticesTotal, instancesTotal);
+	}
+
+	void RecordingRenderDevice::setViewport(GLint positionX, GLint positionY, GLsizei width, GLsizei height) noexcept
+	{
+		writeCommand(RenderCommand::SetViewport, positionX, positionY, width, height);
+		m_TargetDevice->setViewport(positionX, positionY, width, height);
+	}
+
+	void RecordingRenderDevice::setCapability(GLenum capability, bool isEnabled) noexcept
+	{
+		const uint8_t enabledFlag = isEnabled ? 1u : 0u;
+
+		writeCommand(RenderCommand::SetCapability, capability, enabledFlag);
+		m_TargetDevice->setCapability(capability, isEnabled);
+	}
+
+	void RecordingRenderDevice::setBlendFunction(GLenum sourceFactor, GLenum destinationFactor) noexcept
+	{
+		writeCommand(RenderCommand::SetBlendFunction, sourceFactor, destinationFactor);
+		m_TargetDevice->setBlendFunction(sourceFactor, destinationFactor);
+	}
+
+	void RecordingRenderDevice::clear(const glm::vec4& clearColor) noexcept
+	{
+		writeCommand(RenderCommand::Clear, clearColor);
+		m_TargetDevice->clear(clearColor);
+	}
+
+	Error RenderCommandReplayer::open(const char* filename) noexcept
+	{
+		ifstream streamFile(filename, ios::binary);
+
+		if (!streamFile)
+		{
+			Logger::m_GraphicsLogger->error("Unable to open the render command stream file {}", filename);
+
+			return(Error::InitializationError);
+		}
+
+		m_StreamData.assign(istreambuf_iterator<char>(streamFile), istreambuf_iterator<char>());
+		m_StreamOffset = 0;
+		m_IsBroken     = false;
+
+		const uint32_t headerTag = read<uint32_t>();
+		const uint32_t version   = read<uint32_t>();
+
+		if (m_IsBroken || headerTag != RenderCommandFile::HeaderTag || version != RenderCommandFile::Version)
+		{
+			Logger::m_GraphicsLogger->error("{} is not the render command stream(version {})", filename, RenderCommandFile::Version);
+
+			return(Error::ValidationError);
+		}
+
+		return(Error::Ok);
+	}
+
+	bool RenderCommandReplayer::replayFrame(RenderDevice& renderDevice) noexcept
+	{
+		while (!m_IsBroken && m_StreamOffset < m_StreamData.size())
+		{
+			const RenderCommand renderCommand = read<RenderCommand>();
+
+			m_CommandsReplayed++;
+
+			if (renderCommand == RenderCommand::EndFrame)
+			{
+				renderDevice.endFrame();
+
+				return(true);
+			}
+
+			replayCommand(renderDevice, renderCommand);
+		}
+
+		if (m_IsBroken)
+			Logger::m_GraphicsLogger->error("The render command stream is broken at the offset {}", m_StreamOffset);
+
+		return(false);
+	}
+
+	const uint8_t* RenderCommandReplayer::readBlob(uint32_t& blobSize) noexcept
+	{
+		blobSize = read<uint32_t>();
+
+		if (blobSize == 0)
+			return(nullptr);
+
+		if (m_StreamData.size() - m_StreamOffset < blobSize)
+		{
+			m_IsBroken     = true;
+			m_StreamOffset = m_StreamData.size();
+			blobSize       = 0;
+
+			return(nullptr);
+		}
+
+		const uint8_t* blobData = m_StreamData.data() + m_StreamOffset;
+		m_StreamOffset += blobSize;
+
+		return(blobData);
+	}
+
+	GLuint RenderCommandReplayer::mapObject(const unordered_map<GLuint, GLuint>& objectMap, GLuint recordedID) noexcept
+	{
+		const auto objectIterator = objectMap.find(recordedID);
+
+		return((objectIterator != objectMap.end()) ? objectIterator->second : 0u);
+	}
+
+	GLint RenderCommandReplayer::mapLocation(GLint recordedLocation) const noexcept
+	{
+		const uint64_t locationKey = (static_cast<uint64_t>(m_CurrentProgram) << 32) | static_cast<uint32_t>(recordedLocation);
+		const auto     locationIterator = m_UniformLocations.find(locationKey);
+
+		return((locationIterator != m_UniformLocations.end()) ? locationIterator->second : -1);
+	}
+
+	void RenderCommandReplayer::replayCommand(RenderDevice& renderDevice, RenderCommand renderCommand) noexcept
+	{
+		uint32_t blobSize = 0;
+
+		switch (renderCommand)
+		{
+			case RenderCommand::CreateBuffer:
+			{
+				const GLuint recordedID = read<GLuint>();
+				m_Buffers[recordedID] = renderDevice.createBuffer();
+				break;
+			}
+			case RenderCommand::DeleteBuffer:
+			{
+				const GLuint recordedID = read<GLuint>();
+				renderDevice.deleteBuffer(mapObject(m_Buffers, recordedID));
+				m_Buffers.erase(recordedID);
+				break;
+			}
+			case RenderCommand::BindBuffer:
+			{
+				const GLenum target     = read<GLenum>();
+				const GLuint recordedID = read<GLuint>();
+				renderDevice.bindBuffer(target, mapObject(m_Buffers, recordedID));
+				break;
+			}
+			case RenderCommand::BufferData:
+			{
+				const GLenum   target     = read<GLenum>();
+				const GLenum   usage      = read<GLenum>();
+				const uint64_t bufferSize = read<uint64_t>();
+				const uint8_t* bufferData = readBlob(blobSize);
+				renderDevice.bufferData(target, static_cast<GLsizeiptr>(bufferSize), bufferData, usage);
+				break;
+			}
+			case RenderCommand::BufferSubData:
+			{
+				const GLenum   target       = read<GLenum>();
+				const uint64_t bufferOffset = read<uint64_t>();
+				const uint8_t* bufferData   = readBlob(blobSize);
+				renderDevice.bufferSubData(target, static_cast<GLintptr>(bufferOffset), blobSize, bufferData);
+				break;
+			}
+			case RenderCommand::CreateVertexArray:
+			{
+				const GLuint recordedID = read<GLuint>();
+				m_VertexArrays[recordedID] = renderDevice.createVertexArray();
+				break;
+			}
+			case RenderCommand::DeleteVertexArray:
+			{
+				const GLuint recordedID = read<GLuint>();
+				renderDevice.deleteVertexArray(mapObject(m_VertexArrays, recordedID));
+				m_VertexArrays.erase(recordedID);
+				break;
+			}
+			case RenderCommand::BindVertexArray:
+			{
+				const GLuint recordedID = read<GLuint>();
+				renderDevice.bindVertexArray(mapObject(m_VertexArrays, recordedID));
+				break;
+			}
+			case RenderCommand::EnableVertexAttribute:
+			{
+				renderDevice.enableVertexAttribute(read<GLuint>());
+				break;
+			}
+			case RenderCommand::VertexAttributePointer:
+			{
+				const GLuint   attributeIndex  = read<GLuint>();
+				const GLint    componentsTotal = read<GLint>();
+				const GLsizei  stride          = read<GLsizei>();
+				const uint64_t attributeOffset = read<uint64_t>();
+				renderDevice.vertexAttributePointer(attributeIndex, componentsTotal, stride, static_cast<size_t>(attributeOffset));
+				break;
+			}
+			case RenderCommand::VertexAttributeDivisor:
+			{
+				const GLuint attributeIndex = read<GLuint>();
+				const GLuint divisor        = read<GLuint>();
+				renderDevice.vertexAttributeDivisor(attributeIndex, divisor);
+				break;
+			}
+			case RenderCommand::CreateTexture:
+			{
+				const GLuint recordedID = read<GLuint>();
+				m_Textures[recordedID] = renderDevice.createTexture();
+				break;
+			}
+			case RenderCommand::DeleteTexture:
+			{
+				const GLuint recordedID = read<GLuint>();
+				renderDevice.deleteTexture(mapObject(m_Textures, recordedID));
+				m_Textures.erase(recordedID);
+				break;
+			}
+			case RenderCommand::ActiveTexture:
+			{
+				renderDevice.activeTexture(read<GLenum>());
+				break;
+			}
+			case RenderCommand::BindTexture:
+			{
+				const GLuint recordedID = read<GLuint>();
+				renderDevice.bindTexture(mapObject(m_Textures, recordedID));
+				break;
+			}
+			case RenderCommand::TextureImage:
+			{
+				const GLint    internalFormat = read<GLint>();
+				const GLsizei  width          = read<GLsizei>();
+				const GLsizei  height         = read<GLsizei>();
+				const GLenum   format         = read<GLenum>();
+				const uint8_t* pixels         = readBlob(blobSize);
+				renderDevice.textureImage(internalFormat, width, height, format, pixels);
+				break;
+			}
+			case RenderCommand::TextureParameter:
+			{
+				const GLenum parameterName  = read<GLenum>();
+				const GLint  parameterValue = read<GLint>();
+				renderDevice.textureParameter(parameterName, parameterValue);
+				break;
+			}
+			case RenderCommand::TextureParameterFloat:
+			{
+				const GLenum  parameterName  = read<GLenum>();
+				const GLfloat parameterValue = read<GLfloat>();
+				renderDevice.textureParameterFloat(parameterName, parameterValue);
+				break;
+			}
+			case RenderCommand::GenerateMipmap:
+			{
+				renderDevice.generateMipmap();
+				break;
+			}
+			case RenderCommand::CreateShader:
+			{
+				const GLenum shaderType = read<GLenum>();
+				const GLuint recordedID = read<GLuint>();
+				m_Programs[recordedID] = renderDevice.createShader(shaderType);
+				break;
+			}
+			case RenderCommand::DeleteShader:
+			{
+				const GLuint recordedID = read<GLuint>();
+				renderDevice.deleteShader(mapObject(m_Programs, recordedID));
+				m_Programs.erase(recordedID);
+				break;
+			}
+			case RenderCommand::CompileShader:
+			{
+				const GLuint   recordedID   = read<GLuint>();
+				const uint8_t* shaderSource = readBlob(blobSize);
+
+				if (shaderSource == nullptr || shaderSource[blobSize - 1] != 0)
+				{
+					m_IsBroken = true;
+					break;
+				}
+
+				if (!renderDevice.compileShader(mapObject(m_Programs, recordedID), reinterpret_cast<const char*>(shaderSource), m_InfoLog))
+					Logger::m_GraphicsLogger->error("The replayed shader failed to compile: {}", m_InfoLog);
+				break;
+			}
+			case RenderCommand::CreateProgram:
+			{
+				const GLuint recordedID = read<GLuint>();
+				m_Programs[recordedID] = renderDevice.createProgram();
+				break;
+			}
+			case RenderCommand::DeleteProgram:
+			{
+				const GLuint recordedID = read<GLuint>();
+				renderDevice.deleteProgram(mapObject(m_Programs, recordedID));
+				m_Programs.erase(recordedID);
+				break;
+			}
+			case RenderCommand::AttachShader:
+			{
+				const GLuint programID = read<GLuint>();
+				const GLuint shaderID  = read<GLuint>();
+				renderDevice.attachShader(mapObject(m_Programs, programID), mapObject(m_Programs, shaderID));
+				break;
+			}
+			case RenderCommand::LinkProgram:
+			{
+				const GLuint recordedID = read<GLuint>();
+
+				if (!renderDevice.linkProgram(mapObject(m_Programs, recordedID), m_InfoLog))
+					Logger::m_GraphicsLogger->error("The replayed program failed to link: {}", m_InfoLog);
+				break;
+			}
+			case RenderCommand::UseProgram:
+			{
+				m_CurrentProgram = read<GLuint>();
+				renderDevice.useProgram(mapObject(m_Programs, m_CurrentProgram));
+				break;
+			}
+			case RenderCommand::GetUniformLocation:
+			{
+				const GLuint   programID        = read<GLuint>();
+				const GLint    recordedLocation = read<GLint>();
+				const uint8_t* uniformName      = readBlob(blobSize);
+
+				if (uniformName == nullptr || uniformName[blobSize - 1] != 0)
+				{
+					m_IsBroken = true;
+					break;
+				}
+
+				const uint64_t locationKey = (static_cast<uint64_t>(programID) << 32) | static_cast<uint32_t>(recordedLocation);
+				m_UniformLocations[locationKey] = renderDevice.getUniformLocation(mapObject(m_Programs, programID), reinterpret_cast<const char*>(uniformName));
+				break;
+			}
+			case RenderCommand::SetUniformInt:
+			{
+				const GLint location = read<GLint>();
+				renderDevice.setUniform(mapLocation(location), read<GLint>());
+				break;
+			}
+			case RenderCommand::SetUniformFloat:
+			{
+				const GLint location = read<GLint>();
+				renderDevice.setUniform(mapLocation(location), read<GLfloat>());
+				break;
+			}
+			case RenderCommand::SetUniformVec2:
+			{
+				const GLint location = read<GLint>();
+				renderDevice.setUniform(mapLocation(location), read<glm::vec2>());
+				break;
+			}
+			case RenderCommand::SetUniformVec3:
+			{
+				const GLint location = read<GLint>();
+				renderDevice.setUniform(mapLocation(location), read<glm::vec3>());
+				break;
+			}
+			case RenderCommand::SetUniformVec4:
+			{
+				const GLint location = read<GLint>();
+				renderDevice.setUniform(mapLocation(location), read<glm::vec4>());
+				break;
+			}
+			case RenderCommand::SetUniformMat4:
+			{
+				const GLint location = read<GLint>();
+				renderDevice.setUniform(mapLocation(location), read<glm::mat4>());
+				break;
+			}
+			case RenderCommand::DrawArrays:
+			{
+				const GLenum  drawMode      = read<GLenum>();
+				const GLint   firstVertex   = read<GLint>();
+				const GLsizei verticesTotal = read<GLsizei>();
+				renderDevice.drawArrays(drawMode, firstVertex, verticesTotal);
+				break;
+			}
+			case RenderCommand::DrawArraysInstanced:
+			{
+				const GLenum  drawMode       = read<GLenum>();
+				const GLint   firstVertex    = read<GLint>();
+				const GLsizei verticesTotal  = read<GLsizei>();
+				const GLsizei instancesTotal = read<GLsizei>();
+				renderDevice.drawArraysInstanced(drawMode, firstVertex, verticesTotal, instancesTotal);
+				break;
+			}
+			case RenderCommand::SetViewport:
+			{
+				const GLint   positionX = read<GLint>();
+				const GLint   positionY = read<GLint>();
+				const GLsizei width     = read<GLsizei>();
+				const GLsizei height    = read<GLsizei>();
+				renderDevice.setViewport(positionX, positionY, width, height);
+				break;
+			}
+			case RenderCommand::SetCapability:
+			{
+				const GLenum  capability  = read<GLenum>();
+				const uint8_t enabledFlag = read<uint8_t>();
+				renderDevice.setCapability(capability, enabledFlag != 0);
+				break;
+			}
+			case RenderCommand::SetBlendFunction:
+			{
+				const GLenum sourceFactor      = read<GLenum>();
+				const GLenum destinationFactor = read<GLenum>();
+				renderDevice.setBlendFunction(sourceFactor, destinationFactor);
+				break;
+			}
+			case RenderCommand::Clear:
+			{
+				renderDevice.clear(read<glm::vec4>());
+				break;
+			}
+			case RenderCommand::UploadMappedBuffer:
+			{
+				const GLenum   target     = read<GLenum>();
+				const uint8_t* bufferData = readBlob(blobSize);
+
+				if (void* mappedMemory = renderDevice.mapBuffer(target, blobSize); mappedMemory != nullptr)
+				{
+					if (blobSize != 0)
+						memcpy(mappedMemory, bufferData, blobSize);
+
+					renderDevice.unmapBuffer(target);
+				}
+				break;
+			}
+			default:
+			{
+				// The stream of the newer version(or the garbage), the rest can't be parsed.
+				m_IsBroken = true;
+				break;
+			}
+		}
+	}
+}
@@ -0,0 +1,236 @@
+// This file declares the `RecordingRenderDevice` and the `RenderCommandReplayer` classes.
+//
+// The command stream is the header(the tag and the version) followed by the commands,
+// every command is the one byte opcode and the raw arguments. The memory that is
+// passed to the call(the buffer data, the pixels, the shader source and the uniform
+// name) is written as the 32-bit size and the bytes. The object names and the uniform
+// locations that the recorded device handed out are written too, so the replayer maps
+// them to the names of the device it replays into.
+#pragma once
+
+#include "RenderDevice.hpp"
+
+#include "unordered_map"
+#include "cstring"
+#include "cstdio"
+#include "vector"
+
+// This namespace is polluted with the Internals components of the graphics API.
+namespace Engine::GFX
+{
+	namespace RenderCommandFile
+	{
+		static constexpr const uint32_t HeaderTag = 0x444D4352u; // "RCMD"
+		static constexpr const uint32_t Version   = 1u;
+	}
+
+	// The opcode of the recorded command(the values are written into the file).
+	enum class RenderCommand : uint8_t
+	{
+		EndFrame,
+		CreateBuffer,
+		DeleteBuffer,
+		BindBuffer,
+		BufferData,
+		BufferSubData,
+		CreateVertexArray,
+		DeleteVertexArray,
+		BindVertexArray,
+		EnableVertexAttribute,
+		VertexAttributePointer,
+		VertexAttributeDivisor,
+		CreateTexture,
+		DeleteTexture,
+		ActiveTexture,
+		BindTexture,
+		TextureImage,
+		TextureParameter,
+		CreateShader,
+		DeleteShader,
+		CompileShader,
+		CreateProgram,
+		DeleteProgram,
+		AttachShader,
+		LinkProgram,
+		UseProgram,
+		GetUniformLocation,
+		SetUniformInt,
+		SetUniformFloat,
+		SetUniformVec2,
+		SetUniformVec3,
+		SetUniformVec4,
+		SetUniformMat4,
+		DrawArrays,
+		DrawArraysInstanced,
+		SetViewport,
+		SetCapability,
+		SetBlendFunction,
+		Clear,
+		UploadMappedBuffer,
+		TextureParameterFloat,
+		GenerateMipmap,
+	};
+
+	// The render device that writes every call into the command stream and forwards it
+	// to the wrapped device.
+	class RecordingRenderDevice : public RenderDevice
+	{
+	public:
+		explicit RecordingRenderDevice(std::unique_ptr<RenderDevice> targetDevice) noexcept;
+		~RecordingRenderDevice() override;
+
+		// Create the command stream file and write the header.
+		Error open(const char* filename) noexcept;
+
+		void endFrame() noexcept override;
+
+		GLuint createBuffer() noexcept override;
+		void   deleteBuffer(GLuint bufferID) noexcept override;
+		void   bindBuffer(GLenum target, GLuint bufferID) noexcept override;
+		void   bufferData(GLenum target, GLsizeiptr size, const void* data, GLenum usage) noexcept override;
+		void   bufferSubData(GLenum target, GLintptr offset, GLsizeiptr size, const void* data) noexcept override;
+		void*  mapBuffer(GLenum target, GLsizeiptr size) noexcept override;
+		bool   unmapBuffer(GLenum target) noexcept override;
+
+		GLuint createVertexArray() noexcept override;
+		void   deleteVertexArray(GLuint vertexArrayID) noexcept override;
+		void   bindVertexArray(GLuint vertexArrayID) noexcept override;
+		void   enableVertexAttribute(GLuint attributeIndex) noexcept override;
+		void   vertexAttributePointer(GLuint attributeIndex, GLint componentsTotal, GLsizei stride, size_t offset) noexcept override;
+		void   vertexAttributeDivisor(GLuint attributeIndex, GLuint divisor) noexcept override;
+
+		GLuint createTexture() noexcept override;
+		void   deleteTexture(GLuint textureID) noexcept override;
+		void   activeTexture(GLenum textureUnit) noexcept override;
+		void   bindTexture(GLuint textureID) noexcept override;
+		void   textureImage(GLint internalFormat, GLsizei width, GLsizei height, GLenum format, const void* pixels) noexcept override;
+		void   textureParameter(GLenum parameterName, GLint parameterValue) noexcept override;
+		void   textureParameterFloat(GLenum parameterName, GLfloat parameterValue) noexcept override;
+		void   generateMipmap() noexcept override;
+
+		GLfloat getMaxAnisotropy() noexcept override;
+
+		GLuint createShader(GLenum shaderType) noexcept override;
+		void   deleteShader(GLuint shaderID) noexcept override;
+		bool   compileShader(GLuint shaderID, const char* shaderSource, std::string& infoLog) noexcept override;
+		GLuint createProgram() noexcept override;
+		void   deleteProgram(GLuint programID) noexcept override;
+		void   attachShader(GLuint programID, GLuint shaderID) noexcept override;
+		bool   linkProgram(GLuint programID, std::string& infoLog) noexcept override;
+		void   useProgram(GLuint programID) noexcept override;
+
+		bool        getProgramBinary(GLuint programID, GLenum& binaryFormat, std::vector<uint8_t>& programBinary) noexcept override;
+		bool        programBinary(GLuint programID, GLenum binaryFormat, const void* programBinary, GLsizei binarySize) noexcept override;
+		std::string getDriverSignature() noexcept override;
+
+		GLint getUniformLocation(GLuint programID, const char* uniformName) noexcept override;
+		void  setUniform(GLint location, GLint value) noexcept override;
+		void  setUniform(GLint location, GLfloat value) noexcept override;
+		void  setUniform(GLint location, const glm::vec2& value) noexcept override;
+		void  setUniform(GLint location, const glm::vec3& value) noexcept override;
+		void  setUniform(GLint location, const glm::vec4& value) noexcept override;
+		void  setUniform(GLint location, const glm::mat4& value) noexcept override;
+
+		void drawArrays(GLenum drawMode, GLint firstVertex, GLsizei verticesTotal) noexcept override;
+		void drawArraysInstanced(GLenum drawMode, GLint firstVertex, GLsizei verticesTotal, GLsizei instancesTotal) noexcept override;
+
+		void setViewport(GLint positionX, GLint positionY, GLsizei width, GLsizei height) noexcept override;
+		void setCapability(GLenum capability, bool isEnabled) noexcept override;
+		void setBlendFunction(GLenum sourceFactor, GLenum destinationFactor) noexcept override;
+		void clear(const glm::vec4& clearColor) noexcept override;
+
+	private:
+		// Write the opcode and the arguments of the command.
+		template<typename... Args>
+		void writeCommand(RenderCommand renderCommand, const Args&... args) noexcept
+		{
+			if (m_File == nullptr)
+				return;
+
+			fputc(static_cast<int>(renderCommand), m_File);
+			(fwrite(&args, sizeof(Args), 1, m_File), ...);
+		}
+
+		// Write the memory block(the size and the bytes).
+		void writeBlob(const void* data, size_t size) noexcept;
+
+	private:
+		std::unique_ptr<RenderDevice> m_TargetDevice;
+
+		// The mapped memory is the staging copy, it is recorded and copied into the buffer of
+		// the wrapped device on the unmap.
+		std::vector<uint8_t> m_MappedMemory;
+
+		FILE*    m_File           = nullptr;
+		uint64_t m_FramesRecorded = 0;
+	};
+
+	// This class reads the command stream and replays it into the render device frame
+	// by frame(the object names and the uniform locations are remapped).
+	class RenderCommandReplayer
+	{
+	public:
+		// Read the whole command stream into the memory.
+		Error open(const char* filename) noexcept;
+
+		// Replay the commands until the end of the frame, false is returned at the end of
+		// the stream or when the stream is broken.
+		bool replayFrame(RenderDevice& renderDevice) noexcept;
+
+		inline uint64_t getCommandsReplayed() const noexcept
+		{
+			return(m_CommandsReplayed);
+		}
+
+	private:
+		// Read the value, the stream is marked broken when it ends too early.
+		template<typename T>
+		T read() noexcept
+		{
+			T value{};
+
+			if (m_StreamData.size() - m_StreamOffset < sizeof(T))
+			{
+				m_IsBroken     = true;
+				m_StreamOffset = m_StreamData.size();
+
+				return(value);
+			}
+
+			memcpy(&value, m_StreamData.data() + m_StreamOffset, sizeof(T));
+			m_StreamOffset += sizeof(T);
+
+			return(value);
+		}
+
+		// Read the memory block, the returned pointer points into the stream(nullptr when the
+		// block is empty).
+		const uint8_t* readBlob(uint32_t& blobSize) noexcept;
+
+		// Replay the single command.
+		void replayCommand(RenderDevice& renderDevice, RenderCommand renderCommand) noexcept;
+
+		// Map the recorded object name or the uniform location to the replayed one.
+		static GLuint mapObject(const std::unordered_map<GLuint, GLuint>& objectMap, GLuint recordedID) noexcept;
+		GLint         mapLocation(GLint recordedLocation) const noexcept;
+
+	private:
+		std::vector<uint8_t> m_StreamData;
+		size_t               m_StreamOffset     = 0;
+		bool                 m_IsBroken         = false;
+		uint64_t             m_CommandsReplayed = 0;
+
+		// The buffers, the vertex arrays and the textures have their own names, the shaders
+		// share the names with the programs.
+		std::unordered_map<GLuint, GLuint> m_Buffers;
+		std::unordered_map<GLuint, GLuint> m_VertexArrays;
+		std::unordered_map<GLuint, GLuint> m_Textures;
+		std::unordered_map<GLuint, GLuint> m_Programs;
+
+		// The uniform locations by the recorded program(high bits) and the recorded location.
+		std::unordered_map<uint64_t, GLint> m_UniformLocations;
+		GLuint                              m_CurrentProgram = 0;
+
+		std::string m_InfoLog;
+	};
+}
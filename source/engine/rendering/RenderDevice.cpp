@@ -0,0 +1,82 @@
+// This file implements the `RenderDevice` interface.
+#include "RenderDevice.hpp"
+#include "OpenGLRenderDevice.hpp"
+#include "NullRenderDevice.hpp"
+#include "RecordingRenderDevice.hpp"
+#include "../Logger.hpp"
+
+using namespace std;
+
+namespace Engine::GFX
+{
+	unique_ptr<RenderDevice> RenderDevice::m_Instance = make_unique<OpenGLRenderDevice>();
+
+	Error RenderDevice::select(RenderDeviceType deviceType, const char* recordFilename) noexcept
+	{
+		switch (deviceType)
+		{
+			case RenderDeviceType::OpenGL:
+			{
+				m_Instance = make_unique<OpenGLRenderDevice>();
+				break;
+			}
+			case RenderDeviceType::Null:
+			{
+				m_Instance = make_unique<NullRenderDevice>();
+				break;
+			}
+			case RenderDeviceType::Recording:
+			case RenderDeviceType::RecordingNull:
+			{
+				unique_ptr<RenderDevice> targetDevice;
+
+				if (deviceType == RenderDeviceType::Recording)
+					targetDevice = make_unique<OpenGLRenderDevice>();
+				else
+					targetDevice = make_unique<NullRenderDevice>();
+
+				auto recordingDevice = make_unique<RecordingRenderDevice>(std::move(targetDevice));
+
+				if (Error openResult = recordingDevice->open(recordFilename); !FunctionSuccessA(openResult))
+					return(openResult);
+
+				m_Instance = std::move(recordingDevice);
+				break;
+			}
+			default:
+			{
+				return(Error::ValidationError);
+			}
+		}
+
+		return(Error::Ok);
+	}
+
+	bool RenderDevice::parseType(const char* deviceName, RenderDeviceType& deviceType) noexcept
+	{
+		static constexpr const pair<const char*, RenderDeviceType> _DEVICE_NAMES[] =
+		{
+			{ "gl",          RenderDeviceType::OpenGL        },
+			{ "null",        RenderDeviceType::Null          },
+			{ "record",      RenderDeviceType::Recording     },
+			{ "record-null", RenderDeviceType::RecordingNull },
+		};
+
+		for (const auto& [name, type] : _DEVICE_NAMES)
+		{
+			if (strcmp(deviceName, name) == 0)
+			{
+				deviceType = type;
+
+				return(true);
+			}
+		}
+
+		return(false);
+	}
+
+	void RenderDevice::release() noexcept
+	{
+		m_Instance = make_unique<OpenGLRenderDevice>();
+	}
+}
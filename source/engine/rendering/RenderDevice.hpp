@@ -0,0 +1,137 @@
+// This file declares the `RenderDevice` interface.
+//
+// The engine rendering(the sprite renderer, the shader and the texture wrappers, the
+// resource manager and the application setup) talks to the GPU only through this
+// interface. The calls are the thin mirror of the OpenGL calls the engine is using, so
+// the GL backend is a plain forwarder, and the recorded command stream can be replayed
+// call by call. The backends are:
+//
+//   gl          - the OpenGL calls(the default)
+//   null        - does nothing, measures the pure CPU cost of the game and the submission
+//   record      - the OpenGL calls, every call is also written into the command stream
+//   record-null - the same as the `record`, but on top of the `null` backend
+//
+// The backend is selected with the ENGINE_RENDER_DEVICE environment variable.
+#pragma once
+
+#include "../_EngineIncludes.hpp"
+
+#include "memory"
+#include "string"
+#include "vector"
+
+// This namespace is polluted with the Internals components of the graphics API.
+namespace Engine::GFX
+{
+	// The kind of the render device backend.
+	enum class RenderDeviceType : uint8_t
+	{
+		OpenGL,
+		Null,
+		Recording,
+		RecordingNull,
+	};
+
+	// The interface of the render device backend.
+	class RenderDevice
+	{
+	public:
+		virtual ~RenderDevice() = default;
+
+		// Get the render device that is currently used by the engine.
+		static inline RenderDevice& instance() noexcept
+		{
+			return(*m_Instance);
+		}
+
+		// Replace the render device(must be called before any resource is created).
+		static Error select(RenderDeviceType deviceType, const char* recordFilename) noexcept;
+
+		// Parse the backend name(see the list above).
+		static bool parseType(const char* deviceName, RenderDeviceType& deviceType) noexcept;
+
+		// Destroy the selected device and get back to the OpenGL one(the recording is closed).
+		static void release() noexcept;
+
+	public:
+		// Mark the end of the frame(the recorded stream is split into the frames by it).
+		virtual void endFrame() noexcept {}
+
+		// Buffers.
+		virtual GLuint createBuffer() noexcept = 0;
+		virtual void   deleteBuffer(GLuint bufferID) noexcept = 0;
+		virtual void   bindBuffer(GLenum target, GLuint bufferID) noexcept = 0;
+		virtual void   bufferData(GLenum target, GLsizeiptr size, const void* data, GLenum usage) noexcept = 0;
+		virtual void   bufferSubData(GLenum target, GLintptr offset, GLsizeiptr size, const void* data) noexcept = 0;
+
+		// Map the first `size` bytes of the bound buffer for writing, the previous contents are
+		// discarded(the buffer is orphaned, so the GPU is never waited for). The memory may be
+		// written from any thread until the ::unmapBuffer call, false is returned by it when the
+		// contents were lost and must be written again.
+		virtual void*  mapBuffer(GLenum target, GLsizeiptr size) noexcept = 0;
+		virtual bool   unmapBuffer(GLenum target) noexcept = 0;
+
+		// Vertex arrays(the attributes are always the floats).
+		virtual GLuint createVertexArray() noexcept = 0;
+		virtual void   deleteVertexArray(GLuint vertexArrayID) noexcept = 0;
+		virtual void   bindVertexArray(GLuint vertexArrayID) noexcept = 0;
+		virtual void   enableVertexAttribute(GLuint attributeIndex) noexcept = 0;
+		virtual void   vertexAttributePointer(GLuint attributeIndex, GLint componentsTotal, GLsizei stride, size_t offset) noexcept = 0;
+		virtual void   vertexAttributeDivisor(GLuint attributeIndex, GLuint divisor) noexcept = 0;
+
+		// Textures(always the GL_TEXTURE_2D target).
+		virtual GLuint createTexture() noexcept = 0;
+		virtual void   deleteTexture(GLuint textureID) noexcept = 0;
+		virtual void   activeTexture(GLenum textureUnit) noexcept = 0;
+		virtual void   bindTexture(GLuint textureID) noexcept = 0;
+		virtual void   textureImage(GLint internalFormat, GLsizei width, GLsizei height, GLenum format, const void* pixels) noexcept = 0;
+		virtual void   textureParameter(GLenum parameterName, GLint parameterValue) noexcept = 0;
+		virtual void   textureParameterFloat(GLenum parameterName, GLfloat parameterValue) noexcept = 0;
+		virtual void   generateMipmap() noexcept = 0;
+
+		// The largest anisotropy of the texture filtering(1 when the anisotropic filtering is
+		// not supported by the device).
+		virtual GLfloat getMaxAnisotropy() noexcept = 0;
+
+		// Shaders and programs(the compile and link results are returned with the info log).
+		virtual GLuint createShader(GLenum shaderType) noexcept = 0;
+		virtual void   deleteShader(GLuint shaderID) noexcept = 0;
+		virtual bool   compileShader(GLuint shaderID, const char* shaderSource, std::string& infoLog) noexcept = 0;
+		virtual GLuint createProgram() noexcept = 0;
+		virtual void   deleteProgram(GLuint programID) noexcept = 0;
+		virtual void   attachShader(GLuint programID, GLuint shaderID) noexcept = 0;
+		virtual bool   linkProgram(GLuint programID, std::string& infoLog) noexcept = 0;
+		virtual void   useProgram(GLuint programID) noexcept = 0;
+
+		// The linked program binaries(the warm start cache). False is returned when the device
+		// is not able to save or load them, or when the binary was made by the other driver.
+		virtual bool getProgramBinary(GLuint programID, GLenum& binaryFormat, std::vector<uint8_t>& programBinary) noexcept = 0;
+		virtual bool programBinary(GLuint programID, GLenum binaryFormat, const void* programBinary, GLsizei binarySize) noexcept = 0;
+
+		// The vendor, the renderer and the version of the driver(the program binaries are only
+		// valid for the same one).
+		virtual std::string getDriverSignature() noexcept = 0;
+
+		// Uniforms(of the program that is currently used).
+		virtual GLint getUniformLocation(GLuint programID, const char* uniformName) noexcept = 0;
+		virtual void  setUniform(GLint location, GLint value) noexcept = 0;
+		virtual void  setUniform(GLint location, GLfloat value) noexcept = 0;
+		virtual void  setUniform(GLint location, const glm::vec2& value) noexcept = 0;
+		virtual void  setUniform(GLint location, const glm::vec3& value) noexcept = 0;
+		virtual void  setUniform(GLint location, const glm::vec4& value) noexcept = 0;
+		virtual void  setUniform(GLint location, const glm::mat4& value) noexcept = 0;
+
+		// Drawing.
+		virtual void drawArrays(GLenum drawMode, GLint firstVertex, GLsizei verticesTotal) noexcept = 0;
+		virtual void drawArraysInstanced(GLenum drawMode, GLint firstVertex, GLsizei verticesTotal, GLsizei instancesTotal) noexcept = 0;
+
+		// The fixed function state.
+		virtual void setViewport(GLint positionX, GLint positionY, GLsizei width, GLsizei height) noexcept = 0;
+		virtual void setCapability(GLenum capability, bool isEnabled) noexcept = 0;
+		virtual void setBlendFunction(GLenum sourceFactor, GLenum destinationFactor) noexcept = 0;
+		virtual void clear(const glm::vec4& clearColor) noexcept = 0;
+
+	private:
+		static std::unique_ptr<RenderDevice> m_Instance;
+	};
+}
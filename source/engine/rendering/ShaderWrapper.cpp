@@ -1,42 +1,67 @@
 // This class implements the `ShaderWrapper` class.
 #include "ShaderWrapper.hpp"
+#include "RenderDevice.hpp"
 #include "../Logger.hpp"
+#include "../WarmStartCache.hpp"
 
 namespace Engine::GFX::Core
 {
 	Error ShaderWrapper::compileShader(const char* vertexSource, const char* fragmentSource, const char* geometrySource)
 	{
-		GLuint geomertyShader;
+		auto& renderDevice = GFX::RenderDevice::instance();
 
-		Engine::Logger::m_GraphicsLogger->info("Compiling vertex shader");
+		GLuint      geomertyShader;
+		std::string infoLog;
+
+		auto&          warmStartCache = WarmStartCache::instance();
+		const uint64_t programKey     = warmStartCache.getProgramKey(vertexSource, fragmentSource, geometrySource);
+
+		GLenum               binaryFormat = 0;
+		std::vector<uint8_t> programBinary;
+
+		// Load the program binary that was linked by the previous launch, the driver rejects it
+		// when it was updated since then(and the shaders are compiled as usual).
+		if (warmStartCache.loadProgram(programKey, binaryFormat, programBinary))
+		{
+			m_ShaderID = renderDevice.createProgram();
+
+			if (renderDevice.programBinary(m_ShaderID, binaryFormat, programBinary.data(), static_cast<GLsizei>(programBinary.size())))
+			{
+				ENGINE_LOG_DEBUG(m_GraphicsLogger, "Loaded the shader program binary from the warm start cache");
+
+				return(Error::Ok);
+			}
+
+			renderDevice.deleteProgram(m_ShaderID);
+		}
+
+		ENGINE_LOG_DEBUG(m_GraphicsLogger, "Compiling vertex shader");
 
 		// Create the vertex shader, from vertex shader source code.
-		GLuint vertexShader = glCreateShader(GL_VERTEX_SHADER);
+		GLuint vertexShader = renderDevice.createShader(GL_VERTEX_SHADER);
 		
 		// Bind the shader source code to this shader descriptior, and the compile it.
-		glShaderSource (vertexShader, 1, &vertexSource, nullptr);
-		glCompileShader(vertexShader);
+		bool isCompiled = renderDevice.compileShader(vertexShader, vertexSource, infoLog);
 
-		if (checkCompilationErrors(vertexShader, false) != Error::Ok)
+		if (checkCompilationErrors(isCompiled, infoLog, false) != Error::Ok)
 		{
 			Engine::Logger::m_GraphicsLogger->error("Compilation stopped because of an error");
 				
 			return(Error::ValidationError);
 		}
 
-		Engine::Logger::m_GraphicsLogger->info("Compiling fragment shader");
+		ENGINE_LOG_DEBUG(m_GraphicsLogger, "Compiling fragment shader");
 
 		// Create the fragment shader from the fragment shader source code.
-		GLuint fragmentShader = glCreateShader(GL_FRAGMENT_SHADER);
+		GLuint fragmentShader = renderDevice.createShader(GL_FRAGMENT_SHADER);
 		
 		// Bind the shader source code to this shader descriptior, and the compile it.
-		glShaderSource(fragmentShader, 1, &fragmentSource, nullptr);
-		glCompileShader(fragmentShader);
+		isCompiled = renderDevice.compileShader(fragmentShader, fragmentSource, infoLog);
 		
-		if (checkCompilationErrors(fragmentShader, false) != Error::Ok)
+		if (checkCompilationErrors(isCompiled, infoLog, false) != Error::Ok)
 		{
 			// Delete the created shader to avoid memory leaks.
-			glDeleteShader(vertexShader);
+			renderDevice.deleteShader(vertexShader);
 			
 			Engine::Logger::m_GraphicsLogger->error("Compilation stopped because of an error");
 		
@@ -45,162 +70,133 @@ namespace Engine::GFX::Core
 
 		if (geometrySource != nullptr)
 		{
-			Engine::Logger::m_GraphicsLogger->info("Compiling geometry shader");
+			ENGINE_LOG_DEBUG(m_GraphicsLogger, "Compiling geometry shader");
 			
 			// Create the geometry shader.
-			geomertyShader = glCreateShader(GL_GEOMETRY_SHADER);
+			geomertyShader = renderDevice.createShader(GL_GEOMETRY_SHADER);
 			
 			// Bind the shader source code to this shader descriptior, and the compile it.
-			glShaderSource (geomertyShader, 1, &geometrySource, nullptr);
-			glCompileShader(geomertyShader);
+			isCompiled = renderDevice.compileShader(geomertyShader, geometrySource, infoLog);
 			
-			if (checkCompilationErrors(geomertyShader, false) != Error::Ok)
+			if (checkCompilationErrors(isCompiled, infoLog, false) != Error::Ok)
 			{
 				Engine::Logger::m_GraphicsLogger->warn("Compilation stopped because of an error");
 
 				// Delete the created shaders to avoid memory leaks.
-				glDeleteShader(vertexShader);
-				glDeleteShader(fragmentShader);
+				renderDevice.deleteShader(vertexShader);
+				renderDevice.deleteShader(fragmentShader);
 			
 				return(Error::ValidationError);
 			}
 		}
 
-		Engine::Logger::m_GraphicsLogger->info("Linking shaders");
+		ENGINE_LOG_DEBUG(m_GraphicsLogger, "Linking shaders");
 
 		// Attach the shaders to the shader program
-		m_ShaderID = glCreateProgram();
-		glAttachShader(m_ShaderID, vertexShader);
-		glAttachShader(m_ShaderID, fragmentShader);
+		m_ShaderID = renderDevice.createProgram();
+		renderDevice.attachShader(m_ShaderID, vertexShader);
+		renderDevice.attachShader(m_ShaderID, fragmentShader);
 
 		// Link the geometry shader also if the code for it was provided.
 		if (geometrySource != nullptr) 
 		{
-			glAttachShader(m_ShaderID, geomertyShader);
+			renderDevice.attachShader(m_ShaderID, geomertyShader);
 		}	
 		
 		// Link the program.
-		glLinkProgram(m_ShaderID);
+		const bool isLinked = renderDevice.linkProgram(m_ShaderID, infoLog);
 
 		// Delete the shaders because we don't need them more.
-		glDeleteShader(vertexShader);
-		glDeleteShader(fragmentShader);
+		renderDevice.deleteShader(vertexShader);
+		renderDevice.deleteShader(fragmentShader);
 
 		// Also delete the geometry shader if it is existing.
 		if (geometrySource != nullptr)
 		{
-			glDeleteShader(geomertyShader);
+			renderDevice.deleteShader(geomertyShader);
 		}
 
-		if (checkCompilationErrors(m_ShaderID, true) != Error::Ok) 
+		if (checkCompilationErrors(isLinked, infoLog, true) != Error::Ok) 
 		{
 			Engine::Logger::m_GraphicsLogger->warn("Compilation stopped because of an error");
 
 			return(Error::ValidationError);
 		}
 
+		// Keep the linked program for the next launch.
+		if (renderDevice.getProgramBinary(m_ShaderID, binaryFormat, programBinary))
+		{
+			warmStartCache.storeProgram(programKey, binaryFormat, programBinary);
+		}
+
 		return(Error::Ok);
 	}
 
 	void ShaderWrapper::setFloat(const char* name, GLfloat value, GLboolean useShader)
 	{
 		if (useShader) this->useShader();
-		glUniform1f(glGetUniformLocation(m_ShaderID, name), value);
+		setUniform(name, value);
 	}
 
 	void ShaderWrapper::setInteger(const char* name, int value, GLboolean useShader)
 	{
 		if (useShader) this->useShader();
-		glUniform1i(glGetUniformLocation(m_ShaderID, name), value);
+		setUniform(name, static_cast<GLint>(value));
 	}
 
 	void ShaderWrapper::setVector2f(const char* name, GLfloat x, GLfloat y, GLboolean useShader)
 	{
 		if (useShader) this->useShader();
-		glUniform2f(glGetUniformLocation(m_ShaderID, name), x, y);
+		setUniform(name, glm::vec2(x, y));
 	}
 
 	void ShaderWrapper::setVector2f(const char* name, const glm::vec2& value, GLboolean useShader)
 	{
 		if (useShader) this->useShader();
-		glUniform2f(glGetUniformLocation(m_ShaderID, name), value.x, value.y);
+		setUniform(name, value);
 	}
 
 	void ShaderWrapper::setVector3f(const char* name, GLfloat x, GLfloat y, GLfloat z, GLboolean useShader)
 	{
 		if (useShader) this->useShader();
-		glUniform3f(glGetUniformLocation(m_ShaderID, name), x, y, z);
+		setUniform(name, glm::vec3(x, y, z));
 	}
 
 	void ShaderWrapper::setVector3f(const char* name, const glm::vec3& value, GLboolean useShader)
 	{
 		if (useShader) this->useShader();
-		glUniform3f(glGetUniformLocation(m_ShaderID, name), value.x, value.y, value.z);
+		setUniform(name, value);
 	}
 
 	void ShaderWrapper::setVector4f(const char* name, GLfloat x, GLfloat y, GLfloat z, GLfloat w, GLboolean useShader)
 	{
 		if (useShader) this->useShader();
-		glUniform4f(glGetUniformLocation(m_ShaderID, name), x, y, z, w);
+		setUniform(name, glm::vec4(x, y, z, w));
 	}
 
 	void ShaderWrapper::setVector4f(const char* name, const glm::vec4& value, GLboolean useShader)
 	{
 		if (useShader) this->useShader();
-		glUniform4f(glGetUniformLocation(m_ShaderID, name), value.x, value.y, value.z, value.w);
+		setUniform(name, value);
 	}
 
 	void ShaderWrapper::setMatrix4(const char* name, const glm::mat4& matrix, GLboolean useShader)
 	{
 		if (useShader) this->useShader();
-		glUniformMatrix4fv(glGetUniformLocation(m_ShaderID, name), 1, false, glm::value_ptr(matrix));
+		setUniform(name, matrix);
 	}
 
-	Error ShaderWrapper::checkCompilationErrors(GLuint object, GLboolean isProgram)
+	Error ShaderWrapper::checkCompilationErrors(bool isSuccessful, const std::string& infoLog, GLboolean isProgram)
 	{
-		GLint  success;
+		if (isSuccessful)
+			return(Error::Ok);
 
-		// If we're checking for the errors at the shader compilation stage.
+		// Pipe the compilation or the link error message into the graphics+global logging sink.
 		if (!isProgram) 
-		{
-			// Get compilation status of the program.
-			glGetShaderiv(object, GL_COMPILE_STATUS, &success);
-			
-			if (!success) 
-			{
-				// Allocate the space for the shader error message.
-				GLchar infoBuffer[2048];
-
-				// Get the shader compilation error message.
-				glGetShaderInfoLog(object, 2048, nullptr, infoBuffer);
-				
-				// And pipe it into the graphics+global logging sink.
-				Engine::Logger::m_GraphicsLogger->error("Compile-Time error(program): {}", infoBuffer);
-			
-				return(Error::ValidationError);
-			}
-		}
-		// Or if we're checking for the errors at the program link stage.
+			Engine::Logger::m_GraphicsLogger->error("Compile-Time error(program): {}", infoLog);
 		else 
-		{
-			// Get the program linking status.
-			glGetProgramiv(object, GL_LINK_STATUS, &success);
-			
-			if (!success)
-			{
-				// Allocate the space for the program link error message.
-				GLchar infoBuffer[1024];
-
-				// Get program link error message;
-				glGetProgramInfoLog(object, 1024, NULL, infoBuffer);
-
-				// Pipe it into the graphics+global logging sink.
-				Engine::Logger::m_GraphicsLogger->error("Compile-Time error(shader): {}", infoBuffer);
-
-				return(Error::ValidationError);
-			}
-		}
+			Engine::Logger::m_GraphicsLogger->error("Compile-Time error(shader): {}", infoLog);
 
-		return(Error::Ok);
+		return(Error::ValidationError);
 	}
-}
+}
\ No newline at end of file
@@ -2,6 +2,7 @@
 #pragma once
 
 #include "../_EngineIncludes.hpp"
+#include "RenderDevice.hpp"
 
 // This namespace is polluted with the Internals components of the graphics API.
 namespace Engine::GFX::Core
@@ -21,7 +22,7 @@ namespace Engine::GFX::Core
 		// Use the shader.
 		inline ShaderWrapper& useShader()
 		{
-			glUseProgram(m_ShaderID);
+			RenderDevice::instance().useProgram(m_ShaderID);
 		
 			return(*this);
 		}
@@ -48,8 +49,17 @@ namespace Engine::GFX::Core
 		void    setMatrix4 (const char* name, const glm::mat4& matrix, GLboolean useShader = false);
 		 
 	private:
+		// Set the uniform of the program through the render device.
+		template<typename T>
+		inline void setUniform(const char* name, const T& value)
+		{
+			auto& renderDevice = RenderDevice::instance();
+
+			renderDevice.setUniform(renderDevice.getUniformLocation(m_ShaderID, name), value);
+		}
+
 		// Check the compilations errors, pipe them into the graphics+global logging sink.
-		Error checkCompilationErrors(GLuint object, GLboolean isProgram);
+		Error checkCompilationErrors(bool isSuccessful, const std::string& infoLog, GLboolean isProgram);
 
 	private:
 		GLuint m_ShaderID;
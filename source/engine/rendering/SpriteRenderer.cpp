@@ -1,28 +1,172 @@
 // This file implements the `SpriteRenderer` class.
 #include "SpriteRenderer.hpp"
+#include "RenderDevice.hpp"
+#include "AffineKernel.hpp"
 #include "../ResourseManager.hpp"
+#include "../PickingIndex.hpp"
 #include "../Logger.hpp"
+#include "../Profiler.hpp"
+#include "../GpuProfiler.hpp"
+#include "../Metrics.hpp"
+#include "../JobSystem.hpp"
+
+#include "algorithm"
+#include "cmath"
 
 using namespace std;
 
+// The initial amount of the motion instances the instance buffer is able to hold.
+static constexpr const size_t _MOTION_INSTANCE_INITIAL_CAPACITY = 64;
+
+// The first vertex attribute location that is used by the motion instances.
+static constexpr const GLuint _MOTION_ATTRIBUTE_FIRST_LOCATION = 1;
+static constexpr const GLuint _MOTION_ATTRIBUTE_COUNT          = 4;
+
+// The initial amount of the batched sprites the batch instance buffer is able to hold.
+static constexpr const size_t _BATCH_INSTANCE_INITIAL_CAPACITY = 256;
+
+// The first vertex attribute location that is used by the batched sprites(after the motion ones).
+static constexpr const GLuint _BATCH_ATTRIBUTE_FIRST_LOCATION = 5;
+static constexpr const GLuint _BATCH_ATTRIBUTE_COUNT          = 4;
+
+// The amount of the sprites the single job generates, the smaller batches are generated
+// right on the main thread(scheduling the job costs more than writing a few instances).
+static constexpr const size_t _BATCH_SPRITES_PER_JOB = 512;
+
+// The amount of the sprites the affine kernel transforms at once(the SoA arrays are on the stack).
+static constexpr const size_t _BATCH_SPRITES_PER_CHUNK = 64;
+
+// The bits of the sprite shader variants after the effects(see ::SpriteInstanceFlag), and the
+// defines they add to the shader sources.
+static constexpr const uint32_t _SHADER_VARIANT_BATCH    = 16;
+static constexpr const uint32_t _SHADER_VARIANT_MOTION   = 32;
+static constexpr const uint32_t _SHADER_VARIANT_OVERDRAW = 64;
+static constexpr const uint32_t _SHADER_VARIANTS_TOTAL   = 128;
+
+static constexpr const char* const _SHADER_VARIANT_DEFINES[] = {
+	"SPRITE_EFFECT_SHADOW",
+	"SPRITE_EFFECT_GLOW",
+	"SPRITE_EFFECT_TRAIL",
+	"SPRITE_EFFECT_SMOOTH_EDGES",
+	"SPRITE_PATH_BATCH",
+	"SPRITE_PATH_MOTION",
+	"SPRITE_DEBUG_OVERDRAW"
+};
+
+// The cells of the occluder grid(in pixels), the cells are wrapped around the fixed table, so the
+// sprites that are far apart may share the cell(that only adds the candidates to test).
+static constexpr const GLfloat _OCCLUSION_CELL_SIZE  = 128.0f;
+static constexpr const int32_t _OCCLUSION_GRID_SIZE  = 32;
+
+// The margin the opaque rect of the occluder is moved inside by(in pixels), so the pixels at its
+// edge(they are anti-aliased or filtered) never count as covering.
+static constexpr const GLfloat _OCCLUSION_EDGE_MARGIN = 1.0f;
+
+// The index of the occluder grid cell.
+static size_t getOcclusionCellIndex(int32_t cellX, int32_t cellY) noexcept
+{
+	return(static_cast<size_t>((cellX & (_OCCLUSION_GRID_SIZE - 1)) * _OCCLUSION_GRID_SIZE + (cellY & (_OCCLUSION_GRID_SIZE - 1))));
+}
+
+static int32_t getOcclusionCell(GLfloat position) noexcept
+{
+	return(static_cast<int32_t>(std::floor(position / _OCCLUSION_CELL_SIZE)));
+}
+
 namespace Engine::GFX
 {
-    SpriteRenderer::SpriteRenderer(Core::ShaderWrapper& shaderWrapper)
+    SpriteRenderer::SpriteRenderer(StringID shaderName)
 	{
-		m_ShaderWrapper = shaderWrapper;
+		m_ShaderName = shaderName;
+
+		m_VariantPrograms        .assign(_SHADER_VARIANTS_TOTAL, GL_ZERO);
+		m_VariantUniformsVersions.assign(_SHADER_VARIANTS_TOTAL, 0);
+		m_OcclusionCells         .resize(_OCCLUSION_GRID_SIZE * _OCCLUSION_GRID_SIZE);
 
 		initializeRenderPipeline();
+		initializeMotionPipeline();
+		initializeBatchPipeline();
 	}
 
 	SpriteRenderer::~SpriteRenderer()
 	{
-		glDeleteVertexArrays(1, &m_QuadVertexArray);
+		auto& renderDevice = RenderDevice::instance();
+
+		renderDevice.deleteVertexArray(m_QuadVertexArray);
+		renderDevice.deleteVertexArray(m_MotionVertexArray);
+		renderDevice.deleteVertexArray(m_BatchVertexArray);
+		renderDevice.deleteBuffer     (m_QuadVertexBuffer);
+		renderDevice.deleteBuffer     (m_MotionInstanceBuffer);
+		renderDevice.deleteBuffer     (m_BatchInstanceBuffer);
+	}
+
+	span<const char* const> SpriteRenderer::getShaderVariantDefines() noexcept
+	{
+		return(_SHADER_VARIANT_DEFINES);
+	}
+
+	void SpriteRenderer::setProjectionMatrix(const glm::mat4& projectionMatrix) noexcept
+	{
+		m_ProjectionMatrix = projectionMatrix;
+		m_UniformsVersion++;
+	}
+
+	void SpriteRenderer::setElapsedTime(GLfloat elapsedTime) noexcept
+	{
+		m_ElapsedTime = elapsedTime;
+		m_UniformsVersion++;
+	}
+
+	void SpriteRenderer::setCornerRadius(GLfloat cornerRadius) noexcept
+	{
+		m_CornerRadius = cornerRadius;
+		m_UniformsVersion++;
+	}
+
+	void SpriteRenderer::setOverdrawView(bool isEnabled) noexcept
+	{
+		if (m_IsOverdrawView == isEnabled)
+			return;
+
+		m_IsOverdrawView = isEnabled;
+
+		// The heat of the pixels is summed up.
+		if (isEnabled)
+			RenderDevice::instance().setBlendFunction(GL_ONE, GL_ONE);
+		else
+			RenderDevice::instance().setBlendFunction(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+	}
+
+	bool SpriteRenderer::useShaderVariant(uint32_t variantMask) noexcept
+	{
+		if (m_IsOverdrawView)
+			variantMask |= _SHADER_VARIANT_OVERDRAW;
+
+		auto shaderOrError = Engine::ResourceManager::getShaderVariant(m_ShaderName, variantMask);
+
+		if (!shaderOrError.has_value())
+			return(false);
+
+		m_ShaderWrapper = *shaderOrError;
+		m_ShaderWrapper.useShader();
+
+		// The variant is the program of its own, so it keeps its own copy of the uniforms.
+		if (m_VariantPrograms[variantMask] != m_ShaderWrapper.getShaderID() || m_VariantUniformsVersions[variantMask] != m_UniformsVersion)
+		{
+			m_ShaderWrapper.setInteger ("image",            0);
+			m_ShaderWrapper.setMatrix4 ("projectionMatrix", m_ProjectionMatrix);
+			m_ShaderWrapper.setFloat   ("elapsedTime",      m_ElapsedTime);
+			m_ShaderWrapper.setFloat   ("cornerRadius",     m_CornerRadius);
+
+			m_VariantPrograms        [variantMask] = m_ShaderWrapper.getShaderID();
+			m_VariantUniformsVersions[variantMask] = m_UniformsVersion;
+		}
+
+		return(true);
 	}
 
 	void SpriteRenderer::initializeRenderPipeline() noexcept
 	{
-		GLuint  vertexBuffer{};
-		
 		// This verticies are actually a quad.
 		GLfloat verticies[] = {
 			// Position   // Texture
@@ -35,56 +179,742 @@ namespace Engine::GFX
 			1.0f, 0.0f,   1.0f, 0.0f
 		};
 
+		auto& renderDevice = RenderDevice::instance();
+
 		// Setup OpenGL buffers, and populate them.
-		glGenVertexArrays(1, &m_QuadVertexArray);
-		glGenBuffers     (1, &vertexBuffer);
+		m_QuadVertexArray  = renderDevice.createVertexArray();
+		m_QuadVertexBuffer = renderDevice.createBuffer();
 
-		glBindBuffer(GL_ARRAY_BUFFER, vertexBuffer);
-		glBufferData(GL_ARRAY_BUFFER, sizeof(verticies), verticies, GL_STATIC_DRAW);
+		renderDevice.bindBuffer(GL_ARRAY_BUFFER, m_QuadVertexBuffer);
+		renderDevice.bufferData(GL_ARRAY_BUFFER, sizeof(verticies), verticies, GL_STATIC_DRAW);
 
-		glBindVertexArray        (m_QuadVertexArray);
-		glEnableVertexAttribArray(GL_ZERO);
-		glVertexAttribPointer    (GL_ZERO, 4, GL_FLOAT, GL_FALSE, 4 * sizeof(GLfloat), (GLvoid*)GL_ZERO);
-		glBindBuffer             (GL_ARRAY_BUFFER, GL_ZERO);
-		glBindVertexArray        (GL_ZERO);
+		renderDevice.bindVertexArray       (m_QuadVertexArray);
+		renderDevice.enableVertexAttribute (GL_ZERO);
+		renderDevice.vertexAttributePointer(GL_ZERO, 4, 4 * sizeof(GLfloat), GL_ZERO);
+		renderDevice.bindBuffer            (GL_ARRAY_BUFFER, GL_ZERO);
+		renderDevice.bindVertexArray       (GL_ZERO);
 	}
 
-	void SpriteRenderer::renderSprite(const string& textureName, glm::vec2 spritePosition, glm::vec2 spriteSize, GLfloat spriteRotation, glm::vec3 spriteColor) noexcept
+	void SpriteRenderer::renderSprite(StringID textureName, glm::vec2 spritePosition, glm::vec2 spriteSize, GLfloat spriteRotation, glm::vec3 spriteColor, uint32_t effectFlags) noexcept
 	{
+		ENGINE_PROFILE_SCOPE("SpriteRenderer::renderSprite");
+
 		// Try to retrieve the texture.
 		auto textureOrError = Engine::ResourceManager::getTexture(textureName);
 
 		// If it fails, just do nothing.
 		if (!textureOrError.has_value())
 		{
-			Engine::Logger::m_ResourceLogger->error("Unable to render sprite with name {}", textureName);
+			ENGINE_LOG_ERROR(m_ResourceLogger, "Unable to render sprite with name {}", textureName.c_str());
 		
 			return;
 		}
-		
-		m_ShaderWrapper.useShader();
 
-		// Setup model matrix for the sprite.
+		if (!useShaderVariant(effectFlags & (_SHADER_VARIANT_BATCH - 1)))
+		{
+			ENGINE_LOG_ERROR(m_GraphicsLogger, "Unable to render sprite with the effects {:#x}", effectFlags);
+
+			return;
+		}
+
+		// Setup model matrix for the sprite(translate, rotate around the center and scale), the
+		// affine rows are written right into the matrix instead of multiplying the five ones.
+		GLfloat m00, m01, m02, m10, m11, m12;
+		computeSpriteAffinesScalar({ &spritePosition.x, &spritePosition.y, &spriteSize.x, &spriteSize.y, &spriteRotation }, { &m00, &m01, &m02, &m10, &m11, &m12 }, 1);
+
 		glm::mat4 modelMatrix = glm::mat4(1.0f);
-		modelMatrix = glm::translate(modelMatrix, glm::vec3(spritePosition, 1.0f));
-		modelMatrix = glm::translate(modelMatrix, glm::vec3(0.5f * spriteSize.x, 0.5f * spriteSize.y, 0.0f));
-		modelMatrix = glm::rotate   (modelMatrix, glm::radians(spriteRotation), glm::vec3(0.0f, 0.0f, 1.0f));
-		modelMatrix = glm::translate(modelMatrix, glm::vec3(-0.5f * spriteSize.x, -0.5f * spriteSize.y, 0.0f));
-		modelMatrix = glm::scale    (modelMatrix, glm::vec3(spriteSize, 1.0f));
+		modelMatrix[0][0] = m00;
+		modelMatrix[0][1] = m10;
+		modelMatrix[1][0] = m01;
+		modelMatrix[1][1] = m11;
+		modelMatrix[3][0] = m02;
+		modelMatrix[3][1] = m12;
+		modelMatrix[3][2] = 1.0f;
 
 		// Assign model matrix to the shader.
 		m_ShaderWrapper.setMatrix4 ("modelMatrix", modelMatrix);
 		m_ShaderWrapper.setVector3f("spriteColor", spriteColor);
 
+		auto& renderDevice = RenderDevice::instance();
+
 		// Setup the texture
-		glActiveTexture(GL_TEXTURE0);
+		renderDevice.activeTexture(GL_TEXTURE0);
 		textureOrError->bind();
 		
 		// Render
-		glBindVertexArray(m_QuadVertexArray);
-		glDrawArrays     (GL_TRIANGLES, GL_ZERO, 6);
+		renderDevice.bindVertexArray(m_QuadVertexArray);
+		renderDevice.drawArrays     (GL_TRIANGLES, GL_ZERO, 6);
 		
 		// Unbind
-		glBindVertexArray(GL_ZERO);
+		renderDevice.bindVertexArray(GL_ZERO);
+
+		// The shader, the texture and the vertex array.
+		auto& gpuProfiler = GpuProfiler::instance();
+		gpuProfiler.countDrawCalls(1);
+		gpuProfiler.countStateChanges(3);
+
+		static auto& drawCallsMetric = MetricsRegistry::instance().counter("engine_draw_calls_total",      "The issued draw calls");
+		static auto& bindsMetric     = MetricsRegistry::instance().counter("engine_binds_total",           "The shader, texture and vertex array binds");
+		static auto& spritesMetric   = MetricsRegistry::instance().counter("engine_sprites_rendered_total", "The rendered sprites");
+
+		drawCallsMetric.increment();
+		bindsMetric    .increment(3);
+		spritesMetric  .increment();
+	}
+
+	void SpriteRenderer::initializeMotionPipeline() noexcept
+	{
+		auto& renderDevice = RenderDevice::instance();
+
+		m_MotionInstanceCapacity = _MOTION_INSTANCE_INITIAL_CAPACITY;
+
+		// Allocate the instance buffer, it is populated only when the motion begins.
+		m_MotionInstanceBuffer = renderDevice.createBuffer();
+		renderDevice.bindBuffer(GL_ARRAY_BUFFER, m_MotionInstanceBuffer);
+		renderDevice.bufferData(GL_ARRAY_BUFFER, m_MotionInstanceCapacity * sizeof(MotionInstance), nullptr, GL_DYNAMIC_DRAW);
+
+		// The motion vertex array shares the quad with the regular sprites, and adds
+		// the per-instance attributes on top of it.
+		m_MotionVertexArray = renderDevice.createVertexArray();
+		renderDevice.bindVertexArray(m_MotionVertexArray);
+
+		renderDevice.bindBuffer            (GL_ARRAY_BUFFER, m_QuadVertexBuffer);
+		renderDevice.enableVertexAttribute (GL_ZERO);
+		renderDevice.vertexAttributePointer(GL_ZERO, 4, 4 * sizeof(GLfloat), GL_ZERO);
+
+		for (GLuint attributeIndex = 0; attributeIndex < _MOTION_ATTRIBUTE_COUNT; ++attributeIndex)
+		{
+			renderDevice.enableVertexAttribute (_MOTION_ATTRIBUTE_FIRST_LOCATION + attributeIndex);
+			renderDevice.vertexAttributeDivisor(_MOTION_ATTRIBUTE_FIRST_LOCATION + attributeIndex, 1);
+		}
+
+		bindMotionAttributes(0);
+
+		renderDevice.bindVertexArray(GL_ZERO);
+		renderDevice.bindBuffer     (GL_ARRAY_BUFFER, GL_ZERO);
+	}
+
+	void SpriteRenderer::bindMotionAttributes(size_t firstInstance) noexcept
+	{
+		auto& renderDevice = RenderDevice::instance();
+
+		renderDevice.bindBuffer(GL_ARRAY_BUFFER, m_MotionInstanceBuffer);
+
+		// Every attribute of the motion instance is a vec4.
+		for (GLuint attributeIndex = 0; attributeIndex < _MOTION_ATTRIBUTE_COUNT; ++attributeIndex)
+		{
+			const size_t attributeOffset = firstInstance * sizeof(MotionInstance) + attributeIndex * sizeof(glm::vec4);
+
+			renderDevice.vertexAttributePointer(_MOTION_ATTRIBUTE_FIRST_LOCATION + attributeIndex, 4, sizeof(MotionInstance), attributeOffset);
+		}
+	}
+
+	MotionHandle SpriteRenderer::beginMotion(StringID textureName, const SpriteMotion& spriteMotion) noexcept
+	{
+		MotionInstance motionInstance;
+		motionInstance.positions       = { spriteMotion.startPosition, spriteMotion.endPosition };
+		motionInstance.sizeAndRotation = { spriteMotion.spriteSize, spriteMotion.startRotation, spriteMotion.endRotation };
+		motionInstance.color           = { spriteMotion.spriteColor, 1.0f };
+		motionInstance.timing          = { spriteMotion.startTime, spriteMotion.duration, 0.0f, 0.0f };
+
+		// Reuse the slot of the released motion, or append the new one.
+		MotionHandle motionHandle;
+
+		if (!m_MotionFreeSlots.empty())
+		{
+			motionHandle = m_MotionFreeSlots.back();
+			m_MotionFreeSlots.pop_back();
+
+			m_MotionInstances[motionHandle] = motionInstance;
+			m_MotionTextures [motionHandle] = textureName;
+			m_MotionFlags    [motionHandle] = spriteMotion.instanceFlags & (_SHADER_VARIANT_BATCH - 1);
+			m_MotionSlotUsed [motionHandle] = true;
+		}
+		else
+		{
+			motionHandle = static_cast<MotionHandle>(m_MotionInstances.size());
+
+			m_MotionInstances.push_back(motionInstance);
+			m_MotionTextures .push_back(textureName);
+			m_MotionFlags    .push_back(spriteMotion.instanceFlags & (_SHADER_VARIANT_BATCH - 1));
+			m_MotionSlotUsed .push_back(true);
+		}
+
+		auto& renderDevice = RenderDevice::instance();
+
+		renderDevice.bindBuffer(GL_ARRAY_BUFFER, m_MotionInstanceBuffer);
+
+		// Grow the instance buffer(and re-upload every instance) when it is full, otherwise
+		// write only the new instance.
+		if (m_MotionInstances.size() > m_MotionInstanceCapacity)
+		{
+			m_MotionInstanceCapacity *= 2;
+
+			renderDevice.bufferData   (GL_ARRAY_BUFFER, m_MotionInstanceCapacity * sizeof(MotionInstance), nullptr, GL_DYNAMIC_DRAW);
+			renderDevice.bufferSubData(GL_ARRAY_BUFFER, 0, m_MotionInstances.size() * sizeof(MotionInstance), m_MotionInstances.data());
+		}
+		else
+		{
+			renderDevice.bufferSubData(GL_ARRAY_BUFFER, motionHandle * sizeof(MotionInstance), sizeof(MotionInstance), &m_MotionInstances[motionHandle]);
+		}
+
+		renderDevice.bindBuffer(GL_ARRAY_BUFFER, GL_ZERO);
+
+		return(motionHandle);
+	}
+
+	void SpriteRenderer::endMotion(MotionHandle motionHandle) noexcept
+	{
+		if (motionHandle >= m_MotionSlotUsed.size() || !m_MotionSlotUsed[motionHandle])
+			return;
+
+		m_MotionSlotUsed [motionHandle] = false;
+		m_MotionFreeSlots.push_back(motionHandle);
+
+		// Start over from the first slot, so the next motions are drawn in the order they begin in
+		// (the instance buffer keeps its capacity).
+		if (m_MotionFreeSlots.size() == m_MotionInstances.size())
+		{
+			m_MotionInstances.clear();
+			m_MotionTextures .clear();
+			m_MotionFlags    .clear();
+			m_MotionSlotUsed .clear();
+			m_MotionFreeSlots.clear();
+		}
+	}
+
+	bool SpriteRenderer::isMotionFinished(MotionHandle motionHandle, GLfloat currentTime) const noexcept
+	{
+		if (motionHandle >= m_MotionSlotUsed.size() || !m_MotionSlotUsed[motionHandle])
+			return(true);
+
+		const auto& timing = m_MotionInstances[motionHandle].timing;
+
+		return(currentTime >= timing.x + timing.y);
+	}
+
+	void SpriteRenderer::renderMotions(GLfloat currentTime) noexcept
+	{
+		const size_t motionSlotsTotal = m_MotionInstances.size();
+
+		if (motionSlotsTotal == m_MotionFreeSlots.size())
+			return;
+
+		// The vertex array.
+		GpuProfiler::instance().countStateChanges(1);
+
+		auto& renderDevice = RenderDevice::instance();
+
+		renderDevice.activeTexture  (GL_TEXTURE0);
+		renderDevice.bindVertexArray(m_MotionVertexArray);
+
+		// Draw the runs of the neighbour instances that are sharing the same texture and the
+		// effects with a single instanced draw call(the variant is bound when the effects change).
+		size_t   runStart   = 0;
+		uint32_t boundFlags = UINT32_MAX;
+		bool     isBound    = false;
+
+		while (runStart < motionSlotsTotal)
+		{
+			if (!m_MotionSlotUsed[runStart])
+			{
+				++runStart;
+				continue;
+			}
+
+			size_t runEnd = runStart + 1;
+
+			while (runEnd < motionSlotsTotal && m_MotionSlotUsed[runEnd] && m_MotionTextures[runEnd] == m_MotionTextures[runStart] && m_MotionFlags[runEnd] == m_MotionFlags[runStart])
+				++runEnd;
+
+			if (m_MotionFlags[runStart] != boundFlags)
+			{
+				boundFlags = m_MotionFlags[runStart];
+				isBound    = useShaderVariant(boundFlags | _SHADER_VARIANT_MOTION);
+
+				// The time is not shared by the variants.
+				if (isBound)
+				{
+					m_ShaderWrapper.setFloat("globalTime", currentTime);
+
+					GpuProfiler::instance().countStateChanges(1);
+				}
+			}
+
+			if (!isBound)
+			{
+				runStart = runEnd;
+				continue;
+			}
+
+			auto textureOrError = Engine::ResourceManager::getTexture(m_MotionTextures[runStart]);
+
+			if (textureOrError.has_value())
+			{
+				textureOrError->bind();
+
+				bindMotionAttributes(runStart);
+				renderDevice.drawArraysInstanced(GL_TRIANGLES, GL_ZERO, 6, static_cast<GLsizei>(runEnd - runStart));
+
+				GpuProfiler::instance().countDrawCalls(1);
+				GpuProfiler::instance().countStateChanges(1);
+
+				static auto& drawCallsMetric = MetricsRegistry::instance().counter("engine_draw_calls_total",      "The issued draw calls");
+				static auto& bindsMetric     = MetricsRegistry::instance().counter("engine_binds_total",           "The shader, texture and vertex array binds");
+				static auto& spritesMetric   = MetricsRegistry::instance().counter("engine_sprites_rendered_total", "The rendered sprites");
+
+				drawCallsMetric.increment();
+				bindsMetric    .increment();
+				spritesMetric  .increment(runEnd - runStart);
+			}
+			else
+			{
+				ENGINE_LOG_ERROR(m_ResourceLogger, "Unable to render motion with texture {}", m_MotionTextures[runStart].c_str());
+			}
+
+			runStart = runEnd;
+		}
+
+		renderDevice.bindVertexArray(GL_ZERO);
+		renderDevice.bindBuffer     (GL_ARRAY_BUFFER, GL_ZERO);
+	}
+
+	void SpriteRenderer::initializeBatchPipeline() noexcept
+	{
+		auto& renderDevice = RenderDevice::instance();
+
+		m_BatchInstanceCapacity = _BATCH_INSTANCE_INITIAL_CAPACITY;
+
+		// The instance buffer is rewritten every frame.
+		m_BatchInstanceBuffer = renderDevice.createBuffer();
+		renderDevice.bindBuffer(GL_ARRAY_BUFFER, m_BatchInstanceBuffer);
+		renderDevice.bufferData(GL_ARRAY_BUFFER, m_BatchInstanceCapacity * sizeof(SpriteInstance), nullptr, GL_STREAM_DRAW);
+
+		// The batch vertex array shares the quad with the regular sprites as well.
+		m_BatchVertexArray = renderDevice.createVertexArray();
+		renderDevice.bindVertexArray(m_BatchVertexArray);
+
+		renderDevice.bindBuffer            (GL_ARRAY_BUFFER, m_QuadVertexBuffer);
+		renderDevice.enableVertexAttribute (GL_ZERO);
+		renderDevice.vertexAttributePointer(GL_ZERO, 4, 4 * sizeof(GLfloat), GL_ZERO);
+
+		for (GLuint attributeIndex = 0; attributeIndex < _BATCH_ATTRIBUTE_COUNT; ++attributeIndex)
+		{
+			renderDevice.enableVertexAttribute (_BATCH_ATTRIBUTE_FIRST_LOCATION + attributeIndex);
+			renderDevice.vertexAttributeDivisor(_BATCH_ATTRIBUTE_FIRST_LOCATION + attributeIndex, 1);
+		}
+
+		bindBatchAttributes(0);
+
+		renderDevice.bindVertexArray(GL_ZERO);
+		renderDevice.bindBuffer     (GL_ARRAY_BUFFER, GL_ZERO);
+	}
+
+	void SpriteRenderer::bindBatchAttributes(size_t firstInstance) noexcept
+	{
+		auto& renderDevice = RenderDevice::instance();
+
+		renderDevice.bindBuffer(GL_ARRAY_BUFFER, m_BatchInstanceBuffer);
+
+		// Every attribute of the sprite instance is a vec4.
+		for (GLuint attributeIndex = 0; attributeIndex < _BATCH_ATTRIBUTE_COUNT; ++attributeIndex)
+		{
+			const size_t attributeOffset = firstInstance * sizeof(SpriteInstance) + attributeIndex * sizeof(glm::vec4);
+
+			renderDevice.vertexAttributePointer(_BATCH_ATTRIBUTE_FIRST_LOCATION + attributeIndex, 4, sizeof(SpriteInstance), attributeOffset);
+		}
+	}
+
+	void SpriteRenderer::writeSpriteInstances(const SpriteBatchItem* batchItems, SpriteInstance* spriteInstances, size_t batchBegin, size_t batchEnd) noexcept
+	{
+		// The batch items are gathered into the SoA arrays chunk by chunk, so the affine kernel
+		// transforms them with the vector instructions.
+		alignas(32) GLfloat positionX[_BATCH_SPRITES_PER_CHUNK], positionY[_BATCH_SPRITES_PER_CHUNK];
+		alignas(32) GLfloat sizeX[_BATCH_SPRITES_PER_CHUNK], sizeY[_BATCH_SPRITES_PER_CHUNK], rotation[_BATCH_SPRITES_PER_CHUNK];
+		alignas(32) GLfloat m00[_BATCH_SPRITES_PER_CHUNK], m01[_BATCH_SPRITES_PER_CHUNK], m02[_BATCH_SPRITES_PER_CHUNK];
+		alignas(32) GLfloat m10[_BATCH_SPRITES_PER_CHUNK], m11[_BATCH_SPRITES_PER_CHUNK], m12[_BATCH_SPRITES_PER_CHUNK];
+
+		const SpriteTransformsSoA spriteTransforms = { positionX, positionY, sizeX, sizeY, rotation };
+		const SpriteAffinesSoA    spriteAffines    = { m00, m01, m02, m10, m11, m12 };
+
+		for (size_t chunkBegin = batchBegin; chunkBegin < batchEnd; chunkBegin += _BATCH_SPRITES_PER_CHUNK)
+		{
+			const size_t chunkSize = std::min(batchEnd - chunkBegin, _BATCH_SPRITES_PER_CHUNK);
+
+			for (size_t chunkIndex = 0; chunkIndex < chunkSize; ++chunkIndex)
+			{
+				const auto& batchItem = batchItems[chunkBegin + chunkIndex];
+
+				positionX[chunkIndex] = batchItem.spritePosition.x;
+				positionY[chunkIndex] = batchItem.spritePosition.y;
+				sizeX    [chunkIndex] = batchItem.spriteSize.x;
+				sizeY    [chunkIndex] = batchItem.spriteSize.y;
+				rotation [chunkIndex] = batchItem.spriteRotation;
+			}
+
+			computeSpriteAffines(spriteTransforms, spriteAffines, chunkSize);
+
+			for (size_t chunkIndex = 0; chunkIndex < chunkSize; ++chunkIndex)
+			{
+				const auto& batchItem = batchItems[chunkBegin + chunkIndex];
+
+				// The same transform as the model matrix of the ::renderSprite, the 2x2 matrix
+				// is stored by the columns.
+				SpriteInstance spriteInstance;
+				spriteInstance.affineLinear = { m00[chunkIndex], m10[chunkIndex], m01[chunkIndex], m11[chunkIndex] };
+				spriteInstance.affineOffset = { m02[chunkIndex], m12[chunkIndex], static_cast<GLfloat>(batchItem.instanceFlags), 0.0f };
+				spriteInstance.textureRect  = batchItem.textureRect;
+				spriteInstance.color        = { batchItem.spriteColor, 1.0f };
+
+				// The mapped memory is write-combined, so the instance is written at once.
+				spriteInstances[chunkBegin + chunkIndex] = spriteInstance;
+			}
+		}
+	}
+
+	void SpriteRenderer::cullOccludedSprites() noexcept
+	{
+		ENGINE_PROFILE_SCOPE("SpriteRenderer::cullOccludedSprites");
+
+		const size_t spritesTotal = m_BatchItems.size();
+
+		if (spritesTotal < 2)
+			return;
+
+		// The quads of the sprites are transformed by the same kernel as the instances.
+		alignas(32) GLfloat positionX[_BATCH_SPRITES_PER_CHUNK], positionY[_BATCH_SPRITES_PER_CHUNK];
+		alignas(32) GLfloat sizeX[_BATCH_SPRITES_PER_CHUNK], sizeY[_BATCH_SPRITES_PER_CHUNK], rotation[_BATCH_SPRITES_PER_CHUNK];
+		alignas(32) GLfloat m00[_BATCH_SPRITES_PER_CHUNK], m01[_BATCH_SPRITES_PER_CHUNK], m02[_BATCH_SPRITES_PER_CHUNK];
+		alignas(32) GLfloat m10[_BATCH_SPRITES_PER_CHUNK], m11[_BATCH_SPRITES_PER_CHUNK], m12[_BATCH_SPRITES_PER_CHUNK];
+
+		const SpriteTransformsSoA spriteTransforms = { positionX, positionY, sizeX, sizeY, rotation };
+		const SpriteAffinesSoA    spriteAffines    = { m00, m01, m02, m10, m11, m12 };
+
+		m_CullingQuads.resize(spritesTotal);
+
+		for (size_t chunkBegin = 0; chunkBegin < spritesTotal; chunkBegin += _BATCH_SPRITES_PER_CHUNK)
+		{
+			const size_t chunkSize = std::min(spritesTotal - chunkBegin, _BATCH_SPRITES_PER_CHUNK);
+
+			for (size_t chunkIndex = 0; chunkIndex < chunkSize; ++chunkIndex)
+			{
+				const auto& batchItem = m_BatchItems[chunkBegin + chunkIndex];
+
+				positionX[chunkIndex] = batchItem.spritePosition.x;
+				positionY[chunkIndex] = batchItem.spritePosition.y;
+				sizeX    [chunkIndex] = batchItem.spriteSize.x;
+				sizeY    [chunkIndex] = batchItem.spriteSize.y;
+				rotation [chunkIndex] = batchItem.spriteRotation;
+			}
+
+			computeSpriteAffines(spriteTransforms, spriteAffines, chunkSize);
+
+			for (size_t chunkIndex = 0; chunkIndex < chunkSize; ++chunkIndex)
+			{
+				m_CullingQuads[chunkBegin + chunkIndex] = {
+					{ m02[chunkIndex], m12[chunkIndex] },
+					{ m00[chunkIndex], m10[chunkIndex] },
+					{ m01[chunkIndex], m11[chunkIndex] } };
+			}
+		}
+
+		for (auto& occlusionCell : m_OcclusionCells)
+			occlusionCell.clear();
+
+		m_Occluders  .clear();
+		m_CulledItems.assign(spritesTotal, false);
+
+		// The corner of the rounded sprite cuts the opaque rect by this part of the radius.
+		const GLfloat cornerInset = m_CornerRadius * (1.0f - 1.0f / std::sqrt(2.0f));
+
+		StringID  opaqueTextureName;
+		glm::vec4 opaqueRect  = glm::vec4(0.0f);
+		size_t    culledTotal = 0;
+
+		// The sprites are walked from the last queued one, so the grid has only the occluders
+		// that are drawn on top of the sprite.
+		for (size_t itemIndex = spritesTotal; itemIndex-- > 0;)
+		{
+			const auto& batchItem  = m_BatchItems  [itemIndex];
+			const auto& spriteQuad = m_CullingQuads[itemIndex];
+
+			const glm::vec2 quadCorners[4] = {
+				spriteQuad.origin,
+				spriteQuad.origin + spriteQuad.axisX,
+				spriteQuad.origin + spriteQuad.axisY,
+				spriteQuad.origin + spriteQuad.axisX + spriteQuad.axisY };
+
+			// The occluder that covers the sprite covers its origin as well, so it is listed in
+			// the cell of the origin. The rect is convex, so the sprite is covered when all its
+			// corners are.
+			const auto& occlusionCell = m_OcclusionCells[getOcclusionCellIndex(getOcclusionCell(spriteQuad.origin.x), getOcclusionCell(spriteQuad.origin.y))];
+
+			const bool isCovered = any_of(occlusionCell.begin(), occlusionCell.end(), [this, &quadCorners](uint32_t occluderIndex)
+			{
+				const auto& spriteOccluder = m_Occluders[occluderIndex];
+
+				for (const auto& quadCorner : quadCorners)
+				{
+					const glm::vec2 cornerOffset = quadCorner - spriteOccluder.corner;
+					const GLfloat   projectionX  = glm::dot(cornerOffset, spriteOccluder.edgeX);
+					const GLfloat   projectionY  = glm::dot(cornerOffset, spriteOccluder.edgeY);
+
+					if (projectionX < 0.0f || projectionX > spriteOccluder.edgeXLengthSquared || projectionY < 0.0f || projectionY > spriteOccluder.edgeYLengthSquared)
+						return(false);
+				}
+
+				return(true);
+			});
+
+			// The covered sprite covers nothing that its occluder does not.
+			if (isCovered)
+			{
+				m_CulledItems[itemIndex] = true;
+				culledTotal++;
+
+				continue;
+			}
+
+			// The shadows and the trails are translucent, they do not cover anything.
+			if ((batchItem.instanceFlags & (SpriteInstanceShadow | SpriteInstanceTrail)) != 0)
+				continue;
+
+			// The neighbour sprites are likely to share the texture.
+			if (batchItem.textureName != opaqueTextureName)
+			{
+				auto textureOrError = Engine::ResourceManager::getTexture(batchItem.textureName);
+
+				opaqueTextureName = batchItem.textureName;
+				opaqueRect        = textureOrError.has_value() ? textureOrError->getOpaqueRect() : glm::vec4(0.0f);
+			}
+
+			// Map the opaque rect from the texture coordinates to the quad of the sprite.
+			const glm::vec2 textureBegin = { batchItem.textureRect.x, batchItem.textureRect.y };
+			const glm::vec2 textureSize  = { batchItem.textureRect.z - textureBegin.x, batchItem.textureRect.w - textureBegin.y };
+			const GLfloat   axisXLength  = glm::length(spriteQuad.axisX);
+			const GLfloat   axisYLength  = glm::length(spriteQuad.axisY);
+
+			if (textureSize.x == 0.0f || textureSize.y == 0.0f || axisXLength == 0.0f || axisYLength == 0.0f)
+				continue;
+
+			const glm::vec2 opaqueFirst  = (glm::vec2(opaqueRect.x, opaqueRect.y) - textureBegin) / textureSize;
+			const glm::vec2 opaqueSecond = (glm::vec2(opaqueRect.z, opaqueRect.w) - textureBegin) / textureSize;
+
+			GLfloat edgeMargin = _OCCLUSION_EDGE_MARGIN;
+
+			if ((batchItem.instanceFlags & SpriteInstanceSmoothEdges) != 0)
+				edgeMargin += cornerInset * std::min(axisXLength, axisYLength);
+
+			const glm::vec2 quadMargin  = glm::vec2(edgeMargin / axisXLength, edgeMargin / axisYLength);
+			const glm::vec2 opaqueBegin = glm::clamp(glm::min(opaqueFirst, opaqueSecond), 0.0f, 1.0f) + quadMargin;
+			const glm::vec2 opaqueEnd   = glm::clamp(glm::max(opaqueFirst, opaqueSecond), 0.0f, 1.0f) - quadMargin;
+
+			if (opaqueBegin.x >= opaqueEnd.x || opaqueBegin.y >= opaqueEnd.y)
+				continue;
+
+			SpriteOccluder spriteOccluder;
+			spriteOccluder.corner             = spriteQuad.origin + opaqueBegin.x * spriteQuad.axisX + opaqueBegin.y * spriteQuad.axisY;
+			spriteOccluder.edgeX              = (opaqueEnd.x - opaqueBegin.x) * spriteQuad.axisX;
+			spriteOccluder.edgeY              = (opaqueEnd.y - opaqueBegin.y) * spriteQuad.axisY;
+			spriteOccluder.edgeXLengthSquared = glm::dot(spriteOccluder.edgeX, spriteOccluder.edgeX);
+			spriteOccluder.edgeYLengthSquared = glm::dot(spriteOccluder.edgeY, spriteOccluder.edgeY);
+
+			const uint32_t occluderIndex = static_cast<uint32_t>(m_Occluders.size());
+			m_Occluders.push_back(spriteOccluder);
+
+			// List the occluder in every cell its bounds overlap(the grid wraps around once at most).
+			const glm::vec2 occluderMin = glm::min(glm::min(spriteOccluder.corner, spriteOccluder.corner + spriteOccluder.edgeX),
+			                                       glm::min(spriteOccluder.corner + spriteOccluder.edgeY, spriteOccluder.corner + spriteOccluder.edgeX + spriteOccluder.edgeY));
+			const glm::vec2 occluderMax = glm::max(glm::max(spriteOccluder.corner, spriteOccluder.corner + spriteOccluder.edgeX),
+			                                       glm::max(spriteOccluder.corner + spriteOccluder.edgeY, spriteOccluder.corner + spriteOccluder.edgeX + spriteOccluder.edgeY));
+
+			const int32_t cellBeginX = getOcclusionCell(occluderMin.x);
+			const int32_t cellBeginY = getOcclusionCell(occluderMin.y);
+			const int32_t cellEndX   = std::min(getOcclusionCell(occluderMax.x), cellBeginX + _OCCLUSION_GRID_SIZE - 1);
+			const int32_t cellEndY   = std::min(getOcclusionCell(occluderMax.y), cellBeginY + _OCCLUSION_GRID_SIZE - 1);
+
+			for (int32_t cellX = cellBeginX; cellX <= cellEndX; ++cellX)
+				for (int32_t cellY = cellBeginY; cellY <= cellEndY; ++cellY)
+					m_OcclusionCells[getOcclusionCellIndex(cellX, cellY)].push_back(occluderIndex);
+		}
+
+		if (culledTotal == 0)
+			return;
+
+		// Keep the rest of the sprites in the queue order.
+		size_t keptTotal = 0;
+
+		for (size_t itemIndex = 0; itemIndex < spritesTotal; ++itemIndex)
+			if (!m_CulledItems[itemIndex])
+				m_BatchItems[keptTotal++] = m_BatchItems[itemIndex];
+
+		m_BatchItems.resize(keptTotal);
+
+		static auto& culledMetric = MetricsRegistry::instance().counter("engine_sprites_culled_total", "The queued sprites that were covered by the opaque sprites");
+
+		culledMetric.increment(culledTotal);
+	}
+
+	void SpriteRenderer::flushSprites(SpriteBatchOrder batchOrder) noexcept
+	{
+		ENGINE_PROFILE_SCOPE("SpriteRenderer::flushSprites");
+
+		if (m_BatchItems.empty())
+			return;
+
+		// The sprites that are sorted do not overlap, so there is nothing to cull.
+		if (m_IsOcclusionCulling && batchOrder == SpriteBatchOrder::Queue)
+			cullOccludedSprites();
+
+		const size_t spritesTotal = m_BatchItems.size();
+
+		// The sprites that do not overlap are drawn in any order, so the ones with the same
+		// variant and texture are moved together(the runs are longer, the programs are switched
+		// at most once per variant).
+		if (batchOrder == SpriteBatchOrder::Variant)
+		{
+			stable_sort(m_BatchItems.begin(), m_BatchItems.end(), [](const SpriteBatchItem& leftItem, const SpriteBatchItem& rightItem)
+			{
+				if (leftItem.instanceFlags != rightItem.instanceFlags)
+					return(leftItem.instanceFlags < rightItem.instanceFlags);
+
+				return(leftItem.textureName < rightItem.textureName);
+			});
+		}
+
+		// The pick order is the draw order, the covered sprites are not seen, so they are not picked.
+		if (m_PickingIndex != nullptr)
+		{
+			for (const auto& batchItem : m_BatchItems)
+			{
+				if (batchItem.pickingID == SpriteBatchItem::InvalidPickingID || (batchItem.instanceFlags & (SpriteInstanceShadow | SpriteInstanceTrail)) != 0)
+					continue;
+
+				m_PickingIndex->submit(batchItem.pickingID, batchItem.spritePosition, batchItem.spriteSize, batchItem.spriteRotation);
+			}
+		}
+
+		auto& renderDevice = RenderDevice::instance();
+
+		renderDevice.bindBuffer(GL_ARRAY_BUFFER, m_BatchInstanceBuffer);
+
+		// Grow the instance buffer to fit all the queued sprites.
+		if (spritesTotal > m_BatchInstanceCapacity)
+		{
+			while (m_BatchInstanceCapacity < spritesTotal)
+				m_BatchInstanceCapacity *= 2;
+
+			renderDevice.bufferData(GL_ARRAY_BUFFER, m_BatchInstanceCapacity * sizeof(SpriteInstance), nullptr, GL_STREAM_DRAW);
+		}
+
+		auto* spriteInstances = static_cast<SpriteInstance*>(renderDevice.mapBuffer(GL_ARRAY_BUFFER, spritesTotal * sizeof(SpriteInstance)));
+
+		if (spriteInstances == nullptr)
+		{
+			ENGINE_LOG_ERROR(m_GraphicsLogger, "Unable to map the sprite instance buffer, {} sprites are dropped", spritesTotal);
+
+			renderDevice.bindBuffer(GL_ARRAY_BUFFER, GL_ZERO);
+			m_BatchItems.clear();
+
+			return;
+		}
+
+		// The jobs write the disjoint ranges of the instance buffer, the main thread helps
+		// with the jobs until they are all done.
+		if (spritesTotal <= _BATCH_SPRITES_PER_JOB)
+		{
+			writeSpriteInstances(m_BatchItems.data(), spriteInstances, 0, spritesTotal);
+		}
+		else
+		{
+			ENGINE_PROFILE_SCOPE("SpriteRenderer::writeSpriteInstances");
+
+			const SpriteBatchItem* batchItems = m_BatchItems.data();
+			JobCounter             writeCounter;
+
+			JobSystem::instance().parallelFor(spritesTotal, _BATCH_SPRITES_PER_JOB, [batchItems, spriteInstances](size_t batchBegin, size_t batchEnd)
+			{
+				writeSpriteInstances(batchItems, spriteInstances, batchBegin, batchEnd);
+			}, &writeCounter);
+
+			JobSystem::instance().wait(writeCounter);
+		}
+
+		if (!renderDevice.unmapBuffer(GL_ARRAY_BUFFER))
+		{
+			ENGINE_LOG_ERROR(m_GraphicsLogger, "The sprite instance buffer was lost, {} sprites are dropped", spritesTotal);
+
+			renderDevice.bindBuffer(GL_ARRAY_BUFFER, GL_ZERO);
+			m_BatchItems.clear();
+
+			return;
+		}
+
+		renderDevice.activeTexture  (GL_TEXTURE0);
+		renderDevice.bindVertexArray(m_BatchVertexArray);
+
+		// The vertex array.
+		GpuProfiler::instance().countStateChanges(1);
+
+		// Draw the runs of the neighbour sprites that are sharing the same texture and the same
+		// effects with a single instanced draw call(the shader variant is switched only between
+		// the runs of the different effects).
+		uint32_t boundEffects = UINT32_MAX;
+		bool     isBound      = false;
+		size_t   runStart     = 0;
+
+		while (runStart < spritesTotal)
+		{
+			const auto& runItem = m_BatchItems[runStart];
+
+			size_t runEnd = runStart + 1;
+
+			while (runEnd < spritesTotal && m_BatchItems[runEnd].textureName == runItem.textureName && m_BatchItems[runEnd].instanceFlags == runItem.instanceFlags)
+				++runEnd;
+
+			if (runItem.instanceFlags != boundEffects)
+			{
+				boundEffects = runItem.instanceFlags;
+				isBound      = useShaderVariant((runItem.instanceFlags & (_SHADER_VARIANT_BATCH - 1)) | _SHADER_VARIANT_BATCH);
+
+				GpuProfiler::instance().countStateChanges(1);
+			}
+
+			auto textureOrError = Engine::ResourceManager::getTexture(runItem.textureName);
+
+			if (!isBound)
+			{
+				ENGINE_LOG_ERROR(m_GraphicsLogger, "Unable to render sprites with the effects {:#x}", runItem.instanceFlags);
+			}
+			else if (textureOrError.has_value())
+			{
+				textureOrError->bind();
+
+				bindBatchAttributes(runStart);
+				renderDevice.drawArraysInstanced(GL_TRIANGLES, GL_ZERO, 6, static_cast<GLsizei>(runEnd - runStart));
+
+				GpuProfiler::instance().countDrawCalls(1);
+				GpuProfiler::instance().countStateChanges(1);
+
+				static auto& drawCallsMetric = MetricsRegistry::instance().counter("engine_draw_calls_total",      "The issued draw calls");
+				static auto& bindsMetric     = MetricsRegistry::instance().counter("engine_binds_total",           "The shader, texture and vertex array binds");
+				static auto& spritesMetric   = MetricsRegistry::instance().counter("engine_sprites_rendered_total", "The rendered sprites");
+
+				drawCallsMetric.increment();
+				bindsMetric    .increment();
+				spritesMetric  .increment(runEnd - runStart);
+			}
+			else
+			{
+				ENGINE_LOG_ERROR(m_ResourceLogger, "Unable to render sprite with name {}", runItem.textureName.c_str());
+			}
+
+			runStart = runEnd;
+		}
+
+		renderDevice.bindVertexArray(GL_ZERO);
+		renderDevice.bindBuffer     (GL_ARRAY_BUFFER, GL_ZERO);
+
+		m_BatchItems.clear();
 	}
 }
@@ -6,11 +6,71 @@
 #include "ShaderWrapper.hpp"
 #include "TextureWrapper.hpp"
 
+#include "span"
+#include "vector"
+
 using namespace std;
 
 // This namespace is polluted with the Internals components of the graphics API.
 namespace Engine::GFX
 {
+	// The effects of the sprite, every combination of them is the variant of the sprite shader
+	// with the effects compiled in(the variant is compiled when it is used for the first time).
+	enum SpriteInstanceFlag : uint32_t
+	{
+		SpriteInstanceNone   = 0,
+		SpriteInstanceShadow = 1, // the translucent black silhouette
+		SpriteInstanceGlow   = 2, // the pulsing glow, the sprite color is the intensity mask
+		SpriteInstanceTrail  = 4, // the faded copy of the motion blur trail
+
+		// The rounded corners and the edges that are anti-aliased by the shader(the coverage is
+		// computed from the distance to the edge, so the rotated sprites need no MSAA).
+		SpriteInstanceSmoothEdges = 8,
+	};
+
+	// Describes the sprite move between two known transforms, that is interpolated
+	// entirely by the vertex shader(the CPU writes it only once, when the move starts).
+	struct SpriteMotion
+	{
+		glm::vec2 startPosition = { 0.0f, 0.0f };
+		glm::vec2 endPosition   = { 0.0f, 0.0f };
+		glm::vec2 spriteSize    = { 10.0f, 10.0f };
+		GLfloat   startRotation = 0.0f;
+		GLfloat   endRotation   = 0.0f;
+		glm::vec3 spriteColor   = { 1.0f, 1.0f, 1.0f };
+		GLfloat   startTime     = 0.0f;
+		GLfloat   duration      = 0.0f;
+		uint32_t  instanceFlags = SpriteInstanceNone; // the effects(see ::SpriteInstanceFlag)
+	};
+
+	// The reference to the motion instance that is owned by the ::SpriteRenderer.
+	using MotionHandle = uint32_t;
+
+	// The order the queued sprites are drawn in by the ::SpriteRenderer::flushSprites.
+	enum class SpriteBatchOrder : uint8_t
+	{
+		Queue,   // the queue order(the overlapping sprites are blended correctly, the covered ones are culled)
+		Variant, // sorted by the shader variant and the texture(the sprites must not overlap)
+	};
+
+	// The sprite that is queued for the batched rendering(see ::SpriteRenderer::queueSprite).
+	struct SpriteBatchItem
+	{
+		// The sprites with this ID are not submitted to the ::PickingIndex.
+		static constexpr const GLuint InvalidPickingID = 0xFFFFFFFFu;
+
+		StringID  textureName;
+		glm::vec2 spritePosition = { 0.0f, 0.0f };
+		glm::vec2 spriteSize     = { 10.0f, 10.0f };
+		GLfloat   spriteRotation = 0.0f;
+		glm::vec3 spriteColor    = { 1.0f, 1.0f, 1.0f };
+		glm::vec4 textureRect    = { 0.0f, 0.0f, 1.0f, 1.0f }; // the texture coordinates of the corners
+		uint32_t  instanceFlags  = SpriteInstanceNone;
+		GLuint    pickingID      = InvalidPickingID;
+	};
+
+	class PickingIndex;
+
 	// This class represents an object which is generating sprites to the screen, taking
 	// the sprite data and the texture as an input.
 	//
@@ -18,20 +78,188 @@ namespace Engine::GFX
 	class SpriteRenderer
 	{
 	public:
-		SpriteRenderer(Core::ShaderWrapper& shaderWrapper);
+		// The shader must be loaded with the ::getShaderVariantDefines(see ::ResourceManager::loadShaderVariants).
+		SpriteRenderer(StringID shaderName);
 		~SpriteRenderer();
 
 	public:
-		// Render the sprite on the screen.
-		void renderSprite(const string& textureName, glm::vec2 spritePosition, glm::vec2 spriteSize = glm::vec2(10.0f, 10.0f), GLfloat spriteRotation = 0.0f, glm::vec3 spriteColor = glm::vec3(1.0f)) noexcept;
+		// Get the defines of the sprite shader variants, the bits of the effects come first(the
+		// same as ::SpriteInstanceFlag), then the bits of the batched and the motion paths and the
+		// bit of the overdraw heatmap.
+		static span<const char* const> getShaderVariantDefines() noexcept;
+
+		// Set the uniforms that are shared by all the variants of the sprite shader, they are
+		// passed to the variant when it is bound.
+		void setProjectionMatrix(const glm::mat4& projectionMatrix) noexcept;
+		void setElapsedTime     (GLfloat elapsedTime) noexcept;
+
+		// Set the radius of the rounded corners of the ::SpriteInstanceSmoothEdges sprites(relative
+		// to the shorter side of the sprite).
+		void setCornerRadius(GLfloat cornerRadius) noexcept;
+
+		// Skip the queued sprites that are fully covered by the opaque rect of the texture of a
+		// sprite that is queued after them(see ::flushSprites), it is enabled by default.
+		inline void setOcclusionCulling(bool isEnabled) noexcept
+		{
+			m_IsOcclusionCulling = isEnabled;
+		}
+
+		inline bool isOcclusionCulling() const noexcept
+		{
+			return(m_IsOcclusionCulling);
+		}
+
+		// Submit the flushed sprites that have the picking ID to the index, in the order they are
+		// drawn in(after the culling and the sorting), so the topmost pick is always the sprite
+		// the user sees on top. The shadows and the trails are not submitted. The index must
+		// outlive the renderer or be detached with nullptr.
+		inline void setPickingIndex(PickingIndex* pickingIndex) noexcept
+		{
+			m_PickingIndex = pickingIndex;
+		}
+
+		// Draw every pixel of the sprites with the same additive heat instead of the sprite color,
+		// so the pixels that are drawn many times are seen(the screen must be cleared to black).
+		void setOverdrawView(bool isEnabled) noexcept;
+
+		inline bool isOverdrawView() const noexcept
+		{
+			return(m_IsOverdrawView);
+		}
+
+		// Render the sprite on the screen(with the variant of the sprite shader the effects select).
+		void renderSprite(StringID textureName, glm::vec2 spritePosition, glm::vec2 spriteSize = glm::vec2(10.0f, 10.0f), GLfloat spriteRotation = 0.0f, glm::vec3 spriteColor = glm::vec3(1.0f), uint32_t effectFlags = SpriteInstanceNone) noexcept;
+
+		// Upload the motion instance to the GPU, from now on it is rendered by ::renderMotions
+		// until it is released with ::endMotion(once finished, the sprite stays at the end transform).
+		// The motions are drawn in the order they began in, as long as no released slot is reused
+		// (the slots are reset once all the motions are released).
+		MotionHandle beginMotion(StringID textureName, const SpriteMotion& spriteMotion) noexcept;
+
+		// Release the motion instance.
+		void endMotion(MotionHandle motionHandle) noexcept;
+
+		// Find out if the motion has reached its end transform at the `currentTime`.
+		bool isMotionFinished(MotionHandle motionHandle, GLfloat currentTime) const noexcept;
+
+		// Render all the motion instances, the positions are calculated on the GPU from the `currentTime`
+		// (the neighbour instances with the same texture and effects are drawn by a single draw call).
+		void renderMotions(GLfloat currentTime) noexcept;
+
+		// Queue the sprite for the batched rendering, the queued sprites are drawn in the
+		// queue order by the ::flushSprites.
+		inline void queueSprite(const SpriteBatchItem& batchItem)
+		{
+			m_BatchItems.push_back(batchItem);
+		}
+
+		// Cull the queued sprites that are covered(only in the queue order), generate the instance
+		// data of the rest on the worker threads(every job writes its own range of the mapped
+		// instance buffer), then draw the runs of the neighbour sprites that share the texture
+		// and the shader variant with a single instanced draw call.
+		void flushSprites(SpriteBatchOrder batchOrder = SpriteBatchOrder::Queue) noexcept;
 
 	private:
 		// Initialize rendering-related data structures(VAO, VBO), setup vertex
 		// attributes etc.
 		void initializeRenderPipeline() noexcept;
 
+		// Create the instance buffer and the vertex array for the motion instances.
+		void initializeMotionPipeline() noexcept;
+
+		// Point the per-instance vertex attributes to the `firstInstance` in the instance buffer.
+		void bindMotionAttributes(size_t firstInstance) noexcept;
+
+		// Create the instance buffer and the vertex array for the batched sprites.
+		void initializeBatchPipeline() noexcept;
+
+		// Point the per-instance vertex attributes to the `firstInstance` in the batch instance buffer.
+		void bindBatchAttributes(size_t firstInstance) noexcept;
+
+		// Use the variant of the sprite shader, the shared uniforms are set when they changed
+		// since the variant was used last time. False is returned when the variant is not available.
+		bool useShaderVariant(uint32_t variantMask) noexcept;
+
+		// Remove the queued sprites that are fully covered by the opaque sprites queued after them.
+		void cullOccludedSprites() noexcept;
+
 	private:
-		Core::ShaderWrapper m_ShaderWrapper;
+		// The layout of the single motion instance in the instance buffer.
+		struct MotionInstance
+		{
+			glm::vec4 positions;       // start.xy, end.xy
+			glm::vec4 sizeAndRotation; // size.xy, start rotation, end rotation
+			glm::vec4 color;           // rgb, unused
+			glm::vec4 timing;          // start time, duration, unused, unused
+		};
+
+		// The layout of the single batched sprite in the instance buffer.
+		struct SpriteInstance
+		{
+			glm::vec4 affineLinear; // the columns of the rotation and the scale(2x2)
+			glm::vec4 affineOffset; // translation.xy, flags, unused
+			glm::vec4 textureRect;  // u0, v0, u1, v1
+			glm::vec4 color;        // rgb, unused
+		};
+
+		// The quad of the queued sprite, the origin and the axes the unit square is mapped with.
+		struct SpriteQuad
+		{
+			glm::vec2 origin;
+			glm::vec2 axisX;
+			glm::vec2 axisY;
+		};
+
+		// The opaque rect of the sprite that covers the sprites queued before it(the edges are
+		// perpendicular, the rect is the same as the sprite is rotated).
+		struct SpriteOccluder
+		{
+			glm::vec2 corner;
+			glm::vec2 edgeX;
+			glm::vec2 edgeY;
+			GLfloat   edgeXLengthSquared;
+			GLfloat   edgeYLengthSquared;
+		};
+
+		// Write the instances of the [batchBegin, batchEnd) range of the queued sprites.
+		static void writeSpriteInstances(const SpriteBatchItem* batchItems, SpriteInstance* spriteInstances, size_t batchBegin, size_t batchEnd) noexcept;
+
+		StringID            m_ShaderName;
+		Core::ShaderWrapper m_ShaderWrapper; // the variant that is used now
+		GLuint              m_QuadVertexBuffer;
 		GLuint              m_QuadVertexArray;
+
+		GLuint                 m_MotionVertexArray;
+		GLuint                 m_MotionInstanceBuffer;
+		size_t                 m_MotionInstanceCapacity;
+		vector<MotionInstance> m_MotionInstances;
+		vector<StringID>       m_MotionTextures;
+		vector<uint32_t>       m_MotionFlags;
+		vector<bool>           m_MotionSlotUsed;
+		vector<MotionHandle>   m_MotionFreeSlots;
+
+		GLuint                  m_BatchVertexArray;
+		GLuint                  m_BatchInstanceBuffer;
+		size_t                  m_BatchInstanceCapacity;
+		vector<SpriteBatchItem> m_BatchItems;
+
+		// The occluders are found through the grid of the cells(the cell lists the occluders
+		// that overlap it), it is rebuilt by every ::cullOccludedSprites.
+		PickingIndex*            m_PickingIndex       = nullptr;
+		bool                     m_IsOcclusionCulling = true;
+		vector<SpriteQuad>       m_CullingQuads;
+		vector<bool>             m_CulledItems;
+		vector<SpriteOccluder>   m_Occluders;
+		vector<vector<uint32_t>> m_OcclusionCells;
+
+		// The uniforms shared by the variants, and the program and the version of them every
+		// variant was given last time.
+		glm::mat4        m_ProjectionMatrix = glm::mat4(1.0f);
+		GLfloat          m_ElapsedTime      = 0.0f;
+		GLfloat          m_CornerRadius     = 0.06f;
+		bool             m_IsOverdrawView   = false;
+		uint32_t         m_UniformsVersion  = 1;
+		vector<GLuint>   m_VariantPrograms;
+		vector<uint32_t> m_VariantUniformsVersions;
 	};
 }
@@ -1,26 +1,84 @@
 // This class implements the `TextureWrapper` class.
 #include "TextureWrapper.hpp"
 
+#include "algorithm"
+
+// The anisotropy of the anisotropic filtering(clamped to the largest one the device supports).
+static constexpr const GLfloat _TEXTURE_ANISOTROPY = 8.0f;
+
 namespace Engine::GFX::Core
 {
 	void TextureWrapper::make(GLuint imageWidth, GLuint imageHeight, GLubyte* imageData) noexcept
 	{
+		auto& renderDevice = RenderDevice::instance();
+
 		// Generate the texture
-		glGenTextures(1, &m_TextureID);
+		m_TextureID     = renderDevice.createTexture();
 		m_TextureWidth  = imageWidth;
 		m_TextureHeight = imageHeight;
 
 		// Bind the texture and populate it with the given data.
-		glBindTexture(GL_TEXTURE_2D, m_TextureID);
-		glTexImage2D (GL_TEXTURE_2D, GL_ZERO, m_TextureFormat, imageWidth, imageHeight, 0, m_ImageFormat, GL_UNSIGNED_BYTE, imageData);
+		renderDevice.bindTexture (m_TextureID);
+		renderDevice.textureImage(m_TextureFormat, imageWidth, imageHeight, m_ImageFormat, imageData);
+
+		// Build the mipmap chain from the uploaded image.
+		if (m_Filtering != TextureFiltering::Bilinear)
+			renderDevice.generateMipmap();
 
 		// Set the texture parameter
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, m_WrapSMode);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, m_WrapTMode);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, m_FilterMin);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, m_FilterMax);
+		renderDevice.textureParameter(GL_TEXTURE_WRAP_S, m_WrapSMode);
+		renderDevice.textureParameter(GL_TEXTURE_WRAP_T, m_WrapTMode);
+		renderDevice.textureParameter(GL_TEXTURE_MIN_FILTER, m_FilterMin);
+		renderDevice.textureParameter(GL_TEXTURE_MAG_FILTER, m_FilterMax);
+
+		if (m_Filtering == TextureFiltering::Anisotropic)
+		{
+			// The maximum is one without the anisotropic filtering extension(the parameter is unknown then).
+			const GLfloat maxAnisotropy = renderDevice.getMaxAnisotropy();
+
+			if (maxAnisotropy > 1.0f)
+				renderDevice.textureParameterFloat(GL_TEXTURE_MAX_ANISOTROPY_EXT, std::min(_TEXTURE_ANISOTROPY, maxAnisotropy));
+		}
 
 		// Unbind the texture.
-		glBindTexture(GL_TEXTURE_2D, GL_ZERO);
+		renderDevice.bindTexture(GL_ZERO);
+	}
+
+	void TextureWrapper::setFiltering(TextureFiltering textureFiltering) noexcept
+	{
+		m_Filtering = textureFiltering;
+		m_FilterMin = textureFiltering == TextureFiltering::Bilinear ? GL_LINEAR : GL_LINEAR_MIPMAP_LINEAR;
+		m_FilterMax = GL_LINEAR;
+	}
+
+	size_t TextureWrapper::getMemorySize() const noexcept
+	{
+		size_t bytesPerPixel = 4;
+
+		switch (m_TextureFormat)
+		{
+			case GL_RGB:
+			case GL_RGB8:
+			case GL_SRGB8: bytesPerPixel = 3; break;
+			default:                          break;
+		}
+
+		size_t levelWidth  = m_TextureWidth;
+		size_t levelHeight = m_TextureHeight;
+		size_t memorySize  = levelWidth * levelHeight * bytesPerPixel;
+
+		// The every mipmap level is the half of the previous one(rounded down), down to 1x1.
+		if (m_Filtering != TextureFiltering::Bilinear)
+		{
+			while (levelWidth > 1 || levelHeight > 1)
+			{
+				levelWidth  = std::max<size_t>(levelWidth  / 2, 1);
+				levelHeight = std::max<size_t>(levelHeight / 2, 1);
+
+				memorySize += levelWidth * levelHeight * bytesPerPixel;
+			}
+		}
+
+		return(memorySize);
 	}
-}
\ No newline at end of file
+}
@@ -2,10 +2,19 @@
 #pragma once
 
 #include "../_EngineIncludes.hpp"
+#include "RenderDevice.hpp"
 
 // This namespace is polluted with the Internals components of the graphics API.
 namespace Engine::GFX::Core
 {
+	// The filtering of the texture, the trilinear and the anisotropic ones are sampling the
+	// mipmaps(they are generated by the GPU when the texture is made).
+	enum class TextureFiltering : uint8_t
+	{
+		Bilinear,
+		Trilinear,
+		Anisotropic,
+	};
 
 	// This class represents a wrapper around OpenGL textures.
 	//
@@ -18,7 +27,7 @@ namespace Engine::GFX::Core
 		// Default class constructor that's zero-initialized all texture attributes.
 		TextureWrapper() :
 			m_TextureWidth (GL_ZERO),          m_TextureHeight(GL_ZERO),
-			m_TextureFormat(GL_RGB),           m_ImageFormat(GL_RGB),
+			m_TextureFormat(GL_RGB8),          m_ImageFormat(GL_RGB),
 			m_WrapSMode    (GL_CLAMP_TO_EDGE), m_WrapTMode(GL_CLAMP_TO_EDGE),
 			m_FilterMin    (GL_LINEAR),        m_FilterMax(GL_LINEAR)
 		{
@@ -27,13 +36,37 @@ namespace Engine::GFX::Core
 		// Bind the texture.
 		void inline bind() const 
 		{ 
-			glBindTexture(GL_TEXTURE_2D, m_TextureID);
+			RenderDevice::instance().bindTexture(m_TextureID);
 		}
 
 		// Create the texture(load it from the file), store the loaded information in
 		// the class members.
 		void make(GLuint imageWidth, GLuint imageHeight, GLubyte* imageData) noexcept;
 
+		// Set the filtering of the texture(must be called before the texture is made).
+		void setFiltering(TextureFiltering textureFiltering) noexcept;
+
+		inline TextureFiltering getFiltering() const noexcept
+		{
+			return(m_Filtering);
+		}
+
+		// Get the amount of the video memory the texture takes(bytes, including the mipmaps).
+		size_t getMemorySize() const noexcept;
+
+		// Set the part of the texture that is fully opaque(the texture coordinates of the corners,
+		// the rect is empty when there is no such part). The sprites that are covered by it are
+		// not drawn(see ::SpriteRenderer::flushSprites).
+		inline void setOpaqueRect(const glm::vec4& opaqueRect) noexcept
+		{
+			m_OpaqueRect = opaqueRect;
+		}
+
+		inline const glm::vec4& getOpaqueRect() const noexcept
+		{
+			return(m_OpaqueRect);
+		}
+
 		// Getters and setters for the class members.
 		#define __gettersettertype GLuint
 		makeGetterAndSetter(m_TextureID,     TextureID);
@@ -62,5 +95,8 @@ namespace Engine::GFX::Core
 		GLuint m_WrapTMode;
 		GLuint m_FilterMin;
 		GLuint m_FilterMax;
+
+		TextureFiltering m_Filtering = TextureFiltering::Bilinear;
+		glm::vec4        m_OpaqueRect = { 0.0f, 0.0f, 0.0f, 0.0f };
 	};
 }
\ No newline at end of file
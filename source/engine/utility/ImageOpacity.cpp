@@ -0,0 +1,73 @@
+// This file implements the search of the opaque part of the image.
+#include "ImageOpacity.hpp"
+
+#include "cstddef"
+
+// The alpha of the pixel that is fully opaque.
+static constexpr const uint8_t _OPAQUE_ALPHA = 255;
+
+namespace Engine
+{
+	ImageRect findOpaqueRect(const uint8_t* imagePixels, uint32_t imageWidth, uint32_t imageHeight, uint32_t channelsTotal) noexcept
+	{
+		ImageRect opaqueRect = { 0, 0, imageWidth, imageHeight };
+
+		// There is no alpha channel, the whole image is opaque.
+		if (channelsTotal != 2 && channelsTotal != 4)
+			return(opaqueRect);
+
+		auto isTransparent = [imagePixels, imageWidth, channelsTotal](uint32_t pixelX, uint32_t pixelY)
+		{
+			const size_t pixelIndex = static_cast<size_t>(pixelY) * imageWidth + pixelX;
+
+			return(imagePixels[pixelIndex * channelsTotal + channelsTotal - 1] != _OPAQUE_ALPHA);
+		};
+
+		while (!opaqueRect.isEmpty())
+		{
+			const uint32_t rectWidth  = opaqueRect.right  - opaqueRect.left;
+			const uint32_t rectHeight = opaqueRect.bottom - opaqueRect.top;
+
+			// The transparent pixels of the borders: the top, the bottom, the left and the right one.
+			uint32_t transparentPixels[4] = { 0, 0, 0, 0 };
+
+			for (uint32_t pixelX = opaqueRect.left; pixelX < opaqueRect.right; ++pixelX)
+			{
+				transparentPixels[0] += isTransparent(pixelX, opaqueRect.top);
+				transparentPixels[1] += isTransparent(pixelX, opaqueRect.bottom - 1);
+			}
+
+			for (uint32_t pixelY = opaqueRect.top; pixelY < opaqueRect.bottom; ++pixelY)
+			{
+				transparentPixels[2] += isTransparent(opaqueRect.left,      pixelY);
+				transparentPixels[3] += isTransparent(opaqueRect.right - 1, pixelY);
+			}
+
+			if (transparentPixels[0] + transparentPixels[1] + transparentPixels[2] + transparentPixels[3] == 0)
+				return(opaqueRect);
+
+			// Cut off the border that is the most transparent(relative to its length).
+			const float borderShares[4] = {
+				static_cast<float>(transparentPixels[0]) / rectWidth,
+				static_cast<float>(transparentPixels[1]) / rectWidth,
+				static_cast<float>(transparentPixels[2]) / rectHeight,
+				static_cast<float>(transparentPixels[3]) / rectHeight };
+
+			int cutBorder = 0;
+
+			for (int borderIndex = 1; borderIndex < 4; ++borderIndex)
+				if (borderShares[borderIndex] > borderShares[cutBorder])
+					cutBorder = borderIndex;
+
+			switch (cutBorder)
+			{
+				case 0: opaqueRect.top++;    break;
+				case 1: opaqueRect.bottom--; break;
+				case 2: opaqueRect.left++;   break;
+				case 3: opaqueRect.right--;  break;
+			}
+		}
+
+		return(ImageRect{});
+	}
+}
@@ -0,0 +1,28 @@
+// This file declares the search of the opaque part of the image.
+#pragma once
+
+#include "cstdint"
+
+namespace Engine
+{
+	// The rectangle of the image pixels, [left, right) x [top, bottom).
+	struct ImageRect
+	{
+		uint32_t left   = 0;
+		uint32_t top    = 0;
+		uint32_t right  = 0;
+		uint32_t bottom = 0;
+
+		inline bool isEmpty() const noexcept
+		{
+			return(left >= right || top >= bottom);
+		}
+	};
+
+	// Find the large rectangle of the 8-bit image that has only the fully opaque pixels(the alpha
+	// is the last channel of the 2 and 4 channel images, the other images are opaque). The borders
+	// with the most transparent pixels are cut off one by one, so the rectangle is not always the
+	// largest one(it is good enough for the cards with the transparent corners). The empty
+	// rectangle is returned when there are no opaque pixels.
+	ImageRect findOpaqueRect(const uint8_t* imagePixels, uint32_t imageWidth, uint32_t imageHeight, uint32_t channelsTotal) noexcept;
+}
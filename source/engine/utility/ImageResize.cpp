@@ -0,0 +1,104 @@
+// This file implements the image downscaler.
+#include "ImageResize.hpp"
+
+#include "algorithm"
+#include "cmath"
+#include "vector"
+
+using namespace std;
+
+// The source pixel and its share in the destination pixel.
+struct ResizeTap
+{
+	uint32_t sourceIndex;
+	float    weight;
+};
+
+// The taps of the every destination pixel along the single axis, the taps of the pixel
+// `destinationIndex` are [tapOffsets[destinationIndex], tapOffsets[destinationIndex + 1]).
+static void buildResizeTaps(uint32_t sourceSize, uint32_t destinationSize, vector<ResizeTap>& resizeTaps, vector<uint32_t>& tapOffsets)
+{
+	const double scale = static_cast<double>(sourceSize) / destinationSize;
+
+	resizeTaps.clear();
+	tapOffsets.assign(destinationSize + 1, 0);
+
+	for (uint32_t destinationIndex = 0; destinationIndex < destinationSize; ++destinationIndex)
+	{
+		const double rangeBegin = destinationIndex * scale;
+		const double rangeEnd   = std::min((destinationIndex + 1) * scale, static_cast<double>(sourceSize));
+
+		tapOffsets[destinationIndex] = static_cast<uint32_t>(resizeTaps.size());
+
+		for (uint32_t sourceIndex = static_cast<uint32_t>(rangeBegin); sourceIndex < rangeEnd; ++sourceIndex)
+		{
+			const double coverage = std::min(rangeEnd, sourceIndex + 1.0) - std::max(rangeBegin, static_cast<double>(sourceIndex));
+
+			if (coverage > 0.0)
+				resizeTaps.push_back({ sourceIndex, static_cast<float>(coverage / scale) });
+		}
+	}
+
+	tapOffsets[destinationSize] = static_cast<uint32_t>(resizeTaps.size());
+}
+
+namespace Engine
+{
+	void downscaleImage(const uint8_t* sourcePixels, uint32_t sourceWidth, uint32_t sourceHeight, uint32_t channelsTotal,
+		uint8_t* destinationPixels, uint32_t destinationWidth, uint32_t destinationHeight) noexcept
+	{
+		if (sourceWidth == 0 || sourceHeight == 0 || destinationWidth == 0 || destinationHeight == 0)
+			return;
+
+		vector<ResizeTap> horizontalTaps, verticalTaps;
+		vector<uint32_t>  horizontalOffsets, verticalOffsets;
+
+		buildResizeTaps(sourceWidth,  destinationWidth,  horizontalTaps, horizontalOffsets);
+		buildResizeTaps(sourceHeight, destinationHeight, verticalTaps,   verticalOffsets);
+
+		// The rows are filtered horizontally first(into the floats), then the columns.
+		const size_t  rowLength = static_cast<size_t>(destinationWidth) * channelsTotal;
+		vector<float> filteredRows(rowLength * sourceHeight, 0.0f);
+
+		for (uint32_t rowIndex = 0; rowIndex < sourceHeight; ++rowIndex)
+		{
+			const uint8_t* sourceRow   = sourcePixels + static_cast<size_t>(rowIndex) * sourceWidth * channelsTotal;
+			float*         filteredRow = filteredRows.data() + rowIndex * rowLength;
+
+			for (uint32_t columnIndex = 0; columnIndex < destinationWidth; ++columnIndex)
+			{
+				float* filteredPixel = filteredRow + static_cast<size_t>(columnIndex) * channelsTotal;
+
+				for (uint32_t tapIndex = horizontalOffsets[columnIndex]; tapIndex < horizontalOffsets[columnIndex + 1]; ++tapIndex)
+				{
+					const auto&    resizeTap   = horizontalTaps[tapIndex];
+					const uint8_t* sourcePixel = sourceRow + static_cast<size_t>(resizeTap.sourceIndex) * channelsTotal;
+
+					for (uint32_t channelIndex = 0; channelIndex < channelsTotal; ++channelIndex)
+						filteredPixel[channelIndex] += resizeTap.weight * sourcePixel[channelIndex];
+				}
+			}
+		}
+
+		vector<float> destinationRow(rowLength);
+
+		for (uint32_t rowIndex = 0; rowIndex < destinationHeight; ++rowIndex)
+		{
+			std::fill(destinationRow.begin(), destinationRow.end(), 0.0f);
+
+			for (uint32_t tapIndex = verticalOffsets[rowIndex]; tapIndex < verticalOffsets[rowIndex + 1]; ++tapIndex)
+			{
+				const auto&  resizeTap   = verticalTaps[tapIndex];
+				const float* filteredRow = filteredRows.data() + resizeTap.sourceIndex * rowLength;
+
+				for (size_t elementIndex = 0; elementIndex < rowLength; ++elementIndex)
+					destinationRow[elementIndex] += resizeTap.weight * filteredRow[elementIndex];
+			}
+
+			uint8_t* destinationPixel = destinationPixels + rowIndex * rowLength;
+
+			for (size_t elementIndex = 0; elementIndex < rowLength; ++elementIndex)
+				destinationPixel[elementIndex] = static_cast<uint8_t>(std::clamp(std::lround(destinationRow[elementIndex]), 0l, 255l));
+		}
+	}
+}
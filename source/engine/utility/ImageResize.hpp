@@ -0,0 +1,13 @@
+// This file declares the image downscaler.
+#pragma once
+
+#include "cstdint"
+
+namespace Engine
+{
+	// Downscale the 8-bit image with the box filter(every destination pixel is the average of
+	// the source pixels it covers, the partially covered ones are weighted by the coverage). The
+	// destination must not be larger than the source, the rows of both are tightly packed.
+	void downscaleImage(const uint8_t* sourcePixels, uint32_t sourceWidth, uint32_t sourceHeight, uint32_t channelsTotal,
+		uint8_t* destinationPixels, uint32_t destinationWidth, uint32_t destinationHeight) noexcept;
+}
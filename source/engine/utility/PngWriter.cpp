@@ -0,0 +1,148 @@
+// This file implements the PNG image writer.
+#include "PngWriter.hpp"
+#include "../Logger.hpp"
+
+#include "array"
+#include "vector"
+#include "algorithm"
+#include "cstdio"
+
+using namespace std;
+
+// The largest payload of the deflate stored block.
+static constexpr const size_t _PNG_MAX_STORED_BLOCK = 65535;
+
+// Build the CRC-32 lookup table(the polynomial of the PNG chunks) at compile time.
+static constexpr array<uint32_t, 256> makeCrcTable() noexcept
+{
+	array<uint32_t, 256> crcTable = {};
+
+	for (uint32_t tableIndex = 0; tableIndex < 256; ++tableIndex)
+	{
+		uint32_t crcValue = tableIndex;
+
+		for (int bitIndex = 0; bitIndex < 8; ++bitIndex)
+			crcValue = (crcValue & 1) ? 0xEDB88320u ^ (crcValue >> 1) : crcValue >> 1;
+
+		crcTable[tableIndex] = crcValue;
+	}
+
+	return(crcTable);
+}
+
+static constexpr const array<uint32_t, 256> _PNG_CRC_TABLE = makeCrcTable();
+
+static inline void appendBigEndian(vector<uint8_t>& buffer, uint32_t value)
+{
+	buffer.push_back(static_cast<uint8_t>(value >> 24));
+	buffer.push_back(static_cast<uint8_t>(value >> 16));
+	buffer.push_back(static_cast<uint8_t>(value >>  8));
+	buffer.push_back(static_cast<uint8_t>(value));
+}
+
+// Append the chunk(length, type, data and the CRC of the type and the data).
+static void appendChunk(vector<uint8_t>& buffer, const char* chunkType, const vector<uint8_t>& chunkData)
+{
+	appendBigEndian(buffer, static_cast<uint32_t>(chunkData.size()));
+
+	const size_t crcBegin = buffer.size();
+
+	buffer.insert(buffer.end(), chunkType, chunkType + 4);
+	buffer.insert(buffer.end(), chunkData.begin(), chunkData.end());
+
+	uint32_t crcValue = 0xFFFFFFFFu;
+
+	for (size_t byteIndex = crcBegin; byteIndex < buffer.size(); ++byteIndex)
+		crcValue = _PNG_CRC_TABLE[(crcValue ^ buffer[byteIndex]) & 0xFF] ^ (crcValue >> 8);
+
+	appendBigEndian(buffer, crcValue ^ 0xFFFFFFFFu);
+}
+
+namespace Engine
+{
+	Error writePng(const char* filename, uint32_t width, uint32_t height, const uint8_t* rgbaPixels) noexcept
+	{
+		if (width == 0 || height == 0 || rgbaPixels == nullptr)
+			return(Error::ValidationError);
+
+		// Every row is prefixed with the filter type(0 means no filter).
+		const size_t rowSize = static_cast<size_t>(width) * 4;
+
+		vector<uint8_t> scanlines;
+		scanlines.reserve((rowSize + 1) * height);
+
+		for (uint32_t rowIndex = 0; rowIndex < height; ++rowIndex)
+		{
+			scanlines.push_back(0);
+			scanlines.insert(scanlines.end(), rgbaPixels + rowIndex * rowSize, rgbaPixels + (rowIndex + 1) * rowSize);
+		}
+
+		// Wrap the scanlines into the zlib stream of the stored deflate blocks.
+		vector<uint8_t> imageData;
+		imageData.reserve(scanlines.size() + (scanlines.size() / _PNG_MAX_STORED_BLOCK + 1) * 5 + 6);
+
+		imageData.push_back(0x78);
+		imageData.push_back(0x01);
+
+		for (size_t blockOffset = 0; blockOffset < scanlines.size(); blockOffset += _PNG_MAX_STORED_BLOCK)
+		{
+			const size_t   blockSize   = std::min(_PNG_MAX_STORED_BLOCK, scanlines.size() - blockOffset);
+			const uint16_t blockLength = static_cast<uint16_t>(blockSize);
+			const uint16_t blockCheck  = static_cast<uint16_t>(~blockLength);
+
+			imageData.push_back(blockOffset + blockSize == scanlines.size() ? 1 : 0);
+			imageData.push_back(static_cast<uint8_t>(blockLength));
+			imageData.push_back(static_cast<uint8_t>(blockLength >> 8));
+			imageData.push_back(static_cast<uint8_t>(blockCheck));
+			imageData.push_back(static_cast<uint8_t>(blockCheck >> 8));
+
+			imageData.insert(imageData.end(), scanlines.begin() + blockOffset, scanlines.begin() + blockOffset + blockSize);
+		}
+
+		// The Adler-32 checksum of the uncompressed data closes the zlib stream.
+		uint32_t adlerLow  = 1;
+		uint32_t adlerHigh = 0;
+
+		for (const uint8_t scanlineByte : scanlines)
+		{
+			adlerLow  = (adlerLow  + scanlineByte) % 65521;
+			adlerHigh = (adlerHigh + adlerLow)     % 65521;
+		}
+
+		appendBigEndian(imageData, (adlerHigh << 16) | adlerLow);
+
+		// The header: the dimensions, 8 bits per channel, the RGBA color type.
+		vector<uint8_t> imageHeader;
+		appendBigEndian(imageHeader, width);
+		appendBigEndian(imageHeader, height);
+		imageHeader.insert(imageHeader.end(), { 8, 6, 0, 0, 0 });
+
+		vector<uint8_t> pngFile = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+		pngFile.reserve(imageData.size() + 64);
+
+		appendChunk(pngFile, "IHDR", imageHeader);
+		appendChunk(pngFile, "IDAT", imageData);
+		appendChunk(pngFile, "IEND", {});
+
+		FILE* outputFile = fopen(filename, "wb");
+
+		if (outputFile == nullptr)
+		{
+			Logger::m_ResourceLogger->error("Unable to open the image file {}", filename);
+
+			return(Error::InitializationError);
+		}
+
+		const bool isWritten = fwrite(pngFile.data(), 1, pngFile.size(), outputFile) == pngFile.size();
+		fclose(outputFile);
+
+		if (!isWritten)
+		{
+			Logger::m_ResourceLogger->error("Unable to write the image file {}", filename);
+
+			return(Error::InitializationError);
+		}
+
+		return(Error::Ok);
+	}
+}
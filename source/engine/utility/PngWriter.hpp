@@ -0,0 +1,15 @@
+// This file declares the PNG image writer.
+#pragma once
+
+#include "Error.hpp"
+
+#include "cstdint"
+
+namespace Engine
+{
+	// Write the 8-bit RGBA image into the PNG file. The first row of the pixels is the top
+	// row of the image. The image data is stored with no compression(the deflate "stored"
+	// blocks), so the file is bigger than it could be, but the writer needs no zlib and
+	// the pixels are round-tripped exactly(that is what the golden image tests need).
+	Error writePng(const char* filename, uint32_t width, uint32_t height, const uint8_t* rgbaPixels) noexcept;
+}
@@ -0,0 +1,53 @@
+// This file implements the `StringID` and the `StringInterner` classes.
+#include "StringID.hpp"
+#include "../Logger.hpp"
+
+using namespace std;
+
+namespace Engine
+{
+	const char* StringID::c_str() const noexcept
+	{
+		return(StringInterner::instance().lookup(*this));
+	}
+
+	expected<StringID, Error> StringInterner::intern(string_view text)
+	{
+		const StringID stringID(text);
+
+		lock_guard<mutex> internerLock(m_InternerMutex);
+
+		const auto [stringIterator, isInserted] = m_Strings.try_emplace(stringID.getHash(), text);
+
+		// Two different strings are sharing the same ID, one of them has to be renamed.
+		if (!isInserted && stringIterator->second != text)
+		{
+			Logger::m_ResourceLogger->critical("String ID collision: \"{}\" and \"{}\" are both hashed to {:#010x}, \"{}\" must be renamed",
+				stringIterator->second, text, stringID.getHash(), text);
+
+			return(unexpected(Error::ValidationError));
+		}
+
+		return(stringID);
+	}
+
+	const char* StringInterner::lookup(StringID stringID) const noexcept
+	{
+		lock_guard<mutex> internerLock(m_InternerMutex);
+
+		const auto stringIterator = m_Strings.find(stringID.getHash());
+
+		// The node based map never moves the strings, so the pointer stays valid.
+		if (stringIterator != m_Strings.end())
+			return(stringIterator->second.c_str());
+
+		return("<unknown string id>");
+	}
+
+	size_t StringInterner::getInternedCount() const noexcept
+	{
+		lock_guard<mutex> internerLock(m_InternerMutex);
+
+		return(m_Strings.size());
+	}
+}
@@ -0,0 +1,112 @@
+// This file declares the `StringID` and the `StringInterner` classes.
+#pragma once
+
+#include "Error.hpp"
+
+#include "cstdint"
+#include "expected"
+#include "string"
+#include "string_view"
+#include "functional"
+#include "unordered_map"
+#include "mutex"
+
+namespace Engine
+{
+	// Hash the string with the 32-bit FNV-1a function(usable at compile time).
+	constexpr uint32_t hashString(std::string_view text) noexcept
+	{
+		uint32_t hash = 2166136261u;
+
+		for (const char character : text)
+		{
+			hash ^= static_cast<uint8_t>(character);
+			hash *= 16777619u;
+		}
+
+		return(hash);
+	}
+
+	// The compact identifier of the string(the resource name, the texture path etc.). The ID is
+	// the hash of the string itself, so it is compared and hashed for free, and the string
+	// literals are turned into the IDs at compile time(see the `_sid` literal below).
+	class StringID
+	{
+	public:
+		constexpr StringID() = default;
+
+		constexpr explicit StringID(std::string_view text) noexcept : m_Hash(hashString(text))
+		{
+		}
+
+		inline constexpr uint32_t getHash() const noexcept
+		{
+			return(m_Hash);
+		}
+
+		inline constexpr bool isValid() const noexcept
+		{
+			return(m_Hash != 0u);
+		}
+
+		constexpr auto operator<=>(const StringID&) const = default;
+
+		// Recover the interned string, should be used only for the logging.
+		const char* c_str() const noexcept;
+
+	private:
+		uint32_t m_Hash = 0u;
+	};
+
+	// This class remembers the strings behind the IDs, so the IDs can be turned back into
+	// the strings for the logs. The engine interns every resource name when the resource is loaded.
+	class StringInterner
+	{
+	private:
+		StringInterner() = default;
+
+	public:
+		StringInterner(const StringInterner&)            = delete;
+		StringInterner& operator=(const StringInterner&) = delete;
+
+		// This function is the way to realize the Singleton OOP programming pattern,
+		// so that this class can only be instantiated only once.
+		static StringInterner& instance()
+		{
+			static StringInterner _instance;
+			return(_instance);
+		}
+
+	public:
+		// Get the ID of the string and remember the string. The string that collides with another
+		// interned string is not remembered, the ::ValidationError is returned(the resource loaders
+		// refuse the name, so the colliding asset is never aliased with the other one).
+		std::expected<StringID, Error> intern(std::string_view text);
+
+		// Get the string of the interned ID, or the placeholder if the ID was never interned.
+		const char* lookup(StringID stringID) const noexcept;
+
+		// Get the amount of the interned strings.
+		size_t getInternedCount() const noexcept;
+
+	private:
+		mutable std::mutex                        m_InternerMutex;
+		std::unordered_map<uint32_t, std::string> m_Strings;
+	};
+
+	// Turn the string literal into the ID at compile time: "spriteShader"_sid
+	consteval StringID operator""_sid(const char* text, size_t length)
+	{
+		return(StringID(std::string_view(text, length)));
+	}
+}
+
+template<>
+struct std::hash<Engine::StringID>
+{
+	// The ID is already the well distributed hash.
+	size_t operator()(Engine::StringID stringID) const noexcept
+	{
+		return(stringID.getHash());
+	}
+};
@@ -19,7 +19,7 @@ namespace Game
 
 	}
 
-	std::string Board::loadTextureForCard(int cardRank, int cardSuit)
+	StringID Board::loadTextureForCard(int cardRank, int cardSuit)
 	{
 		auto createTexturePath = [&](const string& sCardRank) -> string
 		{
@@ -31,12 +31,12 @@ namespace Game
 			return(result);
 		};
 
-		auto loadTextureA = [&](const string& cardRank) -> string
+		auto loadTextureA = [&](const string& cardRank) -> StringID
 		{
 			string texturePath = createTexturePath(cardRank);
-			Engine::ResourceManager::loadTexture(texturePath.c_str(), true, texturePath);
+			Engine::ResourceManager::loadTexture(texturePath.c_str(), true, texturePath, CARD_TEXTURE_LOAD_OPTIONS);
 
-			return(texturePath);
+			return(StringID(texturePath));
 		};
 
 		if (cardRank == Clubs)
@@ -89,7 +89,7 @@ namespace Game
 				dummyCard.cardSuit = static_cast<CardSuit>(cardSuit);
 				dummyCard.cardOwner = CARD_OWNER_DECK;
 				dummyCard.textureHandleMain = loadTextureForCard(cardRank, cardSuit);
-				dummyCard.textureHandleBack = "card-back-green";
+				dummyCard.textureHandleBack = "card-back-green"_sid;
 
 				m_Cards.push_back(dummyCard);
 			}
@@ -183,6 +183,13 @@ namespace Game
 
 	void Board::step(void)
 	{
+		ENGINE_PROFILE_SCOPE("Board::step");
+
+		static auto& stepsMetric = Engine::MetricsRegistry::instance().counter("game_steps_total", "The game board steps");
+		stepsMetric.increment();
+
+		ENGINE_TRACE("Game step {}, deliverer {}, deck {} cards", m_GameStep, m_Deliverer, m_Deck.size());
+
 		if (isEnded())
 		{
 			calculatePlayerScore();
@@ -319,6 +326,10 @@ namespace Game
 
   void Board::moveCardAI(CardOwner cardOwner)
   {
+	  static auto& thinkTimeMetric = Engine::MetricsRegistry::instance().histogram("game_ai_think_seconds", "The time the AI player takes to pick the move");
+
+	  const uint64_t thinkTimestamp = InputQueue::timestamp();
+
 	  // Get all cards of this owner
 	  vector<Card> playerCards;
 
@@ -326,11 +337,15 @@ namespace Game
 	  {
 		  if (card.cardOwner == cardOwner && moveIsValid(card))
 		  {
+			  thinkTimeMetric.record(InputQueue::timestamp() - thinkTimestamp);
+
 			  move(card);
 			  return;
 		  }
 	  }
 
+	  thinkTimeMetric.record(InputQueue::timestamp() - thinkTimestamp);
+
 	  // Get the card if there exists oner
 	  if (!deckIsEmpty())
 	  {
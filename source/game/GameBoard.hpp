@@ -8,6 +8,9 @@
 #include <algorithm> 
 
 #include "../engine/Logger.hpp"
+#include "../engine/TraceLog.hpp"
+#include "../engine/Profiler.hpp"
+#include "../engine/Metrics.hpp"
 #include "../engine/ResourseManager.hpp"
 
 #include "GameInfo.hpp"
@@ -16,6 +19,9 @@ using namespace std;
 
 namespace Game
 {
+  // The card textures are rotated and scaled on the board, so they are sampled from the mipmaps.
+  static const Engine::TextureLoadOptions CARD_TEXTURE_LOAD_OPTIONS = { .filtering = Engine::GFX::Core::TextureFiltering::Anisotropic };
+
   enum CardRank
   {
 	  Diamonds     = 1,
@@ -61,10 +67,13 @@ namespace Game
 	CardSuit  cardSuit;
 	CardOwner cardOwner;
 
-	string textureHandleMain;
-	string textureHandleBack;
+	Engine::StringID textureHandleMain;
+	Engine::StringID textureHandleBack;
   };
 
+  // The cards are copied by value all over the game, so they must stay plain data.
+  static_assert(std::is_trivially_copyable_v<Card>, "The card must be trivially copyable");
+
   struct PlayerScore
   {
 	  size_t Player1 = 0u;
@@ -137,6 +146,12 @@ namespace Game
 
 	Card& getCardRef(CardSuit cardSuit, CardRank cardRank, bool rewind = false);
 
+	// Restart the random generator with the fixed seed(the reproducible deals).
+	inline void setRandomSeed(uint32_t randomSeed)
+	{
+		m_RandomGenerator.seed(randomSeed);
+	}
+
 	void calculatePlayerScore();
 
 	void assignCardsToThePlayers(void);
@@ -162,7 +177,7 @@ namespace Game
 	Card& getCardRef       (Card card);
 	Card  getCard          (Card card);
 
-	string loadTextureForCard(int cardRank, int cardSuit);
+	Engine::StringID loadTextureForCard(int cardRank, int cardSuit);
 
 	void assignNextDeliverer(void);
 
@@ -1,6 +1,13 @@
 ﻿#include "Program.hpp"
 
 #include "../engine/Sprite.hpp"
+#include "../engine/FrameArena.hpp"
+#include "../engine/LatencyTracker.hpp"
+#include "../engine/Profiler.hpp"
+#include "../engine/GpuProfiler.hpp"
+#include "../engine/DynamicResolution.hpp"
+#include "../engine/Metrics.hpp"
+#include "../engine/HeadlessRunner.hpp"
 
 #include <iostream>
 
@@ -21,6 +28,11 @@ static constexpr const glm::vec2  CARD_ASSET_SIZE_NON_NORMALIZED  = {150.0f, 150
 static constexpr const glm::ivec2 CARD_ASSET_SIZE_NORMALIZED      = CARD_ASSET_SIZE_NON_NORMALIZED*CARD_ASSET_RATIO;
 static constexpr const float      CARDS_ROW_OTHER_PLAYERS_Y_COORD = 0.02f;
 
+static constexpr const char* PROFILE_CAPTURE_RELPATH = "logs/profile_capture.json";
+
+// The radius of the rounded corners of the card(relative to its width).
+static constexpr const float CARD_CORNER_RADIUS = 0.06f;
+
 static constexpr const vec3  CARD_INTENCITY_MASK_BAD   = {0.9, 0.8, 0.8};
 static constexpr const vec3  CARD_INTENCITY_MASK_GOOD  = {0.8, 0.9, 0.8};
 
@@ -55,29 +67,45 @@ hosted on https://github.com/jjisolo/coursework-1.
 
 #include <iostream>
 
+// Get the ID that identifies the card in the ::PickingIndex.
+static GLuint getCardPickingID(const Game::Card& card)
+{
+	return((static_cast<GLuint>(card.cardRank) << 4) | static_cast<GLuint>(card.cardSuit));
+}
+
 namespace Game
 {
 	Engine::Error GameProgram::onUserInitialize()
 	{
         auto windowDimensions  = getWindowDimensions();
 
-		// Load game background texture
-  		ResourceManager::loadTexture("data/assets/background.jpg", false, "background");
+		// Load game background texture(downscaled to the window, it is never drawn bigger).
+  		ResourceManager::loadTexture("data/assets/background.jpg", false, "background", { .targetSize = glm::uvec2(windowDimensions) });
 		
-        // Load the card reverse side textures.
-	    ResourceManager::loadTexture("data/assets/card-back1.png", true, "card-back-blue");
-        ResourceManager::loadTexture("data/assets/card-back2.png", true, "card-back-red");
-        ResourceManager::loadTexture("data/assets/card-back3.png", true, "card-back-green");
-	    ResourceManager::loadTexture("data/assets/card-back4.png", true, "card-back-yellow");	
+        // Load the card reverse side textures(the cards are rotated and scaled, so they are mipmapped).
+	    ResourceManager::loadTexture("data/assets/card-back1.png", true, "card-back-blue",   CARD_TEXTURE_LOAD_OPTIONS);
+        ResourceManager::loadTexture("data/assets/card-back2.png", true, "card-back-red",    CARD_TEXTURE_LOAD_OPTIONS);
+        ResourceManager::loadTexture("data/assets/card-back3.png", true, "card-back-green",  CARD_TEXTURE_LOAD_OPTIONS);
+	    ResourceManager::loadTexture("data/assets/card-back4.png", true, "card-back-yellow", CARD_TEXTURE_LOAD_OPTIONS);	
+
+		// The card edges are anti-aliased by the sprite shader(the cards are drawn rotated).
+		m_SpriteRenderer->setCornerRadius(CARD_CORNER_RADIUS);
+
+		// The cards are picked in the order the renderer draws them in.
+		m_SpriteRenderer->setPickingIndex(&m_cardPicking);
 		
 		// Create and set sprite for the background.
 		Sprite backgroundSprite;
 		backgroundSprite .setSpriteSize({ windowDimensions.x, windowDimensions.y });
-		backgroundSprite .bindTexture  ("background");
+		backgroundSprite .bindTexture  ("background"_sid);
 
 		m_mainMenuSprites .push_back(backgroundSprite);
         m_gameBoardGeneral.push_back(backgroundSprite);
 		
+		// The headless runs must deal the same cards every time.
+		if (HeadlessRunner::instance().isEnabled())
+			m_gameBoard.setRandomSeed(HeadlessRunner::instance().getSettings().randomSeed);
+
 		// Set up game board
 		m_gameBoard.generateDeck();
 		m_gameBoardPendingUpdate = true;
@@ -93,26 +121,31 @@ namespace Game
 
 	Error GameProgram::onUserRelease()
 	{
+		m_SpriteRenderer->setPickingIndex(nullptr);
+
 		return(Error::Ok);
 	}
 
 	Error GameProgram::onUserUpdate(GLfloat elapsedTime)
 	{
+		ENGINE_PROFILE_SCOPE("GameProgram::onUserUpdate");
+
 	    auto windowDimensions = getWindowDimensions();
         
-		if (m_escapeButtonPressed == true)
+		if (wasKeyPressed(GLFW_KEY_ESCAPE))
 			m_showBoardMenuWindow = true;
-
-        // Update mouse cursor position on the current frame.
-        glfwGetCursorPos(getWindowPointer(), &m_mousePositionX, &m_mousePositionY);
 		
 		switch (m_gameInfo.gameState)
 		{
 			case GameState::Main_Menu:
 			{
+				GpuProfiler::instance().beginPass(GpuPass::Background);
+
 				for (auto& sprite : m_mainMenuSprites)
 					sprite.render(m_SpriteRenderer);
 
+				GpuProfiler::instance().endPass();
+
 				 renderMainMenuUI(windowDimensions);
 			} break;
 
@@ -120,7 +153,10 @@ namespace Game
 			{
 				if (!m_gameBoard.isEnded())
 				{
-					bool waitAnimations = false;
+					// Find the card under the cursor on the frame the user is currently seeing.
+					m_hoveredPickingID = m_cardPicking.pick({ m_mousePositionX, m_mousePositionY });
+
+					bool waitAnimations = isAnyCardMoving();
 
 					for (auto& animatedSprite : m_gameBoardCards)
 					{
@@ -143,13 +179,19 @@ namespace Game
 					}
 
 					// Animate individual sprite that is on gameboard group.
+					GpuProfiler::instance().beginPass(GpuPass::Background);
+
 					for (auto& sprite : m_gameBoardGeneral)
 					{
 						sprite.render(m_SpriteRenderer);
 					}
 
-					// Find all sprites that are animating and render each of them
-					vector<AnimatedSprite> animatedCards;
+					GpuProfiler::instance().endPass();
+
+					// Find all sprites that are animating and render each of them(the list only lives
+					// during this frame, so it is allocated from the frame arena).
+					FrameVector<AnimatedSprite> animatedCards(&FrameArena::instance());
+					animatedCards.reserve(m_gameBoardCards.size() + 1);
 
 					for (ptrdiff_t spriteIndex = 0; spriteIndex < m_gameBoardCards.size(); spriteIndex++)
 					{
@@ -177,19 +219,35 @@ namespace Game
 							iter_swap(animatedCards.rbegin(), animatedCards.rbegin() + 1);
 					}
 
+					// The flushed sprites are fed into the picking index in the draw order.
+					m_cardPicking.beginUpdate();
+
 					renderSpriteGroup(m_gameBoardCards);
 					renderSpriteGroup(animatedCards);
+
+					m_cardPicking.endUpdate();
+
+					// The moving cards are drawn on top of the rest, the shader places them from the time.
+					GpuProfiler::instance().beginPass(GpuPass::Cards);
+
+					m_SpriteRenderer->renderMotions(static_cast<GLfloat>(glfwGetTime()));
+
+					GpuProfiler::instance().endPass();
 				}
 				else
 				{
 					m_showScoreBoardMenu = true;
 
 					// Animate individual sprite that is on gameboard group.
+					GpuProfiler::instance().beginPass(GpuPass::Background);
+
 					for (auto& sprite : m_gameBoardGeneral)
 					{
 						sprite.render(m_SpriteRenderer);
 					}
 
+					GpuProfiler::instance().endPass();
+
 					m_gameBoard.calculatePlayerScore();
 					renderFinalUI(m_gameBoard.getPlayerScore());
 				}
@@ -199,24 +257,22 @@ namespace Game
 		return(Error::Ok);
 	}
 
-	void GameProgram::renderSpriteGroup(vector<AnimatedSprite>& spriteGroup)
+	void GameProgram::renderSpriteGroup(span<AnimatedSprite> spriteGroup)
 	{
+		ENGINE_PROFILE_SCOPE("GameProgram::renderSpriteGroup");
+
 		auto windowDimensions = getWindowDimensions();
 
-		// Try to get the shaders from the global shader/texture storage, if the get request fails
-		// exit the program.
-		auto shaderWrapperOrError = Engine::ResourceManager::getShader("spriteShader");
-		if (shaderWrapperOrError.has_value())
-		{
-			(*shaderWrapperOrError).setFloat   ("elapsedTime", glfwGetTime() * 6);
-			(*shaderWrapperOrError).setVector2f("screenResolution", (ivec2)Engine::Window::instance().getWindowDimensionsKHR());
-		}
+		// The time of the glowing effect(passed to the shader variants that are using it).
+		m_SpriteRenderer->setElapsedTime(static_cast<GLfloat>(glfwGetTime() * 6));
 
 		const auto spriteGroupSize = m_gameBoardCards.size();
 		m_hoveredCardCopy.cardRank = CardRankLast;
 
+		auto& gpuProfiler = GpuProfiler::instance();
+
 		for (auto& sprite : spriteGroup) {
-			sprite.animate(m_elapsedTime);
+			sprite.animate();
 
 			const bool applyBadEffect  = (sprite.getRenderFlag()  & SPRITE_APPLY_HOVER_BAD_EFFECT)   == SPRITE_APPLY_HOVER_BAD_EFFECT;
 			const bool applyGoodEffect = (sprite.getRenderFlag() & SPRITE_APPLY_HOVER_GOOD_EFFECT)  == SPRITE_APPLY_HOVER_GOOD_EFFECT;
@@ -225,63 +281,54 @@ namespace Game
 			const auto   size     = sprite.getSpriteSize();
 			const auto   color    = sprite.getSpriteColor();
 			const auto   position = sprite.getSpritePosition();
-			const auto   rotation = sprite.getSpriteRotation();
-
-			// Apply shadows
-			AnimatedSprite shadowSprite;
-			shadowSprite.setSpriteSize    (size);
-			shadowSprite.setMoveSpeed     (sprite.getMoveSpeed());
-			shadowSprite.setSpriteRotation(sprite.getSpriteRotation());
-			shadowSprite.bindTexture      (sprite.getBindedTexture());
-			shadowSprite.setSpritePosition({ position.x + size.x / 14, position.y + size.y / 14 });
 
-			(*shaderWrapperOrError).setInteger("applyShadowEffect", 1);
-			shadowSprite.render(m_SpriteRenderer);
-			(*shaderWrapperOrError).setInteger("applyShadowEffect", 0);
+			// The effects are the flags of the batched sprite now, so the whole group is drawn
+			// by a few instanced draw calls(the instance data is generated on the workers). The
+			// cards are rotated, so their edges are anti-aliased by the shader.
+			AnimatedSprite shadowSprite = sprite;
+			shadowSprite.setSpritePosition({ position.x + size.x / 14, position.y + size.y / 14 });
+			shadowSprite.queue(m_SpriteRenderer, SpriteInstanceShadow | SpriteInstanceSmoothEdges);
 
 			if (applyBlurEffect) // Apply motion blur
 			{
-				(*shaderWrapperOrError).setInteger("applyGlowingEffect", 0, true);
 				const float offsetX = 2.6f;
 				const float offsetY = 2.6f;
 
-				sprite.render(m_SpriteRenderer);
+				sprite.queue(m_SpriteRenderer, SpriteInstanceSmoothEdges);
+
+				AnimatedSprite spriteCopy = sprite;
+				spriteCopy.setSpriteColor({ color.x, color.y, color.z });
 
-				(*shaderWrapperOrError).setInteger("applyMotionEffect", 1, true);
 				for (auto x = 0; x < 3; ++x)
 				{
 					for (auto y = 0; y < 3; ++y)
 					{
-						AnimatedSprite spriteCopy;
-						spriteCopy.setSpriteColor({ color.x, color.y, color.z });
-						spriteCopy.setSpriteRotation(rotation);
-						spriteCopy.setSpriteSize(size);
-						spriteCopy.bindTexture(sprite.getBindedTexture());
-
 						spriteCopy.setSpritePosition({ position.x + offsetX * x, position.y + offsetY * y });
-						spriteCopy.render(m_SpriteRenderer);
+						spriteCopy.queue(m_SpriteRenderer, SpriteInstanceTrail | SpriteInstanceSmoothEdges);
 						spriteCopy.setSpritePosition({ position.x - offsetX * x, position.y - offsetY * y });
-						spriteCopy.render(m_SpriteRenderer);
+						spriteCopy.queue(m_SpriteRenderer, SpriteInstanceTrail | SpriteInstanceSmoothEdges);
 					}
 				}
-				(*shaderWrapperOrError).setInteger("applyMotionEffect", 0, true);
 			}
 			else if (applyBadEffect || applyGoodEffect) // Apply glowing effect
 			{
-				(*shaderWrapperOrError).setVector3f("intencityMask", applyBadEffect ? CARD_INTENCITY_MASK_BAD : CARD_INTENCITY_MASK_GOOD);
-				(*shaderWrapperOrError).setInteger("applyGlowingEffect", 1, true);
-
-				sprite.render(m_SpriteRenderer);
+				// The glowing sprite carries the intensity mask in its color.
+				AnimatedSprite glowingSprite = sprite;
+				glowingSprite.setSpriteColor(applyBadEffect ? CARD_INTENCITY_MASK_BAD : CARD_INTENCITY_MASK_GOOD);
+				glowingSprite.queue(m_SpriteRenderer, SpriteInstanceGlow | SpriteInstanceSmoothEdges);
 			}
 			else
 			{
-				sprite.render(m_SpriteRenderer);
+				sprite.queue(m_SpriteRenderer, SpriteInstanceSmoothEdges);
 			}
-
-			(*shaderWrapperOrError).setInteger("applyGlowingEffect", 0, true);
-			(*shaderWrapperOrError).setInteger("applyBlurEffect", 0, true);
 		}
 
+		gpuProfiler.beginPass(GpuPass::Cards);
+
+		m_SpriteRenderer->flushSprites();
+
+		gpuProfiler.endPass();
+
 		renderGameBoardUI(windowDimensions);
 	}
 
@@ -378,10 +425,10 @@ namespace Game
 			auto renderAreaStart = renderArea.first;
 			auto renderAreaEnd   = renderArea.second;
 
-			playerCard.move({
+			const vec2 cardDestination = {
 				renderAreaStart.x + ((renderAreaEnd.x - renderAreaStart.x) / ownerGroupSize) * cardIndex,
 				renderAreaStart.y
-			});
+			};
 			
 			// Hide card faces of the opponents
 			if ((cardOwner == CARD_OWNER_PLAYER1 || cardOwner == CARD_OWNER_BOARD) || m_openCardsMode)
@@ -389,25 +436,34 @@ namespace Game
 			else
 				playerCard.bindTexture(ownerGroup[cardIndex].textureHandleBack);
 
-			if (playerCard.getIsAnimated())
-				playerCard.setRenderFlag(playerCard.getRenderFlag() | SPRITE_APPLY_MOTION_BLUR_EFFECT);
+			// The dealt card moves on the GPU, it is not arranged again until it arrives.
+			bool isCardMoving = beginCardMotion(playerCard, cardDestination);
+
+			playerCard.setSpritePosition(cardDestination);
 
 			// Main player card controls
-			if (cardOwner == CARD_OWNER_PLAYER1)
+			if (isCardMoving)
+			{
+				playerCard.setRenderFlag(SPRITE_APPLY_NONE_EFFECTS);
+			}
+			else if (cardOwner == CARD_OWNER_PLAYER1)
 			{
+				playerCard.setPickingID(getCardPickingID(ownerGroup[cardIndex]));
+
 				// If the current player is deliverer, track its move
 				if (m_gameBoard.getDeliverer() == CARD_OWNER_PLAYER1)
 				{
-					if (playerCard.isHovered({ m_mousePositionX, m_mousePositionY }, { 1.0f, 1.0f }))
+					if (m_hoveredPickingID == playerCard.getPickingID())
 					{
 						if (m_gameBoard.moveIsValid(ownerGroup[cardIndex]))
 						{
 							playerCard.setRenderFlag(SPRITE_APPLY_HOVER_GOOD_EFFECT);
 
-							if (m_mouseButtonPressed)
+							if (wasMouseButtonPressed(GLFW_MOUSE_BUTTON_LEFT))
 							{
 								m_gameBoard.move(ownerGroup[cardIndex]);
-								playerCard.move(m_boardPosition);
+
+								isCardMoving = beginCardMotion(playerCard, m_boardPosition);
 							}
 						}
 						else
@@ -430,14 +486,17 @@ namespace Game
 				playerCard.setRenderFlag(SPRITE_APPLY_NONE_EFFECTS);
 			}
 
-			m_gameBoardCards   .push_back(playerCard);
+			if (!isCardMoving)
+				m_gameBoardCards.push_back(playerCard);
+
 			m_gameBoardCardsRef.push_back(ownerGroup[cardIndex]);
 		}
 	}
 
-	vector<Card> GameProgram::searchCard(CardOwner owner, bool rewind)
+	FrameVector<Card> GameProgram::searchCard(CardOwner owner, bool rewind)
 	{
-		vector<Card> ownerGroup;
+		FrameVector<Card> ownerGroup(&FrameArena::instance());
+		ownerGroup.reserve(m_gameBoard.getCards().size());
 
 		// Iterate through each card and if the card owner matches with the
 		// requested owner add it to the result group(that contains only
@@ -501,14 +560,10 @@ namespace Game
 
 	void GameProgram::arrangeBoardSprites()
 	{
-		vector<AnimatedSprite> animatedSprites;
-
 		auto      boardOwnerGroup         = searchCard(CARD_OWNER_BOARD);
 		auto      boardOwnerGroupSize     = boardOwnerGroup.size();
 		ptrdiff_t cardsRotatedRenderTotal = 0;
 
-		bool somethingIsAnimating = false;
-
 		for (ptrdiff_t boardSpriteIndex = boardOwnerGroupSize; boardSpriteIndex--> 0;)
 		{
 			// Card previous position in the deck
@@ -552,21 +607,99 @@ namespace Game
 				continue;
 			}
 
-			boardCard.move   (m_boardPosition);
-			boardCard.animate(m_elapsedTime);
+			// The played card moves on the GPU, the cards that are already there lie on the board.
+			if (!beginCardMotion(boardCard, m_boardPosition))
+			{
+				boardCard.setSpritePosition(m_boardPosition);
 
-			if (boardCard.getIsAnimated())
-			{			
-				animatedSprites.push_back(boardCard);
+				m_gameBoardCards.push_back(boardCard);
 			}
-			else
+		}
+	}
+
+	bool GameProgram::beginCardMotion(const AnimatedSprite& cardSprite, vec2 cardDestination)
+	{
+		const vec2 cardPosition = cardSprite.getSpritePosition();
+		const vec2 moveSpeed    = cardSprite.getMoveSpeed();
+
+		// The same duration as the ::AnimatedSprite::move has(the slowest axis wins).
+		GLfloat duration = 0.0f;
+
+		if (moveSpeed.x > 0.0f)
+			duration = fmaxf(duration, fabsf(cardDestination.x - cardPosition.x) / moveSpeed.x);
+		if (moveSpeed.y > 0.0f)
+			duration = fmaxf(duration, fabsf(cardDestination.y - cardPosition.y) / moveSpeed.y);
+
+		if (duration <= 0.0f)
+			return(false);
+
+		SpriteMotion cardMotion;
+		cardMotion.startPosition = cardPosition;
+		cardMotion.endPosition   = cardDestination;
+		cardMotion.spriteSize    = cardSprite.getSpriteSize();
+		cardMotion.startRotation = cardSprite.getSpriteRotation();
+		cardMotion.endRotation   = cardSprite.getSpriteRotation();
+		cardMotion.spriteColor   = cardSprite.getSpriteColor();
+		cardMotion.startTime     = static_cast<GLfloat>(glfwGetTime());
+		cardMotion.duration      = duration;
+
+		const StringID cardTexture = cardSprite.getBindedTexture();
+
+		// The same layers the ::renderSpriteGroup queues for the moving card: the shadow, the card
+		// and the motion blur trail on top of it(the motions are drawn in this order).
+		SpriteMotion shadowMotion = cardMotion;
+		shadowMotion.startPosition += cardMotion.spriteSize / 14.0f;
+		shadowMotion.endPosition   += cardMotion.spriteSize / 14.0f;
+		shadowMotion.instanceFlags  = SpriteInstanceShadow | SpriteInstanceSmoothEdges;
+
+		m_cardMotions.push_back(m_SpriteRenderer->beginMotion(cardTexture, shadowMotion));
+
+		cardMotion.instanceFlags = SpriteInstanceSmoothEdges;
+
+		m_cardMotions.push_back(m_SpriteRenderer->beginMotion(cardTexture, cardMotion));
+
+		const float offsetX = 2.6f;
+		const float offsetY = 2.6f;
+
+		SpriteMotion trailMotion = cardMotion;
+		trailMotion.instanceFlags = SpriteInstanceTrail | SpriteInstanceSmoothEdges;
+
+		for (auto x = 0; x < 3; ++x)
+		{
+			for (auto y = 0; y < 3; ++y)
 			{
-				m_gameBoardCards.push_back(boardCard);
+				for (const float trailSide : { 1.0f, -1.0f })
+				{
+					const vec2 trailOffset = { trailSide * offsetX * x, trailSide * offsetY * y };
+
+					trailMotion.startPosition = cardMotion.startPosition + trailOffset;
+					trailMotion.endPosition   = cardMotion.endPosition   + trailOffset;
+
+					m_cardMotions.push_back(m_SpriteRenderer->beginMotion(cardTexture, trailMotion));
+				}
 			}
 		}
 
-		for(auto sprite: animatedSprites)
-			m_gameBoardCards.push_back(sprite);
+		return(true);
+	}
+
+	void GameProgram::endCardMotions()
+	{
+		for (const auto motionHandle : m_cardMotions)
+			m_SpriteRenderer->endMotion(motionHandle);
+
+		m_cardMotions.clear();
+	}
+
+	bool GameProgram::isAnyCardMoving() const
+	{
+		const GLfloat currentTime = static_cast<GLfloat>(glfwGetTime());
+
+		for (const auto motionHandle : m_cardMotions)
+			if (!m_SpriteRenderer->isMotionFinished(motionHandle, currentTime))
+				return(true);
+
+		return(false);
 	}
 
 	void GameProgram::renderFinalUI(PlayerScore playerScores)
@@ -642,8 +775,9 @@ namespace Game
 
     void GameProgram::updateGameBoardCardSprites(ivec2& windowDimensions)
     { 
-      // Clear the previous sprites.
+      // Clear the previous sprites(the moves of the previous arrangement are over).
       m_gameBoardCards.clear();
+      endCardMotions();
 	 
 	  // Adjust the sprite positions for the each player
 	  arrangePlayerSprite(CARD_OWNER_PLAYER1);
@@ -718,6 +852,7 @@ namespace Game
 
 	  renderSettingsUI();
 	  renderQuitApproveUI();
+	  renderDeveloperToolsUI();
 
 	  ImGui::EndFrame();
 	  ImGui::Render();
@@ -801,6 +936,25 @@ namespace Game
 				{
 					ImGui::MenuItem("Show Debug Window", NULL, &m_showDebugWindow);
 					ImGui::MenuItem("Show Enemy Card Faces", NULL, &m_openCardsMode);
+					ImGui::MenuItem("Show Latency Report", NULL, &m_showLatencyWindow);
+					ImGui::MenuItem("Show Metrics", NULL, &m_showMetricsWindow);
+
+					// The culled sprites are counted by the `engine_sprites_culled_total` metric.
+					bool isOverdrawView     = m_SpriteRenderer->isOverdrawView();
+					bool isOcclusionCulling = m_SpriteRenderer->isOcclusionCulling();
+
+					if (ImGui::MenuItem("Show Overdraw Heatmap", NULL, &isOverdrawView))
+						m_SpriteRenderer->setOverdrawView(isOverdrawView);
+
+					if (ImGui::MenuItem("Cull Covered Cards", NULL, &isOcclusionCulling))
+						m_SpriteRenderer->setOcclusionCulling(isOcclusionCulling);
+
+					if (ImGui::MenuItem("Dump Latency Report"))
+						LatencyTracker::instance().dumpReport();
+
+					// The capture is written into the file when the frames are recorded.
+					if (ImGui::MenuItem("Capture CPU Profile", NULL, false, Profiler::instance().getRemainingFrames() == 0))
+						Profiler::instance().requestCapture(Profiler::DefaultCaptureFrames, PROFILE_CAPTURE_RELPATH);
 
 					ImGui::EndMenu();
 				}
@@ -810,6 +964,22 @@ namespace Game
 		}
 	}
 
+	void GameProgram::renderDeveloperToolsUI()
+	{
+		// The GPU queries are only issued while somebody is looking at them(or the dynamic
+		// resolution is following the GPU time).
+		GpuProfiler::instance().setEnabled(m_showDebugWindow || DynamicResolution::instance().isEnabled());
+
+		if (m_showDebugWindow)
+			GpuProfiler::instance().renderDebugUI(&m_showDebugWindow);
+
+		if (m_showLatencyWindow)
+			LatencyTracker::instance().renderReportUI(&m_showLatencyWindow);
+
+		if (m_showMetricsWindow)
+			MetricsRegistry::instance().renderMetricsUI(&m_showMetricsWindow);
+	}
+
     void GameProgram::renderMainMenuUI(ivec2& windowDimensions)
     {
 			ImguiCreateNewFrameKHR();
@@ -849,6 +1019,7 @@ namespace Game
 			
 			renderQuitApproveUI();
 			renderSettingsUI();
+			renderDeveloperToolsUI();
             
 			ImGui::EndFrame();
 			ImGui::Render();
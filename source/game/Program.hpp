@@ -3,6 +3,10 @@
 #include "../engine/Application.hpp"
 #include "../engine/Sprite.hpp"
 #include "../engine/AnimatedSprite.hpp"
+#include "../engine/PickingIndex.hpp"
+#include "../engine/FrameArena.hpp"
+
+#include "span"
 
 #include "GameInfo.hpp"
 #include "GameBoard.hpp"
@@ -38,12 +42,23 @@ namespace Game
 
 		void arrangeBoardSprites();
 
-		vector<Card> searchCard(CardOwner owner, bool rewind=true);
+		// Start the move of the card sprite to the destination on the GPU(the vertex shader moves
+		// it together with its shadow and the motion blur trail, the sprite is not touched again
+		// until it arrives). False is returned when the card is already there.
+		bool beginCardMotion(const AnimatedSprite& cardSprite, vec2 cardDestination);
+
+		// Release the motions of the previous arrangement of the cards.
+		void endCardMotions();
+
+		bool isAnyCardMoving() const;
+
+		// The returned group is allocated from the frame arena, it must not outlive the frame.
+		FrameVector<Card> searchCard(CardOwner owner, bool rewind=true);
 
 	private:
 		pair<vec2, vec2> getRenderAreaBasedOnCardOwner(CardOwner cardOwner);
 
-		void renderSpriteGroup(vector<AnimatedSprite>& spriteGroup);
+		void renderSpriteGroup(span<AnimatedSprite> spriteGroup);
 
 	    void renderGameBoardUI(ivec2& windowDimensions);
 	    
@@ -53,6 +68,8 @@ namespace Game
 
 		void renderSettingsUI();
 
+		void renderDeveloperToolsUI();
+
 		void renderFinalUI(PlayerScore playerScores);
 
 		void renderPlayerStatUI(CardOwner owner);
@@ -64,6 +81,8 @@ namespace Game
 	    bool m_showSettingsWindow    = false;
 		bool m_showQuitApproveWindow = false;
 		bool m_showDebugWindow       = false;
+		bool m_showLatencyWindow     = false;
+		bool m_showMetricsWindow     = false;
 		bool m_showBoardMenuWindow   = false;
 		bool m_showScoreBoardMenu    = false;
 
@@ -94,7 +113,14 @@ namespace Game
         vector<AnimatedSprite> m_gameBoardCards;
         vector<Card>           m_gameBoardCardsRef;
 
+		// The cards that are moving between the arrangements(drawn by the ::SpriteRenderer::renderMotions).
+		vector<MotionHandle> m_cardMotions;
+
         Card m_hoveredCardCopy;
 		Card m_lastCardCopy;
+
+		// The cards rendered on the previous frame, used to find the card under the cursor.
+		PickingIndex     m_cardPicking;
+		optional<GLuint> m_hoveredPickingID;
 	};
 }
@@ -0,0 +1,317 @@
+// This file implements the `log-decode` tool, that turns the binary trace log(see the
+// `TraceLog` class) back into the text:
+//
+//   log-decode <trace file> [output file]
+//
+// The records of all the threads are merged in the timestamp order.
+#include "../engine/TraceLog.hpp"
+
+#include "spdlog/fmt/fmt.h"
+#ifdef SPDLOG_FMT_EXTERNAL
+	#include "fmt/args.h"
+#else
+	#include "spdlog/fmt/bundled/args.h"
+#endif
+
+#include "cstdio"
+#include "algorithm"
+#include "unordered_map"
+
+using namespace std;
+
+// The decoded format definition.
+struct DecodedFormat
+{
+	string                            fileName;
+	uint32_t                          lineNumber;
+	string                            formatString;
+	vector<Engine::TraceArgType>      argTypes;
+};
+
+// The decoded record(the text is formatted right away, so the argument bytes are not kept).
+struct DecodedRecord
+{
+	uint64_t timestamp;
+	uint32_t threadIndex;
+	uint32_t formatID;
+	string   recordText;
+};
+
+// The sequential reader of the bytes.
+class ByteReader
+{
+public:
+	ByteReader(const uint8_t* begin, const uint8_t* end) : m_Current(begin), m_End(end)
+	{
+	}
+
+	template<typename T>
+	bool read(T& value) noexcept
+	{
+		if (static_cast<size_t>(m_End - m_Current) < sizeof(T))
+			return(false);
+
+		memcpy(&value, m_Current, sizeof(T));
+		m_Current += sizeof(T);
+
+		return(true);
+	}
+
+	bool readVarint(uint64_t& value) noexcept
+	{
+		value = 0;
+
+		for (uint32_t shift = 0; shift < 64 && m_Current < m_End; shift += 7)
+		{
+			const uint8_t varintByte = *m_Current++;
+
+			value |= static_cast<uint64_t>(varintByte & 0x7Fu) << shift;
+
+			if ((varintByte & 0x80u) == 0)
+				return(true);
+		}
+
+		return(false);
+	}
+
+	bool readBytes(string& value, size_t length)
+	{
+		if (static_cast<size_t>(m_End - m_Current) < length)
+			return(false);
+
+		value.assign(reinterpret_cast<const char*>(m_Current), length);
+		m_Current += length;
+
+		return(true);
+	}
+
+	inline bool isEnd() const noexcept
+	{
+		return(m_Current >= m_End);
+	}
+
+private:
+	const uint8_t* m_Current;
+	const uint8_t* m_End;
+};
+
+// Read the arguments of the record and format its text.
+static bool decodeRecord(ByteReader& byteReader, const DecodedFormat& decodedFormat, string& recordText)
+{
+	fmt::dynamic_format_arg_store<fmt::format_context> formatArgs;
+
+	for (const auto argType : decodedFormat.argTypes)
+	{
+		bool isRead = false;
+
+		switch (argType)
+		{
+			case Engine::TraceArgType::Int32:
+			case Engine::TraceArgType::Int64:
+			{
+				uint64_t value;
+				isRead = byteReader.readVarint(value);
+
+				// Undo the zigzag encoding.
+				formatArgs.push_back(static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1u));
+			} break;
+
+			case Engine::TraceArgType::UInt32:
+			case Engine::TraceArgType::UInt64:
+			{
+				uint64_t value;
+				isRead = byteReader.readVarint(value);
+				formatArgs.push_back(value);
+			} break;
+
+			case Engine::TraceArgType::Float:  { float    value; isRead = byteReader.read(value); formatArgs.push_back(value); } break;
+			case Engine::TraceArgType::Double: { double   value; isRead = byteReader.read(value); formatArgs.push_back(value); } break;
+			case Engine::TraceArgType::Bool:   { uint8_t  value; isRead = byteReader.read(value); formatArgs.push_back(value != 0); } break;
+
+			case Engine::TraceArgType::String:
+			{
+				uint16_t stringLength;
+				string   value;
+
+				isRead = byteReader.read(stringLength) && byteReader.readBytes(value, stringLength);
+				formatArgs.push_back(value);
+			} break;
+		}
+
+		if (!isRead)
+			return(false);
+	}
+
+	try
+	{
+		recordText = fmt::vformat(decodedFormat.formatString, formatArgs);
+	}
+	catch (const fmt::format_error& formatError)
+	{
+		recordText = fmt::format("<bad format \"{}\": {}>", decodedFormat.formatString, formatError.what());
+	}
+
+	return(true);
+}
+
+int main(int argc, char* argv[])
+{
+	if (argc < 2)
+	{
+		fprintf(stderr, "usage: log-decode <trace file> [output file]\n");
+
+		return(1);
+	}
+
+	FILE* inputFile = fopen(argv[1], "rb");
+
+	if (inputFile == nullptr)
+	{
+		fprintf(stderr, "unable to open %s\n", argv[1]);
+
+		return(1);
+	}
+
+	vector<uint8_t> fileData;
+	{
+		uint8_t readBuffer[64 * 1024];
+		size_t  readBytes;
+
+		while ((readBytes = fread(readBuffer, 1, sizeof(readBuffer), inputFile)) > 0)
+			fileData.insert(fileData.end(), readBuffer, readBuffer + readBytes);
+
+		fclose(inputFile);
+	}
+
+	ByteReader fileReader(fileData.data(), fileData.data() + fileData.size());
+
+	uint32_t headerTag, fileVersion;
+	uint64_t startTimestamp;
+
+	if (!fileReader.read(headerTag) || !fileReader.read(fileVersion) || !fileReader.read(startTimestamp) ||
+		headerTag != Engine::TraceFile::HeaderTag || fileVersion != Engine::TraceFile::Version)
+	{
+		fprintf(stderr, "%s is not a trace log(or has the unsupported version)\n", argv[1]);
+
+		return(1);
+	}
+
+	unordered_map<uint32_t, DecodedFormat> decodedFormats;
+	vector<DecodedRecord>                  decodedRecords;
+	size_t                                 corruptedChunks = 0;
+
+	uint32_t blockTag;
+
+	while (fileReader.read(blockTag))
+	{
+		if (blockTag == Engine::TraceFile::FormatTag)
+		{
+			uint32_t      formatID;
+			uint8_t       argCount;
+			uint16_t      fileLength, formatLength;
+			DecodedFormat decodedFormat;
+
+			bool isRead = fileReader.read(formatID) && fileReader.read(decodedFormat.lineNumber) && fileReader.read(argCount);
+
+			for (uint8_t argIndex = 0; isRead && argIndex < argCount; ++argIndex)
+			{
+				uint8_t argType;
+				isRead = fileReader.read(argType);
+				decodedFormat.argTypes.push_back(static_cast<Engine::TraceArgType>(argType));
+			}
+
+			isRead = isRead && fileReader.read(fileLength)   && fileReader.readBytes(decodedFormat.fileName, fileLength);
+			isRead = isRead && fileReader.read(formatLength) && fileReader.readBytes(decodedFormat.formatString, formatLength);
+
+			if (!isRead)
+				break;
+
+			decodedFormats[formatID] = std::move(decodedFormat);
+		}
+		else if (blockTag == Engine::TraceFile::ChunkTag)
+		{
+			uint32_t threadIndex, chunkSize;
+			uint64_t baseTimestamp;
+			string   chunkData;
+
+			if (!fileReader.read(threadIndex) || !fileReader.read(baseTimestamp) || !fileReader.read(chunkSize) || !fileReader.readBytes(chunkData, chunkSize))
+				break;
+
+			const auto chunkBegin = reinterpret_cast<const uint8_t*>(chunkData.data());
+			ByteReader chunkReader(chunkBegin, chunkBegin + chunkData.size());
+
+			while (!chunkReader.isEnd())
+			{
+				DecodedRecord decodedRecord;
+				decodedRecord.threadIndex = threadIndex;
+
+				uint16_t recordFormat;
+				uint32_t timestampDelta;
+
+				if (!chunkReader.read(recordFormat) || !chunkReader.read(timestampDelta))
+				{
+					++corruptedChunks;
+					break;
+				}
+
+				decodedRecord.formatID  = recordFormat;
+				decodedRecord.timestamp = baseTimestamp + timestampDelta;
+
+				const auto formatIterator = decodedFormats.find(decodedRecord.formatID);
+
+				// The rest of the chunk can not be parsed without knowing the argument types.
+				if (formatIterator == decodedFormats.end() || !decodeRecord(chunkReader, formatIterator->second, decodedRecord.recordText))
+				{
+					++corruptedChunks;
+					break;
+				}
+
+				decodedRecords.push_back(std::move(decodedRecord));
+			}
+		}
+		else
+		{
+			fprintf(stderr, "unknown block %08x, the rest of the file is skipped\n", blockTag);
+
+			break;
+		}
+	}
+
+	// The chunks of the different threads are interleaved, merge them.
+	stable_sort(decodedRecords.begin(), decodedRecords.end(), [](const DecodedRecord& left, const DecodedRecord& right)
+	{
+		return(left.timestamp < right.timestamp);
+	});
+
+	FILE* outputFile = argc > 2 ? fopen(argv[2], "w") : stdout;
+
+	if (outputFile == nullptr)
+	{
+		fprintf(stderr, "unable to open %s\n", argv[2]);
+
+		return(1);
+	}
+
+	for (const auto& decodedRecord : decodedRecords)
+	{
+		const auto& decodedFormat = decodedFormats[decodedRecord.formatID];
+		const auto  sourceName    = decodedFormat.fileName.substr(decodedFormat.fileName.find_last_of("/\\") + 1);
+
+		fprintf(outputFile, "[%14.6f] [thread %u] [%s:%u] %s\n",
+			static_cast<double>(decodedRecord.timestamp - startTimestamp) / 1e9,
+			decodedRecord.threadIndex,
+			sourceName.c_str(),
+			decodedFormat.lineNumber,
+			decodedRecord.recordText.c_str());
+	}
+
+	if (outputFile != stdout)
+		fclose(outputFile);
+
+	if (corruptedChunks > 0)
+		fprintf(stderr, "%zu chunks were not fully decoded\n", corruptedChunks);
+
+	fprintf(stderr, "%zu records, %zu formats\n", decodedRecords.size(), decodedFormats.size());
+
+	return(0);
+}
@@ -0,0 +1,146 @@
+// This file implements the `render-replay` tool, that replays the render command stream(see
+// the `RecordingRenderDevice` class) frame by frame into the offscreen OpenGL context:
+//
+//   render-replay <command stream> [--null] [headless options, see ::HeadlessRunner]
+//
+// The frame times are reported the same way as the headless run of the game, so the
+// recorded frames of the player machine can be profiled on the dev box without the game.
+#include "../engine/HeadlessRunner.hpp"
+#include "../engine/Logger.hpp"
+
+#include "../engine/rendering/OpenGLRenderDevice.hpp"
+#include "../engine/rendering/NullRenderDevice.hpp"
+#include "../engine/rendering/RecordingRenderDevice.hpp"
+
+#include "cstring"
+#include "cstdio"
+#include "vector"
+
+using namespace std;
+
+// The OpenGL context version(the same as the game is using).
+static constexpr const int _RENDER_REPLAY_CONTEXT_MAJOR = 3;
+static constexpr const int _RENDER_REPLAY_CONTEXT_MINOR = 3;
+
+int main(int argc, char* argv[])
+{
+	if (argc < 2)
+	{
+		fprintf(stderr, "usage: render-replay <command stream> [--null] [headless options]\n");
+
+		return(1);
+	}
+
+	// The stream is replayed until its end(the zero frames) unless the amount of the frames is given.
+	static char headlessArgument[] = "--headless";
+	static char framesArgument[]   = "--frames=0";
+
+	vector<char*> runnerArguments = { argv[0], headlessArgument, framesArgument };
+	bool          isNullReplay    = false;
+
+	for (int argumentIndex = 2; argumentIndex < argc; ++argumentIndex)
+	{
+		if (strcmp(argv[argumentIndex], "--null") == 0)
+			isNullReplay = true;
+		else
+			runnerArguments.push_back(argv[argumentIndex]);
+	}
+
+	auto& headlessRunner = Engine::HeadlessRunner::instance();
+
+	if (!FunctionSuccessA(headlessRunner.parseArguments(static_cast<int>(runnerArguments.size()), runnerArguments.data())))
+		return(1);
+
+	Engine::Logger::initialize();
+
+	Engine::GFX::RenderCommandReplayer commandReplayer;
+
+	if (!FunctionSuccessA(commandReplayer.open(argv[1])))
+	{
+		fprintf(stderr, "unable to read the command stream %s\n", argv[1]);
+
+		Engine::Logger::release();
+
+		return(1);
+	}
+
+	headlessRunner.initializePlatform();
+
+	if (glfwInit() != GLFW_TRUE)
+	{
+		fprintf(stderr, "unable to initialize GLFW\n");
+
+		Engine::Logger::release();
+
+		return(1);
+	}
+
+	glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, _RENDER_REPLAY_CONTEXT_MAJOR);
+	glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, _RENDER_REPLAY_CONTEXT_MINOR);
+	glfwWindowHint(GLFW_OPENGL_PROFILE,        GLFW_OPENGL_CORE_PROFILE);
+
+	GLFWwindow* replayWindow = headlessRunner.createWindow("render-replay");
+
+	if (replayWindow == nullptr)
+	{
+		fprintf(stderr, "unable to create the offscreen context\n");
+
+		glfwTerminate();
+		Engine::Logger::release();
+
+		return(1);
+	}
+
+	glfwMakeContextCurrent(replayWindow);
+
+	if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress) || !FunctionSuccess(headlessRunner.initialize))
+	{
+		fprintf(stderr, "unable to initialize the offscreen render target\n");
+
+		glfwDestroyWindow(replayWindow);
+		glfwTerminate();
+		Engine::Logger::release();
+
+		return(1);
+	}
+
+	// The null replay measures the decoding of the stream alone.
+	unique_ptr<Engine::GFX::RenderDevice> replayDevice;
+
+	if (isNullReplay)
+		replayDevice = make_unique<Engine::GFX::NullRenderDevice>();
+	else
+		replayDevice = make_unique<Engine::GFX::OpenGLRenderDevice>();
+
+	uint64_t framesReplayed = 0;
+
+	while (!headlessRunner.isFinished())
+	{
+		headlessRunner.beginFrame(replayWindow);
+
+		const bool isFrameReplayed = commandReplayer.replayFrame(*replayDevice);
+
+		headlessRunner.endFrame();
+
+		if (!isFrameReplayed)
+			break;
+
+		framesReplayed++;
+	}
+
+	printf("replayed %llu frames(%llu commands)\n",
+		static_cast<unsigned long long>(framesReplayed),
+		static_cast<unsigned long long>(commandReplayer.getCommandsReplayed()));
+
+	// The frame times are written and printed here.
+	headlessRunner.release();
+
+	replayDevice.reset();
+
+	glfwDestroyWindow(replayWindow);
+	glfwTerminate();
+
+	Engine::Logger::release();
+
+	return(0);
+}